@@ -526,17 +526,27 @@ INSTANTIATE_TEST_SUITE_P(SSSE3, TransDCT,
                                                       0, VPX_BITS_8)));
 #endif  // HAVE_SSSE3 && !CONFIG_VP9_HIGHBITDEPTH && VPX_ARCH_X86_64
 
-#if HAVE_AVX2 && !CONFIG_VP9_HIGHBITDEPTH
-static const FuncInfo dct_avx2_func_info = {
-  &fdct_wrapper<vpx_fdct32x32_avx2>, &idct_wrapper<vpx_idct32x32_1024_add_sse2>,
-  32, 1
+#if HAVE_AVX2
+static const FuncInfo dct_avx2_func_info[] = {
+#if !CONFIG_VP9_HIGHBITDEPTH
+  // TODO(johannkoenig): high bit depth fdct32x32.
+  { &fdct_wrapper<vpx_fdct32x32_avx2>,
+    &idct_wrapper<vpx_idct32x32_1024_add_sse2>, 32, 1 },
+#endif
+  { &fdct_wrapper<vpx_fdct16x16_c>, &idct_wrapper<vpx_idct16x16_256_add_avx2>,
+    16, 1 },
+  { &fdct_wrapper<vpx_fdct32x32_c>,
+    &idct_wrapper<vpx_idct32x32_1024_add_avx2>, 32, 1 }
 };
 
-// TODO(johannkoenig): high bit depth fdct32x32.
-INSTANTIATE_TEST_SUITE_P(AVX2, TransDCT,
-                         ::testing::Values(make_tuple(0, &dct_avx2_func_info, 0,
-                                                      VPX_BITS_8)));
-#endif  // HAVE_AVX2 && !CONFIG_VP9_HIGHBITDEPTH
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, TransDCT,
+    ::testing::Combine(
+        ::testing::Range(0, static_cast<int>(sizeof(dct_avx2_func_info) /
+                                             sizeof(dct_avx2_func_info[0]))),
+        ::testing::Values(dct_avx2_func_info), ::testing::Values(0),
+        ::testing::Values(VPX_BITS_8)));
+#endif  // HAVE_AVX2
 
 #if HAVE_NEON
 static const FuncInfo dct_neon_func_info[4] = {
@@ -669,6 +679,18 @@ INSTANTIATE_TEST_SUITE_P(
                        ::testing::Range(0, 4), ::testing::Values(VPX_BITS_8)));
 #endif  // HAVE_SSE2
 
+#if HAVE_AVX2
+static const FuncInfo ht_avx2_func_info = {
+  &vp9_fht16x16_c, &iht_wrapper<vp9_iht16x16_256_add_avx2>, 16, 1
+};
+
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, TransHT,
+    ::testing::Combine(::testing::Values(0),
+                       ::testing::Values(&ht_avx2_func_info),
+                       ::testing::Range(0, 4), ::testing::Values(VPX_BITS_8)));
+#endif  // HAVE_AVX2
+
 #if HAVE_SSE4_1 && CONFIG_VP9_HIGHBITDEPTH
 static const FuncInfo ht_sse4_1_func_info[3] = {
   { &vp9_highbd_fht4x4_c, &highbd_iht_wrapper<vp9_highbd_iht4x4_16_add_sse4_1>,
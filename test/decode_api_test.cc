@@ -8,12 +8,17 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <vector>
+
 #include "third_party/googletest/src/include/gtest/gtest.h"
 
 #include "./vpx_config.h"
 #include "test/ivf_video_source.h"
+#include "test/util.h"
+#include "vpx/vp8cx.h"
 #include "vpx/vp8dx.h"
 #include "vpx/vpx_decoder.h"
+#include "vpx/vpx_encoder.h"
 
 namespace {
 
@@ -193,6 +198,105 @@ TEST(DecodeAPI, Vp9PeekStreamInfoTruncated) {
     TestPeekInfo(profile1_data, data_sz, 11);
   }
 }
+
+#if CONFIG_VP9_ENCODER
+// Decodes a stream with two tile columns single-threaded, tile-threaded and
+// row-threaded, and checks the decode statistics of each frame.
+TEST(DecodeAPI, Vp9DecodeStats) {
+  const int width = 704;
+  const int height = 288;
+  const int kFrames = 3;
+  std::vector<std::vector<uint8_t> > frames;
+  std::vector<uint8_t> img_buf(width * height * 3 / 2);
+  vpx_codec_ctx_t enc;
+  vpx_codec_enc_cfg_t cfg;
+  vpx_image_t img;
+
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_config_default(vpx_codec_vp9_cx(), &cfg, 0));
+  cfg.g_w = width;
+  cfg.g_h = height;
+  cfg.g_lag_in_frames = 0;
+  cfg.rc_end_usage = VPX_CBR;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_init(&enc, vpx_codec_vp9_cx(), &cfg, 0));
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP8E_SET_CPUUSED, 8));
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP9E_SET_TILE_COLUMNS, 1));
+  vpx_img_wrap(&img, VPX_IMG_FMT_I420, width, height, 1, &img_buf[0]);
+  for (int frame = 0; frame < kFrames; ++frame) {
+    const vpx_codec_cx_pkt_t *pkt;
+    vpx_codec_iter_t iter = nullptr;
+    fill_moving_gradient(&img, frame);
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_encode(&enc, &img, frame, 1, 0, VPX_DL_REALTIME));
+    while ((pkt = vpx_codec_get_cx_data(&enc, &iter)) != nullptr) {
+      const uint8_t *const buf = static_cast<uint8_t *>(pkt->data.frame.buf);
+      if (pkt->kind == VPX_CODEC_CX_FRAME_PKT) {
+        frames.push_back(std::vector<uint8_t>(buf, buf + pkt->data.frame.sz));
+      }
+    }
+  }
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+  ASSERT_EQ(static_cast<size_t>(kFrames), frames.size());
+
+  for (int threads = 1; threads <= 2; ++threads) {
+    for (int row_mt = 0; row_mt <= 1; ++row_mt) {
+      vpx_codec_dec_cfg_t dec_cfg = vpx_codec_dec_cfg_t();
+      vpx_codec_ctx_t dec;
+      vpx_decode_stats_t stats;
+      dec_cfg.threads = threads;
+      ASSERT_EQ(VPX_CODEC_OK,
+                vpx_codec_dec_init(&dec, vpx_codec_vp9_dx(), &dec_cfg, 0));
+      ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9D_SET_ROW_MT, row_mt));
+      EXPECT_EQ(VPX_CODEC_INVALID_PARAM,
+                vpx_codec_control(&dec, VP9D_GET_DECODE_STATS,
+                                  static_cast<vpx_decode_stats_t *>(nullptr)));
+      // Nothing has been decoded yet.
+      EXPECT_EQ(VPX_CODEC_ERROR,
+                vpx_codec_control(&dec, VP9D_GET_DECODE_STATS, &stats));
+
+      int64_t parse_us = 0;
+      int64_t recon_us = 0;
+      int64_t lf_us = 0;
+      int64_t worker_us[VPX_DECODE_STATS_MAX_WORKERS] = { 0 };
+      for (int frame = 0; frame < kFrames; ++frame) {
+        vpx_codec_iter_t iter = nullptr;
+        ASSERT_EQ(VPX_CODEC_OK,
+                  vpx_codec_decode(&dec, &frames[frame][0],
+                                   static_cast<unsigned int>(
+                                       frames[frame].size()),
+                                   nullptr, 0));
+        ASSERT_NE(vpx_codec_get_frame(&dec, &iter), nullptr);
+        ASSERT_EQ(VPX_CODEC_OK,
+                  vpx_codec_control(&dec, VP9D_GET_DECODE_STATS, &stats));
+        EXPECT_EQ(threads == 1 ? 0 : threads, stats.num_workers);
+        parse_us += stats.parse.wall_us;
+        recon_us += stats.recon.wall_us;
+        lf_us += stats.lf.wall_us;
+        for (int i = 0; i < VPX_DECODE_STATS_MAX_WORKERS; ++i) {
+          worker_us[i] += stats.worker_busy_us[i] + stats.worker_idle_us[i];
+        }
+      }
+      // Only the row based decoder separates reconstruction from parsing.
+      if (row_mt) {
+        EXPECT_GT(recon_us, 0);
+      } else {
+        EXPECT_EQ(0, recon_us);
+        EXPECT_GT(parse_us, 0);
+      }
+      EXPECT_GT(lf_us, 0);
+      for (int i = 0; i < VPX_DECODE_STATS_MAX_WORKERS; ++i) {
+        if (i < stats.num_workers) {
+          EXPECT_GT(worker_us[i], 0) << "worker " << i;
+        } else {
+          EXPECT_EQ(0, worker_us[i]) << "worker " << i;
+        }
+      }
+      EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+    }
+  }
+}
+#endif  // CONFIG_VP9_ENCODER
 #endif  // CONFIG_VP9_DECODER
 
 TEST(DecodeAPI, HighBitDepthCapability) {
@@ -88,6 +88,15 @@ class Decoder {
                                                 user_priv);
   }
 
+  // Passes the external frame buffer layout information to libvpx.
+  vpx_codec_err_t SetFrameBufferLayoutFunctions(
+      vpx_get_frame_buffer_layout_cb_fn_t cb_get,
+      vpx_release_frame_buffer_cb_fn_t cb_release, void *user_priv) {
+    InitOnce();
+    return vpx_codec_set_frame_buffer_layout_functions(&decoder_, cb_get,
+                                                       cb_release, user_priv);
+  }
+
   const char *GetDecoderName() const {
     return vpx_codec_iface_name(CodecInterface());
   }
@@ -11,6 +11,7 @@
 #include "third_party/googletest/src/include/gtest/gtest.h"
 
 #include "./vpx_config.h"
+#include "test/util.h"
 #include "vpx/vp8cx.h"
 #include "vpx/vpx_encoder.h"
 
@@ -196,4 +197,66 @@ TEST(EncodeAPI, MultiResEncode) {
   }
 }
 
+#if CONFIG_VP9_ENCODER
+TEST(EncodeAPI, Vp9FrameStats) {
+  const int width = 352;
+  const int height = 288;
+  vpx_codec_ctx_t enc;
+  vpx_codec_enc_cfg_t cfg;
+  vpx_image_t img;
+  vpx_frame_stats_t stats;
+  int64_t pick_mode_us = 0;
+  int64_t pack_us = 0;
+  uint8_t *img_buf = reinterpret_cast<uint8_t *>(
+      calloc(width * height * 3 / 2, sizeof(*img_buf)));
+
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_config_default(vpx_codec_vp9_cx(), &cfg, 0));
+  cfg.g_w = width;
+  cfg.g_h = height;
+  cfg.g_lag_in_frames = 0;
+  cfg.rc_end_usage = VPX_CBR;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_init(&enc, vpx_codec_vp9_cx(), &cfg, 0));
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP8E_SET_CPUUSED, 8));
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc, VP9E_SET_DISABLE_LOOPFILTER, 2));
+  EXPECT_EQ(VPX_CODEC_INVALID_PARAM,
+            vpx_codec_control(&enc, VP9E_GET_FRAME_STATS,
+                              static_cast<vpx_frame_stats_t *>(NULL)));
+  // The first call turns on the block level timers.
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc, VP9E_GET_FRAME_STATS, &stats));
+
+  vpx_img_wrap(&img, VPX_IMG_FMT_I420, width, height, 1, img_buf);
+  for (int frame = 0; frame < 5; ++frame) {
+    fill_moving_gradient(&img, frame);
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_encode(&enc, &img, frame, 1, 0, VPX_DL_REALTIME));
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&enc, VP9E_GET_FRAME_STATS, &stats));
+    EXPECT_EQ(0, stats.lf_search_us);
+    pick_mode_us += stats.pick_mode_us;
+    pack_us += stats.pack_us;
+  }
+  EXPECT_GT(pick_mode_us, 0);
+  EXPECT_GT(pack_us, 0);
+
+  // A flush codes no frame, so the times of the last frame are cleared.
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_encode(&enc, NULL, 0, 1, 0, VPX_DL_REALTIME));
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc, VP9E_GET_FRAME_STATS, &stats));
+  EXPECT_EQ(0, stats.scale_us);
+  EXPECT_EQ(0, stats.pick_mode_us);
+  EXPECT_EQ(0, stats.transform_us);
+  EXPECT_EQ(0, stats.pack_us);
+  EXPECT_EQ(0, stats.lf_search_us);
+  EXPECT_EQ(0, stats.lf_us);
+
+  free(img_buf);
+  vpx_codec_destroy(&enc);
+}
+#endif  // CONFIG_VP9_ENCODER
+
 }  // namespace
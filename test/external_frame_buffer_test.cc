@@ -78,6 +78,40 @@ class ExternalFrameBufferList {
     return 0;
   }
 
+  // Gets a free frame buffer like GetFreeFrameBuffer() and lays out the
+  // planes with |extra_stride| bytes of padding at the end of each row. The
+  // planes are stored V, U, Y to check that the decoder follows the offsets.
+  // Returns < 0 on an error.
+  int GetFreeFrameBufferLayout(vpx_codec_frame_buffer_layout_t *layout,
+                               int extra_stride,
+                               vpx_codec_frame_buffer_t *fb) {
+    EXPECT_NE(layout, nullptr);
+    const int bps = layout->bytes_per_sample;
+    const int uv_w = layout->width >> layout->subsampling_x;
+    const int uv_h = layout->height >> layout->subsampling_y;
+    const int uv_border_w = layout->border >> layout->subsampling_x;
+    const int uv_border_h = layout->border >> layout->subsampling_y;
+    const int y_stride =
+        AlignUp16((layout->width + 2 * layout->border) * bps) + extra_stride;
+    const int uv_stride = AlignUp16((uv_w + 2 * uv_border_w) * bps);
+    const size_t y_size =
+        static_cast<size_t>(layout->height + 2 * layout->border) * y_stride;
+    const size_t uv_size =
+        static_cast<size_t>(uv_h + 2 * uv_border_h) * uv_stride;
+    // Leave room to align the start of the buffer.
+    const int ret = GetFreeFrameBuffer(15 + y_size + 2 * uv_size, fb);
+    if (ret < 0) return ret;
+
+    const size_t start = (16 - (reinterpret_cast<size_t>(fb->data) & 15)) & 15;
+    layout->stride[0] = y_stride;
+    layout->stride[1] = layout->stride[2] = uv_stride;
+    layout->offset[2] = start + uv_border_h * uv_stride + uv_border_w * bps;
+    layout->offset[1] = layout->offset[2] + uv_size;
+    layout->offset[0] = start + 2 * uv_size + layout->border * y_stride +
+                        layout->border * bps;
+    return 0;
+  }
+
   // Test function that will not allocate any data for the frame buffer.
   // Returns < 0 on an error.
   int GetZeroFrameBuffer(size_t min_size, vpx_codec_frame_buffer_t *fb) {
@@ -129,6 +163,8 @@ class ExternalFrameBufferList {
   int num_used_buffers() const { return num_used_buffers_; }
 
  private:
+  static int AlignUp16(int value) { return (value + 15) & ~15; }
+
   // Returns the index of the first free frame buffer. Returns |num_buffers_|
   // if there are no free frame buffers.
   int FindFreeBufferIndex() {
@@ -191,6 +227,27 @@ int get_vp9_one_less_byte_frame_buffer(void *user_priv, size_t min_size,
   return fb_list->GetFreeFrameBuffer(min_size - 1, fb);
 }
 
+// Callback used by libvpx to request the application to return a frame
+// buffer and the layout of its planes.
+int get_vp9_frame_buffer_layout(void *user_priv,
+                                vpx_codec_frame_buffer_layout_t *layout,
+                                vpx_codec_frame_buffer_t *fb) {
+  ExternalFrameBufferList *const fb_list =
+      reinterpret_cast<ExternalFrameBufferList *>(user_priv);
+  return fb_list->GetFreeFrameBufferLayout(layout, 64, fb);
+}
+
+// Callback will make the luma stride smaller than the plane and its border.
+int get_vp9_narrow_frame_buffer_layout(void *user_priv,
+                                       vpx_codec_frame_buffer_layout_t *layout,
+                                       vpx_codec_frame_buffer_t *fb) {
+  ExternalFrameBufferList *const fb_list =
+      reinterpret_cast<ExternalFrameBufferList *>(user_priv);
+  const int ret = fb_list->GetFreeFrameBufferLayout(layout, 0, fb);
+  layout->stride[0] -= 16;
+  return ret;
+}
+
 // Callback will not release the external frame buffer.
 int do_not_release_vp9_frame_buffer(void *user_priv,
                                     vpx_codec_frame_buffer_t *fb) {
@@ -208,7 +265,7 @@ class ExternalFrameBufferMD5Test
  protected:
   ExternalFrameBufferMD5Test()
       : DecoderTest(GET_PARAM(::libvpx_test::kCodecFactoryParam)),
-        md5_file_(nullptr), num_buffers_(0) {}
+        md5_file_(nullptr), num_buffers_(0), use_layout_(false) {}
 
   virtual ~ExternalFrameBufferMD5Test() {
     if (md5_file_ != nullptr) fclose(md5_file_);
@@ -220,9 +277,15 @@ class ExternalFrameBufferMD5Test
     if (num_buffers_ > 0 && video.frame_number() == 0) {
       // Have libvpx use frame buffers we create.
       ASSERT_TRUE(fb_list_.CreateBufferList(num_buffers_));
-      ASSERT_EQ(VPX_CODEC_OK,
-                decoder->SetFrameBufferFunctions(GetVP9FrameBuffer,
-                                                 ReleaseVP9FrameBuffer, this));
+      if (use_layout_) {
+        ASSERT_EQ(VPX_CODEC_OK, decoder->SetFrameBufferLayoutFunctions(
+                                    GetVP9FrameBufferLayout,
+                                    ReleaseVP9FrameBuffer, this));
+      } else {
+        ASSERT_EQ(VPX_CODEC_OK, decoder->SetFrameBufferFunctions(
+                                    GetVP9FrameBuffer, ReleaseVP9FrameBuffer,
+                                    this));
+      }
     }
   }
 
@@ -261,6 +324,16 @@ class ExternalFrameBufferMD5Test
     return md5Test->fb_list_.GetFreeFrameBuffer(min_size, fb);
   }
 
+  // Callback to get a free external frame buffer and the layout of its
+  // planes. Return value < 0 is an error.
+  static int GetVP9FrameBufferLayout(void *user_priv,
+                                     vpx_codec_frame_buffer_layout_t *layout,
+                                     vpx_codec_frame_buffer_t *fb) {
+    ExternalFrameBufferMD5Test *const md5Test =
+        reinterpret_cast<ExternalFrameBufferMD5Test *>(user_priv);
+    return md5Test->fb_list_.GetFreeFrameBufferLayout(layout, 32, fb);
+  }
+
   // Callback to release an external frame buffer. Return value < 0 is an
   // error.
   static int ReleaseVP9FrameBuffer(void *user_priv,
@@ -272,10 +345,49 @@ class ExternalFrameBufferMD5Test
 
   void set_num_buffers(int num_buffers) { num_buffers_ = num_buffers; }
   int num_buffers() const { return num_buffers_; }
+  void set_use_layout(bool use_layout) { use_layout_ = use_layout; }
+
+  void RunTestVector(const std::string &filename) {
+    // Number of buffers equals #VP9_MAXIMUM_REF_BUFFERS +
+    // #VPX_MAXIMUM_WORK_BUFFERS + four jitter buffers.
+    const int jitter_buffers = 4;
+    const int num_buffers =
+        VP9_MAXIMUM_REF_BUFFERS + VPX_MAXIMUM_WORK_BUFFERS + jitter_buffers;
+    set_num_buffers(num_buffers);
+
+#if CONFIG_VP8_DECODER
+    // Tell compiler we are not using kVP8TestVectors.
+    (void)libvpx_test::kVP8TestVectors;
+#endif
+
+    // Open compressed video file.
+    std::unique_ptr<libvpx_test::CompressedVideoSource> video;
+    if (filename.substr(filename.length() - 3, 3) == "ivf") {
+      video.reset(new libvpx_test::IVFVideoSource(filename));
+    } else {
+#if CONFIG_WEBM_IO
+      video.reset(new libvpx_test::WebMVideoSource(filename));
+#else
+      fprintf(stderr, "WebM IO is disabled, skipping test vector %s\n",
+              filename.c_str());
+      return;
+#endif
+    }
+    ASSERT_NE(video.get(), nullptr);
+    video->Init();
+
+    // Construct md5 file name.
+    const std::string md5_filename = filename + ".md5";
+    OpenMD5File(md5_filename);
+
+    // Decode frame, and check the md5 matching.
+    ASSERT_NO_FATAL_FAILURE(RunLoop(video.get()));
+  }
 
  private:
   FILE *md5_file_;
   int num_buffers_;
+  bool use_layout_;
   ExternalFrameBufferList fb_list_;
 };
 
@@ -319,6 +431,19 @@ class ExternalFrameBufferTest : public ::testing::Test {
     return decoder_->SetFrameBufferFunctions(cb_get, cb_release, &fb_list_);
   }
 
+  // Passes the external frame buffer layout information to libvpx.
+  vpx_codec_err_t SetFrameBufferLayoutFunctions(
+      int num_buffers, vpx_get_frame_buffer_layout_cb_fn_t cb_get,
+      vpx_release_frame_buffer_cb_fn_t cb_release) {
+    if (num_buffers > 0) {
+      num_buffers_ = num_buffers;
+      EXPECT_TRUE(fb_list_.CreateBufferList(num_buffers_));
+    }
+
+    return decoder_->SetFrameBufferLayoutFunctions(cb_get, cb_release,
+                                                   &fb_list_);
+  }
+
   vpx_codec_err_t DecodeOneFrame() {
     const vpx_codec_err_t res =
         decoder_->DecodeFrame(video_->cxdata(), video_->frame_size());
@@ -379,42 +504,14 @@ class ExternalFrameBufferNonRefTest : public ExternalFrameBufferTest {
 // If md5 checksums match the correct md5 data, then the test is passed.
 // Otherwise, the test failed.
 TEST_P(ExternalFrameBufferMD5Test, ExtFBMD5Match) {
-  const std::string filename = GET_PARAM(kVideoNameParam);
-
-  // Number of buffers equals #VP9_MAXIMUM_REF_BUFFERS +
-  // #VPX_MAXIMUM_WORK_BUFFERS + four jitter buffers.
-  const int jitter_buffers = 4;
-  const int num_buffers =
-      VP9_MAXIMUM_REF_BUFFERS + VPX_MAXIMUM_WORK_BUFFERS + jitter_buffers;
-  set_num_buffers(num_buffers);
-
-#if CONFIG_VP8_DECODER
-  // Tell compiler we are not using kVP8TestVectors.
-  (void)libvpx_test::kVP8TestVectors;
-#endif
-
-  // Open compressed video file.
-  std::unique_ptr<libvpx_test::CompressedVideoSource> video;
-  if (filename.substr(filename.length() - 3, 3) == "ivf") {
-    video.reset(new libvpx_test::IVFVideoSource(filename));
-  } else {
-#if CONFIG_WEBM_IO
-    video.reset(new libvpx_test::WebMVideoSource(filename));
-#else
-    fprintf(stderr, "WebM IO is disabled, skipping test vector %s\n",
-            filename.c_str());
-    return;
-#endif
-  }
-  ASSERT_NE(video.get(), nullptr);
-  video->Init();
-
-  // Construct md5 file name.
-  const std::string md5_filename = filename + ".md5";
-  OpenMD5File(md5_filename);
+  RunTestVector(GET_PARAM(kVideoNameParam));
+}
 
-  // Decode frame, and check the md5 matching.
-  ASSERT_NO_FATAL_FAILURE(RunLoop(video.get()));
+// Same as ExtFBMD5Match, but the application decides the plane layout of the
+// frame buffers.
+TEST_P(ExternalFrameBufferMD5Test, ExtFBLayoutMD5Match) {
+  set_use_layout(true);
+  RunTestVector(GET_PARAM(kVideoNameParam));
 }
 
 #if CONFIG_WEBM_IO
@@ -501,6 +598,40 @@ TEST_F(ExternalFrameBufferTest, SetAfterDecode) {
                                     release_vp9_frame_buffer));
 }
 
+TEST_F(ExternalFrameBufferTest, LayoutMinFrameBuffers) {
+  const int num_buffers = VP9_MAXIMUM_REF_BUFFERS + VPX_MAXIMUM_WORK_BUFFERS;
+  ASSERT_EQ(VPX_CODEC_OK,
+            SetFrameBufferLayoutFunctions(num_buffers,
+                                          get_vp9_frame_buffer_layout,
+                                          release_vp9_frame_buffer));
+  ASSERT_EQ(VPX_CODEC_OK, DecodeRemainingFrames());
+}
+
+TEST_F(ExternalFrameBufferTest, LayoutStrideTooSmall) {
+  const int num_buffers = VP9_MAXIMUM_REF_BUFFERS + VPX_MAXIMUM_WORK_BUFFERS;
+  ASSERT_EQ(VPX_CODEC_OK,
+            SetFrameBufferLayoutFunctions(num_buffers,
+                                          get_vp9_narrow_frame_buffer_layout,
+                                          release_vp9_frame_buffer));
+  ASSERT_EQ(VPX_CODEC_MEM_ERROR, DecodeOneFrame());
+}
+
+TEST_F(ExternalFrameBufferTest, LayoutNullGetFunction) {
+  const int num_buffers = VP9_MAXIMUM_REF_BUFFERS + VPX_MAXIMUM_WORK_BUFFERS;
+  ASSERT_EQ(VPX_CODEC_INVALID_PARAM,
+            SetFrameBufferLayoutFunctions(num_buffers, nullptr,
+                                          release_vp9_frame_buffer));
+}
+
+TEST_F(ExternalFrameBufferTest, LayoutSetAfterDecode) {
+  const int num_buffers = VP9_MAXIMUM_REF_BUFFERS + VPX_MAXIMUM_WORK_BUFFERS;
+  ASSERT_EQ(VPX_CODEC_OK, DecodeOneFrame());
+  ASSERT_EQ(VPX_CODEC_ERROR,
+            SetFrameBufferLayoutFunctions(num_buffers,
+                                          get_vp9_frame_buffer_layout,
+                                          release_vp9_frame_buffer));
+}
+
 TEST_F(ExternalFrameBufferNonRefTest, ReleaseNonRefFrameBuffer) {
   const int num_buffers = VP9_MAXIMUM_REF_BUFFERS + VPX_MAXIMUM_WORK_BUFFERS;
   ASSERT_EQ(VPX_CODEC_OK,
@@ -0,0 +1,278 @@
+/*
+ *  Copyright (c) 2021 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string>
+#include <vector>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./vpx_config.h"
+#include "test/acm_random.h"
+#include "test/md5_helper.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vp8dx.h"
+#include "vpx/vpx_decoder.h"
+#include "vpx/vpx_encoder.h"
+#include "vpx/vpx_thread_pool.h"
+
+namespace {
+
+// Large enough for two tile columns.
+const int kWidth = 640;
+const int kHeight = 480;
+const int kNumFrames = 6;
+
+typedef std::vector<std::string> Stream;
+
+// Fills img with a moving gradient plus some noise.
+void FillFrame(vpx_image_t *img, int frame, libvpx_test::ACMRandom *rnd) {
+  for (int plane = 0; plane < 3; ++plane) {
+    const int w = plane ? (img->d_w + 1) >> 1 : img->d_w;
+    const int h = plane ? (img->d_h + 1) >> 1 : img->d_h;
+    for (int r = 0; r < h; ++r) {
+      uint8_t *const row = img->planes[plane] + r * img->stride[plane];
+      for (int c = 0; c < w; ++c) {
+        row[c] = static_cast<uint8_t>((r + c + 3 * frame) * (plane + 1) +
+                                      (rnd->Rand8() & 15));
+      }
+    }
+  }
+}
+
+class PoolEncoder {
+ public:
+  PoolEncoder(vpx_codec_iface_t *iface, int threads, int row_mt,
+              vpx_codec_thread_pool_t *pool)
+      : rnd_(libvpx_test::ACMRandom::DeterministicSeed()), frame_(0) {
+    vpx_codec_enc_cfg_t cfg;
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_enc_config_default(iface, &cfg, 0));
+    cfg.g_w = kWidth;
+    cfg.g_h = kHeight;
+    cfg.g_threads = threads;
+    cfg.g_lag_in_frames = 0;
+    cfg.rc_target_bitrate = 500;
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_enc_init(&enc_, iface, &cfg, 0));
+    if (iface == &vpx_codec_vp8_cx_algo) {
+      EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc_, VP8E_SET_CPUUSED, 8));
+      EXPECT_EQ(VPX_CODEC_OK,
+                vpx_codec_control(&enc_, VP8E_SET_TOKEN_PARTITIONS,
+                                  VP8_EIGHT_TOKENPARTITION));
+    } else {
+      EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc_, VP8E_SET_CPUUSED, 6));
+      EXPECT_EQ(VPX_CODEC_OK,
+                vpx_codec_control(&enc_, VP9E_SET_TILE_COLUMNS, 2));
+      EXPECT_EQ(VPX_CODEC_OK,
+                vpx_codec_control(&enc_, VP9E_SET_ROW_MT, row_mt));
+      if (pool != nullptr) {
+        EXPECT_EQ(VPX_CODEC_OK,
+                  vpx_codec_control(&enc_, VP9E_SET_THREAD_POOL, pool));
+      }
+    }
+    EXPECT_NE(vpx_img_alloc(&img_, VPX_IMG_FMT_I420, kWidth, kHeight, 1),
+              nullptr);
+  }
+
+  ~PoolEncoder() {
+    vpx_img_free(&img_);
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc_));
+  }
+
+  void EncodeFrame() {
+    FillFrame(&img_, frame_, &rnd_);
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_encode(&enc_, &img_, frame_, 1, 0,
+                                             VPX_DL_GOOD_QUALITY));
+    ++frame_;
+    vpx_codec_iter_t iter = nullptr;
+    const vpx_codec_cx_pkt_t *pkt;
+    while ((pkt = vpx_codec_get_cx_data(&enc_, &iter)) != nullptr) {
+      if (pkt->kind != VPX_CODEC_CX_FRAME_PKT) continue;
+      stream_.push_back(
+          std::string(static_cast<const char *>(pkt->data.frame.buf),
+                      pkt->data.frame.sz));
+    }
+  }
+
+  vpx_codec_ctx_t *ctx() { return &enc_; }
+  const Stream &stream() const { return stream_; }
+
+ private:
+  vpx_codec_ctx_t enc_;
+  vpx_image_t img_;
+  libvpx_test::ACMRandom rnd_;
+  int frame_;
+  Stream stream_;
+};
+
+class PoolDecoder {
+ public:
+  PoolDecoder(vpx_codec_iface_t *iface, int threads, int row_mt,
+              int frame_parallel, vpx_codec_thread_pool_t *pool) {
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    cfg.threads = threads;
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&dec_, iface, &cfg, 0));
+    if (iface != &vpx_codec_vp8_dx_algo) {
+      EXPECT_EQ(VPX_CODEC_OK,
+                vpx_codec_control(&dec_, VP9D_SET_ROW_MT, row_mt));
+      EXPECT_EQ(VPX_CODEC_OK,
+                vpx_codec_control(&dec_, VP9D_SET_LOOP_FILTER_OPT, row_mt));
+      EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec_, VP9D_SET_FRAME_PARALLEL,
+                                                frame_parallel));
+    }
+    if (pool != nullptr) {
+      EXPECT_EQ(VPX_CODEC_OK,
+                vpx_codec_control(&dec_, VPXD_SET_THREAD_POOL, pool));
+    }
+  }
+
+  ~PoolDecoder() { EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec_)); }
+
+  void DecodeFrame(const std::string &frame) {
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_decode(&dec_,
+                               reinterpret_cast<const uint8_t *>(frame.data()),
+                               static_cast<unsigned int>(frame.size()),
+                               nullptr, 0));
+    GetFrames();
+  }
+
+  void Flush() {
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_decode(&dec_, nullptr, 0, nullptr, 0));
+    GetFrames();
+  }
+
+  vpx_codec_ctx_t *ctx() { return &dec_; }
+  std::string md5() { return md5_.Get(); }
+
+ private:
+  void GetFrames() {
+    vpx_codec_iter_t iter = nullptr;
+    const vpx_image_t *img;
+    while ((img = vpx_codec_get_frame(&dec_, &iter)) != nullptr) {
+      md5_.Add(img);
+    }
+  }
+
+  vpx_codec_ctx_t dec_;
+  libvpx_test::MD5 md5_;
+};
+
+Stream Encode(vpx_codec_iface_t *iface, int threads, int row_mt) {
+  PoolEncoder encoder(iface, threads, row_mt, nullptr);
+  for (int i = 0; i < kNumFrames; ++i) encoder.EncodeFrame();
+  return encoder.stream();
+}
+
+std::string Decode(vpx_codec_iface_t *iface, const Stream &stream) {
+  PoolDecoder decoder(iface, 1, 0, 0, nullptr);
+  for (size_t i = 0; i < stream.size(); ++i) decoder.DecodeFrame(stream[i]);
+  decoder.Flush();
+  return decoder.md5();
+}
+
+TEST(ThreadPoolTest, CreateDestroy) {
+  EXPECT_EQ(vpx_codec_thread_pool_create(0), nullptr);
+  EXPECT_EQ(vpx_codec_thread_pool_create(VPX_THREAD_POOL_MAX_THREADS + 1),
+            nullptr);
+  vpx_codec_thread_pool_destroy(nullptr);
+
+  vpx_codec_thread_pool_t *const pool = vpx_codec_thread_pool_create(2);
+  ASSERT_NE(pool, nullptr);
+  vpx_codec_thread_pool_destroy(pool);
+}
+
+// Encoders sharing a pool, including one thread smaller than the number of
+// workers of each encoder, must produce the same streams as without it.
+TEST(ThreadPoolTest, VP9EncodersSharePool) {
+  for (int row_mt = 0; row_mt <= 1; ++row_mt) {
+    const Stream expected = Encode(&vpx_codec_vp9_cx_algo, 4, row_mt);
+    for (int pool_threads = 1; pool_threads <= 3; pool_threads += 2) {
+      SCOPED_TRACE(testing::Message() << "row_mt = " << row_mt
+                                      << " pool threads = " << pool_threads);
+      vpx_codec_thread_pool_t *const pool =
+          vpx_codec_thread_pool_create(pool_threads);
+      ASSERT_NE(pool, nullptr);
+      {
+        PoolEncoder encoder0(&vpx_codec_vp9_cx_algo, 4, row_mt, pool);
+        PoolEncoder encoder1(&vpx_codec_vp9_cx_algo, 4, row_mt, pool);
+        for (int i = 0; i < kNumFrames; ++i) {
+          ASSERT_NO_FATAL_FAILURE(encoder0.EncodeFrame());
+          ASSERT_NO_FATAL_FAILURE(encoder1.EncodeFrame());
+        }
+        // The pool can not be changed once the workers are started.
+        EXPECT_EQ(VPX_CODEC_ERROR,
+                  vpx_codec_control(encoder0.ctx(), VP9E_SET_THREAD_POOL,
+                                    pool));
+        EXPECT_TRUE(expected == encoder0.stream());
+        EXPECT_TRUE(expected == encoder1.stream());
+      }
+      vpx_codec_thread_pool_destroy(pool);
+    }
+  }
+}
+
+#if CONFIG_VP9_DECODER
+TEST(ThreadPoolTest, VP9DecodersSharePool) {
+  const Stream stream = Encode(&vpx_codec_vp9_cx_algo, 4, 0);
+  const std::string expected = Decode(&vpx_codec_vp9_dx_algo, stream);
+  for (int pool_threads = 1; pool_threads <= 3; pool_threads += 2) {
+    SCOPED_TRACE(testing::Message() << "pool threads = " << pool_threads);
+    vpx_codec_thread_pool_t *const pool =
+        vpx_codec_thread_pool_create(pool_threads);
+    ASSERT_NE(pool, nullptr);
+    {
+      PoolDecoder decoder0(&vpx_codec_vp9_dx_algo, 4, 0, 0, pool);
+      PoolDecoder decoder1(&vpx_codec_vp9_dx_algo, 4, 1, 0, pool);
+      PoolDecoder decoder2(&vpx_codec_vp9_dx_algo, 4, 0, 1, pool);
+      for (size_t i = 0; i < stream.size(); ++i) {
+        ASSERT_NO_FATAL_FAILURE(decoder0.DecodeFrame(stream[i]));
+        ASSERT_NO_FATAL_FAILURE(decoder1.DecodeFrame(stream[i]));
+        ASSERT_NO_FATAL_FAILURE(decoder2.DecodeFrame(stream[i]));
+      }
+      ASSERT_NO_FATAL_FAILURE(decoder0.Flush());
+      ASSERT_NO_FATAL_FAILURE(decoder1.Flush());
+      ASSERT_NO_FATAL_FAILURE(decoder2.Flush());
+      EXPECT_EQ(VPX_CODEC_ERROR,
+                vpx_codec_control(decoder0.ctx(), VPXD_SET_THREAD_POOL, pool));
+      EXPECT_EQ(expected, decoder0.md5());
+      EXPECT_EQ(expected, decoder1.md5());
+      EXPECT_EQ(expected, decoder2.md5());
+    }
+    vpx_codec_thread_pool_destroy(pool);
+  }
+}
+#endif  // CONFIG_VP9_DECODER
+
+#if CONFIG_VP8_ENCODER && CONFIG_VP8_DECODER
+TEST(ThreadPoolTest, VP8DecodersSharePool) {
+  const Stream stream = Encode(&vpx_codec_vp8_cx_algo, 1, 0);
+  const std::string expected = Decode(&vpx_codec_vp8_dx_algo, stream);
+  for (int pool_threads = 1; pool_threads <= 3; pool_threads += 2) {
+    SCOPED_TRACE(testing::Message() << "pool threads = " << pool_threads);
+    vpx_codec_thread_pool_t *const pool =
+        vpx_codec_thread_pool_create(pool_threads);
+    ASSERT_NE(pool, nullptr);
+    {
+      PoolDecoder decoder0(&vpx_codec_vp8_dx_algo, 4, 0, 0, pool);
+      PoolDecoder decoder1(&vpx_codec_vp8_dx_algo, 8, 0, 0, pool);
+      for (size_t i = 0; i < stream.size(); ++i) {
+        ASSERT_NO_FATAL_FAILURE(decoder0.DecodeFrame(stream[i]));
+        ASSERT_NO_FATAL_FAILURE(decoder1.DecodeFrame(stream[i]));
+      }
+      EXPECT_EQ(VPX_CODEC_ERROR,
+                vpx_codec_control(decoder0.ctx(), VPXD_SET_THREAD_POOL, pool));
+      EXPECT_EQ(expected, decoder0.md5());
+      EXPECT_EQ(expected, decoder1.md5());
+    }
+    vpx_codec_thread_pool_destroy(pool);
+  }
+}
+#endif  // CONFIG_VP8_ENCODER && CONFIG_VP8_DECODER
+
+}  // namespace
@@ -45,4 +45,16 @@ inline double compute_psnr(const vpx_image_t *img1, const vpx_image_t *img2) {
   return psnr;
 }
 
+// Fills the luma plane of |img| with a gradient that moves with |frame|, so
+// that every frame has residual to code.
+inline void fill_moving_gradient(vpx_image_t *img, int frame) {
+  for (unsigned int r = 0; r < img->d_h; ++r) {
+    unsigned char *const row =
+        img->planes[VPX_PLANE_Y] + r * img->stride[VPX_PLANE_Y];
+    for (unsigned int c = 0; c < img->d_w; ++c) {
+      row[c] = static_cast<unsigned char>(c * 3 + r + frame);
+    }
+  }
+}
+
 #endif  // VPX_TEST_UTIL_H_
@@ -1402,6 +1402,170 @@ INSTANTIATE_TEST_SUITE_P(
         SubpelAvgVarianceParams(6, 6, &vpx_sub_pixel_avg_variance64x64_avx2, 0),
         SubpelAvgVarianceParams(5, 5, &vpx_sub_pixel_avg_variance32x32_avx2,
                                 0)));
+
+#if CONFIG_VP9_HIGHBITDEPTH
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, VpxHBDVarianceTest,
+    ::testing::Values(
+        VarianceParams(6, 6, &vpx_highbd_12_variance64x64_avx2, 12),
+        VarianceParams(6, 5, &vpx_highbd_12_variance64x32_avx2, 12),
+        VarianceParams(5, 6, &vpx_highbd_12_variance32x64_avx2, 12),
+        VarianceParams(5, 5, &vpx_highbd_12_variance32x32_avx2, 12),
+        VarianceParams(5, 4, &vpx_highbd_12_variance32x16_avx2, 12),
+        VarianceParams(4, 5, &vpx_highbd_12_variance16x32_avx2, 12),
+        VarianceParams(4, 4, &vpx_highbd_12_variance16x16_avx2, 12),
+        VarianceParams(4, 3, &vpx_highbd_12_variance16x8_avx2, 12),
+        VarianceParams(3, 4, &vpx_highbd_12_variance8x16_avx2, 12),
+        VarianceParams(3, 3, &vpx_highbd_12_variance8x8_avx2, 12),
+        VarianceParams(6, 6, &vpx_highbd_10_variance64x64_avx2, 10),
+        VarianceParams(6, 5, &vpx_highbd_10_variance64x32_avx2, 10),
+        VarianceParams(5, 6, &vpx_highbd_10_variance32x64_avx2, 10),
+        VarianceParams(5, 5, &vpx_highbd_10_variance32x32_avx2, 10),
+        VarianceParams(5, 4, &vpx_highbd_10_variance32x16_avx2, 10),
+        VarianceParams(4, 5, &vpx_highbd_10_variance16x32_avx2, 10),
+        VarianceParams(4, 4, &vpx_highbd_10_variance16x16_avx2, 10),
+        VarianceParams(4, 3, &vpx_highbd_10_variance16x8_avx2, 10),
+        VarianceParams(3, 4, &vpx_highbd_10_variance8x16_avx2, 10),
+        VarianceParams(3, 3, &vpx_highbd_10_variance8x8_avx2, 10),
+        VarianceParams(6, 6, &vpx_highbd_8_variance64x64_avx2, 8),
+        VarianceParams(6, 5, &vpx_highbd_8_variance64x32_avx2, 8),
+        VarianceParams(5, 6, &vpx_highbd_8_variance32x64_avx2, 8),
+        VarianceParams(5, 5, &vpx_highbd_8_variance32x32_avx2, 8),
+        VarianceParams(5, 4, &vpx_highbd_8_variance32x16_avx2, 8),
+        VarianceParams(4, 5, &vpx_highbd_8_variance16x32_avx2, 8),
+        VarianceParams(4, 4, &vpx_highbd_8_variance16x16_avx2, 8),
+        VarianceParams(4, 3, &vpx_highbd_8_variance16x8_avx2, 8),
+        VarianceParams(3, 4, &vpx_highbd_8_variance8x16_avx2, 8),
+        VarianceParams(3, 3, &vpx_highbd_8_variance8x8_avx2, 8)));
+
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, VpxHBDSubpelVarianceTest,
+    ::testing::Values(
+        SubpelVarianceParams(6, 6, &vpx_highbd_12_sub_pixel_variance64x64_avx2,
+                             12),
+        SubpelVarianceParams(6, 5, &vpx_highbd_12_sub_pixel_variance64x32_avx2,
+                             12),
+        SubpelVarianceParams(5, 6, &vpx_highbd_12_sub_pixel_variance32x64_avx2,
+                             12),
+        SubpelVarianceParams(5, 5, &vpx_highbd_12_sub_pixel_variance32x32_avx2,
+                             12),
+        SubpelVarianceParams(5, 4, &vpx_highbd_12_sub_pixel_variance32x16_avx2,
+                             12),
+        SubpelVarianceParams(4, 5, &vpx_highbd_12_sub_pixel_variance16x32_avx2,
+                             12),
+        SubpelVarianceParams(4, 4, &vpx_highbd_12_sub_pixel_variance16x16_avx2,
+                             12),
+        SubpelVarianceParams(4, 3, &vpx_highbd_12_sub_pixel_variance16x8_avx2,
+                             12),
+        SubpelVarianceParams(6, 6, &vpx_highbd_10_sub_pixel_variance64x64_avx2,
+                             10),
+        SubpelVarianceParams(6, 5, &vpx_highbd_10_sub_pixel_variance64x32_avx2,
+                             10),
+        SubpelVarianceParams(5, 6, &vpx_highbd_10_sub_pixel_variance32x64_avx2,
+                             10),
+        SubpelVarianceParams(5, 5, &vpx_highbd_10_sub_pixel_variance32x32_avx2,
+                             10),
+        SubpelVarianceParams(5, 4, &vpx_highbd_10_sub_pixel_variance32x16_avx2,
+                             10),
+        SubpelVarianceParams(4, 5, &vpx_highbd_10_sub_pixel_variance16x32_avx2,
+                             10),
+        SubpelVarianceParams(4, 4, &vpx_highbd_10_sub_pixel_variance16x16_avx2,
+                             10),
+        SubpelVarianceParams(4, 3, &vpx_highbd_10_sub_pixel_variance16x8_avx2,
+                             10),
+        SubpelVarianceParams(6, 6, &vpx_highbd_8_sub_pixel_variance64x64_avx2,
+                             8),
+        SubpelVarianceParams(6, 5, &vpx_highbd_8_sub_pixel_variance64x32_avx2,
+                             8),
+        SubpelVarianceParams(5, 6, &vpx_highbd_8_sub_pixel_variance32x64_avx2,
+                             8),
+        SubpelVarianceParams(5, 5, &vpx_highbd_8_sub_pixel_variance32x32_avx2,
+                             8),
+        SubpelVarianceParams(5, 4, &vpx_highbd_8_sub_pixel_variance32x16_avx2,
+                             8),
+        SubpelVarianceParams(4, 5, &vpx_highbd_8_sub_pixel_variance16x32_avx2,
+                             8),
+        SubpelVarianceParams(4, 4, &vpx_highbd_8_sub_pixel_variance16x16_avx2,
+                             8),
+        SubpelVarianceParams(4, 3, &vpx_highbd_8_sub_pixel_variance16x8_avx2,
+                             8)));
+
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, VpxHBDSubpelAvgVarianceTest,
+    ::testing::Values(
+        SubpelAvgVarianceParams(6, 6,
+                                &vpx_highbd_12_sub_pixel_avg_variance64x64_avx2,
+                                12),
+        SubpelAvgVarianceParams(6, 5,
+                                &vpx_highbd_12_sub_pixel_avg_variance64x32_avx2,
+                                12),
+        SubpelAvgVarianceParams(5, 6,
+                                &vpx_highbd_12_sub_pixel_avg_variance32x64_avx2,
+                                12),
+        SubpelAvgVarianceParams(5, 5,
+                                &vpx_highbd_12_sub_pixel_avg_variance32x32_avx2,
+                                12),
+        SubpelAvgVarianceParams(5, 4,
+                                &vpx_highbd_12_sub_pixel_avg_variance32x16_avx2,
+                                12),
+        SubpelAvgVarianceParams(4, 5,
+                                &vpx_highbd_12_sub_pixel_avg_variance16x32_avx2,
+                                12),
+        SubpelAvgVarianceParams(4, 4,
+                                &vpx_highbd_12_sub_pixel_avg_variance16x16_avx2,
+                                12),
+        SubpelAvgVarianceParams(4, 3,
+                                &vpx_highbd_12_sub_pixel_avg_variance16x8_avx2,
+                                12),
+        SubpelAvgVarianceParams(6, 6,
+                                &vpx_highbd_10_sub_pixel_avg_variance64x64_avx2,
+                                10),
+        SubpelAvgVarianceParams(6, 5,
+                                &vpx_highbd_10_sub_pixel_avg_variance64x32_avx2,
+                                10),
+        SubpelAvgVarianceParams(5, 6,
+                                &vpx_highbd_10_sub_pixel_avg_variance32x64_avx2,
+                                10),
+        SubpelAvgVarianceParams(5, 5,
+                                &vpx_highbd_10_sub_pixel_avg_variance32x32_avx2,
+                                10),
+        SubpelAvgVarianceParams(5, 4,
+                                &vpx_highbd_10_sub_pixel_avg_variance32x16_avx2,
+                                10),
+        SubpelAvgVarianceParams(4, 5,
+                                &vpx_highbd_10_sub_pixel_avg_variance16x32_avx2,
+                                10),
+        SubpelAvgVarianceParams(4, 4,
+                                &vpx_highbd_10_sub_pixel_avg_variance16x16_avx2,
+                                10),
+        SubpelAvgVarianceParams(4, 3,
+                                &vpx_highbd_10_sub_pixel_avg_variance16x8_avx2,
+                                10),
+        SubpelAvgVarianceParams(6, 6,
+                                &vpx_highbd_8_sub_pixel_avg_variance64x64_avx2,
+                                8),
+        SubpelAvgVarianceParams(6, 5,
+                                &vpx_highbd_8_sub_pixel_avg_variance64x32_avx2,
+                                8),
+        SubpelAvgVarianceParams(5, 6,
+                                &vpx_highbd_8_sub_pixel_avg_variance32x64_avx2,
+                                8),
+        SubpelAvgVarianceParams(5, 5,
+                                &vpx_highbd_8_sub_pixel_avg_variance32x32_avx2,
+                                8),
+        SubpelAvgVarianceParams(5, 4,
+                                &vpx_highbd_8_sub_pixel_avg_variance32x16_avx2,
+                                8),
+        SubpelAvgVarianceParams(4, 5,
+                                &vpx_highbd_8_sub_pixel_avg_variance16x32_avx2,
+                                8),
+        SubpelAvgVarianceParams(4, 4,
+                                &vpx_highbd_8_sub_pixel_avg_variance16x16_avx2,
+                                8),
+        SubpelAvgVarianceParams(4, 3,
+                                &vpx_highbd_8_sub_pixel_avg_variance16x8_avx2,
+                                8)));
+#endif  // CONFIG_VP9_HIGHBITDEPTH
 #endif  // HAVE_AVX2
 
 #if HAVE_NEON
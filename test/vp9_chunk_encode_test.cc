@@ -0,0 +1,256 @@
+/*
+ *  Copyright (c) 2021 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./vpx_config.h"
+#include "test/acm_random.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vpx_encoder.h"
+#if CONFIG_VP9_DECODER
+#include "vpx/vp8dx.h"
+#include "vpx/vpx_decoder.h"
+#endif
+
+namespace {
+
+using libvpx_test::ACMRandom;
+
+const int kWidth = 176;
+const int kHeight = 144;
+const int kFrames = 40;
+const int kFrameSize = kWidth * kHeight * 3 / 2;
+
+typedef std::vector<uint8_t> Packet;
+
+class ChunkEncodeTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    // Two scenes of panning texture, so the clip has a scene cut as well as
+    // the key frames placed by kf_max_dist.
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+    std::vector<uint8_t> texture(2 * kWidth * 2 * kHeight);
+    for (size_t i = 0; i < texture.size(); ++i) texture[i] = rnd.Rand8();
+
+    frames_.resize(kFrames * kFrameSize);
+    for (int f = 0; f < kFrames; ++f) {
+      uint8_t *const frame = &frames_[f * kFrameSize];
+      const int scene = f < kFrames / 2;
+      for (int r = 0; r < kHeight; ++r) {
+        for (int c = 0; c < kWidth; ++c) {
+          frame[r * kWidth + c] =
+              texture[(r + scene * kHeight) * 2 * kWidth + c + f];
+        }
+      }
+      memset(frame + kWidth * kHeight, 64 + 128 * scene,
+             kWidth * kHeight / 2);
+    }
+
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_enc_config_default(&vpx_codec_vp9_cx_algo, &cfg_, 0));
+    cfg_.g_w = kWidth;
+    cfg_.g_h = kHeight;
+    cfg_.g_timebase.num = 1;
+    cfg_.g_timebase.den = 30;
+    cfg_.g_lag_in_frames = 16;
+    cfg_.rc_end_usage = VPX_VBR;
+    cfg_.rc_target_bitrate = 300;
+    cfg_.kf_max_dist = 16;
+
+    cfg_.g_pass = VPX_RC_FIRST_PASS;
+    std::vector<Packet> packets;
+    Encode(cfg_, 0, kFrames, &packets);
+    cfg_.g_pass = VPX_RC_LAST_PASS;
+    cfg_.rc_twopass_stats_in.buf = &stats_[0];
+    cfg_.rc_twopass_stats_in.sz = stats_.size();
+  }
+
+  // Encodes frames [start, start + count) of the clip as one chunk.
+  void Encode(const vpx_codec_enc_cfg_t &cfg, int start, int count,
+              std::vector<Packet> *packets) {
+    vpx_codec_ctx_t enc;
+    vpx_image_t img;
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_enc_init(&enc, &vpx_codec_vp9_cx_algo, &cfg, 0));
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP8E_SET_CPUUSED, 4));
+    // A window of the stats starts on the first frame to encode, so only the
+    // full stats need the chunk start frame.
+    if (cfg.g_pass == VPX_RC_LAST_PASS &&
+        cfg.rc_twopass_stats_in.sz == stats_.size()) {
+      ASSERT_EQ(VPX_CODEC_OK,
+                vpx_codec_control(&enc, VP9E_SET_CHUNK_START_FRAME,
+                                  static_cast<unsigned int>(start)));
+    }
+
+    for (int f = start; f <= start + count; ++f) {
+      vpx_image_t *frame = nullptr;
+      if (f < start + count) {
+        frame = vpx_img_wrap(&img, VPX_IMG_FMT_I420, kWidth, kHeight, 1,
+                             &frames_[f * kFrameSize]);
+      }
+      // Keep flushing until the encoder has no more frames to give.
+      for (;;) {
+        const vpx_codec_cx_pkt_t *pkt;
+        vpx_codec_iter_t iter = nullptr;
+        bool got_data = false;
+        ASSERT_EQ(VPX_CODEC_OK, vpx_codec_encode(&enc, frame, f, 1, 0,
+                                                 VPX_DL_GOOD_QUALITY));
+        while ((pkt = vpx_codec_get_cx_data(&enc, &iter)) != nullptr) {
+          const uint8_t *const buf =
+              static_cast<const uint8_t *>(pkt->data.frame.buf);
+          if (pkt->kind == VPX_CODEC_STATS_PKT) {
+            const uint8_t *const stats =
+                static_cast<const uint8_t *>(pkt->data.twopass_stats.buf);
+            stats_.insert(stats_.end(), stats,
+                          stats + pkt->data.twopass_stats.sz);
+          } else if (pkt->kind == VPX_CODEC_CX_FRAME_PKT) {
+            packets->push_back(Packet(buf, buf + pkt->data.frame.sz));
+            if (packets->size() == 1) {
+              EXPECT_TRUE(pkt->data.frame.flags & VPX_FRAME_IS_KEY);
+            }
+          }
+          got_data = true;
+        }
+        if (frame != nullptr || !got_data) break;
+      }
+    }
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+  }
+
+  std::vector<int> KeyFrameGroupStarts() {
+    vpx_codec_ctx_t enc;
+    std::vector<int> key_frame_map(kFrames, -1);
+    std::vector<int> starts;
+    unsigned int map_size = 0;
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_enc_init(&enc, &vpx_codec_vp9_cx_algo, &cfg_, 0));
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP9E_GET_KEY_FRAME_MAP_SIZE,
+                                              &map_size));
+    EXPECT_EQ(static_cast<unsigned int>(kFrames), map_size);
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP9E_GET_KEY_FRAME_MAP,
+                                              &key_frame_map[0]));
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+    for (int i = 0; i < kFrames; ++i) {
+      EXPECT_GE(key_frame_map[i], 0);
+      if (key_frame_map[i] > 0) starts.push_back(i);
+    }
+    return starts;
+  }
+
+#if CONFIG_VP9_DECODER
+  // Decodes packets as one stream and returns the number of frames decoded.
+  static int Decode(const std::vector<Packet> &packets) {
+    vpx_codec_ctx_t dec;
+    int decoded_frames = 0;
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_dec_init(&dec, &vpx_codec_vp9_dx_algo, nullptr, 0));
+    for (size_t i = 0; i < packets.size(); ++i) {
+      vpx_codec_iter_t iter = nullptr;
+      EXPECT_EQ(VPX_CODEC_OK,
+                vpx_codec_decode(&dec, &packets[i][0],
+                                 static_cast<unsigned int>(packets[i].size()),
+                                 nullptr, 0));
+      while (vpx_codec_get_frame(&dec, &iter) != nullptr) ++decoded_frames;
+    }
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+    return decoded_frames;
+  }
+#endif
+
+  static size_t TotalSize(const std::vector<Packet> &packets) {
+    size_t size = 0;
+    for (size_t i = 0; i < packets.size(); ++i) size += packets[i].size();
+    return size;
+  }
+
+  std::vector<uint8_t> frames_;
+  std::vector<uint8_t> stats_;
+  vpx_codec_enc_cfg_t cfg_;
+};
+
+// Each key frame group is encoded on its own, and the chunks add up to a
+// stream of about the size of the one from a single second pass.
+TEST_F(ChunkEncodeTest, ChunksAddUpToTarget) {
+  std::vector<int> starts = KeyFrameGroupStarts();
+  ASSERT_GE(starts.size(), 2u);
+  starts.push_back(kFrames);
+
+  std::vector<Packet> full;
+  Encode(cfg_, 0, kFrames, &full);
+
+  std::vector<Packet> chunked;
+  for (size_t i = 0; i + 1 < starts.size(); ++i) {
+    std::vector<Packet> chunk;
+    Encode(cfg_, starts[i], starts[i + 1] - starts[i], &chunk);
+    chunked.insert(chunked.end(), chunk.begin(), chunk.end());
+  }
+  ASSERT_EQ(full.size(), chunked.size());
+
+  const double full_size = static_cast<double>(TotalSize(full));
+  EXPECT_NEAR(full_size, static_cast<double>(TotalSize(chunked)),
+              0.1 * full_size);
+
+#if CONFIG_VP9_DECODER
+  // The chunks concatenate into one stream.
+  EXPECT_EQ(kFrames, Decode(chunked));
+#endif
+}
+
+// A last pass encoder given a window of the stats, the stats of one key frame
+// group followed by the totals of the whole first pass, codes that group as a
+// stream of its own.
+TEST_F(ChunkEncodeTest, WindowedStats) {
+  const std::vector<int> starts = KeyFrameGroupStarts();
+  ASSERT_GE(starts.size(), 2u);
+  const int start = starts[1];
+  const int end = starts.size() > 2 ? starts[2] : kFrames;
+  ASSERT_EQ(0u, stats_.size() % (kFrames + 1));
+  const size_t packet_sz = stats_.size() / (kFrames + 1);
+
+  std::vector<uint8_t> window(stats_.begin() + start * packet_sz,
+                              stats_.begin() + end * packet_sz);
+  window.insert(window.end(), stats_.end() - packet_sz, stats_.end());
+  vpx_codec_enc_cfg_t cfg = cfg_;
+  cfg.rc_twopass_stats_in.buf = &window[0];
+  cfg.rc_twopass_stats_in.sz = window.size();
+
+  std::vector<Packet> packets;
+  Encode(cfg, start, end - start, &packets);
+  EXPECT_EQ(static_cast<size_t>(end - start), packets.size());
+#if CONFIG_VP9_DECODER
+  EXPECT_EQ(end - start, Decode(packets));
+#endif
+}
+
+TEST_F(ChunkEncodeTest, InvalidUse) {
+  vpx_codec_ctx_t enc;
+  vpx_codec_enc_cfg_t cfg = cfg_;
+
+  // The start frame must be within the stats.
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_init(&enc, &vpx_codec_vp9_cx_algo, &cfg, 0));
+  EXPECT_EQ(VPX_CODEC_INVALID_PARAM,
+            vpx_codec_control(&enc, VP9E_SET_CHUNK_START_FRAME,
+                              static_cast<unsigned int>(kFrames)));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+
+  // One pass encodes have no stats to take a chunk of.
+  cfg.g_pass = VPX_RC_ONE_PASS;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_init(&enc, &vpx_codec_vp9_cx_algo, &cfg, 0));
+  EXPECT_EQ(VPX_CODEC_ERROR,
+            vpx_codec_control(&enc, VP9E_SET_CHUNK_START_FRAME, 1u));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+}
+
+}  // namespace
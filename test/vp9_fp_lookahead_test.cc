@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2021 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string>
+#include <vector>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+
+namespace {
+
+const unsigned int kFrames = 30;
+const unsigned int kLagInFrames = 10;
+
+class FirstPassLookaheadTest
+    : public ::libvpx_test::EncoderTest,
+      public ::libvpx_test::CodecTestWithParam<int> {
+ protected:
+  FirstPassLookaheadTest()
+      : EncoderTest(GET_PARAM(0)), cpu_used_(GET_PARAM(1)),
+        fp_lookahead_(0) {}
+  virtual ~FirstPassLookaheadTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    cfg_.rc_end_usage = VPX_VBR;
+    cfg_.rc_target_bitrate = 500;
+    cfg_.g_lag_in_frames = kLagInFrames;
+  }
+
+  virtual void BeginPassHook(unsigned int /*pass*/) { md5_.clear(); }
+
+  virtual void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                                  ::libvpx_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, cpu_used_);
+      encoder->Control(VP8E_SET_ENABLEAUTOALTREF, 1);
+      if (fp_lookahead_ > 0)
+        encoder->Control(VP9E_SET_FIRST_PASS_LOOKAHEAD, fp_lookahead_);
+    }
+  }
+
+  virtual void FramePktHook(const vpx_codec_cx_pkt_t *pkt) {
+    ::libvpx_test::MD5 md5_res;
+    md5_res.Add(static_cast<const uint8_t *>(pkt->data.frame.buf),
+                pkt->data.frame.sz);
+    md5_.push_back(md5_res.Get());
+  }
+
+  int cpu_used_;
+  unsigned int fp_lookahead_;
+  std::vector<std::string> md5_;
+};
+
+// When the first pass lookahead covers the whole clip, the second pass sees
+// the stats of every frame before coding the first one, as it does in a
+// two-pass encode.
+TEST_P(FirstPassLookaheadTest, MatchesTwoPass) {
+  ::libvpx_test::RandomVideoSource video;
+  video.SetSize(176, 144);
+  video.set_limit(kFrames);
+
+  SetMode(::libvpx_test::kTwoPassGood);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  const std::vector<std::string> two_pass_md5 = md5_;
+
+  SetMode(::libvpx_test::kOnePassGood);
+  fp_lookahead_ = kFrames;
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  ASSERT_EQ(two_pass_md5, md5_);
+}
+
+// A short lookahead codes every frame, and the recon matches the decoder.
+TEST_P(FirstPassLookaheadTest, ShortLookahead) {
+  ::libvpx_test::RandomVideoSource video;
+  video.SetSize(176, 144);
+  video.set_limit(kFrames);
+
+  SetMode(::libvpx_test::kOnePassGood);
+  fp_lookahead_ = 1;
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  ASSERT_GE(md5_.size(), kFrames);
+}
+
+VP9_INSTANTIATE_TEST_SUITE(FirstPassLookaheadTest, ::testing::Values(2, 4));
+}  // namespace
@@ -0,0 +1,147 @@
+/*
+ *  Copyright (c) 2021 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cstdlib>
+#include <vector>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./vpx_config.h"
+#include "test/acm_random.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vpx_encoder.h"
+
+// After vp8cx.h, the internal headers change how VPX_CTRL_USE_TYPE expands.
+#include "vp9/vp9_cx_iface.h"
+
+namespace {
+
+using libvpx_test::ACMRandom;
+
+const int kWidth = 176;
+const int kHeight = 144;
+const int kFrames = 20;
+const int kFrameSize = kWidth * kHeight * 3 / 2;
+
+class RecodeEstimateTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    // Texture that pans and gets noisier, so the rate control misses the
+    // target of some frames and recodes them.
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+    std::vector<uint8_t> texture(2 * kWidth * kHeight);
+    for (size_t i = 0; i < texture.size(); ++i) texture[i] = rnd.Rand8();
+
+    frames_.resize(kFrames * kFrameSize);
+    for (int f = 0; f < kFrames; ++f) {
+      uint8_t *const frame = &frames_[f * kFrameSize];
+      for (int r = 0; r < kHeight; ++r) {
+        for (int c = 0; c < kWidth; ++c) {
+          const int smooth = (r + c + 2 * f) & 0xff;
+          const int detail = texture[r * 2 * kWidth + c + 4 * f];
+          frame[r * kWidth + c] = static_cast<uint8_t>(
+              smooth + (detail - smooth) * f / (kFrames - 1));
+        }
+      }
+      for (int i = kWidth * kHeight; i < kFrameSize; ++i) {
+        frame[i] = static_cast<uint8_t>(128 + (rnd.Rand8() >> 4));
+      }
+    }
+
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_enc_config_default(&vpx_codec_vp9_cx_algo, &cfg_, 0));
+    cfg_.g_w = kWidth;
+    cfg_.g_h = kHeight;
+    cfg_.g_timebase.num = 1;
+    cfg_.g_timebase.den = 30;
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = VPX_VBR;
+    cfg_.rc_target_bitrate = 300;
+    cfg_.kf_max_dist = 10;
+
+    std::vector<int> packed_bits;
+    std::vector<int> estimated_bits;
+    cfg_.g_pass = VPX_RC_FIRST_PASS;
+    Encode(false, &packed_bits, &estimated_bits);
+    cfg_.g_pass = VPX_RC_LAST_PASS;
+    cfg_.rc_twopass_stats_in.buf = &stats_[0];
+    cfg_.rc_twopass_stats_in.sz = stats_.size();
+  }
+
+  // Encodes the clip and returns the packed and predicted size, in bits, of
+  // the frames whose final encode was a recode with a predicted size.
+  void Encode(bool estimate_recode_size, std::vector<int> *packed_bits,
+              std::vector<int> *estimated_bits) {
+    vpx_codec_ctx_t enc;
+    vpx_image_t img;
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_enc_init(&enc, &vpx_codec_vp9_cx_algo, &cfg_, 0));
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP8E_SET_CPUUSED, 2));
+    // There is no codec control for the prediction, it is set directly.
+    VP9_COMP *const cpi = vp9_get_encoder(&enc);
+    if (estimate_recode_size) cpi->rc.estimate_recode_size = 1;
+
+    // The last call flushes the encoder, which gives the first pass stats
+    // their total.
+    for (int f = 0; f <= kFrames; ++f) {
+      const vpx_codec_cx_pkt_t *pkt;
+      vpx_codec_iter_t iter = nullptr;
+      vpx_image_t *frame = nullptr;
+      if (f < kFrames) {
+        frame = vpx_img_wrap(&img, VPX_IMG_FMT_I420, kWidth, kHeight, 1,
+                             &frames_[f * kFrameSize]);
+      }
+      ASSERT_EQ(VPX_CODEC_OK,
+                vpx_codec_encode(&enc, frame, f, 1, 0, VPX_DL_GOOD_QUALITY));
+      const int estimate = cpi->rc.last_recode_size_estimate;
+      if (!estimate_recode_size) {
+        EXPECT_EQ(-1, estimate);
+      }
+      while ((pkt = vpx_codec_get_cx_data(&enc, &iter)) != nullptr) {
+        if (pkt->kind == VPX_CODEC_STATS_PKT) {
+          const uint8_t *const stats =
+              static_cast<const uint8_t *>(pkt->data.twopass_stats.buf);
+          stats_.insert(stats_.end(), stats,
+                        stats + pkt->data.twopass_stats.sz);
+        } else if (pkt->kind == VPX_CODEC_CX_FRAME_PKT && estimate >= 0) {
+          packed_bits->push_back(static_cast<int>(pkt->data.frame.sz * 8));
+          estimated_bits->push_back(estimate);
+        }
+      }
+    }
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+  }
+
+  vpx_codec_enc_cfg_t cfg_;
+  std::vector<uint8_t> frames_;
+  std::vector<uint8_t> stats_;
+};
+
+TEST_F(RecodeEstimateTest, EstimateIsCloseToPackedSize) {
+  std::vector<int> packed_bits;
+  std::vector<int> estimated_bits;
+  Encode(true, &packed_bits, &estimated_bits);
+  ASSERT_GT(packed_bits.size(), 0u);
+  for (size_t i = 0; i < packed_bits.size(); ++i) {
+    // Only the size of the tiles is predicted, the headers are written.
+    EXPECT_LE(std::abs(estimated_bits[i] - packed_bits[i]), packed_bits[i] / 8)
+        << "recoded frame " << i << " packed " << packed_bits[i]
+        << " estimated " << estimated_bits[i];
+  }
+}
+
+TEST_F(RecodeEstimateTest, NoEstimateByDefault) {
+  std::vector<int> packed_bits;
+  std::vector<int> estimated_bits;
+  Encode(false, &packed_bits, &estimated_bits);
+  EXPECT_EQ(0u, packed_bits.size());
+}
+
+}  // namespace
@@ -207,9 +207,140 @@ INSTANTIATE_TEST_SUITE_P(SSSE3, ScaleTest,
                          ::testing::Values(vp9_scale_and_extend_frame_ssse3));
 #endif  // HAVE_SSSE3
 
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(AVX2, ScaleTest,
+                         ::testing::Values(vp9_scale_and_extend_frame_avx2));
+#endif  // HAVE_AVX2
+
 #if HAVE_NEON
 INSTANTIATE_TEST_SUITE_P(NEON, ScaleTest,
                          ::testing::Values(vp9_scale_and_extend_frame_neon));
 #endif  // HAVE_NEON
 
+#if CONFIG_VP9_HIGHBITDEPTH
+typedef void (*HighbdScaleFrameFunc)(const YV12_BUFFER_CONFIG *src,
+                                     YV12_BUFFER_CONFIG *dst, int bd,
+                                     INTERP_FILTER filter_type,
+                                     int phase_scaler);
+
+class HighbdScaleTest : public ::testing::TestWithParam<HighbdScaleFrameFunc> {
+ public:
+  virtual ~HighbdScaleTest() {}
+
+ protected:
+  virtual void SetUp() {
+    scale_fn_ = GetParam();
+    memset(&img_, 0, sizeof(img_));
+    memset(&ref_img_, 0, sizeof(ref_img_));
+    memset(&dst_img_, 0, sizeof(dst_img_));
+  }
+
+  virtual void TearDown() {
+    vpx_free_frame_buffer(&img_);
+    vpx_free_frame_buffer(&ref_img_);
+    vpx_free_frame_buffer(&dst_img_);
+    libvpx_test::ClearSystemState();
+  }
+
+  // Fills the whole of img, borders included, with random pixels of bit depth
+  // bd, using the same sequence for every image.
+  static void FillImage(YV12_BUFFER_CONFIG *const img, int bd) {
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+    uint16_t *const buf = reinterpret_cast<uint16_t *>(img->buffer_alloc);
+    for (size_t i = 0; i < img->frame_size / sizeof(*buf); ++i) {
+      buf[i] = rnd.Rand16() & ((1 << bd) - 1);
+    }
+  }
+
+  void ResetImages(int src_width, int src_height, int dst_width,
+                   int dst_height, int bd) {
+    vpx_free_frame_buffer(&img_);
+    vpx_free_frame_buffer(&ref_img_);
+    vpx_free_frame_buffer(&dst_img_);
+    ASSERT_EQ(0, vpx_alloc_frame_buffer(&img_, src_width, src_height, 1, 1, 1,
+                                        VP9_ENC_BORDER_IN_PIXELS, 0));
+    ASSERT_EQ(0, vpx_alloc_frame_buffer(&ref_img_, dst_width, dst_height, 1, 1,
+                                        1, VP9_ENC_BORDER_IN_PIXELS, 0));
+    ASSERT_EQ(0, vpx_alloc_frame_buffer(&dst_img_, dst_width, dst_height, 1, 1,
+                                        1, VP9_ENC_BORDER_IN_PIXELS, 0));
+    FillImage(&img_, bd);
+    FillImage(&ref_img_, bd);
+    FillImage(&dst_img_, bd);
+  }
+
+  void RunTest(INTERP_FILTER filter_type) {
+    // Source and destination sizes, including ratios such as 5:3 and 3:5
+    // which have no specialized version.
+    static const int kSizes[][4] = {
+      { 64, 64, 32, 32 },   { 64, 64, 48, 48 },   { 40, 30, 24, 18 },
+      { 50, 30, 30, 18 },   { 30, 18, 50, 30 },   { 66, 34, 44, 22 },
+      { 34, 18, 68, 36 },   { 20, 12, 80, 48 },   { 134, 68, 90, 46 },
+      { 352, 288, 212, 174 }
+    };
+    for (int bd = 8; bd <= 12; bd += 2) {
+      for (int phase_scaler = 0; phase_scaler < 16; phase_scaler += 5) {
+        for (size_t i = 0; i < sizeof(kSizes) / sizeof(kSizes[0]); ++i) {
+          ASSERT_NO_FATAL_FAILURE(ResetImages(kSizes[i][0], kSizes[i][1],
+                                              kSizes[i][2], kSizes[i][3], bd));
+          vp9_highbd_scale_and_extend_frame_c(&img_, &ref_img_, bd, filter_type,
+                                              phase_scaler);
+          ASM_REGISTER_STATE_CHECK(
+              scale_fn_(&img_, &dst_img_, bd, filter_type, phase_scaler));
+          ASSERT_EQ(0, memcmp(dst_img_.buffer_alloc, ref_img_.buffer_alloc,
+                              ref_img_.frame_size))
+              << "bd = " << bd << ", phase_scaler = " << phase_scaler
+              << ", " << kSizes[i][0] << "x" << kSizes[i][1] << " to "
+              << kSizes[i][2] << "x" << kSizes[i][3];
+        }
+      }
+    }
+  }
+
+  HighbdScaleFrameFunc scale_fn_;
+  YV12_BUFFER_CONFIG img_;
+  YV12_BUFFER_CONFIG ref_img_;
+  YV12_BUFFER_CONFIG dst_img_;
+};
+
+TEST_P(HighbdScaleTest, ScaleFrame_EightTap) { RunTest(EIGHTTAP); }
+TEST_P(HighbdScaleTest, ScaleFrame_EightTapSmooth) {
+  RunTest(EIGHTTAP_SMOOTH);
+}
+TEST_P(HighbdScaleTest, ScaleFrame_EightTapSharp) { RunTest(EIGHTTAP_SHARP); }
+TEST_P(HighbdScaleTest, ScaleFrame_Bilinear) { RunTest(BILINEAR); }
+
+TEST_P(HighbdScaleTest, DISABLED_Speed) {
+  static const int kCountSpeedTestBlock = 100;
+  static const int kSizes[][2] = { { 1280, 720 }, { 854, 480 }, { 768, 432 },
+                                   { 640, 360 } };
+  const int bd = 10;
+  for (size_t i = 0; i < sizeof(kSizes) / sizeof(kSizes[0]); ++i) {
+    ASSERT_NO_FATAL_FAILURE(
+        ResetImages(1920, 1080, kSizes[i][0], kSizes[i][1], bd));
+
+    vpx_usec_timer timer;
+    vpx_usec_timer_start(&timer);
+    for (int n = 0; n < kCountSpeedTestBlock; ++n) {
+      scale_fn_(&img_, &dst_img_, bd, EIGHTTAP, 0);
+    }
+    libvpx_test::ClearSystemState();
+    vpx_usec_timer_mark(&timer);
+    const int elapsed_time =
+        static_cast<int>(vpx_usec_timer_elapsed(&timer) / 1000);
+    printf("bd = %d, 1920x1080 to %4dx%4d, scale time: %5d ms\n", bd,
+           kSizes[i][0], kSizes[i][1], elapsed_time);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    C, HighbdScaleTest,
+    ::testing::Values(vp9_highbd_scale_and_extend_frame_c));
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, HighbdScaleTest,
+    ::testing::Values(vp9_highbd_scale_and_extend_frame_avx2));
+#endif  // HAVE_AVX2
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
 }  // namespace libvpx_test
@@ -124,6 +124,12 @@ vpxenc() {
     "$@" ${devnull}
 }
 
+# Echoes the frame count stored in the header of the IVF file $1.
+ivf_frame_count() {
+  od -A n -t u1 -j 24 -N 4 "$1" \
+    | awk '{ print $1 + 256 * ($2 + 256 * ($3 + 256 * $4)) }'
+}
+
 vpxenc_vp8_ivf() {
   if [ "$(vpxenc_can_encode_vp8)" = "yes" ]; then
     local output="${VPX_TEST_OUTPUT_DIR}/vp8.ivf"
@@ -348,6 +354,76 @@ vpxenc_vp9_webm_2pass() {
   fi
 }
 
+vpxenc_vp9_ivf_2pass_kf_groups() {
+  if [ "$(vpxenc_can_encode_vp9)" = "yes" ]; then
+    local first_output="${VPX_TEST_OUTPUT_DIR}/vp9_kf_groups_first.ivf"
+    local rest_output="${VPX_TEST_OUTPUT_DIR}/vp9_kf_groups_rest.ivf"
+    local fpf="${VPX_TEST_OUTPUT_DIR}/vp9_kf_groups.fpf"
+    vpxenc $(yuv_input_hantro_collage) \
+      --codec=vp9 \
+      --limit="${TEST_FRAMES}" \
+      --kf-max-dist=4 \
+      --ivf \
+      --output="${first_output}" \
+      --passes=2 \
+      --pass=1 \
+      --fpf="${fpf}" \
+      --fpf-indexed || return 1
+
+    # Code the first key frame group, then all the others.
+    vpxenc $(yuv_input_hantro_collage) \
+      --codec=vp9 \
+      --limit="${TEST_FRAMES}" \
+      --kf-max-dist=4 \
+      --ivf \
+      --output="${first_output}" \
+      --passes=2 \
+      --pass=2 \
+      --fpf="${fpf}" \
+      --kf-groups=0:1 || return 1
+
+    vpxenc $(yuv_input_hantro_collage) \
+      --codec=vp9 \
+      --limit="${TEST_FRAMES}" \
+      --kf-max-dist=4 \
+      --ivf \
+      --output="${rest_output}" \
+      --passes=2 \
+      --pass=2 \
+      --fpf="${fpf}" \
+      --kf-groups=1 || return 1
+
+    local first_frames="$(ivf_frame_count "${first_output}")"
+    local rest_frames="$(ivf_frame_count "${rest_output}")"
+    if [ "${first_frames}" -eq 0 ] || [ "${rest_frames}" -eq 0 ] || \
+       [ $((first_frames + rest_frames)) -ne "${TEST_FRAMES}" ]; then
+      elog "Key frame groups coded ${first_frames} + ${rest_frames} frames," \
+           "expected ${TEST_FRAMES} in all."
+      return 1
+    fi
+  fi
+}
+
+vpxenc_vp9_ivf_2pass_chunks() {
+  if [ "$(vpxenc_can_encode_vp9)" = "yes" ]; then
+    local output="${VPX_TEST_OUTPUT_DIR}/vp9_chunks.ivf"
+    vpxenc $(yuv_input_hantro_collage) \
+      --codec=vp9 \
+      --limit="${TEST_FRAMES}" \
+      --kf-max-dist=4 \
+      --ivf \
+      --output="${output}" \
+      --passes=2 \
+      --chunks=2 || return 1
+
+    local frames="$(ivf_frame_count "${output}")"
+    if [ "${frames}" -ne "${TEST_FRAMES}" ]; then
+      elog "Chunks coded ${frames} frames, expected ${TEST_FRAMES}."
+      return 1
+    fi
+  fi
+}
+
 vpxenc_vp9_ivf_lossless() {
   if [ "$(vpxenc_can_encode_vp9)" = "yes" ]; then
     local output="${VPX_TEST_OUTPUT_DIR}/vp9_lossless.ivf"
@@ -483,7 +559,9 @@ if [ "$(vpx_config_option_enabled CONFIG_REALTIME_ONLY)" != "yes" ]; then
   vpxenc_tests="$vpxenc_tests
                 vpxenc_vp8_webm_2pass
                 vpxenc_vp8_webm_lag10_frames20
-                vpxenc_vp9_webm_2pass"
+                vpxenc_vp9_webm_2pass
+                vpxenc_vp9_ivf_2pass_kf_groups
+                vpxenc_vp9_ivf_2pass_chunks"
 fi
 
 run_tests vpxenc_verify_environment "${vpxenc_tests}"
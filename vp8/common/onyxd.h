@@ -20,6 +20,7 @@ extern "C" {
 #include "vpx_ports/mem.h"
 #include "vpx/vpx_codec.h"
 #include "vpx/vp8.h"
+#include "vpx/vpx_thread_pool.h"
 
 struct VP8D_COMP;
 struct VP8Common;
@@ -31,6 +32,7 @@ typedef struct {
   int postprocess;
   int max_threads;
   int error_concealment;
+  vpx_codec_thread_pool_t *thread_pool;
 } VP8D_CONFIG;
 
 typedef enum { VP8D_OK = 0 } VP8D_SETTING;
@@ -440,6 +440,7 @@ int vp8_create_decoder_instances(struct frame_buffers *fb, VP8D_CONFIG *oxcf) {
 
   fb->pbi[0]->common.error.setjmp = 1;
   fb->pbi[0]->max_threads = oxcf->max_threads;
+  fb->pbi[0]->thread_pool = oxcf->thread_pool;
   vp8_decoder_create_threads(fb->pbi[0]);
   fb->pbi[0]->common.error.setjmp = 0;
 #endif
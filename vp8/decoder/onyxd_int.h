@@ -16,6 +16,8 @@
 #include "treereader.h"
 #include "vp8/common/onyxc_int.h"
 #include "vp8/common/threading.h"
+#include "vpx_util/vpx_thread.h"
+#include "vpx_util/vpx_job_counter.h"
 
 #if CONFIG_ERROR_CONCEALMENT
 #include "ec_types.h"
@@ -25,12 +27,6 @@
 extern "C" {
 #endif
 
-typedef struct {
-  int ithread;
-  void *ptr1;
-  void *ptr2;
-} DECODETHREAD_DATA;
-
 typedef struct {
   MACROBLOCKD mbd;
 } MB_ROW_DEC;
@@ -89,11 +85,11 @@ typedef struct VP8D_COMP {
   unsigned char **mt_vleft_col; /* mb_rows x 8 */
 
   MB_ROW_DEC *mb_row_di;
-  DECODETHREAD_DATA *de_thread_data;
-
-  pthread_t *h_decoding_thread;
-  sem_t *h_event_start_decoding;
-  sem_t h_event_end_decoding;
+  VPxWorker *decoding_workers;
+  /* Shared threads the workers run on, if set by the application. */
+  VPxThreadPool *thread_pool;
+  /* Hands out the mb rows of the frame in order. */
+  VPxJobCounter mt_row_counter;
 /* end of threading data */
 #endif
 
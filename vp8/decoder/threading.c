@@ -246,8 +246,7 @@ static void mt_decode_macroblock(VP8D_COMP *pbi, MACROBLOCKD *xd,
   }
 }
 
-static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
-                              int start_mb_row) {
+static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd) {
   const vpx_atomic_int *last_row_current_mb_col;
   vpx_atomic_int *current_mb_col;
   int mb_row;
@@ -256,7 +255,6 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
   const vpx_atomic_int first_row_no_sync_above =
       VPX_ATOMIC_INIT(pc->mb_cols + nsync);
   int num_part = 1 << pbi->common.multi_token_partition;
-  int last_mb_row = start_mb_row;
 
   YV12_BUFFER_CONFIG *yv12_fb_new = pbi->dec_fb_ref[INTRA_FRAME];
   YV12_BUFFER_CONFIG *yv12_fb_lst = pbi->dec_fb_ref[LAST_FRAME];
@@ -285,20 +283,21 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
   dst_buffer[1] = yv12_fb_new->u_buffer;
   dst_buffer[2] = yv12_fb_new->v_buffer;
 
-  xd->up_available = (start_mb_row != 0);
-
-  xd->mode_info_context = pc->mi + pc->mode_info_stride * start_mb_row;
   xd->mode_info_stride = pc->mode_info_stride;
 
-  for (mb_row = start_mb_row; mb_row < pc->mb_rows;
-       mb_row += (pbi->decoding_thread_count + 1)) {
+  /* The rows are taken in order, so the row above is always being decoded by
+   * a thread that is already running. At most decoding_thread_count + 1 rows
+   * are in flight, which is no more than the number of token partitions, so
+   * the rows sharing a bool decoder are still decoded one after the other. */
+  while ((mb_row = vpx_job_counter_next(&pbi->mt_row_counter)) >= 0) {
     int recon_yoffset, recon_uvoffset;
     int mb_col;
     int filter_level;
     loop_filter_info_n *lfi_n = &pc->lf_info;
 
-    /* save last row processed by this thread */
-    last_mb_row = mb_row;
+    xd->up_available = (mb_row != 0);
+    xd->mode_info_context = pc->mi + pc->mode_info_stride * mb_row;
+
     /* select bool coder for current partition */
     xd->current_bc = &pbi->mbc[mb_row % num_part];
 
@@ -404,13 +403,9 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
       xd->corrupted |= ref_fb_corrupted[xd->mode_info_context->mbmi.ref_frame];
 
       if (xd->corrupted) {
-        // Move current decoding marcoblock to the end of row for all rows
-        // assigned to this thread, such that other threads won't be waiting.
-        for (; mb_row < pc->mb_rows;
-             mb_row += (pbi->decoding_thread_count + 1)) {
-          current_mb_col = &pbi->mt_current_mb_col[mb_row];
-          vpx_atomic_store_release(current_mb_col, pc->mb_cols + nsync);
-        }
+        // Move current decoding marcoblock to the end of row, such that the
+        // thread decoding the next row won't be waiting.
+        vpx_atomic_store_release(current_mb_col, pc->mb_cols + nsync);
         vpx_internal_error(&xd->error_info, VPX_CODEC_CORRUPT_FRAME,
                            "Corrupted reference frame");
       }
@@ -565,47 +560,23 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
 
     /* last MB of row is ready just after extension is done */
     vpx_atomic_store_release(current_mb_col, mb_col + nsync);
-
-    ++xd->mode_info_context; /* skip prediction column */
-    xd->up_available = 1;
-
-    /* since we have multithread */
-    xd->mode_info_context += xd->mode_info_stride * pbi->decoding_thread_count;
   }
-
-  /* signal end of decoding of current thread for current frame */
-  if (last_mb_row + (int)pbi->decoding_thread_count + 1 >= pc->mb_rows)
-    sem_post(&pbi->h_event_end_decoding);
 }
 
-static THREAD_FUNCTION thread_decoding_proc(void *p_data) {
-  int ithread = ((DECODETHREAD_DATA *)p_data)->ithread;
-  VP8D_COMP *pbi = (VP8D_COMP *)(((DECODETHREAD_DATA *)p_data)->ptr1);
-  MB_ROW_DEC *mbrd = (MB_ROW_DEC *)(((DECODETHREAD_DATA *)p_data)->ptr2);
+static int decoding_worker_hook(void *arg1, void *arg2) {
+  VP8D_COMP *const pbi = (VP8D_COMP *)arg1;
+  MACROBLOCKD *const xd = &((MB_ROW_DEC *)arg2)->mbd;
   ENTROPY_CONTEXT_PLANES mb_row_left_context;
 
-  while (1) {
-    if (vpx_atomic_load_acquire(&pbi->b_multithreaded_rd) == 0) break;
-
-    if (sem_wait(&pbi->h_event_start_decoding[ithread]) == 0) {
-      if (vpx_atomic_load_acquire(&pbi->b_multithreaded_rd) == 0) {
-        break;
-      } else {
-        MACROBLOCKD *xd = &mbrd->mbd;
-        xd->left_context = &mb_row_left_context;
-        if (setjmp(xd->error_info.jmp)) {
-          xd->error_info.setjmp = 0;
-          // Signal the end of decoding for current thread.
-          sem_post(&pbi->h_event_end_decoding);
-          continue;
-        }
-        xd->error_info.setjmp = 1;
-        mt_decode_mb_rows(pbi, xd, ithread + 1);
-      }
-    }
+  xd->left_context = &mb_row_left_context;
+  if (setjmp(xd->error_info.jmp)) {
+    xd->error_info.setjmp = 0;
+    return 0;
   }
-
-  return 0;
+  xd->error_info.setjmp = 1;
+  mt_decode_mb_rows(pbi, xd);
+  xd->error_info.setjmp = 0;
+  return 1;
 }
 
 void vp8_decoder_create_threads(VP8D_COMP *pbi) {
@@ -624,33 +595,25 @@ void vp8_decoder_create_threads(VP8D_COMP *pbi) {
   }
 
   if (core_count > 1) {
+    const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+
     vpx_atomic_init(&pbi->b_multithreaded_rd, 1);
     pbi->decoding_thread_count = core_count - 1;
 
-    CALLOC_ARRAY(pbi->h_decoding_thread, pbi->decoding_thread_count);
-    CALLOC_ARRAY(pbi->h_event_start_decoding, pbi->decoding_thread_count);
+    CALLOC_ARRAY(pbi->decoding_workers, pbi->decoding_thread_count);
     CALLOC_ARRAY_ALIGNED(pbi->mb_row_di, pbi->decoding_thread_count, 32);
-    CALLOC_ARRAY(pbi->de_thread_data, pbi->decoding_thread_count);
-
-    if (sem_init(&pbi->h_event_end_decoding, 0, 0)) {
-      vpx_internal_error(&pbi->common.error, VPX_CODEC_MEM_ERROR,
-                         "Failed to initialize semaphore");
-    }
 
     for (ithread = 0; ithread < pbi->decoding_thread_count; ++ithread) {
-      if (sem_init(&pbi->h_event_start_decoding[ithread], 0, 0)) break;
+      VPxWorker *const worker = &pbi->decoding_workers[ithread];
 
       vp8_setup_block_dptrs(&pbi->mb_row_di[ithread].mbd);
 
-      pbi->de_thread_data[ithread].ithread = ithread;
-      pbi->de_thread_data[ithread].ptr1 = (void *)pbi;
-      pbi->de_thread_data[ithread].ptr2 = (void *)&pbi->mb_row_di[ithread];
-
-      if (pthread_create(&pbi->h_decoding_thread[ithread], 0,
-                         thread_decoding_proc, &pbi->de_thread_data[ithread])) {
-        sem_destroy(&pbi->h_event_start_decoding[ithread]);
-        break;
-      }
+      winterface->init(worker);
+      worker->pool = pbi->thread_pool;
+      worker->hook = decoding_worker_hook;
+      worker->data1 = pbi;
+      worker->data2 = &pbi->mb_row_di[ithread];
+      if (!winterface->reset(worker)) break;
     }
 
     pbi->allocated_decoding_thread_count = ithread;
@@ -658,9 +621,6 @@ void vp8_decoder_create_threads(VP8D_COMP *pbi) {
         (int)pbi->decoding_thread_count) {
       /* the remainder of cleanup cases will be handled in
        * vp8_decoder_remove_threads(). */
-      if (pbi->allocated_decoding_thread_count == 0) {
-        sem_destroy(&pbi->h_event_end_decoding);
-      }
       vpx_internal_error(&pbi->common.error, VPX_CODEC_MEM_ERROR,
                          "Failed to create threads");
     }
@@ -810,35 +770,21 @@ void vp8_decoder_remove_threads(VP8D_COMP *pbi) {
 
     /* allow all threads to exit */
     for (i = 0; i < pbi->allocated_decoding_thread_count; ++i) {
-      sem_post(&pbi->h_event_start_decoding[i]);
-      pthread_join(pbi->h_decoding_thread[i], NULL);
+      vpx_get_worker_interface()->end(&pbi->decoding_workers[i]);
     }
 
-    for (i = 0; i < pbi->allocated_decoding_thread_count; ++i) {
-      sem_destroy(&pbi->h_event_start_decoding[i]);
-    }
-
-    if (pbi->allocated_decoding_thread_count) {
-      sem_destroy(&pbi->h_event_end_decoding);
-    }
-
-    vpx_free(pbi->h_decoding_thread);
-    pbi->h_decoding_thread = NULL;
-
-    vpx_free(pbi->h_event_start_decoding);
-    pbi->h_event_start_decoding = NULL;
+    vpx_free(pbi->decoding_workers);
+    pbi->decoding_workers = NULL;
 
     vpx_free(pbi->mb_row_di);
     pbi->mb_row_di = NULL;
 
-    vpx_free(pbi->de_thread_data);
-    pbi->de_thread_data = NULL;
-
     vp8mt_de_alloc_temp_buffers(pbi, pbi->common.mb_rows);
   }
 }
 
 int vp8mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
   VP8_COMMON *pc = &pbi->common;
   unsigned int i;
   int j;
@@ -879,9 +825,10 @@ int vp8mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd) {
 
   setup_decoding_thread_data(pbi, xd, pbi->mb_row_di,
                              pbi->decoding_thread_count);
+  vpx_job_counter_reset(&pbi->mt_row_counter, pc->mb_rows);
 
   for (i = 0; i < pbi->decoding_thread_count; ++i) {
-    sem_post(&pbi->h_event_start_decoding[i]);
+    winterface->launch(&pbi->decoding_workers[i]);
   }
 
   if (setjmp(xd->error_info.jmp)) {
@@ -891,15 +838,15 @@ int vp8mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd) {
     // the current frame while the main thread starts decoding the next frame,
     // which causes a data race.
     for (i = 0; i < pbi->decoding_thread_count; ++i)
-      sem_wait(&pbi->h_event_end_decoding);
+      winterface->sync(&pbi->decoding_workers[i]);
     return -1;
   }
 
   xd->error_info.setjmp = 1;
-  mt_decode_mb_rows(pbi, xd, 0);
+  mt_decode_mb_rows(pbi, xd);
 
-  for (i = 0; i < pbi->decoding_thread_count + 1; ++i)
-    sem_wait(&pbi->h_event_end_decoding); /* add back for each frame */
+  for (i = 0; i < pbi->decoding_thread_count; ++i)
+    winterface->sync(&pbi->decoding_workers[i]);
 
   return 0;
 }
@@ -60,6 +60,7 @@ struct vpx_codec_alg_priv {
   struct frame_buffers yv12_frame_buffers;
   void *user_priv;
   FRAGMENT_DATA fragments;
+  vpx_codec_thread_pool_t *thread_pool;
 };
 
 static int vp8_init_ctx(vpx_codec_ctx_t *ctx) {
@@ -334,6 +335,7 @@ static vpx_codec_err_t vp8_decode(vpx_codec_alg_priv_t *ctx,
     oxcf.Version = 9;
     oxcf.postprocess = 0;
     oxcf.max_threads = ctx->cfg.threads;
+    oxcf.thread_pool = ctx->thread_pool;
     oxcf.error_concealment =
         (ctx->base.init_flags & VPX_CODEC_USE_ERROR_CONCEALMENT);
 
@@ -687,6 +689,16 @@ static vpx_codec_err_t vp8_set_decryptor(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t vp8_set_thread_pool(vpx_codec_alg_priv_t *ctx,
+                                           va_list args) {
+  vpx_codec_thread_pool_t *pool = va_arg(args, vpx_codec_thread_pool_t *);
+
+  /* The threads are created when the decoder is initialized. */
+  if (ctx->decoder_init) return VPX_CODEC_ERROR;
+  ctx->thread_pool = pool;
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_ctrl_fn_map_t vp8_ctf_maps[] = {
   { VP8_SET_REFERENCE, vp8_set_reference },
   { VP8_COPY_REFERENCE, vp8_get_reference },
@@ -696,6 +708,7 @@ static vpx_codec_ctrl_fn_map_t vp8_ctf_maps[] = {
   { VP8D_GET_LAST_REF_USED, vp8_get_last_ref_frame },
   { VPXD_GET_LAST_QUANTIZER, vp8_get_quantizer },
   { VPXD_SET_DECRYPTOR, vp8_set_decryptor },
+  { VPXD_SET_THREAD_POOL, vp8_set_thread_pool },
   { -1, NULL },
 };
 
@@ -717,6 +730,7 @@ CODEC_INTERFACE(vpx_codec_vp8_dx) = {
       vp8_decode,    /* vpx_codec_decode_fn_t     decode; */
       vp8_get_frame, /* vpx_codec_frame_get_fn_t  frame_get; */
       NULL,
+      NULL,
   },
   {
       /* encoder functions */
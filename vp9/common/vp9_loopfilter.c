@@ -16,6 +16,7 @@
 #include "vpx_dsp/vpx_dsp_common.h"
 #include "vpx_mem/vpx_mem.h"
 #include "vpx_ports/mem.h"
+#include "vpx_ports/vpx_timer.h"
 
 #include "vp9/common/vp9_seg_common.h"
 
@@ -249,22 +250,17 @@ void vp9_loop_filter_init(VP9_COMMON *cm) {
     memset(lfi->lfthr[lvl].hev_thr, (lvl >> 4), SIMD_WIDTH);
 }
 
-void vp9_loop_filter_frame_init(VP9_COMMON *cm, int default_filt_lvl) {
+// Fills in the filter level of each segment, reference and mode in lfi->lvl.
+static void set_filter_levels(const VP9_COMMON *cm, int default_filt_lvl,
+                              loop_filter_info_n *lfi) {
   int seg_id;
   // n_shift is the multiplier for lf_deltas
   // the multiplier is 1 for when filter_lvl is between 0 and 31;
   // 2 when filter_lvl is between 32 and 63
   const int scale = 1 << (default_filt_lvl >> 5);
-  loop_filter_info_n *const lfi = &cm->lf_info;
-  struct loopfilter *const lf = &cm->lf;
+  const struct loopfilter *const lf = &cm->lf;
   const struct segmentation *const seg = &cm->seg;
 
-  // update limits if sharpness has changed
-  if (lf->last_sharpness_level != lf->sharpness_level) {
-    update_sharpness(lfi, lf->sharpness_level);
-    lf->last_sharpness_level = lf->sharpness_level;
-  }
-
   for (seg_id = 0; seg_id < MAX_SEGMENTS; seg_id++) {
     int lvl_seg = default_filt_lvl;
     if (segfeature_active(seg, seg_id, SEG_LVL_ALT_LF)) {
@@ -294,6 +290,19 @@ void vp9_loop_filter_frame_init(VP9_COMMON *cm, int default_filt_lvl) {
   }
 }
 
+void vp9_loop_filter_frame_init(VP9_COMMON *cm, int default_filt_lvl) {
+  loop_filter_info_n *const lfi = &cm->lf_info;
+  struct loopfilter *const lf = &cm->lf;
+
+  // update limits if sharpness has changed
+  if (lf->last_sharpness_level != lf->sharpness_level) {
+    update_sharpness(lfi, lf->sharpness_level);
+    lf->last_sharpness_level = lf->sharpness_level;
+  }
+
+  set_filter_levels(cm, default_filt_lvl, lfi);
+}
+
 static void filter_selectively_vert_row2(
     int subsampling_factor, uint8_t *s, int pitch, unsigned int mask_16x16,
     unsigned int mask_8x8, unsigned int mask_4x4, unsigned int mask_4x4_int,
@@ -877,13 +886,13 @@ void vp9_adjust_mask(VP9_COMMON *const cm, const int mi_row, const int mi_col,
   assert(!(lfm->int_4x4_uv & lfm->above_uv[TX_16X16]));
 }
 
-// This function sets up the bit masks for the entire 64x64 region represented
-// by mi_row, mi_col.
-void vp9_setup_mask(VP9_COMMON *const cm, const int mi_row, const int mi_col,
-                    MODE_INFO **mi8x8, const int mode_info_stride,
-                    LOOP_FILTER_MASK *lfm) {
+// Sets up the bit masks for the 64x64 region at mi_row, mi_col, with the
+// filter levels in lfi_n.
+static void setup_mask(const VP9_COMMON *const cm,
+                       const loop_filter_info_n *const lfi_n, const int mi_row,
+                       const int mi_col, MODE_INFO **mi8x8,
+                       const int mode_info_stride, LOOP_FILTER_MASK *lfm) {
   int idx_32, idx_16, idx_8;
-  const loop_filter_info_n *const lfi_n = &cm->lf_info;
   MODE_INFO **mip = mi8x8;
   MODE_INFO **mip2 = mi8x8;
 
@@ -1011,6 +1020,14 @@ void vp9_setup_mask(VP9_COMMON *const cm, const int mi_row, const int mi_col,
   }
 }
 
+// This function sets up the bit masks for the entire 64x64 region represented
+// by mi_row, mi_col.
+void vp9_setup_mask(VP9_COMMON *const cm, const int mi_row, const int mi_col,
+                    MODE_INFO **mi8x8, const int mode_info_stride,
+                    LOOP_FILTER_MASK *lfm) {
+  setup_mask(cm, &cm->lf_info, mi_row, mi_col, mi8x8, mode_info_stride, lfm);
+}
+
 static void filter_selectively_vert(
     uint8_t *s, int pitch, unsigned int mask_16x16, unsigned int mask_8x8,
     unsigned int mask_4x4, unsigned int mask_4x4_int,
@@ -1484,6 +1501,41 @@ void vp9_loop_filter_frame(YV12_BUFFER_CONFIG *frame, VP9_COMMON *cm,
   loop_filter_rows(frame, cm, xd->plane, start_mi_row, end_mi_row, y_only);
 }
 
+void vp9_loop_filter_frame_y(YV12_BUFFER_CONFIG *frame, VP9_COMMON *cm,
+                             const struct macroblockd_plane planes[MAX_MB_PLANE],
+                             int frame_filter_level, int partial_frame) {
+  // Only the filter levels are set here, the limits are read from cm.
+  loop_filter_info_n lfi_n;
+  struct macroblockd_plane y_plane = planes[0];
+  int start_mi_row, end_mi_row, mi_rows_to_filter;
+  int mi_row, mi_col;
+  if (!frame_filter_level) return;
+  start_mi_row = 0;
+  mi_rows_to_filter = cm->mi_rows;
+  if (partial_frame && cm->mi_rows > 8) {
+    start_mi_row = cm->mi_rows >> 1;
+    start_mi_row &= 0xfffffff8;
+    mi_rows_to_filter = VPXMAX(cm->mi_rows / 8, 8);
+  }
+  end_mi_row = start_mi_row + mi_rows_to_filter;
+
+  set_filter_levels(cm, frame_filter_level, &lfi_n);
+
+  for (mi_row = start_mi_row; mi_row < end_mi_row; mi_row += MI_BLOCK_SIZE) {
+    MODE_INFO **mi = cm->mi_grid_visible + mi_row * cm->mi_stride;
+    for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_BLOCK_SIZE) {
+      // The mask of a superblock only depends on its own blocks, so it is
+      // built just before the superblock is filtered.
+      LOOP_FILTER_MASK lfm;
+      setup_mask(cm, &lfi_n, mi_row, mi_col, mi + mi_col, cm->mi_stride, &lfm);
+      setup_pred_plane(&y_plane.dst, frame->y_buffer, frame->y_stride, mi_row,
+                       mi_col, NULL, 0, 0);
+      vp9_adjust_mask(cm, mi_row, mi_col, &lfm);
+      vp9_filter_block_plane_ss00(cm, &y_plane, mi_row, &lfm);
+    }
+  }
+}
+
 // Used by the encoder to build the loopfilter masks.
 // TODO(slavarnway): Do the encoder the same way the decoder does it and
 //                   build the masks in line as part of the encode process.
@@ -1615,6 +1667,8 @@ void vp9_loop_filter_data_reset(
   lf_data->start = 0;
   lf_data->stop = 0;
   lf_data->y_only = 0;
+  lf_data->wall_us = 0;
+  lf_data->cpu_us = 0;
   memcpy(lf_data->planes, planes, sizeof(lf_data->planes));
 }
 
@@ -1628,8 +1682,14 @@ void vp9_reset_lfm(VP9_COMMON *const cm) {
 
 int vp9_loop_filter_worker(void *arg1, void *unused) {
   LFWorkerData *const lf_data = (LFWorkerData *)arg1;
+  const int64_t cpu_start = vpx_usec_thread_cpu_time();
+  struct vpx_usec_timer timer;
   (void)unused;
+  vpx_usec_timer_start(&timer);
   loop_filter_rows(lf_data->frame_buffer, lf_data->cm, lf_data->planes,
                    lf_data->start, lf_data->stop, lf_data->y_only);
+  vpx_usec_timer_mark(&timer);
+  lf_data->wall_us += vpx_usec_timer_elapsed(&timer);
+  lf_data->cpu_us += vpx_usec_thread_cpu_time() - cpu_start;
   return 1;
 }
@@ -123,6 +123,16 @@ void vp9_loop_filter_frame(YV12_BUFFER_CONFIG *frame, struct VP9Common *cm,
                            struct macroblockd *xd, int frame_filter_level,
                            int y_only, int partial_frame);
 
+// Filters the luma plane of the rows of 'frame' that vp9_loop_filter_frame()
+// filters, without changing the loop filter state in 'cm'. The masks are built
+// from 'frame_filter_level' as each superblock is filtered, so several threads
+// can filter their own copies of a frame at different levels at once. The
+// limits in cm->lf_info must be up to date with the sharpness level. Only the
+// luma plane of 'frame' is used, it need not have chroma planes.
+void vp9_loop_filter_frame_y(YV12_BUFFER_CONFIG *frame, struct VP9Common *cm,
+                             const struct macroblockd_plane planes[MAX_MB_PLANE],
+                             int frame_filter_level, int partial_frame);
+
 // Get the superblock lfm for a given mi_row, mi_col.
 static INLINE LOOP_FILTER_MASK *get_lfm(const struct loopfilter *lf,
                                         const int mi_row, const int mi_col) {
@@ -145,6 +155,11 @@ typedef struct LoopFilterWorkerData {
   int start;
   int stop;
   int y_only;
+
+  // Wall clock and CPU time spent in the worker hooks since the last reset, in
+  // microseconds.
+  int64_t wall_us;
+  int64_t cpu_us;
 } LFWorkerData;
 
 void vp9_loop_filter_data_reset(
@@ -37,9 +37,10 @@ extern "C" {
 #define REF_FRAMES_LOG2 3
 #define REF_FRAMES (1 << REF_FRAMES_LOG2)
 
-// 1 scratch frame for the new frame, REFS_PER_FRAME for scaled references on
-// the encoder.
-#define FRAME_BUFFERS (REF_FRAMES + 1 + REFS_PER_FRAME)
+// VPX_MAXIMUM_WORK_BUFFERS scratch frames: the new frames and the frames held
+// for output when up to 4 frames are decoded in parallel, REFS_PER_FRAME for
+// scaled references on the encoder.
+#define FRAME_BUFFERS (REF_FRAMES + VPX_MAXIMUM_WORK_BUFFERS)
 
 #define FRAME_CONTEXTS_LOG2 2
 #define FRAME_CONTEXTS (1 << FRAME_CONTEXTS_LOG2)
@@ -81,14 +82,39 @@ typedef struct {
                            // frame.
   vpx_codec_frame_buffer_t raw_frame_buffer;
   YV12_BUFFER_CONFIG buf;
+
+  // The following variables will only be used in frame parallel decode.
+
+  // frame_worker_owner indicates which FrameWorker owns this buffer. NULL means
+  // that no FrameWorker owns, or is decoding, this buffer.
+  VPxWorker *frame_worker_owner;
+
+  // row indicates the number of luma pixel rows of the frame that have been
+  // fully decoded and loop filtered. -1 means the decoding has not started,
+  // INT_MAX means the whole frame is ready (or its decoding has failed).
+  int row;
+
+  // parsed is set once the modes and motion vectors of the frame are final,
+  // which the row based multi-threaded decoder reaches before the pixels.
+  int parsed;
 } RefCntBuffer;
 
 typedef struct BufferPool {
+// Protect BufferPool from being accessed by several FrameWorkers at
+// the same time during frame parallel decode. Only initialized and used by
+// the decoder.
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t pool_mutex;
+#endif
+
   // Private data associated with the frame buffer callbacks.
   void *cb_priv;
 
   vpx_get_frame_buffer_cb_fn_t get_fb_cb;
   vpx_release_frame_buffer_cb_fn_t release_fb_cb;
+  // Used instead of get_fb_cb when set, to let the application lay out the
+  // planes of the frame buffers.
+  vpx_get_frame_buffer_layout_cb_fn_t get_fb_layout_cb;
 
   RefCntBuffer frame_bufs[FRAME_BUFFERS];
 
@@ -329,6 +355,22 @@ static INLINE YV12_BUFFER_CONFIG *get_frame_new_buffer(VP9_COMMON *cm) {
   return &cm->buffer_pool->frame_bufs[cm->new_fb_idx].buf;
 }
 
+static INLINE void lock_buffer_pool(BufferPool *const pool) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&pool->pool_mutex);
+#else
+  (void)pool;
+#endif
+}
+
+static INLINE void unlock_buffer_pool(BufferPool *const pool) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(&pool->pool_mutex);
+#else
+  (void)pool;
+#endif
+}
+
 static INLINE int get_free_fb(VP9_COMMON *cm) {
   RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
   int i;
@@ -13,25 +13,61 @@
 #include "./vpx_config.h"
 #include "vpx_dsp/vpx_dsp_common.h"
 #include "vpx_mem/vpx_mem.h"
+#include "vpx_ports/vpx_timer.h"
 #include "vp9/common/vp9_entropymode.h"
 #include "vp9/common/vp9_thread_common.h"
 #include "vp9/common/vp9_reconinter.h"
 #include "vp9/common/vp9_loopfilter.h"
 
 #if CONFIG_MULTITHREAD
-static INLINE void mutex_lock(pthread_mutex_t *const mutex) {
-  const int kMaxTryLocks = 4000;
-  int locked = 0;
+void vp9_row_progress_init(VP9RowProgress *progress) {
+  vpx_atomic_init(&progress->cur_col, -1);
+  vpx_atomic_init(&progress->num_waiters, 0);
+  pthread_mutex_init(&progress->mutex, NULL);
+  pthread_cond_init(&progress->cond, NULL);
+}
+
+void vp9_row_progress_destroy(VP9RowProgress *progress) {
+  pthread_mutex_destroy(&progress->mutex);
+  pthread_cond_destroy(&progress->cond);
+}
+
+void vp9_row_progress_reset(VP9RowProgress *progress, int cur_col) {
+  vpx_atomic_init(&progress->cur_col, cur_col);
+}
+
+void vp9_row_progress_wait(VP9RowProgress *progress, int col) {
+  // The row being waited on is usually only a few blocks behind, so poll its
+  // progress before falling back to sleeping.
+  const int kMaxSpins = 4000;
   int i;
 
-  for (i = 0; i < kMaxTryLocks; ++i) {
-    if (!pthread_mutex_trylock(mutex)) {
-      locked = 1;
-      break;
-    }
+  for (i = 0; i < kMaxSpins; ++i) {
+    if (vpx_atomic_load_acquire(&progress->cur_col) >= col) return;
   }
 
-  if (!locked) pthread_mutex_lock(mutex);
+  pthread_mutex_lock(&progress->mutex);
+  // num_waiters is only modified with the mutex held. It is published before
+  // the progress is checked again, and vp9_row_progress_set() publishes the
+  // progress before checking num_waiters, so at least one of the two threads
+  // sees the other's update and the wakeup cannot be lost.
+  vpx_atomic_store_seq_cst(&progress->num_waiters,
+                           vpx_atomic_load_acquire(&progress->num_waiters) + 1);
+  while (vpx_atomic_load_seq_cst(&progress->cur_col) < col) {
+    pthread_cond_wait(&progress->cond, &progress->mutex);
+  }
+  vpx_atomic_store_release(&progress->num_waiters,
+                           vpx_atomic_load_acquire(&progress->num_waiters) - 1);
+  pthread_mutex_unlock(&progress->mutex);
+}
+
+void vp9_row_progress_set(VP9RowProgress *progress, int cur_col) {
+  vpx_atomic_store_seq_cst(&progress->cur_col, cur_col);
+  if (vpx_atomic_load_seq_cst(&progress->num_waiters)) {
+    pthread_mutex_lock(&progress->mutex);
+    pthread_cond_broadcast(&progress->cond);
+    pthread_mutex_unlock(&progress->mutex);
+  }
 }
 #endif  // CONFIG_MULTITHREAD
 
@@ -40,13 +76,7 @@ static INLINE void sync_read(VP9LfSync *const lf_sync, int r, int c) {
   const int nsync = lf_sync->sync_range;
 
   if (r && !(c & (nsync - 1))) {
-    pthread_mutex_t *const mutex = &lf_sync->mutex[r - 1];
-    mutex_lock(mutex);
-
-    while (c > lf_sync->cur_sb_col[r - 1] - nsync) {
-      pthread_cond_wait(&lf_sync->cond[r - 1], mutex);
-    }
-    pthread_mutex_unlock(mutex);
+    vp9_row_progress_wait(&lf_sync->progress[r - 1], c + nsync);
   }
 #else
   (void)lf_sync;
@@ -70,14 +100,7 @@ static INLINE void sync_write(VP9LfSync *const lf_sync, int r, int c,
     cur = sb_cols + nsync;
   }
 
-  if (sig) {
-    mutex_lock(&lf_sync->mutex[r]);
-
-    lf_sync->cur_sb_col[r] = cur;
-
-    pthread_cond_signal(&lf_sync->cond[r]);
-    pthread_mutex_unlock(&lf_sync->mutex[r]);
-  }
+  if (sig) vp9_row_progress_set(&lf_sync->progress[r], cur);
 #else
   (void)lf_sync;
   (void)r;
@@ -86,6 +109,19 @@ static INLINE void sync_write(VP9LfSync *const lf_sync, int r, int c,
 #endif  // CONFIG_MULTITHREAD
 }
 
+// Initialize the loop-filtered superblock index to -1 for all SB rows.
+static void reset_progress(VP9LfSync *const lf_sync, int sb_rows) {
+#if CONFIG_MULTITHREAD
+  int i;
+  for (i = 0; i < sb_rows; ++i) {
+    vp9_row_progress_reset(&lf_sync->progress[i], -1);
+  }
+#else
+  (void)lf_sync;
+  (void)sb_rows;
+#endif  // CONFIG_MULTITHREAD
+}
+
 // Implement row loopfiltering for each thread.
 static INLINE void thread_loop_filter_rows(
     const YV12_BUFFER_CONFIG *const frame_buffer, VP9_COMMON *const cm,
@@ -93,7 +129,6 @@ static INLINE void thread_loop_filter_rows(
     int y_only, VP9LfSync *const lf_sync) {
   const int num_planes = y_only ? 1 : MAX_MB_PLANE;
   const int sb_cols = mi_cols_aligned_to_sb(cm->mi_cols) >> MI_BLOCK_SIZE_LOG2;
-  const int num_active_workers = lf_sync->num_active_workers;
   int mi_row, mi_col;
   enum lf_path path;
   if (y_only)
@@ -105,10 +140,7 @@ static INLINE void thread_loop_filter_rows(
   else
     path = LF_PATH_SLOW;
 
-  assert(num_active_workers > 0);
-
-  for (mi_row = start; mi_row < stop;
-       mi_row += num_active_workers * MI_BLOCK_SIZE) {
+  for (mi_row = start; mi_row < stop; mi_row += MI_BLOCK_SIZE) {
     MODE_INFO **const mi = cm->mi_grid_visible + mi_row * cm->mi_stride;
     LOOP_FILTER_MASK *lfm = get_lfm(&cm->lf, mi_row, 0);
 
@@ -148,9 +180,21 @@ static INLINE void thread_loop_filter_rows(
 static int loop_filter_row_worker(void *arg1, void *arg2) {
   VP9LfSync *const lf_sync = (VP9LfSync *)arg1;
   LFWorkerData *const lf_data = (LFWorkerData *)arg2;
-  thread_loop_filter_rows(lf_data->frame_buffer, lf_data->cm, lf_data->planes,
-                          lf_data->start, lf_data->stop, lf_data->y_only,
-                          lf_sync);
+  const int64_t cpu_start = vpx_usec_thread_cpu_time();
+  struct vpx_usec_timer timer;
+  int row;
+  vpx_usec_timer_start(&timer);
+  // The rows are taken in order, so the row above is always being filtered by
+  // a worker that is already running, whichever workers get to run.
+  while ((row = vpx_job_counter_next(&lf_sync->row_counter)) >= 0) {
+    const int mi_row = lf_data->start + row * MI_BLOCK_SIZE;
+    const int mi_row_end = VPXMIN(mi_row + MI_BLOCK_SIZE, lf_data->stop);
+    thread_loop_filter_rows(lf_data->frame_buffer, lf_data->cm, lf_data->planes,
+                            mi_row, mi_row_end, lf_data->y_only, lf_sync);
+  }
+  vpx_usec_timer_mark(&timer);
+  lf_data->wall_us += vpx_usec_timer_elapsed(&timer);
+  lf_data->cpu_us += vpx_usec_thread_cpu_time() - cpu_start;
   return 1;
 }
 
@@ -177,8 +221,10 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, VP9_COMMON *cm,
   }
   lf_sync->num_active_workers = num_workers;
 
-  // Initialize cur_sb_col to -1 for all SB rows.
-  memset(lf_sync->cur_sb_col, -1, sizeof(*lf_sync->cur_sb_col) * sb_rows);
+  reset_progress(lf_sync, sb_rows);
+  vpx_job_counter_reset(
+      &lf_sync->row_counter,
+      (stop - start + MI_BLOCK_SIZE - 1) >> MI_BLOCK_SIZE_LOG2);
 
   // Set up loopfilter thread data.
   // The decoder is capping num_workers because it has been observed that using
@@ -198,7 +244,7 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, VP9_COMMON *cm,
 
     // Loopfilter data
     vp9_loop_filter_data_reset(lf_data, frame, cm, planes);
-    lf_data->start = start + i * MI_BLOCK_SIZE;
+    lf_data->start = start;
     lf_data->stop = stop;
     lf_data->y_only = y_only;
 
@@ -251,8 +297,7 @@ void vp9_lpf_mt_init(VP9LfSync *lf_sync, VP9_COMMON *cm, int frame_filter_level,
     vp9_loop_filter_alloc(lf_sync, cm, sb_rows, cm->width, num_workers);
   }
 
-  // Initialize cur_sb_col to -1 for all SB rows.
-  memset(lf_sync->cur_sb_col, -1, sizeof(*lf_sync->cur_sb_col) * sb_rows);
+  reset_progress(lf_sync, sb_rows);
 
   lf_sync->corrupted = 0;
 
@@ -283,19 +328,11 @@ void vp9_loop_filter_alloc(VP9LfSync *lf_sync, VP9_COMMON *cm, int rows,
   {
     int i;
 
-    CHECK_MEM_ERROR(cm, lf_sync->mutex,
-                    vpx_malloc(sizeof(*lf_sync->mutex) * rows));
-    if (lf_sync->mutex) {
+    CHECK_MEM_ERROR(cm, lf_sync->progress,
+                    vpx_malloc(sizeof(*lf_sync->progress) * rows));
+    if (lf_sync->progress) {
       for (i = 0; i < rows; ++i) {
-        pthread_mutex_init(&lf_sync->mutex[i], NULL);
-      }
-    }
-
-    CHECK_MEM_ERROR(cm, lf_sync->cond,
-                    vpx_malloc(sizeof(*lf_sync->cond) * rows));
-    if (lf_sync->cond) {
-      for (i = 0; i < rows; ++i) {
-        pthread_cond_init(&lf_sync->cond[i], NULL);
+        vp9_row_progress_init(&lf_sync->progress[i]);
       }
     }
 
@@ -328,9 +365,6 @@ void vp9_loop_filter_alloc(VP9LfSync *lf_sync, VP9_COMMON *cm, int rows,
   lf_sync->num_workers = num_workers;
   lf_sync->num_active_workers = lf_sync->num_workers;
 
-  CHECK_MEM_ERROR(cm, lf_sync->cur_sb_col,
-                  vpx_malloc(sizeof(*lf_sync->cur_sb_col) * rows));
-
   CHECK_MEM_ERROR(cm, lf_sync->num_tiles_done,
                   vpx_malloc(sizeof(*lf_sync->num_tiles_done) *
                                  mi_cols_aligned_to_sb(cm->mi_rows) >>
@@ -345,19 +379,12 @@ void vp9_loop_filter_dealloc(VP9LfSync *lf_sync) {
   assert(lf_sync != NULL);
 
 #if CONFIG_MULTITHREAD
-  if (lf_sync->mutex != NULL) {
-    int i;
-    for (i = 0; i < lf_sync->rows; ++i) {
-      pthread_mutex_destroy(&lf_sync->mutex[i]);
-    }
-    vpx_free(lf_sync->mutex);
-  }
-  if (lf_sync->cond != NULL) {
+  if (lf_sync->progress != NULL) {
     int i;
     for (i = 0; i < lf_sync->rows; ++i) {
-      pthread_cond_destroy(&lf_sync->cond[i]);
+      vp9_row_progress_destroy(&lf_sync->progress[i]);
     }
-    vpx_free(lf_sync->cond);
+    vpx_free(lf_sync->progress);
   }
   if (lf_sync->recon_done_mutex != NULL) {
     int i;
@@ -381,7 +408,6 @@ void vp9_loop_filter_dealloc(VP9LfSync *lf_sync) {
 #endif  // CONFIG_MULTITHREAD
 
   vpx_free(lf_sync->lfdata);
-  vpx_free(lf_sync->cur_sb_col);
   vpx_free(lf_sync->num_tiles_done);
   // clear the structure as the source of this call may be a resize in which
   // case this call will be followed by an _alloc() which may fail.
@@ -420,10 +446,7 @@ static int get_next_row(VP9_COMMON *cm, VP9LfSync *lf_sync) {
   pthread_mutex_lock(lf_sync->lf_mutex);
   if (lf_sync->corrupted) {
     int row = return_val >> MI_BLOCK_SIZE_LOG2;
-    pthread_mutex_lock(&lf_sync->mutex[row]);
-    lf_sync->cur_sb_col[row] = INT_MAX;
-    pthread_cond_signal(&lf_sync->cond[row]);
-    pthread_mutex_unlock(&lf_sync->mutex[row]);
+    vp9_row_progress_set(&lf_sync->progress[row], INT_MAX);
     return_val = -1;
   }
   pthread_mutex_unlock(lf_sync->lf_mutex);
@@ -12,7 +12,9 @@
 #define VPX_VP9_COMMON_VP9_THREAD_COMMON_H_
 #include "./vpx_config.h"
 #include "vp9/common/vp9_loopfilter.h"
+#include "vpx_util/vpx_atomics.h"
 #include "vpx_util/vpx_thread.h"
+#include "vpx_util/vpx_job_counter.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -21,14 +23,37 @@ extern "C" {
 struct VP9Common;
 struct FRAME_COUNTS;
 
+#if CONFIG_MULTITHREAD
+// Progress of a row of blocks, published by the thread working on the row.
+// The progress is an atomic counter: readers spin on it for a while and only
+// sleep on the condition variable when the row is further behind, and the
+// writer only takes the mutex when a reader is actually sleeping.
+typedef struct VP9RowProgress {
+  vpx_atomic_int cur_col;
+  vpx_atomic_int num_waiters;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+} VP9RowProgress;
+
+void vp9_row_progress_init(VP9RowProgress *progress);
+void vp9_row_progress_destroy(VP9RowProgress *progress);
+
+// Resets the progress of a row. Not thread safe.
+void vp9_row_progress_reset(VP9RowProgress *progress, int cur_col);
+
+// Waits until the progress of the row reaches col.
+void vp9_row_progress_wait(VP9RowProgress *progress, int col);
+
+// Advances the progress of the row to cur_col, waking up any waiting reader.
+void vp9_row_progress_set(VP9RowProgress *progress, int cur_col);
+#endif  // CONFIG_MULTITHREAD
+
 // Loopfilter row synchronization
 typedef struct VP9LfSyncData {
 #if CONFIG_MULTITHREAD
-  pthread_mutex_t *mutex;
-  pthread_cond_t *cond;
+  // The loop-filtered superblock index in each row.
+  VP9RowProgress *progress;
 #endif
-  // Allocate memory to store the loop-filtered superblock index in each row.
-  int *cur_sb_col;
   // The optimal sync_range for different resolution and platform should be
   // determined by testing. Currently, it is chosen to be a power-of-2 number.
   int sync_range;
@@ -38,6 +63,9 @@ typedef struct VP9LfSyncData {
   LFWorkerData *lfdata;
   int num_workers;         // number of allocated workers.
   int num_active_workers;  // number of scheduled workers.
+  // Hands out the superblock rows to the workers of
+  // vp9_loop_filter_frame_mt() in order.
+  VPxJobCounter row_counter;
 
 #if CONFIG_MULTITHREAD
   pthread_mutex_t *lf_mutex;
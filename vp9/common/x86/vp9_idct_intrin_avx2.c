@@ -0,0 +1,53 @@
+/*
+ *  Copyright (c) 2021 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "./vp9_rtcd.h"
+#include "vp9/common/vp9_enums.h"
+#include "vpx_dsp/x86/inv_txfm_avx2.h"
+
+static INLINE void idct16_avx2(__m256i *const in) {
+  transpose_16bit_16x16_avx2(in, in);
+  idct16_16col_avx2(in, in);
+}
+
+static INLINE void iadst16_avx2(__m256i *const in) {
+  transpose_16bit_16x16_avx2(in, in);
+  vpx_iadst16_16col_avx2(in);
+}
+
+void vp9_iht16x16_256_add_avx2(const tran_low_t *input, uint8_t *dest,
+                               int stride, int tx_type) {
+  __m256i in[16];
+  int i;
+
+  for (i = 0; i < 16; ++i) in[i] = load_input_data16_avx2(input + i * 16);
+
+  switch (tx_type) {
+    case DCT_DCT:
+      idct16_avx2(in);
+      idct16_avx2(in);
+      break;
+    case ADST_DCT:
+      idct16_avx2(in);
+      iadst16_avx2(in);
+      break;
+    case DCT_ADST:
+      iadst16_avx2(in);
+      idct16_avx2(in);
+      break;
+    default:
+      assert(tx_type == ADST_ADST);
+      iadst16_avx2(in);
+      iadst16_avx2(in);
+      break;
+  }
+
+  for (i = 0; i < 16; ++i) write_buffer_16x1_avx2(dest + i * stride, in[i]);
+}
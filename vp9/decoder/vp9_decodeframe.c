@@ -45,6 +45,7 @@
 #include "vp9/decoder/vp9_decodemv.h"
 #include "vp9/decoder/vp9_decoder.h"
 #include "vp9/decoder/vp9_dsubexp.h"
+#include "vp9/decoder/vp9_dthread.h"
 #include "vp9/decoder/vp9_job_queue.h"
 
 #define MAX_VP9_HEADER_SIZE 80
@@ -574,8 +575,9 @@ static void extend_and_predict(TileWorkerData *twd, const uint8_t *buf_ptr1,
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
 static void dec_build_inter_predictors(
-    TileWorkerData *twd, MACROBLOCKD *xd, int plane, int bw, int bh, int x,
-    int y, int w, int h, int mi_x, int mi_y, const InterpKernel *kernel,
+    TileWorkerData *twd, VP9Decoder *const pbi, MACROBLOCKD *xd, int plane,
+    int bw, int bh, int x, int y, int w, int h, int mi_x, int mi_y,
+    const InterpKernel *kernel,
     const struct scale_factors *sf, struct buf_2d *pre_buf,
     struct buf_2d *dst_buf, const MV *mv, RefCntBuffer *ref_frame_buf,
     int is_scaled, int ref) {
@@ -651,6 +653,14 @@ static void dec_build_inter_predictors(
   x0_16 += scaled_mv.col;
   y0_16 += scaled_mv.row;
 
+  // Wait until the reference rows this block reads from, including the
+  // filter taps, have been decoded and loop filtered.
+  if (pbi->frame_parallel_decode) {
+    const int y1 = ((y0_16 + (h - 1) * ys) >> SUBPEL_BITS) + VP9_INTERP_EXTEND;
+    const int rows = VPXMAX(y1 + 1, 1) << pd->subsampling_y;
+    vp9_frameworker_wait(ref_frame_buf, rows);
+  }
+
   // Get reference block pointer.
   buf_ptr = ref_frame + y0 * pre_buf->stride + x0;
   buf_stride = pre_buf->stride;
@@ -755,10 +765,10 @@ static void dec_build_inter_predictors_sb(TileWorkerData *twd,
         for (y = 0; y < num_4x4_h; ++y) {
           for (x = 0; x < num_4x4_w; ++x) {
             const MV mv = average_split_mvs(pd, mi, ref, i++);
-            dec_build_inter_predictors(twd, xd, plane, n4w_x4, n4h_x4, 4 * x,
-                                       4 * y, 4, 4, mi_x, mi_y, kernel, sf,
-                                       pre_buf, dst_buf, &mv, ref_frame_buf,
-                                       is_scaled, ref);
+            dec_build_inter_predictors(twd, pbi, xd, plane, n4w_x4, n4h_x4,
+                                       4 * x, 4 * y, 4, 4, mi_x, mi_y, kernel,
+                                       sf, pre_buf, dst_buf, &mv,
+                                       ref_frame_buf, is_scaled, ref);
           }
         }
       }
@@ -772,9 +782,10 @@ static void dec_build_inter_predictors_sb(TileWorkerData *twd,
         const int n4w_x4 = 4 * num_4x4_w;
         const int n4h_x4 = 4 * num_4x4_h;
         struct buf_2d *const pre_buf = &pd->pre[ref];
-        dec_build_inter_predictors(twd, xd, plane, n4w_x4, n4h_x4, 0, 0, n4w_x4,
-                                   n4h_x4, mi_x, mi_y, kernel, sf, pre_buf,
-                                   dst_buf, &mv, ref_frame_buf, is_scaled, ref);
+        dec_build_inter_predictors(twd, pbi, xd, plane, n4w_x4, n4h_x4, 0, 0,
+                                   n4w_x4, n4h_x4, mi_x, mi_y, kernel, sf,
+                                   pre_buf, dst_buf, &mv, ref_frame_buf,
+                                   is_scaled, ref);
       }
     }
   }
@@ -1512,6 +1523,31 @@ static void resize_context_buffers(VP9_COMMON *cm, int width, int height) {
   }
 }
 
+// Gets a frame buffer for the new frame from the frame buffer callbacks.
+static int realloc_new_frame_buffer(VP9_COMMON *cm) {
+  BufferPool *const pool = cm->buffer_pool;
+  vpx_codec_frame_buffer_t *const fb =
+      &pool->frame_bufs[cm->new_fb_idx].raw_frame_buffer;
+
+  if (pool->get_fb_layout_cb != NULL) {
+    return vpx_realloc_frame_buffer_layout(
+        get_frame_new_buffer(cm), cm->width, cm->height, cm->subsampling_x,
+        cm->subsampling_y,
+#if CONFIG_VP9_HIGHBITDEPTH
+        cm->use_highbitdepth,
+#endif
+        VP9_DEC_BORDER_IN_PIXELS, fb, pool->get_fb_layout_cb, pool->cb_priv);
+  }
+  return vpx_realloc_frame_buffer(
+      get_frame_new_buffer(cm), cm->width, cm->height, cm->subsampling_x,
+      cm->subsampling_y,
+#if CONFIG_VP9_HIGHBITDEPTH
+      cm->use_highbitdepth,
+#endif
+      VP9_DEC_BORDER_IN_PIXELS, cm->byte_alignment, fb, pool->get_fb_cb,
+      pool->cb_priv);
+}
+
 static void setup_frame_size(VP9_COMMON *cm, struct vpx_read_bit_buffer *rb) {
   int width, height;
   BufferPool *const pool = cm->buffer_pool;
@@ -1519,18 +1555,13 @@ static void setup_frame_size(VP9_COMMON *cm, struct vpx_read_bit_buffer *rb) {
   resize_context_buffers(cm, width, height);
   setup_render_size(cm, rb);
 
-  if (vpx_realloc_frame_buffer(
-          get_frame_new_buffer(cm), cm->width, cm->height, cm->subsampling_x,
-          cm->subsampling_y,
-#if CONFIG_VP9_HIGHBITDEPTH
-          cm->use_highbitdepth,
-#endif
-          VP9_DEC_BORDER_IN_PIXELS, cm->byte_alignment,
-          &pool->frame_bufs[cm->new_fb_idx].raw_frame_buffer, pool->get_fb_cb,
-          pool->cb_priv)) {
+  lock_buffer_pool(pool);
+  if (realloc_new_frame_buffer(cm)) {
+    unlock_buffer_pool(pool);
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate frame buffer");
   }
+  unlock_buffer_pool(pool);
 
   pool->frame_bufs[cm->new_fb_idx].released = 0;
   pool->frame_bufs[cm->new_fb_idx].buf.subsampling_x = cm->subsampling_x;
@@ -1603,18 +1634,13 @@ static void setup_frame_size_with_refs(VP9_COMMON *cm,
   resize_context_buffers(cm, width, height);
   setup_render_size(cm, rb);
 
-  if (vpx_realloc_frame_buffer(
-          get_frame_new_buffer(cm), cm->width, cm->height, cm->subsampling_x,
-          cm->subsampling_y,
-#if CONFIG_VP9_HIGHBITDEPTH
-          cm->use_highbitdepth,
-#endif
-          VP9_DEC_BORDER_IN_PIXELS, cm->byte_alignment,
-          &pool->frame_bufs[cm->new_fb_idx].raw_frame_buffer, pool->get_fb_cb,
-          pool->cb_priv)) {
+  lock_buffer_pool(pool);
+  if (realloc_new_frame_buffer(cm)) {
+    unlock_buffer_pool(pool);
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate frame buffer");
   }
+  unlock_buffer_pool(pool);
 
   pool->frame_bufs[cm->new_fb_idx].released = 0;
   pool->frame_bufs[cm->new_fb_idx].buf.subsampling_x = cm->subsampling_x;
@@ -1696,34 +1722,26 @@ static void get_tile_buffers(VP9Decoder *pbi, const uint8_t *data,
   }
 }
 
-static void map_write(RowMTWorkerData *const row_mt_worker_data, int map_idx,
-                      int sync_idx) {
+// The superblocks of a job are reconstructed from left to right, so the
+// progress of a job is the column of its last reconstructed superblock.
+static void recon_sync_write(RowMTWorkerData *const row_mt_worker_data,
+                             int sb_col, int sync_idx) {
 #if CONFIG_MULTITHREAD
-  pthread_mutex_lock(&row_mt_worker_data->recon_sync_mutex[sync_idx]);
-  row_mt_worker_data->recon_map[map_idx] = 1;
-  pthread_cond_signal(&row_mt_worker_data->recon_sync_cond[sync_idx]);
-  pthread_mutex_unlock(&row_mt_worker_data->recon_sync_mutex[sync_idx]);
+  vp9_row_progress_set(&row_mt_worker_data->recon_progress[sync_idx], sb_col);
 #else
   (void)row_mt_worker_data;
-  (void)map_idx;
+  (void)sb_col;
   (void)sync_idx;
 #endif  // CONFIG_MULTITHREAD
 }
 
-static void map_read(RowMTWorkerData *const row_mt_worker_data, int map_idx,
-                     int sync_idx) {
+static void recon_sync_read(RowMTWorkerData *const row_mt_worker_data,
+                            int sb_col, int sync_idx) {
 #if CONFIG_MULTITHREAD
-  volatile int8_t *map = row_mt_worker_data->recon_map + map_idx;
-  pthread_mutex_t *const mutex =
-      &row_mt_worker_data->recon_sync_mutex[sync_idx];
-  pthread_mutex_lock(mutex);
-  while (!(*map)) {
-    pthread_cond_wait(&row_mt_worker_data->recon_sync_cond[sync_idx], mutex);
-  }
-  pthread_mutex_unlock(mutex);
+  vp9_row_progress_wait(&row_mt_worker_data->recon_progress[sync_idx], sb_col);
 #else
   (void)row_mt_worker_data;
-  (void)map_idx;
+  (void)sb_col;
   (void)sync_idx;
 #endif  // CONFIG_MULTITHREAD
 }
@@ -1766,6 +1784,103 @@ static void vp9_tile_done(VP9Decoder *pbi) {
 #endif
 }
 
+// Adapts the frame context to the symbol counts of the parsed frame.
+static void adapt_frame_context(VP9_COMMON *cm) {
+  if (!cm->error_resilient_mode && !cm->frame_parallel_decoding_mode) {
+    vp9_adapt_coef_probs(cm);
+
+    if (!frame_is_intra_only(cm)) {
+      vp9_adapt_mode_probs(cm);
+      vp9_adapt_mv_probs(cm, cm->allow_high_precision_mv);
+    }
+  }
+}
+
+// In frame parallel decode, records that count more tiles of SB row sb_row
+// are final, and broadcasts the rows that are final from the top of the frame
+// so the next frame can reconstruct while this one is still being decoded.
+static void row_mt_sb_row_done(VP9Decoder *pbi, int sb_row, int count) {
+#if CONFIG_MULTITHREAD
+  VP9_COMMON *const cm = &pbi->common;
+  RowMTWorkerData *const row_mt_worker_data = pbi->row_mt_worker_data;
+  const int sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  int rows_final = 0;
+
+  if (!pbi->frame_parallel_decode) return;
+
+  pthread_mutex_lock(&row_mt_worker_data->recon_done_mutex);
+  row_mt_worker_data->sb_row_done[sb_row] += count;
+  if (sb_row == row_mt_worker_data->sb_rows_final) {
+    int *const final_rows = &row_mt_worker_data->sb_rows_final;
+    while (*final_rows < sb_rows &&
+           row_mt_worker_data->sb_row_done[*final_rows] >= tile_cols) {
+      ++*final_rows;
+    }
+    rows_final = *final_rows;
+  }
+  pthread_mutex_unlock(&row_mt_worker_data->recon_done_mutex);
+
+  // The whole frame is broadcast once all of its jobs are done.
+  if (rows_final > 0 && rows_final < sb_rows) {
+    // Filtering the next SB row may still modify up to 16 pixel rows above
+    // its top edge (chroma counted in luma rows).
+    const int lf_rows = (cm->lf.filter_level && !cm->skip_loop_filter) ? 16 : 0;
+    vp9_frameworker_broadcast(
+        pbi->cur_buf,
+        (rows_final << (MI_BLOCK_SIZE_LOG2 + MI_SIZE_LOG2)) - lf_rows);
+  }
+#else
+  (void)pbi;
+  (void)sb_row;
+  (void)count;
+#endif  // CONFIG_MULTITHREAD
+}
+
+// In frame parallel decode, the modes, motion vectors and symbol counts of the
+// frame are final once its last tile has been parsed. Hand them to the next
+// frame so that its parse jobs overlap the reconstruction and loop filtering
+// jobs still in flight for this one.
+static void row_mt_tile_parsed(VP9Decoder *pbi) {
+#if CONFIG_MULTITHREAD
+  VP9_COMMON *const cm = &pbi->common;
+  RowMTWorkerData *const row_mt_worker_data = pbi->row_mt_worker_data;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  int all_parsed;
+
+  if (!pbi->frame_parallel_decode) return;
+
+  pthread_mutex_lock(&row_mt_worker_data->recon_done_mutex);
+  all_parsed = ++row_mt_worker_data->num_tiles_parsed == tile_cols;
+  pthread_mutex_unlock(&row_mt_worker_data->recon_done_mutex);
+  if (!all_parsed) return;
+
+  vp9_frameworker_broadcast_parsed(pbi->cur_buf);
+
+  // Otherwise the context was ready right after the frame header.
+  if (cm->refresh_frame_context && !cm->frame_parallel_decoding_mode) {
+    VPxWorker *const worker = pbi->frame_worker_owner;
+    FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+    int col;
+
+    for (col = 0; col < tile_cols; ++col) {
+      TileWorkerData *const tile_data = &pbi->tile_worker_data[col];
+      vp9_accumulate_frame_counts(&cm->counts, &tile_data->counts, 1);
+    }
+    adapt_frame_context(cm);
+    cm->frame_contexts[cm->frame_context_idx] = *cm->fc;
+    row_mt_worker_data->context_published = 1;
+
+    vp9_frameworker_lock_stats(worker);
+    frame_worker_data->frame_context_ready = 1;
+    vp9_frameworker_signal_stats(worker);
+    vp9_frameworker_unlock_stats(worker);
+  }
+#else
+  (void)pbi;
+#endif  // CONFIG_MULTITHREAD
+}
+
 static void vp9_jobq_alloc(VP9Decoder *pbi) {
   VP9_COMMON *const cm = &pbi->common;
   RowMTWorkerData *const row_mt_worker_data = pbi->row_mt_worker_data;
@@ -1790,7 +1905,6 @@ static void recon_tile_row(TileWorkerData *tile_data, VP9Decoder *pbi,
   RowMTWorkerData *const row_mt_worker_data = pbi->row_mt_worker_data;
   const int tile_cols = 1 << cm->log2_tile_cols;
   const int aligned_cols = mi_cols_aligned_to_sb(cm->mi_cols);
-  const int sb_cols = aligned_cols >> MI_BLOCK_SIZE_LOG2;
   const int cur_sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
   int mi_col_start = tile_data->xd.tile.mi_col_start;
   int mi_col_end = tile_data->xd.tile.mi_col_end;
@@ -1805,8 +1919,8 @@ static void recon_tile_row(TileWorkerData *tile_data, VP9Decoder *pbi,
 
     // Top Dependency
     if (cur_sb_row) {
-      map_read(row_mt_worker_data, ((cur_sb_row - 1) * sb_cols) + c,
-               ((cur_sb_row - 1) * tile_cols) + cur_tile_col);
+      recon_sync_read(row_mt_worker_data, c,
+                      ((cur_sb_row - 1) * tile_cols) + cur_tile_col);
     }
 
     for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
@@ -1843,9 +1957,11 @@ static void recon_tile_row(TileWorkerData *tile_data, VP9Decoder *pbi,
         }
       }
     }
-    map_write(row_mt_worker_data, (cur_sb_row * sb_cols) + c,
-              (cur_sb_row * tile_cols) + cur_tile_col);
+    recon_sync_write(row_mt_worker_data, c,
+                     (cur_sb_row * tile_cols) + cur_tile_col);
   }
+  if (!cm->lf.filter_level || cm->skip_loop_filter)
+    row_mt_sb_row_done(pbi, cur_sb_row, 1);
 }
 
 static void parse_tile_row(TileWorkerData *tile_data, VP9Decoder *pbi,
@@ -1890,25 +2006,68 @@ static void parse_tile_row(TileWorkerData *tile_data, VP9Decoder *pbi,
   }
 }
 
+// Adds 'wall_us' of the time of 'section' to 'stage', with the same share of
+// its CPU time.
+static INLINE void add_time_share(vpx_stage_time_t *stage,
+                                  const vpx_stage_time_t *section,
+                                  int64_t wall_us) {
+  stage->wall_us += wall_us;
+  if (section->wall_us > 0)
+    stage->cpu_us += section->cpu_us * wall_us / section->wall_us;
+}
+
+static INLINE void add_stage_time(vpx_stage_time_t *stage,
+                                  const vpx_stage_time_t *time) {
+  stage->wall_us += time->wall_us;
+  stage->cpu_us += time->cpu_us;
+}
+
+// Adds the times of decoder thread 'worker' to the frame statistics.
+static void add_worker_times(VP9Decoder *pbi, int worker,
+                             const DecodeTimes *times) {
+  vpx_decode_stats_t *const stats = &pbi->stats;
+  add_stage_time(&stats->parse, &times->parse);
+  add_stage_time(&stats->recon, &times->recon);
+  add_stage_time(&stats->lf, &times->lf);
+  if (worker < VPX_DECODE_STATS_MAX_WORKERS) {
+    stats->worker_busy_us[worker] += times->busy_us;
+    stats->worker_idle_us[worker] += times->idle_us;
+    stats->num_workers = VPXMAX(stats->num_workers, worker + 1);
+  }
+}
+
+// Waits for the next job, counting the wait as idle time of the thread.
+static int dequeue_job(JobQueueRowMt *jobq, Job *job, DecodeTimes *times) {
+  struct vpx_usec_timer timer;
+  int done;
+  vpx_usec_timer_start(&timer);
+  done = vp9_jobq_dequeue(jobq, job, sizeof(*job), 1);
+  vpx_usec_timer_mark(&timer);
+  times->idle_us += vpx_usec_timer_elapsed(&timer);
+  return done;
+}
+
 static int row_decode_worker_hook(void *arg1, void *arg2) {
   ThreadData *const thread_data = (ThreadData *)arg1;
   uint8_t **data_end = (uint8_t **)arg2;
   VP9Decoder *const pbi = thread_data->pbi;
   VP9_COMMON *const cm = &pbi->common;
   RowMTWorkerData *const row_mt_worker_data = pbi->row_mt_worker_data;
-  const int aligned_cols = mi_cols_aligned_to_sb(cm->mi_cols);
   const int aligned_rows = mi_cols_aligned_to_sb(cm->mi_rows);
   const int sb_rows = aligned_rows >> MI_BLOCK_SIZE_LOG2;
   const int tile_cols = 1 << cm->log2_tile_cols;
   Job job;
   LFWorkerData *lf_data = thread_data->lf_data;
   VP9LfSync *lf_sync = thread_data->lf_sync;
+  DecodeTimes *const times = &thread_data->times;
+  DecodeTimer timer;
   volatile int corrupted = 0;
   TileWorkerData *volatile tile_data_recon = NULL;
 
-  while (!vp9_jobq_dequeue(&row_mt_worker_data->jobq, &job, sizeof(job), 1)) {
+  while (!dequeue_job(&row_mt_worker_data->jobq, &job, times)) {
     int mi_col;
     const int mi_row = job.row_num;
+    decode_timer_start(&timer);
 
     if (job.job_type == LPF_JOB) {
       lf_data->start = mi_row;
@@ -1917,6 +2076,7 @@ static int row_decode_worker_hook(void *arg1, void *arg2) {
       if (cm->lf.filter_level && !cm->skip_loop_filter &&
           mi_row < cm->mi_rows) {
         vp9_loopfilter_job(lf_data, lf_sync);
+        row_mt_sb_row_done(pbi, mi_row >> MI_BLOCK_SIZE_LOG2, tile_cols);
       }
     } else if (job.job_type == RECON_JOB) {
       const int cur_sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
@@ -1933,14 +2093,13 @@ static int row_decode_worker_hook(void *arg1, void *arg2) {
       mi_col_end = tile_data_recon->xd.tile.mi_col_end;
 
       if (setjmp(tile_data_recon->error_info.jmp)) {
-        const int sb_cols = aligned_cols >> MI_BLOCK_SIZE_LOG2;
         tile_data_recon->error_info.setjmp = 0;
         corrupted = 1;
         for (mi_col = mi_col_start; mi_col < mi_col_end;
              mi_col += MI_BLOCK_SIZE) {
           const int c = mi_col >> MI_BLOCK_SIZE_LOG2;
-          map_write(row_mt_worker_data, (cur_sb_row * sb_cols) + c,
-                    (cur_sb_row * tile_cols) + job.tile_col);
+          recon_sync_write(row_mt_worker_data, c,
+                           (cur_sb_row * tile_cols) + job.tile_col);
         }
         if (is_last_row) {
           vp9_tile_done(pbi);
@@ -2003,8 +2162,15 @@ static int row_decode_worker_hook(void *arg1, void *arg2) {
         parse_job.job_type = PARSE_JOB;
         vp9_jobq_queue(&row_mt_worker_data->jobq, &parse_job,
                        sizeof(parse_job));
+      } else {
+        row_mt_tile_parsed(pbi);
       }
     }
+
+    times->busy_us += decode_timer_add(
+        &timer, job.job_type == PARSE_JOB
+                    ? &times->parse
+                    : job.job_type == RECON_JOB ? &times->recon : &times->lf);
   }
 
   vpx_free(tile_data_recon);
@@ -2022,12 +2188,15 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
   int tile_row, tile_col;
   int mi_row, mi_col;
   TileWorkerData *tile_data = NULL;
+  DecodeTimer row_timer;
+  struct vpx_usec_timer block_timer;
 
   if (cm->lf.filter_level && !cm->skip_loop_filter &&
       pbi->lf_worker.data1 == NULL) {
     CHECK_MEM_ERROR(cm, pbi->lf_worker.data1,
                     vpx_memalign(32, sizeof(LFWorkerData)));
     pbi->lf_worker.hook = vp9_loop_filter_worker;
+    pbi->lf_worker.pool = pbi->thread_pool;
     if (pbi->max_threads > 1 && !winterface->reset(&pbi->lf_worker)) {
       vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
                          "Loop filter thread creation failed");
@@ -2080,6 +2249,16 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
     vp9_tile_set_row(&tile, cm, tile_row);
     for (mi_row = tile.mi_row_start; mi_row < tile.mi_row_end;
          mi_row += MI_BLOCK_SIZE) {
+      // Wall clock time of the row spent on reconstruction, timed per
+      // superblock.
+      int64_t recon_us = 0;
+      vpx_stage_time_t row_time = { 0, 0 };
+      // The co-located motion vectors of the previous frame must be decoded.
+      if (pbi->frame_parallel_decode && cm->use_prev_frame_mvs) {
+        vp9_frameworker_wait(cm->prev_frame,
+                             (mi_row + MI_BLOCK_SIZE) << MI_SIZE_LOG2);
+      }
+      decode_timer_start(&row_timer);
       for (tile_col = 0; tile_col < tile_cols; ++tile_col) {
         const int col =
             pbi->inv_tile_order ? tile_cols - tile_col - 1 : tile_col;
@@ -2107,8 +2286,11 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
                   row_mt_worker_data->dqcoeff[plane];
             }
             tile_data->xd.partition = row_mt_worker_data->partition;
+            vpx_usec_timer_start(&block_timer);
             process_partition(tile_data, pbi, mi_row, mi_col, BLOCK_64X64, 4,
                               RECON, recon_block);
+            vpx_usec_timer_mark(&block_timer);
+            recon_us += vpx_usec_timer_elapsed(&block_timer);
           } else {
             decode_partition(tile_data, pbi, mi_row, mi_col, BLOCK_64X64, 4);
           }
@@ -2118,6 +2300,12 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
           vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME,
                              "Failed to decode tile data");
       }
+      // The CPU time of the row is only read once, and shared out between the
+      // stages by their wall clock time.
+      decode_timer_add(&row_timer, &row_time);
+      add_time_share(&pbi->stats.recon, &row_time, recon_us);
+      add_time_share(&pbi->stats.parse, &row_time,
+                     VPXMAX(row_time.wall_us - recon_us, 0));
       // Loopfilter one row.
       if (cm->lf.filter_level && !cm->skip_loop_filter) {
         const int lf_start = mi_row - MI_BLOCK_SIZE;
@@ -2136,7 +2324,16 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
           winterface->launch(&pbi->lf_worker);
         } else {
           winterface->execute(&pbi->lf_worker);
+          // Filtering the next row may still modify up to 16 pixel rows above
+          // its top edge (chroma counted in luma rows).
+          if (pbi->frame_parallel_decode) {
+            vp9_frameworker_broadcast(pbi->cur_buf,
+                                      (mi_row << MI_SIZE_LOG2) - 16);
+          }
         }
+      } else if (pbi->frame_parallel_decode) {
+        vp9_frameworker_broadcast(pbi->cur_buf,
+                                  (mi_row + MI_BLOCK_SIZE) << MI_SIZE_LOG2);
       }
     }
   }
@@ -2148,8 +2345,13 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
     lf_data->start = lf_data->stop;
     lf_data->stop = cm->mi_rows;
     winterface->execute(&pbi->lf_worker);
+    pbi->stats.lf.wall_us += lf_data->wall_us;
+    pbi->stats.lf.cpu_us += lf_data->cpu_us;
   }
 
+  if (pbi->frame_parallel_decode)
+    vp9_frameworker_broadcast(pbi->cur_buf, INT_MAX);
+
   // Get last tile data.
   tile_data = pbi->tile_worker_data + tile_cols * tile_rows - 1;
 
@@ -2189,6 +2391,8 @@ static int tile_worker_hook(void *arg1, void *arg2) {
 
   LFWorkerData *lf_data = tile_data->lf_data;
   VP9LfSync *lf_sync = tile_data->lf_sync;
+  DecodeTimes *const times = &tile_data->times;
+  DecodeTimer timer;
 
   volatile int mi_row = 0;
   volatile int n = tile_data->buf_start;
@@ -2208,6 +2412,7 @@ static int tile_worker_hook(void *arg1, void *arg2) {
   }
 
   tile_data->xd.corrupted = 0;
+  decode_timer_start(&timer);
 
   do {
     int mi_col;
@@ -2249,6 +2454,7 @@ static int tile_worker_hook(void *arg1, void *arg2) {
       bit_reader_end = vpx_reader_find_end(&tile_data->bit_reader);
     }
   } while (!tile_data->xd.corrupted && ++n <= tile_data->buf_end);
+  times->busy_us += decode_timer_add(&timer, &times->parse);
 
   if (pbi->lpf_mt_opt && n < tile_data->buf_end && cm->lf.filter_level &&
       !cm->skip_loop_filter) {
@@ -2262,7 +2468,9 @@ static int tile_worker_hook(void *arg1, void *arg2) {
 
   if (pbi->lpf_mt_opt && !tile_data->xd.corrupted && cm->lf.filter_level &&
       !cm->skip_loop_filter) {
+    decode_timer_start(&timer);
     vp9_loopfilter_rows(lf_data, lf_sync);
+    times->busy_us += decode_timer_add(&timer, &times->lf);
   }
 
   tile_data->data_end = bit_reader_end;
@@ -2292,6 +2500,7 @@ static INLINE void init_mt(VP9Decoder *pbi) {
       ++pbi->num_tile_workers;
 
       winterface->init(worker);
+      worker->pool = pbi->thread_pool;
       if (n < num_threads - 1 && !winterface->reset(worker)) {
         vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
                            "Tile decoder thread creation failed");
@@ -2330,7 +2539,6 @@ static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
   int col;
   int corrupted = 0;
   const int sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
-  const int sb_cols = mi_cols_aligned_to_sb(cm->mi_cols) >> MI_BLOCK_SIZE_LOG2;
   VP9LfSync *lf_row_sync = &pbi->lf_row_sync;
   YV12_BUFFER_CONFIG *const new_fb = get_frame_new_buffer(cm);
 
@@ -2338,8 +2546,11 @@ static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
   assert(tile_rows == 1);
   (void)tile_rows;
 
-  memset(row_mt_worker_data->recon_map, 0,
-         sb_rows * sb_cols * sizeof(*row_mt_worker_data->recon_map));
+#if CONFIG_MULTITHREAD
+  for (i = 0; i < sb_rows * tile_cols; ++i) {
+    vp9_row_progress_reset(&row_mt_worker_data->recon_progress[i], -1);
+  }
+#endif  // CONFIG_MULTITHREAD
 
   init_mt(pbi);
 
@@ -2357,6 +2568,7 @@ static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
     }
 
     thread_data->pbi = pbi;
+    vp9_zero(thread_data->times);
 
     worker->hook = row_decode_worker_hook;
     worker->data1 = thread_data;
@@ -2374,6 +2586,16 @@ static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
   vp9_jobq_reset(&row_mt_worker_data->jobq);
   row_mt_worker_data->num_tiles_done = 0;
   row_mt_worker_data->data_end = NULL;
+  row_mt_worker_data->num_tiles_parsed = 0;
+  row_mt_worker_data->context_published = 0;
+  row_mt_worker_data->sb_rows_final = 0;
+  memset(row_mt_worker_data->sb_row_done, 0,
+         sb_rows * sizeof(*row_mt_worker_data->sb_row_done));
+
+  // The parse jobs read the co-located motion vectors of the previous frame,
+  // which may still be decoded by another frame worker.
+  if (pbi->frame_parallel_decode && cm->use_prev_frame_mvs)
+    vp9_frameworker_wait_parsed(cm->prev_frame);
 
   // Load tile data into tile_buffers
   get_tile_buffers(pbi, data, data_end, tile_cols, tile_rows,
@@ -2415,6 +2637,10 @@ static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
     corrupted |= !winterface->sync(worker);
   }
 
+  for (i = 0; i < num_workers; ++i) {
+    add_worker_times(pbi, i, &row_mt_worker_data->thread_data[i].times);
+  }
+
   pbi->mb.corrupted = corrupted;
 
   {
@@ -2424,13 +2650,17 @@ static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
   }
 
   // Accumulate thread frame counts.
-  if (!cm->frame_parallel_decoding_mode) {
+  if (!cm->frame_parallel_decoding_mode &&
+      !row_mt_worker_data->context_published) {
     for (i = 0; i < tile_cols; ++i) {
       TileWorkerData *const tile_data = &pbi->tile_worker_data[i];
       vp9_accumulate_frame_counts(&cm->counts, &tile_data->counts, 1);
     }
   }
 
+  if (pbi->frame_parallel_decode)
+    vp9_frameworker_broadcast(pbi->cur_buf, INT_MAX);
+
   return row_mt_worker_data->data_end;
 }
 
@@ -2444,6 +2674,7 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi, const uint8_t *data,
   const int tile_cols = 1 << cm->log2_tile_cols;
   const int tile_rows = 1 << cm->log2_tile_rows;
   const int num_workers = VPXMIN(pbi->max_threads, tile_cols);
+  struct vpx_usec_timer timer;
   int n;
 
   assert(tile_cols <= (1 << 6));
@@ -2469,6 +2700,7 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi, const uint8_t *data,
     tile_data->xd = pbi->mb;
     tile_data->xd.counts =
         cm->frame_parallel_decoding_mode ? NULL : &tile_data->counts;
+    vp9_zero(tile_data->times);
     worker->hook = tile_worker_hook;
     worker->data1 = tile_data;
     worker->data2 = pbi;
@@ -2520,6 +2752,7 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi, const uint8_t *data,
     const int remain = tile_cols % num_workers;
     int buf_start = 0;
 
+    vpx_usec_timer_start(&timer);
     for (n = 0; n < num_workers; ++n) {
       const int count = base + (remain + n) / num_workers;
       VPxWorker *const worker = &pbi->tile_workers[n];
@@ -2549,6 +2782,16 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi, const uint8_t *data,
       pbi->mb.corrupted |= !winterface->sync(worker);
       if (!bit_reader_end) bit_reader_end = tile_data->data_end;
     }
+    vpx_usec_timer_mark(&timer);
+
+    // A worker is idle for the part of the decode it is not busy with.
+    for (n = 0; n < num_workers; ++n) {
+      DecodeTimes *const times =
+          &((TileWorkerData *)pbi->tile_workers[n].data1)->times;
+      times->idle_us =
+          VPXMAX(vpx_usec_timer_elapsed(&timer) - times->busy_us, 0);
+      add_worker_times(pbi, n, times);
+    }
   }
 
   // Accumulate thread frame counts.
@@ -2564,6 +2807,37 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi, const uint8_t *data,
   return bit_reader_end;
 }
 
+// Filters the frame with the tile decoding workers and adds their times to
+// the decode statistics.
+static void loop_filter_frame_mt(VP9Decoder *pbi, YV12_BUFFER_CONFIG *new_fb) {
+  VP9_COMMON *const cm = &pbi->common;
+  VP9LfSync *const lf_sync = &pbi->lf_row_sync;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  struct vpx_usec_timer timer;
+  int i;
+
+  vpx_usec_timer_start(&timer);
+  vp9_loop_filter_frame_mt(new_fb, cm, pbi->mb.plane, cm->lf.filter_level, 0,
+                           0, pbi->tile_workers, pbi->num_tile_workers,
+                           lf_sync);
+  vpx_usec_timer_mark(&timer);
+  if (!cm->lf.filter_level) return;
+
+  // The filter workers time themselves. The tile decoding workers are idle
+  // for the rest of the time the frame is being filtered.
+  for (i = 0; i < VPXMIN(pbi->num_tile_workers, tile_cols); ++i) {
+    DecodeTimes times;
+    vp9_zero(times);
+    if (i < lf_sync->num_active_workers) {
+      times.lf.wall_us = lf_sync->lfdata[i].wall_us;
+      times.lf.cpu_us = lf_sync->lfdata[i].cpu_us;
+      times.busy_us = times.lf.wall_us;
+    }
+    times.idle_us = VPXMAX(vpx_usec_timer_elapsed(&timer) - times.busy_us, 0);
+    add_worker_times(pbi, i, &times);
+  }
+}
+
 static void error_handler(void *data) {
   VP9_COMMON *const cm = (VP9_COMMON *)data;
   vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME, "Truncated packet");
@@ -2629,6 +2903,22 @@ static INLINE void flush_all_fb_on_key(VP9_COMMON *cm) {
   }
 }
 
+// Frame parallel counterpart of flush_all_fb_on_key(): the other buffers may
+// still be in use by the other frame workers, so only the references held by
+// the reference map are dropped.
+static void release_ref_frame_map(VP9_COMMON *cm) {
+  BufferPool *const pool = cm->buffer_pool;
+  RefCntBuffer *const frame_bufs = pool->frame_bufs;
+  int i;
+  lock_buffer_pool(pool);
+  for (i = 0; i < REF_FRAMES; ++i) {
+    decrease_ref_count(cm->ref_frame_map[i], frame_bufs, pool);
+    cm->ref_frame_map[i] = -1;
+    cm->next_ref_frame_map[i] = -1;
+  }
+  unlock_buffer_pool(pool);
+}
+
 static size_t read_uncompressed_header(VP9Decoder *pbi,
                                        struct vpx_read_bit_buffer *rb) {
   VP9_COMMON *const cm = &pbi->common;
@@ -2659,13 +2949,16 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
   if (cm->show_existing_frame) {
     // Show an existing frame directly.
     const int frame_to_show = cm->ref_frame_map[vpx_rb_read_literal(rb, 3)];
+    lock_buffer_pool(pool);
     if (frame_to_show < 0 || frame_bufs[frame_to_show].ref_count < 1) {
+      unlock_buffer_pool(pool);
       vpx_internal_error(&cm->error, VPX_CODEC_UNSUP_BITSTREAM,
                          "Buffer %d does not contain a decoded frame",
                          frame_to_show);
     }
 
     ref_cnt_fb(frame_bufs, &cm->new_fb_idx, frame_to_show);
+    unlock_buffer_pool(pool);
     pbi->refresh_frame_flags = 0;
     cm->lf.filter_level = 0;
     cm->show_frame = 1;
@@ -2692,8 +2985,12 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
 
     setup_frame_size(cm, rb);
     if (pbi->need_resync) {
-      memset(&cm->ref_frame_map, -1, sizeof(cm->ref_frame_map));
-      flush_all_fb_on_key(cm);
+      if (pbi->frame_parallel_decode) {
+        release_ref_frame_map(cm);
+      } else {
+        memset(&cm->ref_frame_map, -1, sizeof(cm->ref_frame_map));
+        flush_all_fb_on_key(cm);
+      }
       pbi->need_resync = 0;
     }
   } else {
@@ -2725,7 +3022,11 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
       pbi->refresh_frame_flags = vpx_rb_read_literal(rb, REF_FRAMES);
       setup_frame_size(cm, rb);
       if (pbi->need_resync) {
-        memset(&cm->ref_frame_map, -1, sizeof(cm->ref_frame_map));
+        if (pbi->frame_parallel_decode) {
+          release_ref_frame_map(cm);
+        } else {
+          memset(&cm->ref_frame_map, -1, sizeof(cm->ref_frame_map));
+        }
         pbi->need_resync = 0;
       }
     } else if (pbi->need_resync != 1) { /* Skip if need resync */
@@ -2787,6 +3088,7 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
   cm->frame_context_idx = vpx_rb_read_literal(rb, FRAME_CONTEXTS_LOG2);
 
   // Generate next_ref_frame_map.
+  lock_buffer_pool(pool);
   for (mask = pbi->refresh_frame_flags; mask; mask >>= 1) {
     if (mask & 1) {
       cm->next_ref_frame_map[ref_index] = cm->new_fb_idx;
@@ -2806,6 +3108,7 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
     if (cm->ref_frame_map[ref_index] >= 0)
       ++frame_bufs[cm->ref_frame_map[ref_index]].ref_count;
   }
+  unlock_buffer_pool(pool);
   pbi->hold_ref_buf = 1;
 
   if (frame_is_intra_only(cm) || cm->error_resilient_mode)
@@ -2951,11 +3254,17 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
   struct vpx_read_bit_buffer rb;
   int context_updated = 0;
   uint8_t clear_data[MAX_VP9_HEADER_SIZE];
-  const size_t first_partition_size = read_uncompressed_header(
+  size_t first_partition_size;
+  int tile_rows, tile_cols;
+  YV12_BUFFER_CONFIG *new_fb;
+  DecodeTimer timer;
+
+  decode_timer_start(&timer);
+  first_partition_size = read_uncompressed_header(
       pbi, init_read_bit_buffer(pbi, &rb, data, data_end, clear_data));
-  const int tile_rows = 1 << cm->log2_tile_rows;
-  const int tile_cols = 1 << cm->log2_tile_cols;
-  YV12_BUFFER_CONFIG *const new_fb = get_frame_new_buffer(cm);
+  tile_rows = 1 << cm->log2_tile_rows;
+  tile_cols = 1 << cm->log2_tile_cols;
+  new_fb = get_frame_new_buffer(cm);
 #if CONFIG_BITSTREAM_DEBUG || CONFIG_MISMATCH_DEBUG
   bitstream_queue_set_frame_read(cm->current_video_frame * 2 + cm->show_frame);
 #endif
@@ -2967,6 +3276,7 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
   if (!first_partition_size) {
     // showing a frame directly
     *p_data_end = data + (cm->profile <= PROFILE_2 ? 1 : 2);
+    decode_timer_add(&timer, &pbi->stats.header);
     return;
   }
 
@@ -2996,6 +3306,23 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
   if (cm->lf.filter_level && !cm->skip_loop_filter) {
     vp9_loop_filter_frame_init(cm, cm->lf.filter_level);
   }
+  decode_timer_add(&timer, &pbi->stats.header);
+
+  // If encoded in frame parallel mode, frame context is ready after decoding
+  // the frame header.
+  if (pbi->frame_parallel_decode &&
+      (!cm->refresh_frame_context || cm->frame_parallel_decoding_mode)) {
+    VPxWorker *const worker = pbi->frame_worker_owner;
+    FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+    if (cm->refresh_frame_context) {
+      context_updated = 1;
+      cm->frame_contexts[cm->frame_context_idx] = *cm->fc;
+    }
+    vp9_frameworker_lock_stats(worker);
+    frame_worker_data->frame_context_ready = 1;
+    vp9_frameworker_signal_stats(worker);
+    vp9_frameworker_unlock_stats(worker);
+  }
 
   if (pbi->tile_worker_data == NULL ||
       (tile_cols * tile_rows) != pbi->total_tiles) {
@@ -3015,6 +3342,9 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
     if (pbi->row_mt == 1) {
       *p_data_end =
           decode_tiles_row_wise_mt(pbi, data + first_partition_size, data_end);
+      // In frame parallel decode the context may have been adapted and
+      // stored as soon as the frame was parsed.
+      context_updated |= pbi->row_mt_worker_data->context_published;
     } else {
       // Multi-threaded tile decoder
       *p_data_end = decode_tiles_mt(pbi, data + first_partition_size, data_end);
@@ -3023,9 +3353,7 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
           if (!cm->skip_loop_filter) {
             // If multiple threads are used to decode tiles, then we use those
             // threads to do parallel loopfiltering.
-            vp9_loop_filter_frame_mt(
-                new_fb, cm, pbi->mb.plane, cm->lf.filter_level, 0, 0,
-                pbi->tile_workers, pbi->num_tile_workers, &pbi->lf_row_sync);
+            loop_filter_frame_mt(pbi, new_fb);
           }
         } else {
           vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME,
@@ -3038,14 +3366,7 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
   }
 
   if (!xd->corrupted) {
-    if (!cm->error_resilient_mode && !cm->frame_parallel_decoding_mode) {
-      vp9_adapt_coef_probs(cm);
-
-      if (!frame_is_intra_only(cm)) {
-        vp9_adapt_mode_probs(cm);
-        vp9_adapt_mv_probs(cm, cm->allow_high_precision_mv);
-      }
-    }
+    if (!context_updated) adapt_frame_context(cm);
   } else {
     vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME,
                        "Decode failed. Frame data is corrupted.");
@@ -35,6 +35,7 @@
 #include "vp9/decoder/vp9_decodeframe.h"
 #include "vp9/decoder/vp9_decoder.h"
 #include "vp9/decoder/vp9_detokenize.h"
+#include "vp9/decoder/vp9_dthread.h"
 
 static void initialize_dec(void) {
   static volatile int init_done = 0;
@@ -66,20 +67,11 @@ void vp9_dec_alloc_row_mt_mem(RowMTWorkerData *row_mt_worker_data,
   {
     int i;
     CHECK_MEM_ERROR(
-        cm, row_mt_worker_data->recon_sync_mutex,
-        vpx_malloc(sizeof(*row_mt_worker_data->recon_sync_mutex) * num_jobs));
-    if (row_mt_worker_data->recon_sync_mutex) {
+        cm, row_mt_worker_data->recon_progress,
+        vpx_malloc(sizeof(*row_mt_worker_data->recon_progress) * num_jobs));
+    if (row_mt_worker_data->recon_progress) {
       for (i = 0; i < num_jobs; ++i) {
-        pthread_mutex_init(&row_mt_worker_data->recon_sync_mutex[i], NULL);
-      }
-    }
-
-    CHECK_MEM_ERROR(
-        cm, row_mt_worker_data->recon_sync_cond,
-        vpx_malloc(sizeof(*row_mt_worker_data->recon_sync_cond) * num_jobs));
-    if (row_mt_worker_data->recon_sync_cond) {
-      for (i = 0; i < num_jobs; ++i) {
-        pthread_cond_init(&row_mt_worker_data->recon_sync_cond[i], NULL);
+        vp9_row_progress_init(&row_mt_worker_data->recon_progress[i]);
       }
     }
   }
@@ -96,8 +88,9 @@ void vp9_dec_alloc_row_mt_mem(RowMTWorkerData *row_mt_worker_data,
   CHECK_MEM_ERROR(cm, row_mt_worker_data->partition,
                   vpx_calloc(num_sbs * PARTITIONS_PER_SB,
                              sizeof(*row_mt_worker_data->partition)));
-  CHECK_MEM_ERROR(cm, row_mt_worker_data->recon_map,
-                  vpx_calloc(num_sbs, sizeof(*row_mt_worker_data->recon_map)));
+  CHECK_MEM_ERROR(
+      cm, row_mt_worker_data->sb_row_done,
+      vpx_calloc(num_jobs, sizeof(*row_mt_worker_data->sb_row_done)));
 
   // allocate memory for thread_data
   if (row_mt_worker_data->thread_data == NULL) {
@@ -113,19 +106,12 @@ void vp9_dec_free_row_mt_mem(RowMTWorkerData *row_mt_worker_data) {
     int plane;
 #if CONFIG_MULTITHREAD
     int i;
-    if (row_mt_worker_data->recon_sync_mutex != NULL) {
+    if (row_mt_worker_data->recon_progress != NULL) {
       for (i = 0; i < row_mt_worker_data->num_jobs; ++i) {
-        pthread_mutex_destroy(&row_mt_worker_data->recon_sync_mutex[i]);
+        vp9_row_progress_destroy(&row_mt_worker_data->recon_progress[i]);
       }
-      vpx_free(row_mt_worker_data->recon_sync_mutex);
-      row_mt_worker_data->recon_sync_mutex = NULL;
-    }
-    if (row_mt_worker_data->recon_sync_cond != NULL) {
-      for (i = 0; i < row_mt_worker_data->num_jobs; ++i) {
-        pthread_cond_destroy(&row_mt_worker_data->recon_sync_cond[i]);
-      }
-      vpx_free(row_mt_worker_data->recon_sync_cond);
-      row_mt_worker_data->recon_sync_cond = NULL;
+      vpx_free(row_mt_worker_data->recon_progress);
+      row_mt_worker_data->recon_progress = NULL;
     }
 #endif
     for (plane = 0; plane < 3; ++plane) {
@@ -136,8 +122,8 @@ void vp9_dec_free_row_mt_mem(RowMTWorkerData *row_mt_worker_data) {
     }
     vpx_free(row_mt_worker_data->partition);
     row_mt_worker_data->partition = NULL;
-    vpx_free(row_mt_worker_data->recon_map);
-    row_mt_worker_data->recon_map = NULL;
+    vpx_free(row_mt_worker_data->sb_row_done);
+    row_mt_worker_data->sb_row_done = NULL;
     vpx_free(row_mt_worker_data->thread_data);
     row_mt_worker_data->thread_data = NULL;
   }
@@ -337,6 +323,7 @@ static void swap_frame_buffers(VP9Decoder *pbi) {
   BufferPool *const pool = cm->buffer_pool;
   RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
 
+  lock_buffer_pool(pool);
   for (mask = pbi->refresh_frame_flags; mask; mask >>= 1) {
     const int old_idx = cm->ref_frame_map[ref_index];
     // Current thread releases the holding of reference frame.
@@ -356,11 +343,26 @@ static void swap_frame_buffers(VP9Decoder *pbi) {
     decrease_ref_count(old_idx, frame_bufs, pool);
     cm->ref_frame_map[ref_index] = cm->next_ref_frame_map[ref_index];
   }
+
+  if (pbi->frame_parallel_decode) {
+    // The new frame becomes prev_frame, whose motion vectors the next frame
+    // may read while another worker is already decoding into the pool.
+    if (!cm->show_existing_frame) {
+      if (cm->prev_frame != NULL) {
+        decrease_ref_count((int)(cm->prev_frame - frame_bufs), frame_bufs,
+                           pool);
+      }
+      ++frame_bufs[cm->new_fb_idx].ref_count;
+    }
+    // A shown frame stays referenced until the application has received it.
+    if (!cm->show_frame) --frame_bufs[cm->new_fb_idx].ref_count;
+  } else {
+    --frame_bufs[cm->new_fb_idx].ref_count;
+  }
+  unlock_buffer_pool(pool);
   pbi->hold_ref_buf = 0;
   cm->frame_to_show = get_frame_new_buffer(cm);
 
-  --frame_bufs[cm->new_fb_idx].ref_count;
-
   // Invalidate these references until the next frame starts.
   for (ref_index = 0; ref_index < 3; ref_index++)
     cm->frame_refs[ref_index].idx = -1;
@@ -383,6 +385,7 @@ static void release_fb_on_decoder_exit(VP9Decoder *pbi) {
   // Release all the reference buffers if worker thread is holding them.
   if (pbi->hold_ref_buf == 1) {
     int ref_index = 0, mask;
+    lock_buffer_pool(pool);
     for (mask = pbi->refresh_frame_flags; mask; mask >>= 1) {
       const int old_idx = cm->ref_frame_map[ref_index];
       // Current thread releases the holding of reference frame.
@@ -392,6 +395,10 @@ static void release_fb_on_decoder_exit(VP9Decoder *pbi) {
       if (mask & 1) {
         decrease_ref_count(old_idx, frame_bufs, pool);
       }
+      // In frame parallel decode the next frame may already have continued
+      // from next_ref_frame_map, so the reference map has to follow it.
+      if (pbi->frame_parallel_decode)
+        cm->ref_frame_map[ref_index] = cm->next_ref_frame_map[ref_index];
       ++ref_index;
     }
 
@@ -399,7 +406,10 @@ static void release_fb_on_decoder_exit(VP9Decoder *pbi) {
     for (; ref_index < REF_FRAMES && !cm->show_existing_frame; ++ref_index) {
       const int old_idx = cm->ref_frame_map[ref_index];
       decrease_ref_count(old_idx, frame_bufs, pool);
+      if (pbi->frame_parallel_decode)
+        cm->ref_frame_map[ref_index] = cm->next_ref_frame_map[ref_index];
     }
+    unlock_buffer_pool(pool);
     pbi->hold_ref_buf = 0;
   }
 }
@@ -431,6 +441,7 @@ int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
   pbi->ready_for_new_data = 0;
 
   // Check if the previous frame was a frame without any references to it.
+  lock_buffer_pool(pool);
   if (cm->new_fb_idx >= 0 && frame_bufs[cm->new_fb_idx].ref_count == 0 &&
       !frame_bufs[cm->new_fb_idx].released) {
     pool->release_fb_cb(pool->cb_priv,
@@ -440,6 +451,12 @@ int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
 
   // Find a free frame buffer. Return error if can not find any.
   cm->new_fb_idx = get_free_fb(cm);
+  if (cm->new_fb_idx != INVALID_IDX && pbi->frame_parallel_decode) {
+    frame_bufs[cm->new_fb_idx].frame_worker_owner = pbi->frame_worker_owner;
+    frame_bufs[cm->new_fb_idx].row = -1;
+    frame_bufs[cm->new_fb_idx].parsed = 0;
+  }
+  unlock_buffer_pool(pool);
   if (cm->new_fb_idx == INVALID_IDX) {
     pbi->ready_for_new_data = 1;
     release_fb_on_decoder_exit(pbi);
@@ -455,12 +472,24 @@ int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
   pbi->hold_ref_buf = 0;
   pbi->cur_buf = &frame_bufs[cm->new_fb_idx];
 
+  // The reference map is only updated if the frame header gets parsed.
+  if (pbi->frame_parallel_decode)
+    memcpy(cm->next_ref_frame_map, cm->ref_frame_map,
+           sizeof(cm->ref_frame_map));
+
   if (setjmp(cm->error.jmp)) {
     cm->error.setjmp = 0;
     pbi->ready_for_new_data = 1;
     release_fb_on_decoder_exit(pbi);
+    if (pbi->frame_parallel_decode) {
+      // Release the workers waiting on the current frame.
+      pbi->cur_buf->buf.corrupted = 1;
+      vp9_frameworker_broadcast(pbi->cur_buf, INT_MAX);
+    }
     // Release current frame.
+    lock_buffer_pool(pool);
     decrease_ref_count(cm->new_fb_idx, frame_bufs, pool);
+    unlock_buffer_pool(pool);
     vpx_clear_system_state();
     return -1;
   }
@@ -472,6 +501,13 @@ int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
 
   vpx_clear_system_state();
 
+  if (pbi->frame_parallel_decode) {
+    // A shown existing frame may still be decoded by another worker.
+    if (cm->show_existing_frame)
+      vp9_frameworker_wait(&frame_bufs[cm->new_fb_idx], INT_MAX);
+    vp9_frameworker_lock_stats(pbi->frame_worker_owner);
+  }
+
   if (!cm->show_existing_frame) {
     cm->last_show_frame = cm->show_frame;
     cm->prev_frame = cm->cur_frame;
@@ -487,6 +523,15 @@ int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
     cm->current_video_frame++;
   }
 
+  if (pbi->frame_parallel_decode) {
+    VPxWorker *const worker = pbi->frame_worker_owner;
+    FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+    frame_worker_data->frame_context_ready = 1;
+    frame_worker_data->frame_decoded = 1;
+    vp9_frameworker_signal_stats(worker);
+    vp9_frameworker_unlock_stats(worker);
+  }
+
   cm->error.setjmp = 0;
   return retcode;
 }
@@ -510,7 +555,10 @@ int vp9_get_raw_frame(VP9Decoder *pbi, YV12_BUFFER_CONFIG *sd,
 
 #if CONFIG_VP9_POSTPROC
   if (!cm->show_existing_frame) {
+    DecodeTimer timer;
+    decode_timer_start(&timer);
     ret = vp9_post_proc_frame(cm, sd, flags, cm->width);
+    decode_timer_add(&timer, &pbi->stats.postproc);
   } else {
     *sd = *cm->frame_to_show;
     ret = 0;
@@ -13,8 +13,10 @@
 
 #include "./vpx_config.h"
 
+#include "vpx/vp8dx.h"
 #include "vpx/vpx_codec.h"
 #include "vpx_dsp/bitreader.h"
+#include "vpx_ports/vpx_timer.h"
 #include "vpx_scale/yv12config.h"
 #include "vpx_util/vpx_thread.h"
 
@@ -33,10 +35,44 @@ extern "C" {
 
 typedef enum JobType { PARSE_JOB, RECON_JOB, LPF_JOB } JobType;
 
+// The time a decoder thread spent in each stage of a frame, and the wall clock
+// time it was working and waiting for work.
+typedef struct DecodeTimes {
+  vpx_stage_time_t parse;
+  vpx_stage_time_t recon;
+  vpx_stage_time_t lf;
+  int64_t busy_us;
+  int64_t idle_us;
+} DecodeTimes;
+
+// Measures the wall clock and CPU time of a section of decoding.
+typedef struct DecodeTimer {
+  struct vpx_usec_timer wall;
+  int64_t cpu_start;
+} DecodeTimer;
+
+static INLINE void decode_timer_start(DecodeTimer *t) {
+  t->cpu_start = vpx_usec_thread_cpu_time();
+  vpx_usec_timer_start(&t->wall);
+}
+
+// Adds the time since decode_timer_start() to 'stage' and returns the wall
+// clock time.
+static INLINE int64_t decode_timer_add(DecodeTimer *t,
+                                       vpx_stage_time_t *stage) {
+  int64_t wall_us;
+  vpx_usec_timer_mark(&t->wall);
+  wall_us = vpx_usec_timer_elapsed(&t->wall);
+  stage->wall_us += wall_us;
+  stage->cpu_us += vpx_usec_thread_cpu_time() - t->cpu_start;
+  return wall_us;
+}
+
 typedef struct ThreadData {
   struct VP9Decoder *pbi;
   LFWorkerData *lf_data;
   VP9LfSync *lf_sync;
+  DecodeTimes times;
 } ThreadData;
 
 typedef struct TileBuffer {
@@ -52,6 +88,7 @@ typedef struct TileWorkerData {
   FRAME_COUNTS counts;
   LFWorkerData *lf_data;
   VP9LfSync *lf_sync;
+  DecodeTimes times;
   DECLARE_ALIGNED(16, MACROBLOCKD, xd);
   /* dqcoeff are shared by all the planes. So planes must be decoded serially */
   DECLARE_ALIGNED(16, tran_low_t, dqcoeff[32 * 32]);
@@ -69,17 +106,25 @@ typedef struct RowMTWorkerData {
   int *eob[MAX_MB_PLANE];
   PARTITION_TYPE *partition;
   tran_low_t *dqcoeff[MAX_MB_PLANE];
-  int8_t *recon_map;
   const uint8_t *data_end;
   uint8_t *jobq_buf;
   JobQueueRowMt jobq;
   size_t jobq_size;
   int num_tiles_done;
   int num_jobs;
+  // Used in frame parallel decode only. sb_row_done counts the tiles of each
+  // SB row that are final (a loop filtered row counts all of them), and
+  // sb_rows_final is the number of leading SB rows that are final.
+  int *sb_row_done;
+  int sb_rows_final;
+  // Tiles whose last row has been parsed, and whether the frame context was
+  // adapted and handed to the next frame before the frame was reconstructed.
+  int num_tiles_parsed;
+  int context_published;
 #if CONFIG_MULTITHREAD
   pthread_mutex_t recon_done_mutex;
-  pthread_mutex_t *recon_sync_mutex;
-  pthread_cond_t *recon_sync_cond;
+  // The reconstructed superblock column in each SB row of each tile column.
+  VP9RowProgress *recon_progress;
 #endif
   ThreadData *thread_data;
 } RowMTWorkerData;
@@ -110,6 +155,8 @@ typedef struct VP9Decoder {
   TileBuffer tile_buffers[64];
   int num_tile_workers;
   int total_tiles;
+  // Shared threads the workers run on, if set by the application.
+  VPxThreadPool *thread_pool;
 
   VP9LfSync lf_row_sync;
 
@@ -124,6 +171,12 @@ typedef struct VP9Decoder {
   int row_mt;
   int lpf_mt_opt;
   RowMTWorkerData *row_mt_worker_data;
+
+  int frame_parallel_decode;     // frame-based threading.
+  VPxWorker *frame_worker_owner;  // frame_worker that owns this pbi.
+
+  // Decode times, added up until reset by the caller.
+  vpx_decode_stats_t stats;
 } VP9Decoder;
 
 int vp9_receive_compressed_data(struct VP9Decoder *pbi, size_t size,
@@ -0,0 +1,227 @@
+/*
+ *  Copyright (c) 2014 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <limits.h>
+#include <string.h>
+
+#include "./vpx_config.h"
+#include "vpx_mem/vpx_mem.h"
+#include "vp9/common/vp9_alloccommon.h"
+#include "vp9/decoder/vp9_dthread.h"
+#include "vp9/decoder/vp9_decoder.h"
+
+void vp9_frameworker_lock_stats(VPxWorker *const worker) {
+#if CONFIG_MULTITHREAD
+  FrameWorkerData *const worker_data = (FrameWorkerData *)worker->data1;
+  pthread_mutex_lock(&worker_data->stats_mutex);
+#else
+  (void)worker;
+#endif
+}
+
+void vp9_frameworker_unlock_stats(VPxWorker *const worker) {
+#if CONFIG_MULTITHREAD
+  FrameWorkerData *const worker_data = (FrameWorkerData *)worker->data1;
+  pthread_mutex_unlock(&worker_data->stats_mutex);
+#else
+  (void)worker;
+#endif
+}
+
+void vp9_frameworker_signal_stats(VPxWorker *const worker) {
+#if CONFIG_MULTITHREAD
+  FrameWorkerData *const worker_data = (FrameWorkerData *)worker->data1;
+  pthread_cond_broadcast(&worker_data->stats_cond);
+#else
+  (void)worker;
+#endif
+}
+
+void vp9_frameworker_wait(RefCntBuffer *const ref_buf, int row) {
+#if CONFIG_MULTITHREAD
+  VPxWorker *const ref_worker = ref_buf ? ref_buf->frame_worker_owner : NULL;
+  FrameWorkerData *ref_worker_data;
+
+  // The buffer was not decoded in frame parallel mode.
+  if (ref_worker == NULL) return;
+
+  ref_worker_data = (FrameWorkerData *)ref_worker->data1;
+  pthread_mutex_lock(&ref_worker_data->stats_mutex);
+  while (ref_buf->row < row) {
+    pthread_cond_wait(&ref_worker_data->stats_cond,
+                      &ref_worker_data->stats_mutex);
+  }
+  pthread_mutex_unlock(&ref_worker_data->stats_mutex);
+#else
+  (void)ref_buf;
+  (void)row;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void vp9_frameworker_wait_parsed(RefCntBuffer *const ref_buf) {
+#if CONFIG_MULTITHREAD
+  VPxWorker *const ref_worker = ref_buf ? ref_buf->frame_worker_owner : NULL;
+  FrameWorkerData *ref_worker_data;
+
+  // The buffer was not decoded in frame parallel mode.
+  if (ref_worker == NULL) return;
+
+  ref_worker_data = (FrameWorkerData *)ref_worker->data1;
+  pthread_mutex_lock(&ref_worker_data->stats_mutex);
+  while (!ref_buf->parsed) {
+    pthread_cond_wait(&ref_worker_data->stats_cond,
+                      &ref_worker_data->stats_mutex);
+  }
+  pthread_mutex_unlock(&ref_worker_data->stats_mutex);
+#else
+  (void)ref_buf;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void vp9_frameworker_broadcast(RefCntBuffer *const buf, int row) {
+#if CONFIG_MULTITHREAD
+  VPxWorker *const worker = buf->frame_worker_owner;
+
+  vp9_frameworker_lock_stats(worker);
+  // Row based multi-threaded decoding may report its rows out of order.
+  if (row > buf->row) buf->row = row;
+  if (row == INT_MAX) buf->parsed = 1;
+  vp9_frameworker_signal_stats(worker);
+  vp9_frameworker_unlock_stats(worker);
+#else
+  (void)buf;
+  (void)row;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void vp9_frameworker_broadcast_parsed(RefCntBuffer *const buf) {
+#if CONFIG_MULTITHREAD
+  VPxWorker *const worker = buf->frame_worker_owner;
+
+  vp9_frameworker_lock_stats(worker);
+  buf->parsed = 1;
+  vp9_frameworker_signal_stats(worker);
+  vp9_frameworker_unlock_stats(worker);
+#else
+  (void)buf;
+#endif  // CONFIG_MULTITHREAD
+}
+
+int vp9_frameworker_copy_context(VPxWorker *const dst_worker,
+                                 VPxWorker *const src_worker) {
+  FrameWorkerData *const src_worker_data = (FrameWorkerData *)src_worker->data1;
+  FrameWorkerData *const dst_worker_data = (FrameWorkerData *)dst_worker->data1;
+  VP9_COMMON *const src_cm = &src_worker_data->pbi->common;
+  VP9_COMMON *const dst_cm = &dst_worker_data->pbi->common;
+  BufferPool *const pool = dst_cm->buffer_pool;
+  RefCntBuffer *prev_frame;
+  int frame_decoded;
+
+  // Wait until source frame's context is ready.
+  vp9_frameworker_lock_stats(src_worker);
+#if CONFIG_MULTITHREAD
+  while (!src_worker_data->frame_context_ready) {
+    pthread_cond_wait(&src_worker_data->stats_cond,
+                      &src_worker_data->stats_mutex);
+  }
+
+  // The segmentation map of the source frame is only complete once all of
+  // its blocks have been decoded.
+  if (src_cm->seg.enabled && !src_cm->show_existing_frame) {
+    while (!src_worker_data->frame_decoded) {
+      pthread_cond_wait(&src_worker_data->stats_cond,
+                        &src_worker_data->stats_mutex);
+    }
+  }
+#endif  // CONFIG_MULTITHREAD
+  frame_decoded = src_worker_data->frame_decoded;
+
+  dst_worker_data->pbi->need_resync = src_worker_data->pbi->need_resync;
+  memcpy(dst_cm->ref_frame_map, src_cm->next_ref_frame_map,
+         sizeof(src_cm->next_ref_frame_map));
+
+  // Mirror the state a serial decoder would have after decoding the source
+  // frame. Fields the source worker updates once its frame is decoded are
+  // derived from its header so they do not depend on its progress.
+  dst_cm->last_width = src_cm->width;
+  dst_cm->last_height = src_cm->height;
+  dst_cm->last_show_frame = src_cm->show_existing_frame
+                                ? src_cm->last_show_frame
+                                : src_cm->show_frame;
+  prev_frame =
+      src_cm->show_existing_frame ? src_cm->prev_frame : src_cm->cur_frame;
+  dst_cm->current_video_frame =
+      src_cm->current_video_frame + (frame_decoded ? 0 : src_cm->show_frame);
+  dst_cm->frame_type = src_cm->frame_type;
+  dst_cm->intra_only = src_cm->intra_only;
+  dst_cm->bit_depth = src_cm->bit_depth;
+#if CONFIG_VP9_HIGHBITDEPTH
+  dst_cm->use_highbitdepth = src_cm->use_highbitdepth;
+#endif
+  dst_cm->subsampling_x = src_cm->subsampling_x;
+  dst_cm->subsampling_y = src_cm->subsampling_y;
+  dst_cm->color_space = src_cm->color_space;
+  dst_cm->color_range = src_cm->color_range;
+  memcpy(dst_cm->ref_frame_sign_bias, src_cm->ref_frame_sign_bias,
+         sizeof(src_cm->ref_frame_sign_bias));
+  dst_cm->lf.mode_ref_delta_enabled = src_cm->lf.mode_ref_delta_enabled;
+  memcpy(dst_cm->lf.ref_deltas, src_cm->lf.ref_deltas,
+         sizeof(src_cm->lf.ref_deltas));
+  memcpy(dst_cm->lf.mode_deltas, src_cm->lf.mode_deltas,
+         sizeof(src_cm->lf.mode_deltas));
+  dst_cm->seg = src_cm->seg;
+  memcpy(dst_cm->frame_contexts, src_cm->frame_contexts,
+         FRAME_CONTEXTS * sizeof(src_cm->frame_contexts[0]));
+
+  // Size the context buffers as the serial decoder would have them, so the
+  // next frame header resizes (and clears the segmentation map) only when
+  // the frame size actually changes.
+  if (src_cm->width > 0 && src_cm->height > 0 &&
+      (dst_cm->width != src_cm->width || dst_cm->height != src_cm->height)) {
+    const int new_mi_rows =
+        ALIGN_POWER_OF_TWO(src_cm->height, MI_SIZE_LOG2) >> MI_SIZE_LOG2;
+    const int new_mi_cols =
+        ALIGN_POWER_OF_TWO(src_cm->width, MI_SIZE_LOG2) >> MI_SIZE_LOG2;
+    if (new_mi_cols > dst_cm->mi_cols || new_mi_rows > dst_cm->mi_rows) {
+      if (vp9_alloc_context_buffers(dst_cm, src_cm->width, src_cm->height)) {
+        dst_cm->width = 0;
+        dst_cm->height = 0;
+        vp9_frameworker_unlock_stats(src_worker);
+        return 1;
+      }
+    } else {
+      vp9_set_mb_mi(dst_cm, src_cm->width, src_cm->height);
+    }
+    vp9_init_context_buffers(dst_cm);
+    dst_cm->width = src_cm->width;
+    dst_cm->height = src_cm->height;
+  }
+
+  // The source worker swaps its segmentation maps once its frame is decoded,
+  // so its last map is the one the next frame predicts from.
+  if (dst_cm->last_frame_seg_map != NULL &&
+      src_cm->last_frame_seg_map != NULL && dst_cm->width == src_cm->width &&
+      dst_cm->height == src_cm->height) {
+    memcpy(dst_cm->last_frame_seg_map, src_cm->last_frame_seg_map,
+           dst_cm->mi_rows * dst_cm->mi_cols);
+  }
+  vp9_frameworker_unlock_stats(src_worker);
+
+  // Hold the previous frame while its motion vectors may be read.
+  lock_buffer_pool(pool);
+  if (dst_cm->prev_frame != NULL) {
+    decrease_ref_count((int)(dst_cm->prev_frame - pool->frame_bufs),
+                       pool->frame_bufs, pool);
+  }
+  dst_cm->prev_frame = prev_frame;
+  if (prev_frame != NULL) ++prev_frame->ref_count;
+  unlock_buffer_pool(pool);
+  return 0;
+}
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2014 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPX_VP9_DECODER_VP9_DTHREAD_H_
+#define VPX_VP9_DECODER_VP9_DTHREAD_H_
+
+#include "./vpx_config.h"
+#include "vpx_util/vpx_thread.h"
+#include "vp9/common/vp9_onyxc_int.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct VP9Decoder;
+
+// WorkerData for the FrameWorker thread. It contains all the information of
+// the worker and decode structures for decoding a frame.
+typedef struct FrameWorkerData {
+  struct VP9Decoder *pbi;
+  const uint8_t *data;
+  const uint8_t *data_end;
+  size_t data_size;
+  void *user_priv;
+  int result;
+  int worker_id;
+  int received_frame;
+
+  // scratch_buffer is used in frame parallel mode only.
+  // It is used to make a copy of the compressed data.
+  uint8_t *scratch_buffer;
+  size_t scratch_buffer_size;
+
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t stats_mutex;
+  pthread_cond_t stats_cond;
+#endif
+
+  int frame_context_ready;  // Current frame's context is ready to read.
+  int frame_decoded;        // Finished decoding current frame.
+} FrameWorkerData;
+
+void vp9_frameworker_lock_stats(VPxWorker *const worker);
+void vp9_frameworker_unlock_stats(VPxWorker *const worker);
+void vp9_frameworker_signal_stats(VPxWorker *const worker);
+
+// Wait until the first row luma pixel rows of ref_buf have been decoded and
+// loop filtered. Returns immediately if ref_buf is not owned by a FrameWorker.
+void vp9_frameworker_wait(RefCntBuffer *const ref_buf, int row);
+
+// Wait until the modes and motion vectors of ref_buf have been parsed. Returns
+// immediately if ref_buf is not owned by a FrameWorker.
+void vp9_frameworker_wait_parsed(RefCntBuffer *const ref_buf);
+
+// FrameWorker broadcasts its decoding progress so other workers that are
+// waiting on it can resume decoding. The progress never moves backwards, and
+// a whole frame (row == INT_MAX) is parsed as well.
+void vp9_frameworker_broadcast(RefCntBuffer *const buf, int row);
+
+// FrameWorker broadcasts that the modes and motion vectors of buf are final.
+void vp9_frameworker_broadcast_parsed(RefCntBuffer *const buf);
+
+// Copy necessary decoding context from src worker to dst worker. Returns 0 on
+// success.
+int vp9_frameworker_copy_context(VPxWorker *const dst_worker,
+                                 VPxWorker *const src_worker);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // VPX_VP9_DECODER_VP9_DTHREAD_H_
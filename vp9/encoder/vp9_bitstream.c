@@ -18,6 +18,7 @@
 #include "vpx_mem/vpx_mem.h"
 #include "vpx_ports/mem_ops.h"
 #include "vpx_ports/system_state.h"
+#include "vpx_ports/vpx_timer.h"
 #if CONFIG_BITSTREAM_DEBUG
 #include "vpx_util/vpx_debug_util.h"
 #endif  // CONFIG_BITSTREAM_DEBUG
@@ -128,9 +129,21 @@ static void update_switchable_interp_probs(VP9_COMMON *cm, vpx_writer *w,
                      counts->switchable_interp[j], SWITCHABLE_FILTERS, w);
 }
 
-static void pack_mb_tokens(vpx_writer *w, TOKENEXTRA **tp,
+// Returns the coefficient probabilities the token is coded with.
+static INLINE const vpx_prob *get_token_probs(const vpx_prob *coef_probs,
+                                              const TOKENEXTRA *p) {
+  return coef_probs + (p->token_ctx >> TOKEN_BITS) * UNCONSTRAINED_NODES;
+}
+
+static void pack_mb_tokens(vpx_writer *const writer, TOKENEXTRA **tp,
                            const TOKENEXTRA *const stop,
+                           const vpx_prob *const coef_probs,
                            vpx_bit_depth_t bit_depth) {
+  // Write to a local copy of the writer, so the compiler can keep its state in
+  // registers over the tokens instead of going through memory for each bit.
+  vpx_writer local_writer = *writer;
+  vpx_writer *const w = &local_writer;
+  const int token_mask = (1 << TOKEN_BITS) - 1;
   const TOKENEXTRA *p;
   const vp9_extra_bit *const extra_bits =
 #if CONFIG_VP9_HIGHBITDEPTH
@@ -142,24 +155,25 @@ static void pack_mb_tokens(vpx_writer *w, TOKENEXTRA **tp,
   (void)bit_depth;
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
-  for (p = *tp; p < stop && p->token != EOSB_TOKEN; ++p) {
-    if (p->token == EOB_TOKEN) {
-      vpx_write(w, 0, p->context_tree[0]);
+  for (p = *tp; p < stop && p->token_ctx != EOSB_TOKEN; ++p) {
+    if ((p->token_ctx & token_mask) == EOB_TOKEN) {
+      vpx_write(w, 0, get_token_probs(coef_probs, p)[0]);
       continue;
     }
-    vpx_write(w, 1, p->context_tree[0]);
-    while (p->token == ZERO_TOKEN) {
-      vpx_write(w, 0, p->context_tree[1]);
+    vpx_write(w, 1, get_token_probs(coef_probs, p)[0]);
+    while ((p->token_ctx & token_mask) == ZERO_TOKEN) {
+      vpx_write(w, 0, get_token_probs(coef_probs, p)[1]);
       ++p;
-      if (p == stop || p->token == EOSB_TOKEN) {
-        *tp = (TOKENEXTRA *)(uintptr_t)p + (p->token == EOSB_TOKEN);
+      if (p == stop || p->token_ctx == EOSB_TOKEN) {
+        *tp = (TOKENEXTRA *)(uintptr_t)p + (p->token_ctx == EOSB_TOKEN);
+        *writer = local_writer;
         return;
       }
     }
 
     {
-      const int t = p->token;
-      const vpx_prob *const context_tree = p->context_tree;
+      const int t = p->token_ctx & token_mask;
+      const vpx_prob *const context_tree = get_token_probs(coef_probs, p);
       assert(t != ZERO_TOKEN);
       assert(t != EOB_TOKEN);
       assert(t != EOSB_TOKEN);
@@ -190,7 +204,8 @@ static void pack_mb_tokens(vpx_writer *w, TOKENEXTRA **tp,
       }
     }
   }
-  *tp = (TOKENEXTRA *)(uintptr_t)p + (p->token == EOSB_TOKEN);
+  *tp = (TOKENEXTRA *)(uintptr_t)p + (p->token_ctx == EOSB_TOKEN);
+  *writer = local_writer;
 }
 
 static void write_segment_id(vpx_writer *w, const struct segmentation *seg,
@@ -397,7 +412,8 @@ static void write_modes_b(
   }
 
   assert(*tok < tok_end);
-  pack_mb_tokens(w, tok, tok_end, cm->bit_depth);
+  pack_mb_tokens(w, tok, tok_end, cm->fc->coef_probs[0][0][0][0][0],
+                 cm->bit_depth);
 }
 
 static void write_partition(const VP9_COMMON *const cm,
@@ -698,6 +714,199 @@ static void update_coef_probs(VP9_COMP *cpi, vpx_writer *w) {
   }
 }
 
+// Returns the cost of coding the branches in 'branch_ct' of the coefficient
+// token tree with the model probabilities 'model_probs'.
+static int64_t coef_tree_cost(const unsigned int branch_ct[ENTROPY_NODES][2],
+                              const vpx_prob *model_probs) {
+  vpx_prob probs[ENTROPY_NODES];
+  int64_t cost = 0;
+  int i;
+  vp9_model_to_full_probs(model_probs, probs);
+  for (i = 0; i < ENTROPY_NODES; ++i) {
+    cost += (int64_t)branch_ct[i][0] * vp9_cost_zero(probs[i]) +
+            (int64_t)branch_ct[i][1] * vp9_cost_one(probs[i]);
+  }
+  return cost;
+}
+
+// Returns the cost of the coefficient tokens of the frame. It is called after
+// write_compressed_header(), so cm->fc holds the probabilities chosen by
+// update_coef_probs(), which are the ones the tiles are packed with.
+static int64_t estimate_coef_cost(VP9_COMP *cpi) {
+  const VP9_COMMON *const cm = &cpi->common;
+  const TX_SIZE max_tx_size = tx_mode_to_biggest_tx_size[cm->tx_mode];
+  const vp9_extra_bit *const extra_bits =
+#if CONFIG_VP9_HIGHBITDEPTH
+      (cm->bit_depth == VPX_BITS_12)
+          ? vp9_extra_bits_high12
+          : (cm->bit_depth == VPX_BITS_10) ? vp9_extra_bits_high10
+                                           : vp9_extra_bits;
+#else
+      vp9_extra_bits;
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  // The cost of the sign and extra bits of each token. The values of the extra
+  // bits are not counted, so each is costed as if 0 and 1 were as likely.
+  int token_bits_cost[ENTROPY_TOKENS];
+  int64_t cost = 0;
+  TX_SIZE tx_size;
+  int t, i, j, k, l;
+
+  for (t = 0; t < ENTROPY_TOKENS; ++t) {
+    const vp9_extra_bit *const b = &extra_bits[t];
+    token_bits_cost[t] =
+        (t == ZERO_TOKEN || t == EOB_TOKEN) ? 0 : vp9_cost_bit(128, 0);
+    for (i = 0; i < b->len; ++i) {
+      token_bits_cost[t] +=
+          (vp9_cost_zero(b->prob[i]) + vp9_cost_one(b->prob[i])) >> 1;
+    }
+  }
+
+  for (tx_size = TX_4X4; tx_size <= max_tx_size; ++tx_size) {
+    vp9_coeff_stats frame_branch_ct[PLANE_TYPES];
+    vp9_coeff_probs_model frame_coef_probs[PLANE_TYPES];
+    build_tree_distribution(cpi, tx_size, frame_branch_ct, frame_coef_probs);
+    for (i = 0; i < PLANE_TYPES; ++i) {
+      for (j = 0; j < REF_TYPES; ++j) {
+        for (k = 0; k < COEF_BANDS; ++k) {
+          for (l = 0; l < BAND_COEFF_CONTEXTS(k); ++l) {
+            const unsigned int *const coef_counts =
+                cpi->td.rd_counts.coef_counts[tx_size][i][j][k][l];
+            cost += coef_tree_cost(frame_branch_ct[i][j][k][l],
+                                   cm->fc->coef_probs[tx_size][i][j][k][l]);
+            for (t = ONE_TOKEN; t < EOB_TOKEN; ++t)
+              cost += (int64_t)coef_counts[t] * token_bits_cost[t];
+          }
+        }
+      }
+    }
+  }
+  return cost;
+}
+
+static int64_t branch_cost(const unsigned int ct[2], vpx_prob prob) {
+  return (int64_t)ct[0] * vp9_cost_zero(prob) +
+         (int64_t)ct[1] * vp9_cost_one(prob);
+}
+
+// Returns the cost of coding the symbols counted in 'counts' with 'tree'.
+// None of the trees it is used with has more than MV_CLASSES symbols.
+static int64_t symbol_cost(const unsigned int *counts, const vpx_prob *probs,
+                           vpx_tree tree, int num_symbols) {
+  int costs[MV_CLASSES];
+  int64_t cost = 0;
+  int i;
+  assert(num_symbols <= MV_CLASSES);
+  vp9_cost_tokens(costs, probs, tree);
+  for (i = 0; i < num_symbols; ++i) cost += (int64_t)counts[i] * costs[i];
+  return cost;
+}
+
+static int64_t estimate_mv_cost(const nmv_context *nmvc,
+                                const nmv_context_counts *counts,
+                                int allow_hp) {
+  int64_t cost =
+      symbol_cost(counts->joints, nmvc->joints, vp9_mv_joint_tree, MV_JOINTS);
+  int i, j;
+  for (i = 0; i < 2; ++i) {
+    const nmv_component *const comp = &nmvc->comps[i];
+    const nmv_component_counts *const c = &counts->comps[i];
+    cost += branch_cost(c->sign, comp->sign);
+    cost += symbol_cost(c->classes, comp->classes, vp9_mv_class_tree,
+                        MV_CLASSES);
+    cost += symbol_cost(c->class0, comp->class0, vp9_mv_class0_tree,
+                        CLASS0_SIZE);
+    for (j = 0; j < MV_OFFSET_BITS; ++j)
+      cost += branch_cost(c->bits[j], comp->bits[j]);
+    for (j = 0; j < CLASS0_SIZE; ++j) {
+      cost += symbol_cost(c->class0_fp[j], comp->class0_fp[j], vp9_mv_fp_tree,
+                          MV_FP_SIZE);
+    }
+    cost += symbol_cost(c->fp, comp->fp, vp9_mv_fp_tree, MV_FP_SIZE);
+    if (allow_hp) {
+      cost += branch_cost(c->class0_hp, comp->class0_hp);
+      cost += branch_cost(c->hp, comp->hp);
+    }
+  }
+  return cost;
+}
+
+// Costs the mode info of the frame from its FRAME_COUNTS. The intra modes of
+// intra only frames are coded with probabilities that depend on the modes of
+// the neighbouring blocks, which the counts do not keep, so they are left out.
+static int64_t estimate_mode_cost(const VP9_COMMON *cm,
+                                  const FRAME_COUNTS *counts) {
+  const FRAME_CONTEXT *const fc = cm->fc;
+  const vpx_prob(*const partition_probs)[PARTITION_TYPES - 1] =
+      frame_is_intra_only(cm) ? vp9_kf_partition_probs : fc->partition_prob;
+  int64_t cost = 0;
+  int i, j;
+
+  for (i = 0; i < PARTITION_CONTEXTS; ++i) {
+    cost += symbol_cost(counts->partition[i], partition_probs[i],
+                        vp9_partition_tree, PARTITION_TYPES);
+  }
+  for (i = 0; i < SKIP_CONTEXTS; ++i)
+    cost += branch_cost(counts->skip[i], fc->skip_probs[i]);
+
+  if (cm->tx_mode == TX_MODE_SELECT) {
+    unsigned int ct_8x8p[TX_SIZES - 3][2];
+    unsigned int ct_16x16p[TX_SIZES - 2][2];
+    unsigned int ct_32x32p[TX_SIZES - 1][2];
+    for (i = 0; i < TX_SIZE_CONTEXTS; ++i) {
+      tx_counts_to_branch_counts_8x8(counts->tx.p8x8[i], ct_8x8p);
+      for (j = 0; j < TX_SIZES - 3; ++j)
+        cost += branch_cost(ct_8x8p[j], fc->tx_probs.p8x8[i][j]);
+      tx_counts_to_branch_counts_16x16(counts->tx.p16x16[i], ct_16x16p);
+      for (j = 0; j < TX_SIZES - 2; ++j)
+        cost += branch_cost(ct_16x16p[j], fc->tx_probs.p16x16[i][j]);
+      tx_counts_to_branch_counts_32x32(counts->tx.p32x32[i], ct_32x32p);
+      for (j = 0; j < TX_SIZES - 1; ++j)
+        cost += branch_cost(ct_32x32p[j], fc->tx_probs.p32x32[i][j]);
+    }
+  }
+
+  if (frame_is_intra_only(cm)) return cost;
+
+  for (i = 0; i < BLOCK_SIZE_GROUPS; ++i) {
+    cost += symbol_cost(counts->y_mode[i], fc->y_mode_prob[i],
+                        vp9_intra_mode_tree, INTRA_MODES);
+  }
+  for (i = 0; i < INTRA_MODES; ++i) {
+    cost += symbol_cost(counts->uv_mode[i], fc->uv_mode_prob[i],
+                        vp9_intra_mode_tree, INTRA_MODES);
+  }
+  for (i = 0; i < INTER_MODE_CONTEXTS; ++i) {
+    cost += symbol_cost(counts->inter_mode[i], fc->inter_mode_probs[i],
+                        vp9_inter_mode_tree, INTER_MODES);
+  }
+  if (cm->interp_filter == SWITCHABLE) {
+    for (i = 0; i < SWITCHABLE_FILTER_CONTEXTS; ++i) {
+      cost += symbol_cost(counts->switchable_interp[i],
+                          fc->switchable_interp_prob[i],
+                          vp9_switchable_interp_tree, SWITCHABLE_FILTERS);
+    }
+  }
+  for (i = 0; i < INTRA_INTER_CONTEXTS; ++i)
+    cost += branch_cost(counts->intra_inter[i], fc->intra_inter_prob[i]);
+  if (cm->reference_mode == REFERENCE_MODE_SELECT) {
+    for (i = 0; i < COMP_INTER_CONTEXTS; ++i)
+      cost += branch_cost(counts->comp_inter[i], fc->comp_inter_prob[i]);
+  }
+  if (cm->reference_mode != COMPOUND_REFERENCE) {
+    for (i = 0; i < REF_CONTEXTS; ++i) {
+      cost += branch_cost(counts->single_ref[i][0], fc->single_ref_prob[i][0]);
+      cost += branch_cost(counts->single_ref[i][1], fc->single_ref_prob[i][1]);
+    }
+  }
+  if (cm->reference_mode != SINGLE_REFERENCE) {
+    for (i = 0; i < REF_CONTEXTS; ++i)
+      cost += branch_cost(counts->comp_ref[i], fc->comp_ref_prob[i]);
+  }
+  cost += estimate_mv_cost(&fc->nmvc, &counts->mv,
+                           cm->allow_high_precision_mv);
+  return cost;
+}
+
 static void encode_loopfilter(struct loopfilter *lf,
                               struct vpx_write_bit_buffer *wb) {
   int i;
@@ -1058,6 +1267,15 @@ static size_t encode_tiles_mt(VP9_COMP *cpi, uint8_t *data_ptr) {
   return total_size;
 }
 
+int vp9_pack_bitstream_uses_workers(const VP9_COMP *cpi) {
+  const VP9_COMMON *const cm = &cpi->common;
+  // Encoding tiles in parallel is done only for realtime mode now. In other
+  // modes the speed up is insignificant and requires further testing to ensure
+  // that it does not make the overall process worse in any case.
+  return cpi->oxcf.mode == REALTIME && cpi->num_workers > 1 &&
+         cm->log2_tile_rows == 0 && cm->log2_tile_cols > 0;
+}
+
 static size_t encode_tiles(VP9_COMP *cpi, uint8_t *data_ptr) {
   VP9_COMMON *const cm = &cpi->common;
   MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
@@ -1070,11 +1288,7 @@ static size_t encode_tiles(VP9_COMP *cpi, uint8_t *data_ptr) {
   memset(cm->above_seg_context, 0,
          sizeof(*cm->above_seg_context) * mi_cols_aligned_to_sb(cm->mi_cols));
 
-  // Encoding tiles in parallel is done only for realtime mode now. In other
-  // modes the speed up is insignificant and requires further testing to ensure
-  // that it does not make the overall process worse in any case.
-  if (cpi->oxcf.mode == REALTIME && cpi->num_workers > 1 && tile_rows == 1 &&
-      tile_cols > 1) {
+  if (vp9_pack_bitstream_uses_workers(cpi)) {
     return encode_tiles_mt(cpi, data_ptr);
   }
 
@@ -1350,11 +1564,33 @@ static size_t write_compressed_header(VP9_COMP *cpi, uint8_t *data) {
   return header_bc.pos;
 }
 
+int64_t vp9_estimate_frame_bits(VP9_COMP *cpi, uint8_t *dest,
+                                int64_t *header_bits) {
+  struct vpx_write_bit_buffer wb = { dest, 0 };
+  size_t uncompressed_hdr_size;
+  int64_t cost;
+
+  write_uncompressed_header(cpi, &wb);
+  // The size of the compressed header.
+  vpx_wb_write_literal(&wb, 0, 16);
+  uncompressed_hdr_size = vpx_wb_bytes_written(&wb);
+  vpx_clear_system_state();
+  *header_bits = (int64_t)(uncompressed_hdr_size +
+                           write_compressed_header(
+                               cpi, dest + uncompressed_hdr_size))
+                 << 3;
+
+  cost = estimate_coef_cost(cpi) +
+         estimate_mode_cost(&cpi->common, cpi->td.counts);
+  return cost >> VP9_PROB_COST_SHIFT;
+}
+
 void vp9_pack_bitstream(VP9_COMP *cpi, uint8_t *dest, size_t *size) {
   uint8_t *data = dest;
   size_t first_part_size, uncompressed_hdr_size;
   struct vpx_write_bit_buffer wb = { data, 0 };
   struct vpx_write_bit_buffer saved_wb;
+  struct vpx_usec_timer timer;
 
 #if CONFIG_BITSTREAM_DEBUG
   bitstream_queue_reset_write();
@@ -1370,6 +1606,7 @@ void vp9_pack_bitstream(VP9_COMP *cpi, uint8_t *dest, size_t *size) {
     return;
   }
 
+  vpx_usec_timer_start(&timer);
   saved_wb = wb;
   vpx_wb_write_literal(&wb, 0, 16);  // don't know in advance first part. size
 
@@ -1386,4 +1623,7 @@ void vp9_pack_bitstream(VP9_COMP *cpi, uint8_t *dest, size_t *size) {
   data += encode_tiles(cpi, data);
 
   *size = data - dest;
+
+  vpx_usec_timer_mark(&timer);
+  cpi->stage_times.pack_us += vpx_usec_timer_elapsed(&timer);
 }
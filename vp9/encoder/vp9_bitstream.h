@@ -37,6 +37,18 @@ void vp9_bitstream_encode_tiles_buffer_dealloc(VP9_COMP *const cpi);
 
 void vp9_pack_bitstream(VP9_COMP *cpi, uint8_t *dest, size_t *size);
 
+// Writes the headers of the last encoded frame to 'dest' and sets
+// 'header_bits' to their size. Like vp9_pack_bitstream(), this updates the
+// probabilities in cm->fc, so the caller restores the coding context. Returns
+// an estimate of the bits the tiles of the frame take with the updated
+// probabilities. It is computed from the token counts and the FRAME_COUNTS,
+// without packing the tiles.
+int64_t vp9_estimate_frame_bits(VP9_COMP *cpi, uint8_t *dest,
+                                int64_t *header_bits);
+
+// Returns 1 if vp9_pack_bitstream() packs the tiles on the encoder workers.
+int vp9_pack_bitstream_uses_workers(const VP9_COMP *cpi);
+
 static INLINE int vp9_preserve_existing_gf(VP9_COMP *cpi) {
   return cpi->refresh_golden_frame && cpi->rc.is_src_frame_alt_ref &&
          !cpi->use_svc;
@@ -436,18 +436,23 @@ void vp9_denoiser_denoise(VP9_COMP *cpi, MACROBLOCK *mb, int mi_row, int mi_col,
     *denoiser_decision = FILTER_ZEROMV_BLOCK;
 }
 
-static void copy_frame(YV12_BUFFER_CONFIG *const dest,
+// Copies the luma of src into the n frames in dests. The copies are done a
+// row at a time, so src is read once however many frames it goes to.
+static void copy_frame(YV12_BUFFER_CONFIG *const *const dests, int n,
                        const YV12_BUFFER_CONFIG *const src) {
-  int r;
+  int r, i;
   const uint8_t *srcbuf = src->y_buffer;
-  uint8_t *destbuf = dest->y_buffer;
 
-  assert(dest->y_width == src->y_width);
-  assert(dest->y_height == src->y_height);
+  for (i = 0; i < n; ++i) {
+    assert(dests[i]->y_width == src->y_width);
+    assert(dests[i]->y_height == src->y_height);
+  }
 
-  for (r = 0; r < dest->y_height; ++r) {
-    memcpy(destbuf, srcbuf, dest->y_width);
-    destbuf += dest->y_stride;
+  for (r = 0; r < src->y_height; ++r) {
+    for (i = 0; i < n; ++i) {
+      memcpy(dests[i]->y_buffer + r * dests[i]->y_stride, srcbuf,
+             src->y_width);
+    }
     srcbuf += src->y_stride;
   }
 }
@@ -467,6 +472,8 @@ void vp9_denoiser_update_frame_info(
     int refresh_last_frame, int alt_fb_idx, int gld_fb_idx, int lst_fb_idx,
     int resized, int svc_refresh_denoiser_buffers, int second_spatial_layer) {
   const int shift = second_spatial_layer ? denoiser->num_ref_frames : 0;
+  YV12_BUFFER_CONFIG *dests[REF_FRAMES];
+  int num_dests = 0;
   // Copy source into denoised reference buffers on KEY_FRAME or
   // if the just encoded frame was resized. For SVC, copy source if the base
   // spatial layer was key frame.
@@ -476,8 +483,9 @@ void vp9_denoiser_update_frame_info(
     // Start at 1 so as not to overwrite the INTRA_FRAME
     for (i = 1; i < denoiser->num_ref_frames; ++i) {
       if (denoiser->running_avg_y[i + shift].buffer_alloc != NULL)
-        copy_frame(&denoiser->running_avg_y[i + shift], &src);
+        dests[num_dests++] = &denoiser->running_avg_y[i + shift];
     }
+    copy_frame(dests, num_dests, &src);
     denoiser->reset = 0;
     return;
   }
@@ -487,25 +495,21 @@ void vp9_denoiser_update_frame_info(
     int i;
     for (i = 0; i < REF_FRAMES; i++) {
       if (svc->update_buffer_slot[svc->spatial_layer_id] & (1 << i))
-        copy_frame(&denoiser->running_avg_y[i + 1 + shift],
-                   &denoiser->running_avg_y[INTRA_FRAME + shift]);
+        dests[num_dests++] = &denoiser->running_avg_y[i + 1 + shift];
     }
+    copy_frame(dests, num_dests, &denoiser->running_avg_y[INTRA_FRAME + shift]);
   } else {
     // If more than one refresh occurs, must copy frame buffer.
     if ((refresh_alt_ref_frame + refresh_golden_frame + refresh_last_frame) >
         1) {
-      if (refresh_alt_ref_frame) {
-        copy_frame(&denoiser->running_avg_y[alt_fb_idx + 1 + shift],
-                   &denoiser->running_avg_y[INTRA_FRAME + shift]);
-      }
-      if (refresh_golden_frame) {
-        copy_frame(&denoiser->running_avg_y[gld_fb_idx + 1 + shift],
-                   &denoiser->running_avg_y[INTRA_FRAME + shift]);
-      }
-      if (refresh_last_frame) {
-        copy_frame(&denoiser->running_avg_y[lst_fb_idx + 1 + shift],
-                   &denoiser->running_avg_y[INTRA_FRAME + shift]);
-      }
+      if (refresh_alt_ref_frame)
+        dests[num_dests++] = &denoiser->running_avg_y[alt_fb_idx + 1 + shift];
+      if (refresh_golden_frame)
+        dests[num_dests++] = &denoiser->running_avg_y[gld_fb_idx + 1 + shift];
+      if (refresh_last_frame)
+        dests[num_dests++] = &denoiser->running_avg_y[lst_fb_idx + 1 + shift];
+      copy_frame(dests, num_dests,
+                 &denoiser->running_avg_y[INTRA_FRAME + shift]);
     } else {
       if (refresh_alt_ref_frame) {
         swap_frame_buffer(&denoiser->running_avg_y[alt_fb_idx + 1 + shift],
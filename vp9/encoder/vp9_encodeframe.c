@@ -2259,7 +2259,7 @@ static void encode_b(VP9_COMP *cpi, const TileInfo *const tile, ThreadData *td,
   if (output_enabled) {
     update_stats(&cpi->common, td);
 
-    (*tp)->token = EOSB_TOKEN;
+    (*tp)->token_ctx = EOSB_TOKEN;
     (*tp)++;
   }
 }
@@ -2597,7 +2597,7 @@ static void encode_b_rt(VP9_COMP *cpi, ThreadData *td,
   encode_superblock(cpi, td, tp, output_enabled, mi_row, mi_col, bsize, ctx);
   update_stats(&cpi->common, td);
 
-  (*tp)->token = EOSB_TOKEN;
+  (*tp)->token_ctx = EOSB_TOKEN;
   (*tp)++;
 }
 
@@ -4660,10 +4660,14 @@ static void encode_rd_sb_row(VP9_COMP *cpi, ThreadData *td,
 
     const int idx_str = cm->mi_stride * mi_row + mi_col;
     MODE_INFO **mi = cm->mi_grid_visible + idx_str;
+    struct vpx_usec_timer sb_timer;
+    int64_t coded_time;
 
     vp9_rd_cost_reset(&dummy_rdc);
     (*(cpi->row_mt_sync_read_ptr))(&tile_data->row_mt_sync, sb_row,
                                    sb_col_in_tile);
+    coded_time = td->time_transform + td->time_tokenize;
+    if (cpi->time_block_stages) vpx_usec_timer_start(&sb_timer);
 
     if (sf->adaptive_pred_interp_filter) {
       for (i = 0; i < 64; ++i) td->leaf_tree[i].pred_interp_filter = SWITCHABLE;
@@ -4735,6 +4739,14 @@ static void encode_rd_sb_row(VP9_COMP *cpi, ThreadData *td,
       rd_pick_partition(cpi, td, tile_data, tp, mi_row, mi_col, BLOCK_64X64,
                         &dummy_rdc, dummy_rdc, td->pc_root);
     }
+    if (cpi->time_block_stages) {
+      // The mode search is whatever the superblock took outside of coding the
+      // chosen blocks.
+      vpx_usec_timer_mark(&sb_timer);
+      td->time_pick_mode +=
+          vpx_usec_timer_elapsed(&sb_timer) -
+          (td->time_transform + td->time_tokenize - coded_time);
+    }
     (*(cpi->row_mt_sync_write_ptr))(&tile_data->row_mt_sync, sb_row,
                                     sb_col_in_tile, num_sb_cols);
   }
@@ -5689,9 +5701,13 @@ static void encode_nonrd_sb_row(VP9_COMP *cpi, ThreadData *td,
     BLOCK_SIZE bsize = BLOCK_64X64;
     int seg_skip = 0;
     int i;
+    struct vpx_usec_timer sb_timer;
+    int64_t coded_time;
 
     (*(cpi->row_mt_sync_read_ptr))(&tile_data->row_mt_sync, sb_row,
                                    sb_col_in_tile);
+    coded_time = td->time_transform + td->time_tokenize;
+    if (cpi->time_block_stages) vpx_usec_timer_start(&sb_timer);
 
     if (cpi->use_skin_detection) {
       vp9_compute_skin_sb(cpi, BLOCK_16X16, mi_row, mi_col);
@@ -5815,6 +5831,12 @@ static void encode_nonrd_sb_row(VP9_COMP *cpi, ThreadData *td,
         cpi->count_lastgolden_frame_usage[sboffset] = x->lastgolden_frame_usage;
     }
 
+    if (cpi->time_block_stages) {
+      vpx_usec_timer_mark(&sb_timer);
+      td->time_pick_mode +=
+          vpx_usec_timer_elapsed(&sb_timer) -
+          (td->time_transform + td->time_tokenize - coded_time);
+    }
     (*(cpi->row_mt_sync_write_ptr))(&tile_data->row_mt_sync, sb_row,
                                     sb_col_in_tile, num_sb_cols);
   }
@@ -6610,6 +6632,8 @@ static void encode_superblock(VP9_COMP *cpi, ThreadData *td, TOKENEXTRA **t,
   MODE_INFO *mi = xd->mi[0];
   const int seg_skip =
       segfeature_active(&cm->seg, mi->segment_id, SEG_LVL_SKIP);
+  const int timed = output_enabled && cpi->time_block_stages;
+  struct vpx_usec_timer timer;
   x->skip_recode = !x->select_tx_size && mi->sb_type >= BLOCK_8X8 &&
                    cpi->oxcf.aq_mode != COMPLEXITY_AQ &&
                    cpi->oxcf.aq_mode != CYCLIC_REFRESH_AQ &&
@@ -6626,6 +6650,9 @@ static void encode_superblock(VP9_COMP *cpi, ThreadData *td, TOKENEXTRA **t,
 
   if (x->skip_encode) return;
 
+  // Dry runs are part of the mode search, so only the final coding of each
+  // block is timed.
+  if (timed) vpx_usec_timer_start(&timer);
   if (!is_inter_block(mi)) {
     int plane;
 #if CONFIG_BETTER_HW_COMPATIBILITY && CONFIG_VP9_HIGHBITDEPTH
@@ -6638,8 +6665,6 @@ static void encode_superblock(VP9_COMP *cpi, ThreadData *td, TOKENEXTRA **t,
     for (plane = 0; plane < MAX_MB_PLANE; ++plane)
       vp9_encode_intra_block_plane(x, VPXMAX(bsize, BLOCK_8X8), plane, 1);
     if (output_enabled) sum_intra_stats(td->counts, mi);
-    vp9_tokenize_sb(cpi, td, t, !output_enabled, seg_skip,
-                    VPXMAX(bsize, BLOCK_8X8));
   } else {
     int ref;
     const int is_compound = has_second_ref(mi);
@@ -6678,8 +6703,17 @@ static void encode_superblock(VP9_COMP *cpi, ThreadData *td, TOKENEXTRA **t,
 #endif
 
     vp9_encode_sb(x, VPXMAX(bsize, BLOCK_8X8), mi_row, mi_col, output_enabled);
-    vp9_tokenize_sb(cpi, td, t, !output_enabled, seg_skip,
-                    VPXMAX(bsize, BLOCK_8X8));
+  }
+  if (timed) {
+    vpx_usec_timer_mark(&timer);
+    td->time_transform += vpx_usec_timer_elapsed(&timer);
+    vpx_usec_timer_start(&timer);
+  }
+  vp9_tokenize_sb(cpi, td, t, !output_enabled, seg_skip,
+                  VPXMAX(bsize, BLOCK_8X8));
+  if (timed) {
+    vpx_usec_timer_mark(&timer);
+    td->time_tokenize += vpx_usec_timer_elapsed(&timer);
   }
 
   if (seg_skip) {
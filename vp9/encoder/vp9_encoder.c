@@ -65,6 +65,9 @@
 #include "vp9/encoder/vp9_ethread.h"
 #include "vp9/encoder/vp9_extend.h"
 #include "vp9/encoder/vp9_firstpass.h"
+#if !CONFIG_REALTIME_ONLY
+#include "vp9/encoder/vp9_fp_lookahead.h"
+#endif
 #include "vp9/encoder/vp9_mbgraph.h"
 #if CONFIG_NON_GREEDY_MV
 #include "vp9/encoder/vp9_mcomp.h"
@@ -1278,6 +1281,15 @@ static void update_reference_segmentation_map(VP9_COMP *cpi) {
   }
 }
 
+// Number of frames the lookahead must hold before the first one is coded.
+static int get_lookahead_depth(const VP9EncoderConfig *oxcf) {
+  // With the first pass lookahead, the stats of the newest frame are not known
+  // until the next one comes in.
+  if (oxcf->pass == 2 && oxcf->fp_lookahead > 0)
+    return oxcf->lag_in_frames + oxcf->fp_lookahead + 1;
+  return oxcf->lag_in_frames;
+}
+
 static void alloc_raw_frame_buffers(VP9_COMP *cpi) {
   VP9_COMMON *cm = &cpi->common;
   const VP9EncoderConfig *oxcf = &cpi->oxcf;
@@ -1288,7 +1300,7 @@ static void alloc_raw_frame_buffers(VP9_COMP *cpi) {
 #if CONFIG_VP9_HIGHBITDEPTH
                                         cm->use_highbitdepth,
 #endif
-                                        oxcf->lag_in_frames);
+                                        get_lookahead_depth(oxcf));
   if (!cpi->lookahead)
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate lag buffers");
@@ -1397,9 +1409,12 @@ static void alloc_compressor_data(VP9_COMP *cpi) {
   vpx_free(cpi->tile_tok[0][0]);
 
   {
+    // The buffer is sized for the worst case, but only the tokens written by
+    // vp9_tokenize_sb() are ever read. It is not cleared, so the pages past the
+    // tokens each superblock row actually produces are never touched.
     unsigned int tokens = get_token_alloc(cm->mb_rows, cm->mb_cols);
     CHECK_MEM_ERROR(cm, cpi->tile_tok[0][0],
-                    vpx_calloc(tokens, sizeof(*cpi->tile_tok[0][0])));
+                    vpx_malloc(tokens * sizeof(*cpi->tile_tok[0][0])));
   }
 
   sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
@@ -2272,7 +2287,7 @@ void vp9_update_compressor_with_img_fmt(VP9_COMP *cpi, vpx_img_fmt_t img_fmt) {
 #if CONFIG_VP9_HIGHBITDEPTH
                                       use_highbitdepth,
 #endif
-                                      oxcf->lag_in_frames);
+                                      get_lookahead_depth(oxcf));
   alloc_raw_frame_buffers(cpi);
 }
 
@@ -2475,7 +2490,8 @@ VP9_COMP *vp9_create_compressor(const VP9EncoderConfig *oxcf,
 #if !CONFIG_REALTIME_ONLY
   if (oxcf->pass == 1) {
     vp9_init_first_pass(cpi);
-  } else if (oxcf->pass == 2) {
+  } else if (oxcf->pass == 2 && oxcf->fp_lookahead == 0) {
+    // With the first pass lookahead, the stats come in along with the frames.
     const size_t packet_sz = sizeof(FIRSTPASS_STATS);
     const int packets = (int)(oxcf->two_pass_stats_in.sz / packet_sz);
 
@@ -2776,6 +2792,9 @@ void vp9_remove_compressor(VP9_COMP *cpi) {
 
       fclose(f);
     }
+#if !CONFIG_REALTIME_ONLY
+    if (cpi->oxcf.pass == 1 && cpi->row_mt) vp9_print_fp_row_mt_stats(cpi);
+#endif  // !CONFIG_REALTIME_ONLY
 #endif
 
 #if 0
@@ -2803,6 +2822,11 @@ void vp9_remove_compressor(VP9_COMP *cpi) {
 
   free_tpl_buffer(cpi);
 
+#if !CONFIG_REALTIME_ONLY
+  // The first pass thread may still be reading a frame of the lookahead.
+  vp9_fp_lookahead_destroy(cpi->fp_lookahead);
+#endif
+
   for (t = 0; t < cpi->num_workers; ++t) {
     VPxWorker *const worker = &cpi->workers[t];
     EncWorkerData *const thread_data = &cpi->tile_thr_data[t];
@@ -2821,6 +2845,10 @@ void vp9_remove_compressor(VP9_COMP *cpi) {
   vpx_free(cpi->workers);
   vp9_row_mt_mem_dealloc(cpi);
 
+  for (t = 0; t < cpi->num_lpf_search_bufs; ++t)
+    vpx_free_frame_buffer(&cpi->lpf_search_bufs[t]);
+  vpx_free(cpi->lpf_search_bufs);
+
   if (cpi->num_workers > 1) {
     vp9_loop_filter_dealloc(&cpi->lf_row_sync);
     vp9_bitstream_encode_tiles_buffer_dealloc(cpi);
@@ -3057,55 +3085,6 @@ static void scale_and_extend_frame_nonnormative(const YV12_BUFFER_CONFIG *src,
   vpx_extend_frame_borders(dst);
 }
 
-#if CONFIG_VP9_HIGHBITDEPTH
-static void scale_and_extend_frame(const YV12_BUFFER_CONFIG *src,
-                                   YV12_BUFFER_CONFIG *dst, int bd,
-                                   INTERP_FILTER filter_type,
-                                   int phase_scaler) {
-  const int src_w = src->y_crop_width;
-  const int src_h = src->y_crop_height;
-  const int dst_w = dst->y_crop_width;
-  const int dst_h = dst->y_crop_height;
-  const uint8_t *const srcs[3] = { src->y_buffer, src->u_buffer,
-                                   src->v_buffer };
-  const int src_strides[3] = { src->y_stride, src->uv_stride, src->uv_stride };
-  uint8_t *const dsts[3] = { dst->y_buffer, dst->u_buffer, dst->v_buffer };
-  const int dst_strides[3] = { dst->y_stride, dst->uv_stride, dst->uv_stride };
-  const InterpKernel *const kernel = vp9_filter_kernels[filter_type];
-  int x, y, i;
-
-  for (i = 0; i < MAX_MB_PLANE; ++i) {
-    const int factor = (i == 0 || i == 3 ? 1 : 2);
-    const int src_stride = src_strides[i];
-    const int dst_stride = dst_strides[i];
-    for (y = 0; y < dst_h; y += 16) {
-      const int y_q4 = y * (16 / factor) * src_h / dst_h + phase_scaler;
-      for (x = 0; x < dst_w; x += 16) {
-        const int x_q4 = x * (16 / factor) * src_w / dst_w + phase_scaler;
-        const uint8_t *src_ptr = srcs[i] +
-                                 (y / factor) * src_h / dst_h * src_stride +
-                                 (x / factor) * src_w / dst_w;
-        uint8_t *dst_ptr = dsts[i] + (y / factor) * dst_stride + (x / factor);
-
-        if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
-          vpx_highbd_convolve8(CONVERT_TO_SHORTPTR(src_ptr), src_stride,
-                               CONVERT_TO_SHORTPTR(dst_ptr), dst_stride, kernel,
-                               x_q4 & 0xf, 16 * src_w / dst_w, y_q4 & 0xf,
-                               16 * src_h / dst_h, 16 / factor, 16 / factor,
-                               bd);
-        } else {
-          vpx_scaled_2d(src_ptr, src_stride, dst_ptr, dst_stride, kernel,
-                        x_q4 & 0xf, 16 * src_w / dst_w, y_q4 & 0xf,
-                        16 * src_h / dst_h, 16 / factor, 16 / factor);
-        }
-      }
-    }
-  }
-
-  vpx_extend_frame_borders(dst);
-}
-#endif  // CONFIG_VP9_HIGHBITDEPTH
-
 #if !CONFIG_REALTIME_ONLY
 static int scale_down(VP9_COMP *cpi, int q) {
   RATE_CONTROL *const rc = &cpi->rc;
@@ -3312,15 +3291,17 @@ void vp9_update_reference_frames(VP9_COMP *cpi) {
   if (is_one_pass_cbr_svc(cpi)) vp9_svc_update_ref_frame(cpi);
 }
 
-static void loopfilter_frame(VP9_COMP *cpi, VP9_COMMON *cm) {
-  MACROBLOCKD *xd = &cpi->td.mb.e_mbd;
-  struct loopfilter *lf = &cm->lf;
-  int is_reference_frame =
-      (cm->frame_type == KEY_FRAME || cpi->refresh_last_frame ||
-       cpi->refresh_golden_frame || cpi->refresh_alt_ref_frame);
+static int is_reference_frame(const VP9_COMP *cpi) {
+  const VP9_COMMON *const cm = &cpi->common;
   if (cpi->use_svc &&
       cpi->svc.temporal_layering_mode == VP9E_TEMPORAL_LAYERING_MODE_BYPASS)
-    is_reference_frame = !cpi->svc.non_reference_frame;
+    return !cpi->svc.non_reference_frame;
+  return cm->frame_type == KEY_FRAME || cpi->refresh_last_frame ||
+         cpi->refresh_golden_frame || cpi->refresh_alt_ref_frame;
+}
+
+static void pick_loopfilter_level(VP9_COMP *cpi, VP9_COMMON *cm) {
+  struct loopfilter *lf = &cm->lf;
 
   // Skip loop filter in show_existing_frame mode.
   if (cm->show_existing_frame) {
@@ -3329,13 +3310,13 @@ static void loopfilter_frame(VP9_COMP *cpi, VP9_COMMON *cm) {
   }
 
   if (cpi->loopfilter_ctrl == NO_LOOPFILTER ||
-      (!is_reference_frame && cpi->loopfilter_ctrl == LOOPFILTER_REFERENCE)) {
+      (!is_reference_frame(cpi) &&
+       cpi->loopfilter_ctrl == LOOPFILTER_REFERENCE)) {
     lf->filter_level = 0;
-    vpx_extend_frame_inner_borders(cm->frame_to_show);
     return;
   }
 
-  if (xd->lossless) {
+  if (cpi->td.mb.e_mbd.lossless) {
     lf->filter_level = 0;
     lf->last_filt_level = 0;
   } else {
@@ -3358,20 +3339,34 @@ static void loopfilter_frame(VP9_COMP *cpi, VP9_COMMON *cm) {
 
     vpx_usec_timer_mark(&timer);
     cpi->time_pick_lpf += vpx_usec_timer_elapsed(&timer);
+    cpi->stage_times.lf_search_us += vpx_usec_timer_elapsed(&timer);
   }
+}
 
-  if (lf->filter_level > 0 && is_reference_frame) {
+// Applies the loop filter at the level set by pick_loopfilter_level() on up to
+// 'num_workers' workers.
+static void loopfilter_frame(VP9_COMP *cpi, VP9_COMMON *cm, int num_workers) {
+  MACROBLOCKD *xd = &cpi->td.mb.e_mbd;
+  struct loopfilter *lf = &cm->lf;
+  struct vpx_usec_timer lf_timer;
+
+  if (cm->show_existing_frame) return;
+
+  vpx_usec_timer_start(&lf_timer);
+  if (lf->filter_level > 0 && is_reference_frame(cpi)) {
     vp9_build_mask_frame(cm, lf->filter_level, 0);
 
-    if (cpi->num_workers > 1)
+    if (num_workers > 1)
       vp9_loop_filter_frame_mt(cm->frame_to_show, cm, xd->plane,
                                lf->filter_level, 0, 0, cpi->workers,
-                               cpi->num_workers, &cpi->lf_row_sync);
+                               num_workers, &cpi->lf_row_sync);
     else
       vp9_loop_filter_frame(cm->frame_to_show, cm, xd, lf->filter_level, 0, 0);
   }
 
   vpx_extend_frame_inner_borders(cm->frame_to_show);
+  vpx_usec_timer_mark(&lf_timer);
+  cpi->stage_times.lf_us += vpx_usec_timer_elapsed(&lf_timer);
 }
 
 static INLINE void alloc_frame_mvs(VP9_COMMON *const cm, int buffer_idx) {
@@ -3392,6 +3387,9 @@ void vp9_scale_references(VP9_COMP *cpi) {
   MV_REFERENCE_FRAME ref_frame;
   const VP9_REFFRAME ref_mask[3] = { VP9_LAST_FLAG, VP9_GOLD_FLAG,
                                      VP9_ALT_FLAG };
+  struct vpx_usec_timer timer;
+
+  vpx_usec_timer_start(&timer);
 
   for (ref_frame = LAST_FRAME; ref_frame <= ALTREF_FRAME; ++ref_frame) {
     // Need to convert from VP9_REFFRAME to index into ref_mask (subtract 1).
@@ -3425,8 +3423,8 @@ void vp9_scale_references(VP9_COMP *cpi) {
                                        cm->byte_alignment, NULL, NULL, NULL))
             vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                                "Failed to allocate frame buffer");
-          scale_and_extend_frame(ref, &new_fb_ptr->buf, (int)cm->bit_depth,
-                                 EIGHTTAP, 0);
+          vp9_highbd_scale_and_extend_frame(ref, &new_fb_ptr->buf,
+                                            (int)cm->bit_depth, EIGHTTAP, 0);
           cpi->scaled_ref_idx[ref_frame - 1] = new_fb;
           alloc_frame_mvs(cm, new_fb);
         }
@@ -3478,6 +3476,9 @@ void vp9_scale_references(VP9_COMP *cpi) {
         cpi->scaled_ref_idx[ref_frame - 1] = INVALID_IDX;
     }
   }
+
+  vpx_usec_timer_mark(&timer);
+  cpi->stage_times.scale_us += vpx_usec_timer_elapsed(&timer);
 }
 
 static void release_scaled_references(VP9_COMP *cpi) {
@@ -3898,6 +3899,7 @@ static int encode_without_recode_loop(VP9_COMP *cpi, size_t *size,
   SVC *const svc = &cpi->svc;
   int q = 0, bottom_index = 0, top_index = 0;
   int no_drop_scene_change = 0;
+  struct vpx_usec_timer scale_timer;
   const INTERP_FILTER filter_scaler =
       (is_one_pass_cbr_svc(cpi))
           ? svc->downsample_filter_type[svc->spatial_layer_id]
@@ -3924,6 +3926,7 @@ static int encode_without_recode_loop(VP9_COMP *cpi, size_t *size,
 
   set_frame_size(cpi);
 
+  vpx_usec_timer_start(&scale_timer);
   if (is_one_pass_cbr_svc(cpi) &&
       cpi->un_scaled_source->y_width == cm->width << 2 &&
       cpi->un_scaled_source->y_height == cm->height << 2 &&
@@ -3972,6 +3975,8 @@ static int encode_without_recode_loop(VP9_COMP *cpi, size_t *size,
     cpi->raw_source_frame = cpi->Source;
 #endif
   }
+  vpx_usec_timer_mark(&scale_timer);
+  cpi->stage_times.scale_us += vpx_usec_timer_elapsed(&scale_timer);
 
   if ((cpi->use_svc &&
        (svc->spatial_layer_id < svc->number_spatial_layers - 1 ||
@@ -3996,10 +4001,14 @@ static int encode_without_recode_loop(VP9_COMP *cpi, size_t *size,
         cpi->oxcf.mode == REALTIME && cpi->oxcf.speed >= 5) ||
        cpi->sf.partition_search_type == SOURCE_VAR_BASED_PARTITION ||
        (cpi->noise_estimate.enabled && !cpi->oxcf.noise_sensitivity) ||
-       cpi->compute_source_sad_onepass))
+       cpi->compute_source_sad_onepass)) {
+    vpx_usec_timer_start(&scale_timer);
     cpi->Last_Source = vp9_scale_if_required(
         cm, cpi->unscaled_last_source, &cpi->scaled_last_source,
         (cpi->oxcf.pass == 0), EIGHTTAP, 0);
+    vpx_usec_timer_mark(&scale_timer);
+    cpi->stage_times.scale_us += vpx_usec_timer_elapsed(&scale_timer);
+  }
 
   if (cpi->Last_Source == NULL ||
       cpi->Last_Source->y_width != cpi->Source->y_width ||
@@ -4400,6 +4409,12 @@ static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size, uint8_t *dest
   int q = 0, q_low = 0, q_high = 0;
   int last_q_attempt = 0;
   int enable_acl;
+  // Packed and estimated size of the tiles of the first encode at the current
+  // frame size, which scale the tile size estimates of the recodes.
+  int64_t packed_tile_bits = 0;
+  int64_t estimated_tile_bits = 1;
+  int size_estimate_valid = 0;
+  struct vpx_usec_timer scale_timer;
 #ifdef AGGRESSIVE_VBR
   int qrange_adj = 1;
 #endif
@@ -4460,6 +4475,7 @@ static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size, uint8_t *dest
       // Reset the loop state for new frame size.
       overshoot_seen = 0;
       undershoot_seen = 0;
+      size_estimate_valid = 0;
 
       // Reconfiguration for change in frame size has concluded.
       cpi->resize_pending = 0;
@@ -4482,6 +4498,7 @@ static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size, uint8_t *dest
                                        &frame_over_shoot_limit);
     }
 
+    vpx_usec_timer_start(&scale_timer);
     cpi->Source =
         vp9_scale_if_required(cm, cpi->un_scaled_source, &cpi->scaled_source,
                               (oxcf->pass == 0), EIGHTTAP, 0);
@@ -4506,6 +4523,8 @@ static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size, uint8_t *dest
       cpi->Last_Source = vp9_scale_if_required(cm, cpi->unscaled_last_source,
                                                &cpi->scaled_last_source,
                                                (oxcf->pass == 0), EIGHTTAP, 0);
+    vpx_usec_timer_mark(&scale_timer);
+    cpi->stage_times.scale_us += vpx_usec_timer_elapsed(&scale_timer);
 
     if (frame_is_intra_only(cm) == 0) {
       if (loop_count > 0) {
@@ -4574,9 +4593,34 @@ static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size, uint8_t *dest
     // to recode.
     if (cpi->sf.recode_loop >= ALLOW_RECODE_KFARFGF) {
       save_coding_context(cpi);
-      if (!cpi->sf.use_nonrd_pick_mode) vp9_pack_bitstream(cpi, dest, size);
+      if (rc->estimate_recode_size && !cpi->sf.use_nonrd_pick_mode &&
+          !cpi->ext_ratectrl.ready) {
+        // Only the first encode at this size is packed. The recodes only
+        // write their headers, and the size of their tiles is predicted from
+        // their token and mode counts. The prediction is scaled by how far
+        // off it was for the packed encode.
+        int64_t header_bits;
+        const int64_t tile_bits =
+            VPXMAX(vp9_estimate_frame_bits(cpi, dest, &header_bits), 1);
+        if (!size_estimate_valid) {
+          restore_coding_context(cpi);
+          vp9_pack_bitstream(cpi, dest, size);
+          packed_tile_bits = VPXMAX(((int64_t)(*size) << 3) - header_bits, 0);
+          estimated_tile_bits = tile_bits;
+          size_estimate_valid = 1;
+          rc->projected_frame_size = (int)(*size) << 3;
+          rc->last_recode_size_estimate = -1;
+        } else {
+          rc->projected_frame_size =
+              (int)(header_bits +
+                    tile_bits * packed_tile_bits / estimated_tile_bits);
+          rc->last_recode_size_estimate = rc->projected_frame_size;
+        }
+      } else {
+        if (!cpi->sf.use_nonrd_pick_mode) vp9_pack_bitstream(cpi, dest, size);
 
-      rc->projected_frame_size = (int)(*size) << 3;
+        rc->projected_frame_size = (int)(*size) << 3;
+      }
 
       if (frame_over_shoot_limit == 0) frame_over_shoot_limit = 1;
     }
@@ -4898,10 +4942,12 @@ YV12_BUFFER_CONFIG *vp9_svc_twostage_scale(
       vp9_scale_and_extend_frame(scaled_temp, scaled, filter_type,
                                  phase_scaler);
     } else {
-      scale_and_extend_frame(unscaled, scaled_temp, (int)cm->bit_depth,
-                             filter_type2, phase_scaler2);
-      scale_and_extend_frame(scaled_temp, scaled, (int)cm->bit_depth,
-                             filter_type, phase_scaler);
+      vp9_highbd_scale_and_extend_frame(unscaled, scaled_temp,
+                                        (int)cm->bit_depth, filter_type2,
+                                        phase_scaler2);
+      vp9_highbd_scale_and_extend_frame(scaled_temp, scaled,
+                                        (int)cm->bit_depth, filter_type,
+                                        phase_scaler);
     }
 #else
     vp9_scale_and_extend_frame(unscaled, scaled_temp, filter_type2,
@@ -4925,8 +4971,8 @@ YV12_BUFFER_CONFIG *vp9_scale_if_required(
       if (cm->bit_depth == VPX_BITS_8)
         vp9_scale_and_extend_frame(unscaled, scaled, filter_type, phase_scaler);
       else
-        scale_and_extend_frame(unscaled, scaled, (int)cm->bit_depth,
-                               filter_type, phase_scaler);
+        vp9_highbd_scale_and_extend_frame(unscaled, scaled, (int)cm->bit_depth,
+                                          filter_type, phase_scaler);
     else
       scale_and_extend_frame_nonnormative(unscaled, scaled, (int)cm->bit_depth);
 #else
@@ -5388,6 +5434,7 @@ static void encode_frame_to_data_rate(
   const VP9EncoderConfig *const oxcf = &cpi->oxcf;
   struct segmentation *const seg = &cm->seg;
   TX_SIZE t;
+  int lf_workers;
 
   // SVC: skip encoding of enhancement layer if the layer target bandwidth = 0.
   // No need to set svc.skip_enhancement_layer if whole superframe will be
@@ -5478,6 +5525,7 @@ static void encode_frame_to_data_rate(
   save_encode_params(cpi);
 #endif  // CONFIG_CONSISTENT_RECODE || CONFIG_RATE_CTRL
 
+  cpi->rc.last_recode_size_estimate = -1;
   if (cpi->sf.recode_loop == DISALLOW_RECODE) {
     if (!encode_without_recode_loop(cpi, size, dest)) return;
   } else {
@@ -5545,12 +5593,26 @@ static void encode_frame_to_data_rate(
   cm->frame_to_show->render_height = cm->render_height;
 
   // Pick the loop filter level for the frame.
-  loopfilter_frame(cpi, cm);
+  pick_loopfilter_level(cpi, cm);
 
   if (cpi->rc.use_post_encode_drop) save_coding_context(cpi);
 
-  // build the bitstream
-  vp9_pack_bitstream(cpi, dest, size);
+  // The bitstream does not depend on the filtered frame. When the loop filter
+  // leaves a worker idle, build the bitstream on it while the frame is
+  // filtered.
+  lf_workers = cm->lf.filter_level > 0 && is_reference_frame(cpi)
+                   ? vp9_get_lf_workers_while_packing(cpi)
+                   : 0;
+  if (lf_workers > 0) {
+    vp9_launch_pack_bitstream(cpi, dest, size);
+    loopfilter_frame(cpi, cm, lf_workers);
+    vp9_sync_pack_bitstream(cpi);
+  } else {
+    loopfilter_frame(cpi, cm, cpi->num_workers);
+
+    // build the bitstream
+    vp9_pack_bitstream(cpi, dest, size);
+  }
 
   {
     const RefCntBuffer *coded_frame_buf =
@@ -5809,6 +5871,15 @@ int vp9_receive_raw_frame(VP9_COMP *cpi, vpx_enc_frame_flags_t frame_flags,
     res = -1;
   }
 
+#if !CONFIG_REALTIME_ONLY
+  // Only frames that are accepted are analyzed by the first pass.
+  if (res == 0 && cpi->oxcf.pass == 2 && cpi->oxcf.fp_lookahead > 0) {
+    vp9_fp_lookahead_push(
+        cpi, vp9_lookahead_peek(cpi->lookahead,
+                                vp9_lookahead_depth(cpi->lookahead) - 1));
+  }
+#endif
+
   return res;
 }
 
@@ -6622,7 +6693,7 @@ static void set_mv_limits(const VP9_COMMON *cm, MACROBLOCK *x, int mi_row,
       ((cm->mi_cols - 1 - mi_col) * MI_SIZE) + (17 - 2 * VP9_INTERP_EXTEND);
 }
 
-static void mode_estimation(VP9_COMP *cpi, MACROBLOCK *x, MACROBLOCKD *xd,
+static void mode_estimation(VP9_COMP *cpi, ThreadData *td,
                             struct scale_factors *sf, GF_PICTURE *gf_picture,
                             int frame_idx, TplDepFrame *tpl_frame,
                             int16_t *src_diff, tran_low_t *coeff,
@@ -6631,7 +6702,8 @@ static void mode_estimation(VP9_COMP *cpi, MACROBLOCK *x, MACROBLOCKD *xd,
                             YV12_BUFFER_CONFIG *ref_frame[], uint8_t *predictor,
                             int64_t *recon_error, int64_t *sse) {
   VP9_COMMON *cm = &cpi->common;
-  ThreadData *td = &cpi->td;
+  MACROBLOCK *const x = &td->mb;
+  MACROBLOCKD *const xd = &x->e_mbd;
 
   const int bw = 4 << b_width_log2_lookup[bsize];
   const int bh = 4 << b_height_log2_lookup[bsize];
@@ -7183,19 +7255,16 @@ static void build_motion_field(
 }
 #endif  // CONFIG_NON_GREEDY_MV
 
-static void mc_flow_dispenser(VP9_COMP *cpi, GF_PICTURE *gf_picture,
-                              int frame_idx, BLOCK_SIZE bsize) {
-  TplDepFrame *tpl_frame = &cpi->tpl_stats[frame_idx];
-  YV12_BUFFER_CONFIG *this_frame = gf_picture[frame_idx].frame;
-  YV12_BUFFER_CONFIG *ref_frame[MAX_INTER_REF_FRAMES] = { NULL, NULL, NULL };
-
-  VP9_COMMON *cm = &cpi->common;
-  struct scale_factors sf;
-  int rdmult, idx;
-  ThreadData *td = &cpi->td;
+void vp9_mc_flow_dispenser_row(VP9_COMP *cpi, ThreadData *td, int mi_row,
+                               int mi_col_start, int mi_col_end) {
+  TplFlowData *const flow_data = &cpi->tpl_flow_data;
+  TplDepFrame *tpl_frame = &cpi->tpl_stats[flow_data->frame_idx];
   MACROBLOCK *x = &td->mb;
   MACROBLOCKD *xd = &x->e_mbd;
-  int mi_row, mi_col;
+  MODE_INFO **const mi_save = xd->mi;
+  MODE_INFO mi;
+  MODE_INFO *mi_ptr = &mi;
+  int mi_col;
 
 #if CONFIG_VP9_HIGHBITDEPTH
   DECLARE_ALIGNED(16, uint16_t, predictor16[32 * 32 * 3]);
@@ -7209,29 +7278,70 @@ static void mc_flow_dispenser(VP9_COMP *cpi, GF_PICTURE *gf_picture,
   DECLARE_ALIGNED(16, tran_low_t, qcoeff[32 * 32]);
   DECLARE_ALIGNED(16, tran_low_t, dqcoeff[32 * 32]);
 
+  const BLOCK_SIZE bsize = flow_data->bsize;
   const TX_SIZE tx_size = max_txsize_lookup[bsize];
-  const int mi_height = num_8x8_blocks_high_lookup[bsize];
   const int mi_width = num_8x8_blocks_wide_lookup[bsize];
   int64_t recon_error, sse;
+
+  // Each row works on its own mode info so that rows can be estimated
+  // concurrently.
+  vp9_zero(mi);
+  xd->mi = &mi_ptr;
+  xd->cur_buf = flow_data->this_frame;
+
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH)
+    predictor = CONVERT_TO_BYTEPTR(predictor16);
+  else
+    predictor = predictor8;
+#endif
+
+  for (mi_col = mi_col_start; mi_col < mi_col_end; mi_col += mi_width) {
+    mode_estimation(cpi, td, &flow_data->sf, flow_data->gf_picture,
+                    flow_data->frame_idx, tpl_frame, src_diff, coeff, qcoeff,
+                    dqcoeff, mi_row, mi_col, bsize, tx_size,
+                    flow_data->ref_frame, predictor, &recon_error, &sse);
+    tpl_model_store(tpl_frame->tpl_stats_ptr, mi_row, mi_col, bsize,
+                    tpl_frame->stride);
+  }
+
+  xd->mi = mi_save;
+}
+
+static void mc_flow_dispenser(VP9_COMP *cpi, GF_PICTURE *gf_picture,
+                              int frame_idx, BLOCK_SIZE bsize) {
+  TplDepFrame *tpl_frame = &cpi->tpl_stats[frame_idx];
+  TplFlowData *const flow_data = &cpi->tpl_flow_data;
+  YV12_BUFFER_CONFIG *this_frame = gf_picture[frame_idx].frame;
+
+  VP9_COMMON *cm = &cpi->common;
+  int rdmult, idx;
+  ThreadData *td = &cpi->td;
+  MACROBLOCK *x = &td->mb;
+  MACROBLOCKD *xd = &x->e_mbd;
+  int mi_row, mi_col;
+
+  const int mi_height = num_8x8_blocks_high_lookup[bsize];
+  const int mi_width = num_8x8_blocks_wide_lookup[bsize];
 #if CONFIG_NON_GREEDY_MV
   int square_block_idx;
   int rf_idx;
 #endif
 
+  flow_data->gf_picture = gf_picture;
+  flow_data->frame_idx = frame_idx;
+  flow_data->bsize = bsize;
+  flow_data->this_frame = this_frame;
+
   // Setup scaling factor
 #if CONFIG_VP9_HIGHBITDEPTH
   vp9_setup_scale_factors_for_frame(
-      &sf, this_frame->y_crop_width, this_frame->y_crop_height,
+      &flow_data->sf, this_frame->y_crop_width, this_frame->y_crop_height,
       this_frame->y_crop_width, this_frame->y_crop_height,
       cpi->common.use_highbitdepth);
-
-  if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH)
-    predictor = CONVERT_TO_BYTEPTR(predictor16);
-  else
-    predictor = predictor8;
 #else
   vp9_setup_scale_factors_for_frame(
-      &sf, this_frame->y_crop_width, this_frame->y_crop_height,
+      &flow_data->sf, this_frame->y_crop_width, this_frame->y_crop_height,
       this_frame->y_crop_width, this_frame->y_crop_height);
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
@@ -7239,7 +7349,8 @@ static void mc_flow_dispenser(VP9_COMP *cpi, GF_PICTURE *gf_picture,
   // unavailable, the pointer will be set to Null.
   for (idx = 0; idx < MAX_INTER_REF_FRAMES; ++idx) {
     int rf_idx = gf_picture[frame_idx].ref_frame[idx];
-    if (rf_idx != -1) ref_frame[idx] = gf_picture[rf_idx].frame;
+    flow_data->ref_frame[idx] =
+        (rf_idx != -1) ? gf_picture[rf_idx].frame : NULL;
   }
 
   xd->mi = cm->mi_grid_visible;
@@ -7260,7 +7371,7 @@ static void mc_flow_dispenser(VP9_COMP *cpi, GF_PICTURE *gf_picture,
   for (square_block_idx = 0; square_block_idx < SQUARE_BLOCK_SIZES;
        ++square_block_idx) {
     BLOCK_SIZE square_bsize = square_block_idx_to_bsize(square_block_idx);
-    build_motion_field(cpi, frame_idx, ref_frame, square_bsize);
+    build_motion_field(cpi, frame_idx, flow_data->ref_frame, square_bsize);
   }
   for (rf_idx = 0; rf_idx < MAX_INTER_REF_FRAMES; ++rf_idx) {
     int ref_frame_idx = gf_picture[frame_idx].ref_frame[rf_idx];
@@ -7273,15 +7384,20 @@ static void mc_flow_dispenser(VP9_COMP *cpi, GF_PICTURE *gf_picture,
   }
 #endif
 
+  // The blocks of a frame only depend on the source and reference frames, so
+  // the rows can be estimated in any order.
+  if (cpi->row_mt) {
+    vp9_mc_flow_dispenser_row_mt(cpi);
+  } else {
+    for (mi_row = 0; mi_row < cm->mi_rows; mi_row += mi_height)
+      vp9_mc_flow_dispenser_row(cpi, td, mi_row, 0, cm->mi_cols);
+  }
+
+  // Motion flow dependency dispenser. This only accumulates into the stats of
+  // the reference frames, and is done in raster order after all the rows are
+  // estimated so the result does not depend on the number of threads.
   for (mi_row = 0; mi_row < cm->mi_rows; mi_row += mi_height) {
     for (mi_col = 0; mi_col < cm->mi_cols; mi_col += mi_width) {
-      mode_estimation(cpi, x, xd, &sf, gf_picture, frame_idx, tpl_frame,
-                      src_diff, coeff, qcoeff, dqcoeff, mi_row, mi_col, bsize,
-                      tx_size, ref_frame, predictor, &recon_error, &sse);
-      // Motion flow dependency dispenser.
-      tpl_model_store(tpl_frame->tpl_stats_ptr, mi_row, mi_col, bsize,
-                      tpl_frame->stride);
-
       tpl_model_update(cpi->tpl_stats, tpl_frame->tpl_stats_ptr, mi_row, mi_col,
                        bsize);
     }
@@ -7775,6 +7891,10 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
     vp9_one_pass_cbr_svc_start_layer(cpi);
   }
 
+#if !CONFIG_REALTIME_ONLY
+  if (oxcf->pass == 2) vp9_fp_lookahead_update(cpi, flush);
+#endif
+
   vpx_usec_timer_start(&cmptimer);
 
   vp9_set_high_precision_mv(cpi, ALTREF_HIGH_PRECISION_MV);
@@ -8376,6 +8496,34 @@ void vp9_apply_encoding_flags(VP9_COMP *cpi, vpx_enc_frame_flags_t flags) {
   }
 }
 
+void vp9_reset_stage_times(VP9_COMP *cpi) {
+  int t;
+  vp9_zero(cpi->stage_times);
+  cpi->td.time_pick_mode = 0;
+  cpi->td.time_transform = 0;
+  cpi->td.time_tokenize = 0;
+  for (t = 0; t < cpi->num_workers - 1; ++t) {
+    ThreadData *const td = cpi->tile_thr_data[t].td;
+    td->time_pick_mode = 0;
+    td->time_transform = 0;
+    td->time_tokenize = 0;
+  }
+}
+
+void vp9_get_stage_times(const VP9_COMP *cpi, vpx_frame_stats_t *stats) {
+  int t;
+  *stats = cpi->stage_times;
+  stats->pick_mode_us += cpi->td.time_pick_mode;
+  stats->transform_us += cpi->td.time_transform;
+  stats->pack_us += cpi->td.time_tokenize;
+  for (t = 0; t < cpi->num_workers - 1; ++t) {
+    const ThreadData *const td = cpi->tile_thr_data[t].td;
+    stats->pick_mode_us += td->time_pick_mode;
+    stats->transform_us += td->time_transform;
+    stats->pack_us += td->time_tokenize;
+  }
+}
+
 void vp9_set_row_mt(VP9_COMP *cpi) {
   // Enable row based multi-threading for supported modes of encoding
   cpi->row_mt = 0;
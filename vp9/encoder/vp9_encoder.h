@@ -25,6 +25,7 @@
 #include "vpx_ports/system_state.h"
 #include "vpx_util/vpx_thread.h"
 #include "vpx_util/vpx_timestamp.h"
+#include "vpx_util/vpx_job_counter.h"
 
 #include "vp9/common/vp9_alloccommon.h"
 #include "vp9/common/vp9_ppflags.h"
@@ -185,6 +186,9 @@ typedef struct VP9EncoderConfig {
   int key_freq;  // maximum distance to key frame.
 
   int lag_in_frames;  // how many frames lag before we start encoding
+  // Frames of first pass stats computed beyond the lag when the first pass
+  // runs alongside the second pass (pass == 2 without stats_in), or 0.
+  int fp_lookahead;
 
   // ----------------------------------------------------------------
   // DATARATE CONTROL OPTIONS
@@ -350,13 +354,6 @@ typedef struct TileDataEnc {
   int *row_base_thresh_freq_fact;
 } TileDataEnc;
 
-typedef struct RowMTInfo {
-  JobQueueHandle job_queue_hdl;
-#if CONFIG_MULTITHREAD
-  pthread_mutex_t job_mutex;
-#endif
-} RowMTInfo;
-
 typedef struct {
   TOKENEXTRA *start;
   TOKENEXTRA *stop;
@@ -376,7 +373,8 @@ typedef struct MultiThreadHandle {
 
   int jobs_per_tile_col;
 
-  RowMTInfo row_mt_info[MAX_NUM_TILE_COLS];
+  // Hands out the jobs of each tile column in order.
+  VPxJobCounter job_counter[MAX_NUM_TILE_COLS];
   int thread_id_to_tile_id[MAX_NUM_THREADS];  // Mapping of threads to tiles
 } MultiThreadHandle;
 
@@ -394,6 +392,15 @@ typedef struct ThreadData {
   PICK_MODE_CONTEXT *leaf_tree;
   PC_TREE *pc_tree;
   PC_TREE *pc_root;
+#if CONFIG_INTERNAL_STATS
+  // Time spent waiting for the row above in the row-mt first pass.
+  uint64_t fp_sync_wait_time;
+#endif
+  // Time spent in the block level stages of the frame, for
+  // VP9E_GET_FRAME_STATS.
+  int64_t time_pick_mode;
+  int64_t time_transform;
+  int64_t time_tokenize;
 } ThreadData;
 
 struct EncWorkerData;
@@ -509,6 +516,18 @@ typedef struct ARNRFilterData {
   struct scale_factors sf;
 } ARNRFilterData;
 
+struct GF_PICTURE;
+
+// Per-frame state shared by the rows of the TPL model motion flow pass.
+typedef struct TplFlowData {
+  struct GF_PICTURE *gf_picture;
+  int frame_idx;
+  BLOCK_SIZE bsize;
+  YV12_BUFFER_CONFIG *this_frame;
+  YV12_BUFFER_CONFIG *ref_frame[MAX_INTER_REF_FRAMES];
+  struct scale_factors sf;
+} TplFlowData;
+
 typedef struct EncFrameBuf {
   int mem_valid;
   int released;
@@ -688,6 +707,7 @@ typedef struct VP9_COMP {
 
   BLOCK_SIZE tpl_bsize;
   TplDepFrame tpl_stats[MAX_ARF_GOP_SIZE];
+  TplFlowData tpl_flow_data;
   YV12_BUFFER_CONFIG *tpl_recon_frames[REF_FRAMES];
   EncFrameBuf enc_frame_buf[REF_FRAMES];
 #if CONFIG_MULTITHREAD
@@ -804,6 +824,11 @@ typedef struct VP9_COMP {
   uint64_t time_compress_data;
   uint64_t time_pick_lpf;
   uint64_t time_encode_sb_row;
+  // Frame level stage times since the last vp9_reset_stage_times().
+  vpx_frame_stats_t stage_times;
+  // Set once VP9E_GET_FRAME_STATS is used. Turns on the per block timers that
+  // the block level stage times come from.
+  int time_block_stages;
 
 #if CONFIG_FP_MB_STATS
   int use_fp_mb_stats;
@@ -820,6 +845,11 @@ typedef struct VP9_COMP {
   // quantization of altref frames
   struct ALT_REF_AQ *alt_ref_aq;
 
+#if !CONFIG_REALTIME_ONLY
+  // First pass run ahead of this encoder when oxcf.fp_lookahead is set.
+  struct FP_LOOKAHEAD *fp_lookahead;
+#endif
+
 #if CONFIG_INTERNAL_STATS
   unsigned int mode_chosen_counts[MAX_MODES];
 
@@ -926,8 +956,17 @@ typedef struct VP9_COMP {
   // Multi-threading
   int num_workers;
   VPxWorker *workers;
+  // Shared threads the workers run on, if set by the application.
+  VPxThreadPool *thread_pool;
   struct EncWorkerData *tile_thr_data;
   VP9LfSync lf_row_sync;
+  // Luma copies of the unfiltered frame that the workers filter when trying
+  // loop filter levels at the same time, one per worker.
+  YV12_BUFFER_CONFIG *lpf_search_bufs;
+  int num_lpf_search_bufs;
+  // Output of the packing that runs on a worker while the loop filter is
+  // applied.
+  PackBitstreamData pack_data;
   struct VP9BitstreamWorkerData *vp9_bitstream_worker_data;
 
   int keep_level_stats;
@@ -1306,6 +1345,10 @@ YV12_BUFFER_CONFIG *vp9_scale_if_required(
 
 void vp9_apply_encoding_flags(VP9_COMP *cpi, vpx_enc_frame_flags_t flags);
 
+void vp9_reset_stage_times(VP9_COMP *cpi);
+
+void vp9_get_stage_times(const VP9_COMP *cpi, vpx_frame_stats_t *stats);
+
 static INLINE int is_one_pass_cbr_svc(const struct VP9_COMP *const cpi) {
   return (cpi->use_svc && cpi->oxcf.pass == 0);
 }
@@ -1387,6 +1430,11 @@ void vp9_new_framerate(VP9_COMP *cpi, double framerate);
 
 void vp9_set_row_mt(VP9_COMP *cpi);
 
+// Estimates the TPL model stats of the blocks of one row of the frame set up
+// in cpi->tpl_flow_data, from mi_col_start up to mi_col_end.
+void vp9_mc_flow_dispenser_row(VP9_COMP *cpi, ThreadData *td, int mi_row,
+                               int mi_col_start, int mi_col_end);
+
 int vp9_get_psnr(const VP9_COMP *cpi, PSNR_STATS *psnr);
 
 #define LAYER_IDS_TO_IDX(sl, tl, num_tl) ((sl) * (num_tl) + (tl))
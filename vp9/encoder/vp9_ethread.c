@@ -8,13 +8,16 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include "vp9/encoder/vp9_bitstream.h"
 #include "vp9/encoder/vp9_encodeframe.h"
 #include "vp9/encoder/vp9_encoder.h"
 #include "vp9/encoder/vp9_ethread.h"
 #include "vp9/encoder/vp9_firstpass.h"
 #include "vp9/encoder/vp9_multi_thread.h"
+#include "vp9/encoder/vp9_picklpf.h"
 #include "vp9/encoder/vp9_temporal_filter.h"
 #include "vpx_dsp/vpx_dsp_common.h"
+#include "vpx_ports/vpx_timer.h"
 
 static void accumulate_rd_opt(ThreadData *td, ThreadData *td_t) {
   int i, j, k, l, m, n;
@@ -104,6 +107,7 @@ static void create_enc_workers(VP9_COMP *cpi, int num_workers) {
 
       ++cpi->num_workers;
       winterface->init(worker);
+      worker->pool = cpi->thread_pool;
 
       if (i < allocated_workers - 1) {
         thread_data->cpi = cpi;
@@ -270,27 +274,18 @@ void vp9_row_mt_sync_mem_alloc(VP9RowMTSync *row_mt_sync, VP9_COMMON *cm,
   {
     int i;
 
-    CHECK_MEM_ERROR(cm, row_mt_sync->mutex,
-                    vpx_malloc(sizeof(*row_mt_sync->mutex) * rows));
-    if (row_mt_sync->mutex) {
+    CHECK_MEM_ERROR(cm, row_mt_sync->progress,
+                    vpx_malloc(sizeof(*row_mt_sync->progress) * rows));
+    if (row_mt_sync->progress) {
       for (i = 0; i < rows; ++i) {
-        pthread_mutex_init(&row_mt_sync->mutex[i], NULL);
-      }
-    }
-
-    CHECK_MEM_ERROR(cm, row_mt_sync->cond,
-                    vpx_malloc(sizeof(*row_mt_sync->cond) * rows));
-    if (row_mt_sync->cond) {
-      for (i = 0; i < rows; ++i) {
-        pthread_cond_init(&row_mt_sync->cond[i], NULL);
+        vp9_row_progress_init(&row_mt_sync->progress[i]);
       }
     }
   }
+#else
+  (void)cm;
 #endif  // CONFIG_MULTITHREAD
 
-  CHECK_MEM_ERROR(cm, row_mt_sync->cur_col,
-                  vpx_malloc(sizeof(*row_mt_sync->cur_col) * rows));
-
   // Set up nsync.
   row_mt_sync->sync_range = 1;
 }
@@ -301,20 +296,13 @@ void vp9_row_mt_sync_mem_dealloc(VP9RowMTSync *row_mt_sync) {
 #if CONFIG_MULTITHREAD
     int i;
 
-    if (row_mt_sync->mutex != NULL) {
-      for (i = 0; i < row_mt_sync->rows; ++i) {
-        pthread_mutex_destroy(&row_mt_sync->mutex[i]);
-      }
-      vpx_free(row_mt_sync->mutex);
-    }
-    if (row_mt_sync->cond != NULL) {
+    if (row_mt_sync->progress != NULL) {
       for (i = 0; i < row_mt_sync->rows; ++i) {
-        pthread_cond_destroy(&row_mt_sync->cond[i]);
+        vp9_row_progress_destroy(&row_mt_sync->progress[i]);
       }
-      vpx_free(row_mt_sync->cond);
+      vpx_free(row_mt_sync->progress);
     }
 #endif  // CONFIG_MULTITHREAD
-    vpx_free(row_mt_sync->cur_col);
     // clear the structure as the source of this call may be dynamic change
     // in tiles in which case this call will be followed by an _alloc()
     // which may fail.
@@ -322,18 +310,25 @@ void vp9_row_mt_sync_mem_dealloc(VP9RowMTSync *row_mt_sync) {
   }
 }
 
+void vp9_row_mt_sync_reset(VP9RowMTSync *row_mt_sync, int rows) {
+#if CONFIG_MULTITHREAD
+  int i;
+  // Initialize cur_col to -1 for all rows.
+  for (i = 0; i < rows; ++i) {
+    vp9_row_progress_reset(&row_mt_sync->progress[i], -1);
+  }
+#else
+  (void)row_mt_sync;
+  (void)rows;
+#endif  // CONFIG_MULTITHREAD
+}
+
 void vp9_row_mt_sync_read(VP9RowMTSync *const row_mt_sync, int r, int c) {
 #if CONFIG_MULTITHREAD
   const int nsync = row_mt_sync->sync_range;
 
   if (r && !(c & (nsync - 1))) {
-    pthread_mutex_t *const mutex = &row_mt_sync->mutex[r - 1];
-    pthread_mutex_lock(mutex);
-
-    while (c > row_mt_sync->cur_col[r - 1] - nsync + 1) {
-      pthread_cond_wait(&row_mt_sync->cond[r - 1], mutex);
-    }
-    pthread_mutex_unlock(mutex);
+    vp9_row_progress_wait(&row_mt_sync->progress[r - 1], c + nsync - 1);
   }
 #else
   (void)row_mt_sync;
@@ -364,14 +359,7 @@ void vp9_row_mt_sync_write(VP9RowMTSync *const row_mt_sync, int r, int c,
     cur = cols + nsync;
   }
 
-  if (sig) {
-    pthread_mutex_lock(&row_mt_sync->mutex[r]);
-
-    row_mt_sync->cur_col[r] = cur;
-
-    pthread_cond_signal(&row_mt_sync->cond[r]);
-    pthread_mutex_unlock(&row_mt_sync->mutex[r]);
-  }
+  if (sig) vp9_row_progress_set(&row_mt_sync->progress[r], cur);
 #else
   (void)row_mt_sync;
   (void)r;
@@ -389,6 +377,20 @@ void vp9_row_mt_sync_write_dummy(VP9RowMTSync *const row_mt_sync, int r, int c,
   return;
 }
 
+int vp9_get_fp_sync_range(int width) {
+  // A first pass MB is cheap to encode, so on wide frames signaling the row
+  // below after every MB costs more than the extra startup delay of a coarser
+  // wavefront. The numbers are picked by testing, as in the loop filter.
+  if (width < 640)
+    return 1;
+  else if (width <= 1280)
+    return 2;
+  else if (width <= 2560)
+    return 4;
+  else
+    return 8;
+}
+
 #if !CONFIG_REALTIME_ONLY
 static int first_pass_worker_hook(void *arg1, void *arg2) {
   EncWorkerData *const thread_data = (EncWorkerData *)arg1;
@@ -414,9 +416,8 @@ static int first_pass_worker_hook(void *arg1, void *arg2) {
         (JobNode *)vp9_enc_grp_get_next_job(multi_thread_ctxt, cur_tile_id);
     if (NULL == proc_job) {
       // Query for the status of other tiles
-      end_of_frame = vp9_get_tiles_proc_status(
-          multi_thread_ctxt, thread_data->tile_completion_status, &cur_tile_id,
-          tile_cols);
+      end_of_frame = vp9_get_tiles_proc_status(multi_thread_ctxt,
+                                               &cur_tile_id, tile_cols);
     } else {
       tile_col = proc_job->tile_col_id;
       tile_row = proc_job->tile_row_id;
@@ -427,8 +428,23 @@ static int first_pass_worker_hook(void *arg1, void *arg2) {
       best_ref_mv = zero_mv;
       vp9_zero(fp_acc_data);
       fp_acc_data.image_data_start_row = INVALID_ROW;
+#if CONFIG_INTERNAL_STATS
+      {
+        struct vpx_usec_timer row_timer;
+        const uint64_t wait_time = thread_data->td->fp_sync_wait_time;
+        vpx_usec_timer_start(&row_timer);
+        vp9_first_pass_encode_tile_mb_row(cpi, thread_data->td, &fp_acc_data,
+                                          this_tile, &best_ref_mv, mb_row);
+        vpx_usec_timer_mark(&row_timer);
+        thread_data->fp_busy_time +=
+            vpx_usec_timer_elapsed(&row_timer) -
+            (thread_data->td->fp_sync_wait_time - wait_time);
+        ++thread_data->fp_rows;
+      }
+#else
       vp9_first_pass_encode_tile_mb_row(cpi, thread_data->td, &fp_acc_data,
                                         this_tile, &best_ref_mv, mb_row);
+#endif  // CONFIG_INTERNAL_STATS
     }
   }
   return 0;
@@ -469,10 +485,34 @@ void vp9_encode_fp_row_mt(VP9_COMP *cpi) {
     if (thread_data->td != &cpi->td) {
       thread_data->td->mb = cpi->td.mb;
     }
+#if CONFIG_INTERNAL_STATS
+    thread_data->fp_busy_time = 0;
+#endif
   }
 
+#if CONFIG_INTERNAL_STATS
+  {
+    struct vpx_usec_timer frame_timer;
+    uint64_t frame_time;
+
+    vpx_usec_timer_start(&frame_timer);
+    launch_enc_workers(cpi, first_pass_worker_hook, multi_thread_ctxt,
+                       num_workers);
+    vpx_usec_timer_mark(&frame_timer);
+    frame_time = VPXMAX(vpx_usec_timer_elapsed(&frame_timer), 1);
+
+    for (i = 0; i < num_workers; i++) {
+      EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
+      const uint64_t busy_time = VPXMIN(thread_data->fp_busy_time, frame_time);
+      ++thread_data->fp_util_hist[VPXMIN(busy_time * 10 / frame_time, 9)];
+      thread_data->fp_total_busy_time += busy_time;
+      thread_data->fp_total_frame_time += frame_time;
+    }
+  }
+#else
   launch_enc_workers(cpi, first_pass_worker_hook, multi_thread_ctxt,
                      num_workers);
+#endif  // CONFIG_INTERNAL_STATS
 
   first_tile_col = &cpi->tile_data[0];
   for (i = 1; i < tile_cols; i++) {
@@ -481,6 +521,30 @@ void vp9_encode_fp_row_mt(VP9_COMP *cpi) {
   }
 }
 
+#if CONFIG_INTERNAL_STATS
+void vp9_print_fp_row_mt_stats(const VP9_COMP *cpi) {
+  FILE *const f = fopen("fpthreads.stt", "a");
+  int i, j;
+
+  if (f == NULL) return;
+  fprintf(f, "Thread\t  Rows\t  Util\t");
+  for (j = 0; j < 10; j++) fprintf(f, "  <%3d%%", (j + 1) * 10);
+  fprintf(f, "\n");
+  for (i = 0; i < cpi->num_workers; i++) {
+    const EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
+    const double util =
+        thread_data->fp_total_frame_time
+            ? 100.0 * thread_data->fp_total_busy_time /
+                  thread_data->fp_total_frame_time
+            : 0.0;
+    fprintf(f, "%6d\t%6d\t%5.1f%%\t", i, thread_data->fp_rows, util);
+    for (j = 0; j < 10; j++) fprintf(f, "%7u", thread_data->fp_util_hist[j]);
+    fprintf(f, "\n");
+  }
+  fclose(f);
+}
+#endif  // CONFIG_INTERNAL_STATS
+
 static int temporal_filter_worker_hook(void *arg1, void *arg2) {
   EncWorkerData *const thread_data = (EncWorkerData *)arg1;
   MultiThreadHandle *multi_thread_ctxt = (MultiThreadHandle *)arg2;
@@ -503,9 +567,8 @@ static int temporal_filter_worker_hook(void *arg1, void *arg2) {
         (JobNode *)vp9_enc_grp_get_next_job(multi_thread_ctxt, cur_tile_id);
     if (NULL == proc_job) {
       // Query for the status of other tiles
-      end_of_frame = vp9_get_tiles_proc_status(
-          multi_thread_ctxt, thread_data->tile_completion_status, &cur_tile_id,
-          tile_cols);
+      end_of_frame = vp9_get_tiles_proc_status(multi_thread_ctxt,
+                                               &cur_tile_id, tile_cols);
     } else {
       tile_col = proc_job->tile_col_id;
       tile_row = proc_job->tile_row_id;
@@ -560,6 +623,222 @@ void vp9_temporal_filter_row_mt(VP9_COMP *cpi) {
 }
 #endif  // !CONFIG_REALTIME_ONLY
 
+static int tpl_worker_hook(void *arg1, void *arg2) {
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  MultiThreadHandle *multi_thread_ctxt = (MultiThreadHandle *)arg2;
+  VP9_COMP *const cpi = thread_data->cpi;
+  const VP9_COMMON *const cm = &cpi->common;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int mi_height = num_8x8_blocks_high_lookup[cpi->tpl_bsize];
+  int tile_row, tile_col;
+  TileDataEnc *this_tile;
+  int end_of_frame;
+  int thread_id = thread_data->thread_id;
+  int cur_tile_id = multi_thread_ctxt->thread_id_to_tile_id[thread_id];
+  JobNode *proc_job = NULL;
+  int mi_row;
+
+  end_of_frame = 0;
+  while (0 == end_of_frame) {
+    // Get the next job in the queue
+    proc_job =
+        (JobNode *)vp9_enc_grp_get_next_job(multi_thread_ctxt, cur_tile_id);
+    if (NULL == proc_job) {
+      // Query for the status of other tiles
+      end_of_frame = vp9_get_tiles_proc_status(multi_thread_ctxt,
+                                               &cur_tile_id, tile_cols);
+    } else {
+      tile_col = proc_job->tile_col_id;
+      tile_row = proc_job->tile_row_id;
+      this_tile = &cpi->tile_data[tile_row * tile_cols + tile_col];
+      mi_row = proc_job->vert_unit_row_num * mi_height;
+
+      vp9_mc_flow_dispenser_row(cpi, thread_data->td, mi_row,
+                                this_tile->tile_info.mi_col_start,
+                                this_tile->tile_info.mi_col_end);
+    }
+  }
+  return 0;
+}
+
+// The TPL rows have no dependency on each other within a frame, so unlike the
+// encoder the workers need no VP9RowMTSync and simply drain the job queue.
+void vp9_mc_flow_dispenser_row_mt(VP9_COMP *cpi) {
+  VP9_COMMON *const cm = &cpi->common;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int tile_rows = 1 << cm->log2_tile_rows;
+  MultiThreadHandle *multi_thread_ctxt = &cpi->multi_thread_ctxt;
+  int num_workers = VPXMAX(cpi->oxcf.max_threads, 1);
+  int i;
+
+  // The job queue is sized for 16x16 rows, which is enough for TPL blocks of
+  // 16x16 and larger.
+  assert(num_8x8_blocks_high_lookup[cpi->tpl_bsize] >= 2);
+
+  if (multi_thread_ctxt->allocated_tile_cols < tile_cols ||
+      multi_thread_ctxt->allocated_tile_rows < tile_rows ||
+      multi_thread_ctxt->allocated_vert_unit_rows < cm->mb_rows) {
+    vp9_row_mt_mem_dealloc(cpi);
+    vp9_init_tile_data(cpi);
+    vp9_row_mt_mem_alloc(cpi);
+  } else {
+    vp9_init_tile_data(cpi);
+  }
+
+  create_enc_workers(cpi, num_workers);
+
+  vp9_assign_tile_to_thread(multi_thread_ctxt, tile_cols, cpi->num_workers);
+
+  vp9_prepare_job_queue(cpi, TPL_JOB);
+
+  for (i = 0; i < num_workers; i++) {
+    EncWorkerData *thread_data;
+    thread_data = &cpi->tile_thr_data[i];
+
+    // Before estimating a frame, copy the thread data from cpi.
+    if (thread_data->td != &cpi->td) {
+      thread_data->td->mb = cpi->td.mb;
+    }
+  }
+
+  launch_enc_workers(cpi, tpl_worker_hook, multi_thread_ctxt, num_workers);
+}
+
+typedef struct LpfSearchData {
+  const YV12_BUFFER_CONFIG *sd;
+  const int *levels;
+  int64_t *errs;
+  int num_levels;
+  int partial_frame;
+} LpfSearchData;
+
+static int lpf_search_worker_hook(void *arg1, void *arg2) {
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  LpfSearchData *const search = (LpfSearchData *)arg2;
+  VP9_COMP *const cpi = thread_data->cpi;
+  YV12_BUFFER_CONFIG *const buf = &cpi->lpf_search_bufs[thread_data->start];
+  int i;
+
+  for (i = thread_data->start; i < search->num_levels; i += cpi->num_workers) {
+    search->errs[i] = vp9_try_filter_level_on_copy(
+        search->sd, cpi, search->levels[i], search->partial_frame, buf);
+  }
+  return 1;
+}
+
+// The level search only filters and measures the luma plane, so a worker's
+// copy of the frame has no chroma planes and no border.
+static void alloc_lpf_search_buf(VP9_COMMON *cm, YV12_BUFFER_CONFIG *buf) {
+  const int aligned_width = (cm->width + 7) & ~7;
+  const int aligned_height = (cm->height + 7) & ~7;
+  const int y_stride = (aligned_width + 31) & ~31;
+#if CONFIG_VP9_HIGHBITDEPTH
+  const int bytes_per_sample = cm->use_highbitdepth ? 2 : 1;
+#else
+  const int bytes_per_sample = 1;
+#endif
+  const size_t size = (size_t)y_stride * aligned_height * bytes_per_sample;
+
+  if (size > buf->buffer_alloc_sz) {
+    vpx_free_frame_buffer(buf);
+    CHECK_MEM_ERROR(cm, buf->buffer_alloc, (uint8_t *)vpx_memalign(32, size));
+    buf->buffer_alloc_sz = size;
+  }
+  buf->y_width = aligned_width;
+  buf->y_height = aligned_height;
+  buf->y_crop_width = cm->width;
+  buf->y_crop_height = cm->height;
+  buf->y_stride = y_stride;
+  buf->y_buffer = buf->buffer_alloc;
+  buf->flags = 0;
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (cm->use_highbitdepth) {
+    buf->y_buffer = CONVERT_TO_BYTEPTR(buf->buffer_alloc);
+    buf->flags = YV12_FLAG_HIGHBITDEPTH;
+  }
+#endif
+}
+
+void vp9_try_filter_levels_mt(VP9_COMP *cpi, const YV12_BUFFER_CONFIG *sd,
+                              const int *levels, int64_t *errs, int num_levels,
+                              int partial_frame) {
+  VP9_COMMON *const cm = &cpi->common;
+  LpfSearchData search;
+  int i;
+
+  // The workers were created to encode the frame.
+  assert(cpi->num_workers > 1);
+
+  if (cpi->num_lpf_search_bufs < cpi->num_workers) {
+    for (i = 0; i < cpi->num_lpf_search_bufs; ++i)
+      vpx_free_frame_buffer(&cpi->lpf_search_bufs[i]);
+    vpx_free(cpi->lpf_search_bufs);
+    cpi->num_lpf_search_bufs = 0;
+    CHECK_MEM_ERROR(cm, cpi->lpf_search_bufs,
+                    vpx_calloc(cpi->num_workers, sizeof(*cpi->lpf_search_bufs)));
+    cpi->num_lpf_search_bufs = cpi->num_workers;
+  }
+  for (i = 0; i < VPXMIN(num_levels, cpi->num_workers); ++i)
+    alloc_lpf_search_buf(cm, &cpi->lpf_search_bufs[i]);
+
+  search.sd = sd;
+  search.levels = levels;
+  search.errs = errs;
+  search.num_levels = num_levels;
+  search.partial_frame = partial_frame;
+
+  // All the workers are launched so that the main thread takes a level too.
+  launch_enc_workers(cpi, lpf_search_worker_hook, &search, cpi->num_workers);
+}
+
+static int pack_bitstream_worker_hook(void *arg1, void *arg2) {
+  VP9_COMP *const cpi = (VP9_COMP *)arg1;
+  PackBitstreamData *const data = (PackBitstreamData *)arg2;
+  vp9_pack_bitstream(cpi, data->dest, data->size);
+  return 1;
+}
+
+int vp9_get_lf_workers_while_packing(const VP9_COMP *cpi) {
+  const VP9_COMMON *const cm = &cpi->common;
+  const int sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  // The loop filter uses at most one worker per tile column, see
+  // loop_filter_rows_mt().
+  const int lf_workers = VPXMIN(cpi->num_workers, VPXMIN(tile_cols, sb_rows));
+
+  if (cpi->num_workers < 2 || vp9_pack_bitstream_uses_workers(cpi)) return 0;
+
+  // The packing takes the worker at num_workers - 2, the last one with a
+  // thread. The loop filter runs on the main thread alone, or on the workers
+  // before the packing one, and is not given fewer workers than it would use
+  // otherwise.
+  if (lf_workers > 1 && lf_workers > cpi->num_workers - 2) return 0;
+  return lf_workers;
+}
+
+void vp9_launch_pack_bitstream(VP9_COMP *cpi, uint8_t *dest, size_t *size) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  VPxWorker *const worker = &cpi->workers[cpi->num_workers - 2];
+
+  assert(cpi->num_workers >= 2);
+  cpi->pack_data.dest = dest;
+  cpi->pack_data.size = size;
+  worker->hook = pack_bitstream_worker_hook;
+  worker->data1 = cpi;
+  worker->data2 = &cpi->pack_data;
+  worker->had_error = 0;
+  winterface->launch(worker);
+}
+
+void vp9_sync_pack_bitstream(VP9_COMP *cpi) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  VPxWorker *const worker = &cpi->workers[cpi->num_workers - 2];
+
+  if (!winterface->sync(worker))
+    vpx_internal_error(&cpi->common.error, VPX_CODEC_ERROR,
+                       "Failed to pack the bitstream");
+}
+
 static int enc_row_mt_worker_hook(void *arg1, void *arg2) {
   EncWorkerData *const thread_data = (EncWorkerData *)arg1;
   MultiThreadHandle *multi_thread_ctxt = (MultiThreadHandle *)arg2;
@@ -580,9 +859,8 @@ static int enc_row_mt_worker_hook(void *arg1, void *arg2) {
         (JobNode *)vp9_enc_grp_get_next_job(multi_thread_ctxt, cur_tile_id);
     if (NULL == proc_job) {
       // Query for the status of other tiles
-      end_of_frame = vp9_get_tiles_proc_status(
-          multi_thread_ctxt, thread_data->tile_completion_status, &cur_tile_id,
-          tile_cols);
+      end_of_frame = vp9_get_tiles_proc_status(multi_thread_ctxt,
+                                               &cur_tile_id, tile_cols);
     } else {
       tile_col = proc_job->tile_col_id;
       tile_row = proc_job->tile_row_id;
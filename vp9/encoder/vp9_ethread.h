@@ -11,6 +11,8 @@
 #ifndef VPX_VP9_ENCODER_VP9_ETHREAD_H_
 #define VPX_VP9_ENCODER_VP9_ETHREAD_H_
 
+#include "vp9/common/vp9_thread_common.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -27,17 +29,31 @@ typedef struct EncWorkerData {
   struct ThreadData *td;
   int start;
   int thread_id;
-  int tile_completion_status[MAX_NUM_TILE_COLS];
+#if CONFIG_INTERNAL_STATS
+  // Row-mt first pass statistics of the thread.
+  int fp_rows;                   // MB rows encoded.
+  uint64_t fp_busy_time;         // Time spent encoding the rows of the frame.
+  uint64_t fp_total_busy_time;   // Sum of fp_busy_time over all the frames.
+  uint64_t fp_total_frame_time;  // Sum of the wall time of all the frames.
+  // Number of frames whose utilization (fp_busy_time over the wall time of
+  // the frame) falls in each 10% bucket.
+  unsigned int fp_util_hist[10];
+#endif  // CONFIG_INTERNAL_STATS
 } EncWorkerData;
 
+// Output of the bitstream packing that runs on a worker while the loop filter
+// is applied.
+typedef struct PackBitstreamData {
+  uint8_t *dest;
+  size_t *size;
+} PackBitstreamData;
+
 // Encoder row synchronization
 typedef struct VP9RowMTSyncData {
 #if CONFIG_MULTITHREAD
-  pthread_mutex_t *mutex;
-  pthread_cond_t *cond;
+  // The sb/mb block index in each row.
+  VP9RowProgress *progress;
 #endif
-  // Allocate memory to store the sb/mb block index in each row.
-  int *cur_col;
   int sync_range;
   int rows;
 } VP9RowMTSync;
@@ -48,6 +64,16 @@ void vp9_encode_tiles_row_mt(struct VP9_COMP *cpi);
 
 void vp9_encode_fp_row_mt(struct VP9_COMP *cpi);
 
+// Returns the number of MBs a first pass row encodes between two progress
+// updates for the row below, for a frame of the given width.
+int vp9_get_fp_sync_range(int width);
+
+#if CONFIG_INTERNAL_STATS
+// Appends the per-thread utilization histogram of the row-mt first pass to
+// fpthreads.stt.
+void vp9_print_fp_row_mt_stats(const struct VP9_COMP *cpi);
+#endif  // CONFIG_INTERNAL_STATS
+
 void vp9_row_mt_sync_read(VP9RowMTSync *const row_mt_sync, int r, int c);
 void vp9_row_mt_sync_write(VP9RowMTSync *const row_mt_sync, int r, int c,
                            const int cols);
@@ -56,6 +82,9 @@ void vp9_row_mt_sync_read_dummy(VP9RowMTSync *const row_mt_sync, int r, int c);
 void vp9_row_mt_sync_write_dummy(VP9RowMTSync *const row_mt_sync, int r, int c,
                                  const int cols);
 
+// Reset the progress of all the rows, before the rows are processed.
+void vp9_row_mt_sync_reset(VP9RowMTSync *row_mt_sync, int rows);
+
 // Allocate memory for row based multi-threading synchronization.
 void vp9_row_mt_sync_mem_alloc(VP9RowMTSync *row_mt_sync, struct VP9Common *cm,
                                int rows);
@@ -65,6 +94,26 @@ void vp9_row_mt_sync_mem_dealloc(VP9RowMTSync *row_mt_sync);
 
 void vp9_temporal_filter_row_mt(struct VP9_COMP *cpi);
 
+void vp9_mc_flow_dispenser_row_mt(struct VP9_COMP *cpi);
+
+// Tries the loop filter levels in 'levels' at the same time, each worker
+// filtering its own copy of the unfiltered frame, and stores the luma sse
+// against 'sd' of each level in 'errs'.
+void vp9_try_filter_levels_mt(struct VP9_COMP *cpi,
+                              const YV12_BUFFER_CONFIG *sd, const int *levels,
+                              int64_t *errs, int num_levels, int partial_frame);
+
+// Returns the number of workers the loop filter can be applied on while the
+// bitstream is packed on another one, or 0 if there is no worker to spare.
+int vp9_get_lf_workers_while_packing(const struct VP9_COMP *cpi);
+
+// Starts packing the bitstream into 'dest' on the last worker with a thread of
+// its own. vp9_sync_pack_bitstream() must be called before the output is used.
+void vp9_launch_pack_bitstream(struct VP9_COMP *cpi, uint8_t *dest,
+                               size_t *size);
+
+void vp9_sync_pack_bitstream(struct VP9_COMP *cpi);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
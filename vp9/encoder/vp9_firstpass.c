@@ -19,6 +19,7 @@
 #include "vpx_mem/vpx_mem.h"
 #include "vpx_ports/mem.h"
 #include "vpx_ports/system_state.h"
+#include "vpx_ports/vpx_timer.h"
 #include "vpx_scale/vpx_scale.h"
 #include "vpx_scale/yv12config.h"
 
@@ -957,7 +958,17 @@ void vp9_first_pass_encode_tile_mb_row(VP9_COMP *cpi, ThreadData *td,
     const int mb_index = mb_row * cm->mb_cols + mb_col;
 #endif
 
+#if CONFIG_INTERNAL_STATS
+    {
+      struct vpx_usec_timer wait_timer;
+      vpx_usec_timer_start(&wait_timer);
+      (*(cpi->row_mt_sync_read_ptr))(&tile_data->row_mt_sync, mb_row, c);
+      vpx_usec_timer_mark(&wait_timer);
+      td->fp_sync_wait_time += vpx_usec_timer_elapsed(&wait_timer);
+    }
+#else
     (*(cpi->row_mt_sync_read_ptr))(&tile_data->row_mt_sync, mb_row, c);
+#endif  // CONFIG_INTERNAL_STATS
 
     // Adjust to the next column of MBs.
     x->plane[0].src.buf = cpi->Source->y_buffer +
@@ -1734,7 +1745,23 @@ void vp9_init_second_pass(VP9_COMP *cpi) {
 
   stats = &twopass->total_stats;
 
-  *stats = *twopass->stats_in_end;
+  if (oxcf->fp_lookahead > 0) {
+    // There is no total stats packet, only the stats of the frames in the
+    // lookahead so far.
+    const FIRSTPASS_STATS *s;
+    for (s = twopass->stats_in; s < twopass->stats_in_end; ++s)
+      accumulate_stats(stats, s);
+    twopass->kf_scan_show_idx = 0;
+  } else if ((int)(twopass->stats_in_end->count + 0.5) >
+             twopass->stats_in_end - twopass->stats_in) {
+    // The stats are a window of a longer first pass, followed by the total
+    // stats packet of the whole clip. Total the window itself.
+    const FIRSTPASS_STATS *s;
+    for (s = twopass->stats_in; s < twopass->stats_in_end; ++s)
+      accumulate_stats(stats, s);
+  } else {
+    *stats = *twopass->stats_in_end;
+  }
   twopass->total_left_stats = *stats;
 
   // Scan the first pass file and calculate a modified score for each
@@ -1831,6 +1858,66 @@ void vp9_init_second_pass(VP9_COMP *cpi) {
   twopass->arnr_strength_adjustment = 0;
 }
 
+void vp9_twopass_update_stats_in(VP9_COMP *cpi, const FIRSTPASS_STATS *stats,
+                                 int num_frames, int second_pass_started) {
+  const VP9EncoderConfig *const oxcf = &cpi->oxcf;
+  TWO_PASS *const twopass = &cpi->twopass;
+  const int prev_num_frames = fps_get_num_frames(&twopass->first_pass_info);
+  const int pos =
+      twopass->stats_in ? (int)(twopass->stats_in - twopass->stats_in_start)
+                        : 0;
+  const FIRSTPASS_STATS *s;
+
+  twopass->stats_in_start = stats;
+  twopass->stats_in = stats + pos;
+  twopass->stats_in_end = stats + num_frames;
+  fps_init_first_pass_info(&twopass->first_pass_info, stats, num_frames);
+
+  if (second_pass_started) {
+    const double av_err = get_distribution_av_err(cpi, twopass);
+    for (s = stats + prev_num_frames; s < stats + num_frames; ++s) {
+      accumulate_stats(&twopass->total_stats, s);
+      accumulate_stats(&twopass->total_left_stats, s);
+      twopass->normalized_score_left +=
+          calculate_norm_frame_score(cpi, twopass, oxcf, s, av_err);
+      twopass->bits_left +=
+          (int64_t)(s->duration * oxcf->target_bandwidth / 10000000.0);
+    }
+  }
+}
+
+void vp9_twopass_set_chunk_start_frame(VP9_COMP *cpi, int start_frame) {
+  const VP9EncoderConfig *const oxcf = &cpi->oxcf;
+  TWO_PASS *const twopass = &cpi->twopass;
+  const FIRSTPASS_STATS *const start = twopass->stats_in_start + start_frame;
+  const double av_err = get_distribution_av_err(cpi, twopass);
+  double skipped_score = 0.0;
+  const FIRSTPASS_STATS *s;
+
+  assert(twopass->stats_in == twopass->stats_in_start);
+  assert(start < twopass->stats_in_end);
+
+  // The frames before the chunk are coded elsewhere. Leave them out of what
+  // is left to code, and hand the chunk the share of the bits a full encode
+  // would have left for it.
+  for (s = twopass->stats_in_start; s < start; ++s) {
+    subtract_stats(&twopass->total_left_stats, s);
+    skipped_score += calculate_norm_frame_score(cpi, twopass, oxcf, s, av_err);
+  }
+  if (twopass->normalized_score_left > 0.0) {
+    twopass->bits_left = (int64_t)(
+        twopass->bits_left *
+        (1.0 - skipped_score / twopass->normalized_score_left));
+  }
+  twopass->normalized_score_left -= skipped_score;
+
+  twopass->stats_in_start = start;
+  twopass->stats_in = start;
+  fps_init_first_pass_info(&twopass->first_pass_info, start,
+                           (int)(twopass->stats_in_end - start));
+  twopass->chunk_start_frame = start_frame;
+}
+
 /* This function considers how the quality of prediction may be deteriorating
  * with distance. It compares the coded error for the last frame and the
  * second reference frame (usually two frames old) and also applies a factor
@@ -3239,6 +3326,15 @@ int vp9_get_frames_to_next_key(const VP9EncoderConfig *oxcf,
       ++frames_to_key;
     }
   }
+
+  // With the first pass lookahead the clip may go on past the stats known so
+  // far. Without a scene cut in them, assume there is none up to the max
+  // interval: vp9_rc_get_second_pass_params() checks the frames of the kf
+  // group again as their stats come in.
+  if (oxcf->fp_lookahead > 0 && !twopass->first_pass_done &&
+      frames_to_key == max_frames_to_key)
+    frames_to_key = oxcf->key_freq;
+
   return frames_to_key;
 }
 
@@ -3271,6 +3367,9 @@ static void find_next_key_frame(VP9_COMP *cpi, int kf_show_idx) {
   double abs_mv_in_out_accumulator = 0.0;
   const double av_err = get_distribution_av_err(cpi, twopass);
   const double mean_mod_score = twopass->mean_mod_score;
+  int kf_known_frames;
+  int64_t bits_left = twopass->bits_left;
+  double score_left = twopass->normalized_score_left;
   vp9_zero(next_frame);
 
   cpi->common.frame_type = KEY_FRAME;
@@ -3311,7 +3410,9 @@ static void find_next_key_frame(VP9_COMP *cpi, int kf_show_idx) {
     rc->next_key_frame_forced = 0;
   }
 
-  for (i = 0; i < rc->frames_to_key; ++i) {
+  kf_known_frames = VPXMIN(rc->frames_to_key,
+                           fps_get_num_frames(first_pass_info) - kf_show_idx);
+  for (i = 0; i < kf_known_frames; ++i) {
     const FIRSTPASS_STATS *frame_stats =
         fps_get_frame_stats(first_pass_info, kf_show_idx + i);
     // Accumulate kf group error.
@@ -3319,8 +3420,25 @@ static void find_next_key_frame(VP9_COMP *cpi, int kf_show_idx) {
                                           mean_mod_score, av_err);
   }
 
+  if (oxcf->fp_lookahead > 0) {
+    twopass->kf_scan_show_idx =
+        VPXMIN(kf_show_idx + rc->frames_to_key,
+               fps_get_num_frames(first_pass_info) - 1);
+  }
+
+  // The first pass lookahead may not have reached the end of the kf group
+  // yet. Assume the rest of the group scores as the known part on average,
+  // and brings in the bits of its duration.
+  if (kf_known_frames < rc->frames_to_key) {
+    const int unknown_frames = rc->frames_to_key - kf_known_frames;
+    const double unknown_err = kf_group_err * unknown_frames / kf_known_frames;
+    kf_group_err += unknown_err;
+    score_left += unknown_err;
+    bits_left += (int64_t)unknown_frames * rc->avg_frame_bandwidth;
+  }
+
   // Calculate the number of bits that should be assigned to the kf group.
-  if (twopass->bits_left > 0 && twopass->normalized_score_left > 0.0) {
+  if (bits_left > 0 && score_left > 0.0) {
     // Maximum number of bits for a single normal frame (not key frame).
     const int max_bits = frame_max_bits(rc, &cpi->oxcf);
 
@@ -3329,8 +3447,8 @@ static void find_next_key_frame(VP9_COMP *cpi, int kf_show_idx) {
 
     // Default allocation based on bits left and relative
     // complexity of the section.
-    twopass->kf_group_bits = (int64_t)(
-        twopass->bits_left * (kf_group_err / twopass->normalized_score_left));
+    twopass->kf_group_bits =
+        (int64_t)(bits_left * (kf_group_err / score_left));
 
     // Clip based on maximum per frame rate defined by the user.
     max_grp_bits = (int64_t)max_bits * (int64_t)rc->frames_to_key;
@@ -3466,6 +3584,52 @@ static void find_next_key_frame(VP9_COMP *cpi, int kf_show_idx) {
   }
 }
 
+// With the first pass lookahead, the kf group may have been defined before
+// the stats of all its frames were known. At the start of each GF group, look
+// for a scene cut in the frames that came in since, and end the kf group
+// there, or at the end of the clip.
+static void update_kf_group_end(VP9_COMP *cpi, int show_idx) {
+  RATE_CONTROL *const rc = &cpi->rc;
+  TWO_PASS *const twopass = &cpi->twopass;
+  const VP9EncoderConfig *const oxcf = &cpi->oxcf;
+  const FIRST_PASS_INFO *first_pass_info = &twopass->first_pass_info;
+  const int num_frames = fps_get_num_frames(first_pass_info);
+  const int kf_end = show_idx + rc->frames_to_key;
+  int new_kf_end = kf_end;
+  int i;
+
+  if (oxcf->auto_key) {
+    const int scan_end = VPXMIN(kf_end, num_frames - 1);
+    for (i = VPXMAX(twopass->kf_scan_show_idx, show_idx + 1); i < scan_end;
+         ++i) {
+      if (test_candidate_kf(first_pass_info, i)) {
+        new_kf_end = i;
+        break;
+      }
+    }
+    twopass->kf_scan_show_idx = VPXMAX(twopass->kf_scan_show_idx, i);
+  }
+  if (twopass->first_pass_done) new_kf_end = VPXMIN(new_kf_end, num_frames);
+
+  if (new_kf_end < kf_end) {
+    // Give back the bits and error score of the frames cut off the group.
+    const double av_err = get_distribution_av_err(cpi, twopass);
+    double err_left = 0.0;
+    for (i = show_idx + rc->source_alt_ref_active; i < new_kf_end; ++i) {
+      err_left += calculate_norm_frame_score(
+          cpi, twopass, oxcf, fps_get_frame_stats(first_pass_info, i), av_err);
+    }
+    if (twopass->kf_group_error_left > err_left) {
+      twopass->kf_group_bits = (int64_t)(
+          twopass->kf_group_bits * (err_left / twopass->kf_group_error_left));
+      twopass->normalized_score_left += twopass->kf_group_error_left - err_left;
+      twopass->kf_group_error_left = err_left;
+    }
+    rc->frames_to_key = new_kf_end - show_idx;
+    rc->next_key_frame_forced = 0;
+  }
+}
+
 static int is_skippable_frame(const VP9_COMP *cpi) {
   // If the current frame does not have non-zero motion vector detected in the
   // first  pass, and so do its previous and forward frames, then this frame
@@ -3603,7 +3767,8 @@ void vp9_rc_get_second_pass_params(VP9_COMP *cpi) {
     twopass->active_worst_quality = cpi->oxcf.cq_level;
   } else if (cm->current_video_frame == 0) {
     const int frames_left =
-        (int)(twopass->total_stats.count - cm->current_video_frame);
+        (int)(twopass->total_stats.count - twopass->chunk_start_frame -
+              cm->current_video_frame);
     // Special case code for first frame.
     const int section_target_bandwidth =
         (int)(twopass->bits_left / frames_left);
@@ -3641,6 +3806,11 @@ void vp9_rc_get_second_pass_params(VP9_COMP *cpi) {
   else
     twopass->fr_content_type = FC_NORMAL;
 
+  if (cpi->oxcf.fp_lookahead > 0 && rc->frames_till_gf_update_due == 0 &&
+      rc->frames_to_key > 0) {
+    update_kf_group_end(cpi, show_idx);
+  }
+
   // Keyframe and section processing.
   if (rc->frames_to_key == 0 || (cpi->frame_flags & FRAMEFLAGS_KEY)) {
     // Define next KF group and assign bits to it.
@@ -3914,6 +4084,8 @@ int vp9_get_coding_frame_num(const VP9EncoderConfig *oxcf,
   return coding_frame_num;
 }
 
+#endif  // CONFIG_RATE_CTRL
+
 void vp9_get_key_frame_map(const VP9EncoderConfig *oxcf,
                            const TWO_PASS *const twopass, int *key_frame_map) {
   const FIRST_PASS_INFO *first_pass_info = &twopass->first_pass_info;
@@ -3936,7 +4108,6 @@ void vp9_get_key_frame_map(const VP9EncoderConfig *oxcf,
   }
   assert(show_idx == first_pass_info->num_frames);
 }
-#endif  // CONFIG_RATE_CTRL
 
 FIRSTPASS_STATS vp9_get_frame_stats(const TWO_PASS *twopass) {
   return twopass->this_frame_stats;
@@ -205,6 +205,14 @@ typedef struct {
   // Error score of frames still to be coded in kf group
   double kf_group_error_left;
 
+  // With the first pass lookahead, the show index of the first frame of the
+  // kf group not checked for a scene cut yet.
+  int kf_scan_show_idx;
+
+  // When encoding a chunk of the clip, the frame of the stats the chunk
+  // starts on.
+  int chunk_start_frame;
+
   double bpm_factor;
   int rolling_arf_group_target_bits;
   int rolling_arf_group_actual_bits;
@@ -256,6 +264,15 @@ void vp9_first_pass_encode_tile_mb_row(struct VP9_COMP *cpi,
                                        MV *best_ref_mv, int mb_row);
 
 void vp9_init_second_pass(struct VP9_COMP *cpi);
+
+// Points the second pass at the stats of the first num_frames frames, when
+// the first pass runs alongside it. Once the second pass has started, the
+// stats of the frames added since the last call also go into the totals and
+// budget of the clip.
+void vp9_twopass_update_stats_in(struct VP9_COMP *cpi,
+                                 const FIRSTPASS_STATS *stats, int num_frames,
+                                 int second_pass_started);
+void vp9_twopass_set_chunk_start_frame(struct VP9_COMP *cpi, int start_frame);
 void vp9_rc_get_second_pass_params(struct VP9_COMP *cpi);
 
 // Post encode update of the rate control parameters for 2-pass
@@ -309,6 +326,8 @@ int vp9_get_coding_frame_num(const struct VP9EncoderConfig *oxcf,
                              const FIRST_PASS_INFO *first_pass_info,
                              int multi_layer_arf, int allow_alt_ref);
 
+#endif  // CONFIG_RATE_CTRL
+
 /*!\brief Compute a key frame binary map indicates whether key frames appear
  * in the corresponding positions. The passed in key_frame_map must point to an
  * integer array with length equal to twopass->first_pass_info.num_frames,
@@ -316,7 +335,6 @@ int vp9_get_coding_frame_num(const struct VP9EncoderConfig *oxcf,
  */
 void vp9_get_key_frame_map(const struct VP9EncoderConfig *oxcf,
                            const TWO_PASS *const twopass, int *key_frame_map);
-#endif  // CONFIG_RATE_CTRL
 
 FIRSTPASS_STATS vp9_get_frame_stats(const TWO_PASS *twopass);
 FIRSTPASS_STATS vp9_get_total_stats(const TWO_PASS *twopass);
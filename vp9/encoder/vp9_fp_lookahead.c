@@ -0,0 +1,151 @@
+/*
+ *  Copyright (c) 2021 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include "vpx_mem/vpx_mem.h"
+#include "vp9/encoder/vp9_encoder.h"
+#include "vp9/encoder/vp9_fp_lookahead.h"
+
+static int first_pass_worker_hook(void *arg1, void *unused) {
+  FP_LOOKAHEAD *const fpl = (FP_LOOKAHEAD *)arg1;
+  VP9_COMP *const fp_cpi = fpl->fp_cpi;
+  struct lookahead_entry *const source = fpl->source;
+  ENCODE_FRAME_RESULT encode_frame_result;
+  unsigned int frame_flags;
+  size_t size;
+  int64_t time_stamp, time_end;
+  int ret;
+  (void)unused;
+
+  if (setjmp(fp_cpi->common.error.jmp)) {
+    fp_cpi->common.error.setjmp = 0;
+    return 0;
+  }
+  fp_cpi->common.error.setjmp = 1;
+
+  vp9_init_encode_frame_result(&encode_frame_result);
+  ret = vp9_receive_raw_frame(fp_cpi, source->flags, &source->img,
+                              source->ts_start, source->ts_end) == 0 &&
+        vp9_get_compressed_data(fp_cpi, &frame_flags, &size, NULL,
+                                &time_stamp, &time_end, 0,
+                                &encode_frame_result) == 0;
+  fpl->source_stats = fp_cpi->twopass.this_frame_stats;
+
+  fp_cpi->common.error.setjmp = 0;
+  return ret;
+}
+
+static void alloc_first_pass(VP9_COMP *cpi, FP_LOOKAHEAD *fpl) {
+  VP9_COMMON *const cm = &cpi->common;
+  VP9EncoderConfig oxcf = cpi->oxcf;
+
+  // Configure the first pass as vp9_cx_iface.c does for VPX_RC_FIRST_PASS.
+  oxcf.pass = 1;
+  oxcf.mode = BEST;
+  oxcf.lag_in_frames = 0;
+  oxcf.fp_lookahead = 0;
+  oxcf.two_pass_stats_in.buf = NULL;
+  oxcf.two_pass_stats_in.sz = 0;
+
+  CHECK_MEM_ERROR(cm, fpl->buffer_pool,
+                  vpx_calloc(1, sizeof(*fpl->buffer_pool)));
+  CHECK_MEM_ERROR(cm, fpl->fp_cpi,
+                  vp9_create_compressor(&oxcf, fpl->buffer_pool));
+
+  // The first pass gets a thread of its own rather than one from
+  // cpi->thread_pool: it waits on its own workers while it runs.
+  vpx_get_worker_interface()->init(&fpl->worker);
+  fpl->worker.hook = first_pass_worker_hook;
+  fpl->worker.data1 = fpl;
+  fpl->worker.data2 = NULL;
+  if (!vpx_get_worker_interface()->reset(&fpl->worker))
+    vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
+                       "Failed to start the first pass thread");
+}
+
+// Waits for the worker and appends the stats of its frame to the stats of
+// the second pass.
+static void sync_first_pass(VP9_COMP *cpi, FP_LOOKAHEAD *fpl) {
+  VP9_COMMON *const cm = &cpi->common;
+
+  if (fpl->source == NULL) return;
+
+  if (!vpx_get_worker_interface()->sync(&fpl->worker)) {
+    const struct vpx_internal_error_info *const error =
+        &fpl->fp_cpi->common.error;
+    fpl->source = NULL;
+    vpx_internal_error(&cm->error, VPX_CODEC_ERROR, "First pass: %s",
+                       error->has_detail ? error->detail : "failed");
+  }
+
+  if (fpl->num_stats == fpl->stats_size) {
+    const int new_size = VPXMAX(2 * fpl->stats_size, 64);
+    FIRSTPASS_STATS *new_stats;
+    CHECK_MEM_ERROR(cm, new_stats,
+                    vpx_malloc(new_size * sizeof(*fpl->stats)));
+    if (fpl->num_stats > 0)
+      memcpy(new_stats, fpl->stats, fpl->num_stats * sizeof(*fpl->stats));
+    vpx_free(fpl->stats);
+    fpl->stats = new_stats;
+    fpl->stats_size = new_size;
+  }
+  fpl->stats[fpl->num_stats++] = fpl->source_stats;
+  fpl->source = NULL;
+
+  vp9_twopass_update_stats_in(cpi, fpl->stats, fpl->num_stats,
+                              fpl->second_pass_started);
+}
+
+void vp9_fp_lookahead_push(VP9_COMP *cpi, struct lookahead_entry *source) {
+  VP9_COMMON *const cm = &cpi->common;
+  FP_LOOKAHEAD *fpl = cpi->fp_lookahead;
+
+  if (fpl == NULL) {
+    CHECK_MEM_ERROR(cm, cpi->fp_lookahead,
+                    vpx_calloc(1, sizeof(*cpi->fp_lookahead)));
+    fpl = cpi->fp_lookahead;
+    alloc_first_pass(cpi, fpl);
+  }
+
+  sync_first_pass(cpi, fpl);
+
+  fpl->source = source;
+  vpx_get_worker_interface()->launch(&fpl->worker);
+}
+
+void vp9_fp_lookahead_update(VP9_COMP *cpi, int flush) {
+  FP_LOOKAHEAD *const fpl = cpi->fp_lookahead;
+
+  if (fpl == NULL) return;
+
+  if (flush && !cpi->twopass.first_pass_done) {
+    sync_first_pass(cpi, fpl);
+    cpi->twopass.first_pass_done = 1;
+  }
+
+  // The lookahead holds one frame more than the stats, so the stats of any
+  // frame about to be coded are known.
+  if (!fpl->second_pass_started && fpl->num_stats > 0 &&
+      (flush || vp9_lookahead_full(cpi->lookahead))) {
+    vp9_init_second_pass(cpi);
+    fpl->second_pass_started = 1;
+  }
+}
+
+void vp9_fp_lookahead_destroy(FP_LOOKAHEAD *fpl) {
+  if (fpl == NULL) return;
+
+  vpx_get_worker_interface()->end(&fpl->worker);
+  vp9_remove_compressor(fpl->fp_cpi);
+  vpx_free(fpl->buffer_pool);
+  vpx_free(fpl->stats);
+  vpx_free(fpl);
+}
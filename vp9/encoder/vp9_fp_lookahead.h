@@ -0,0 +1,60 @@
+/*
+ *  Copyright (c) 2021 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPX_VP9_ENCODER_VP9_FP_LOOKAHEAD_H_
+#define VPX_VP9_ENCODER_VP9_FP_LOOKAHEAD_H_
+
+#include "vpx_util/vpx_thread.h"
+#include "vp9/common/vp9_onyxc_int.h"
+#include "vp9/encoder/vp9_firstpass.h"
+#include "vp9/encoder/vp9_lookahead.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct VP9_COMP;
+
+// Runs the first pass of a two-pass encode on the frames entering the
+// lookahead of the second pass encoder, so that both passes are done in a
+// single pass over the input. The first pass encoder computes the stats of
+// the newest frame on its own thread while the second pass codes the oldest
+// frames of the lookahead.
+typedef struct FP_LOOKAHEAD {
+  struct VP9_COMP *fp_cpi;
+  BufferPool *buffer_pool;
+  VPxWorker worker;
+  // Frame the worker is computing the stats of, or NULL when idle.
+  struct lookahead_entry *source;
+  FIRSTPASS_STATS source_stats;
+  // Stats of all the frames done so far, in show order. Only the second
+  // pass encoder reads them.
+  FIRSTPASS_STATS *stats;
+  int num_stats;
+  int stats_size;
+  int second_pass_started;
+} FP_LOOKAHEAD;
+
+// Starts the first pass on a frame just pushed into the lookahead of cpi,
+// after handing the stats of the previous frame over to the second pass.
+void vp9_fp_lookahead_push(struct VP9_COMP *cpi,
+                           struct lookahead_entry *source);
+
+// To be called before coding each frame. Starts the second pass once the
+// lookahead is full. On flush, first waits for the stats of the last frame.
+void vp9_fp_lookahead_update(struct VP9_COMP *cpi, int flush);
+
+void vp9_fp_lookahead_destroy(FP_LOOKAHEAD *fpl);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // VPX_VP9_ENCODER_VP9_FP_LOOKAHEAD_H_
@@ -15,6 +15,7 @@ typedef enum {
   FIRST_PASS_JOB,
   ENCODE_JOB,
   ARNR_JOB,
+  TPL_JOB,
   NUM_JOB_TYPES,
 } JOB_TYPE;
 
@@ -27,20 +28,8 @@ typedef struct {
 
 // Job queue element parameters
 typedef struct {
-  // Pointer to the next link in the job queue
-  void *next;
-
   // Job information context of the module
   JobNode job_info;
 } JobQueue;
 
-// Job queue handle
-typedef struct {
-  // Pointer to the next link in the job queue
-  void *next;
-
-  // Counter to store the number of jobs picked up for processing
-  int num_jobs_acquired;
-} JobQueueHandle;
-
 #endif  // VPX_VP9_ENCODER_VP9_JOB_QUEUE_H_
@@ -51,8 +51,9 @@ struct lookahead_ctx *vp9_lookahead_init(unsigned int width,
                                          unsigned int depth) {
   struct lookahead_ctx *ctx = NULL;
 
-  // Clamp the lookahead queue depth
-  depth = clamp(depth, 1, MAX_LAG_BUFFERS);
+  // Clamp the lookahead queue depth. With the first pass lookahead it also
+  // holds the frames the first pass is ahead by, plus the one it is on.
+  depth = clamp(depth, 1, MAX_LAG_BUFFERS + MAX_FP_LOOKAHEAD + 1);
 
   // Allocate memory to keep previous source frames available.
   depth += MAX_PRE_FRAMES;
@@ -21,6 +21,10 @@ extern "C" {
 
 #define MAX_LAG_BUFFERS 25
 
+// The max number of frames the first pass can run ahead of the lag, see
+// VP9E_SET_FIRST_PASS_LOOKAHEAD.
+#define MAX_FP_LOOKAHEAD 256
+
 struct lookahead_entry {
   YV12_BUFFER_CONFIG img;
   int64_t ts_start;
@@ -17,38 +17,14 @@
 
 void *vp9_enc_grp_get_next_job(MultiThreadHandle *multi_thread_ctxt,
                                int tile_id) {
-  RowMTInfo *row_mt_info;
-  JobQueueHandle *job_queue_hdl = NULL;
-  void *next = NULL;
-  JobNode *job_info = NULL;
-#if CONFIG_MULTITHREAD
-  pthread_mutex_t *mutex_handle = NULL;
-#endif
-
-  row_mt_info = (RowMTInfo *)(&multi_thread_ctxt->row_mt_info[tile_id]);
-  job_queue_hdl = (JobQueueHandle *)&row_mt_info->job_queue_hdl;
-#if CONFIG_MULTITHREAD
-  mutex_handle = &row_mt_info->job_mutex;
-#endif
-
-// lock the mutex for queue access
-#if CONFIG_MULTITHREAD
-  pthread_mutex_lock(mutex_handle);
-#endif
-  next = job_queue_hdl->next;
-  if (NULL != next) {
-    JobQueue *job_queue = (JobQueue *)next;
-    job_info = &job_queue->job_info;
-    // Update the next job in the queue
-    job_queue_hdl->next = job_queue->next;
-    job_queue_hdl->num_jobs_acquired++;
-  }
-
-#if CONFIG_MULTITHREAD
-  pthread_mutex_unlock(mutex_handle);
-#endif
-
-  return job_info;
+  const int job_row_num =
+      vpx_job_counter_next(&multi_thread_ctxt->job_counter[tile_id]);
+
+  if (job_row_num < 0) return NULL;
+  return &multi_thread_ctxt
+              ->job_queue[tile_id * multi_thread_ctxt->jobs_per_tile_col +
+                          job_row_num]
+              .job_info;
 }
 
 void vp9_row_mt_alloc_rd_thresh(VP9_COMP *const cpi,
@@ -87,14 +63,6 @@ void vp9_row_mt_mem_alloc(VP9_COMP *cpi) {
   multi_thread_ctxt->job_queue =
       (JobQueue *)vpx_memalign(32, total_jobs * sizeof(JobQueue));
 
-#if CONFIG_MULTITHREAD
-  // Create mutex for each tile
-  for (tile_col = 0; tile_col < tile_cols; tile_col++) {
-    RowMTInfo *row_mt_info = &multi_thread_ctxt->row_mt_info[tile_col];
-    pthread_mutex_init(&row_mt_info->job_mutex, NULL);
-  }
-#endif
-
   // Allocate memory for row based multi-threading
   for (tile_col = 0; tile_col < tile_cols; tile_col++) {
     TileDataEnc *this_tile = &cpi->tile_data[tile_col];
@@ -136,15 +104,6 @@ void vp9_row_mt_mem_dealloc(VP9_COMP *cpi) {
   // Deallocate memory for job queue
   if (multi_thread_ctxt->job_queue) vpx_free(multi_thread_ctxt->job_queue);
 
-#if CONFIG_MULTITHREAD
-  // Destroy mutex for each tile
-  for (tile_col = 0; tile_col < multi_thread_ctxt->allocated_tile_cols;
-       tile_col++) {
-    RowMTInfo *row_mt_info = &multi_thread_ctxt->row_mt_info[tile_col];
-    if (row_mt_info) pthread_mutex_destroy(&row_mt_info->job_mutex);
-  }
-#endif
-
   // Free row based multi-threading sync memory
   for (tile_col = 0; tile_col < multi_thread_ctxt->allocated_tile_cols;
        tile_col++) {
@@ -179,9 +138,9 @@ void vp9_multi_thread_tile_init(VP9_COMP *cpi) {
     TileDataEnc *this_tile = &cpi->tile_data[i];
     int jobs_per_tile_col = cpi->oxcf.pass == 1 ? cm->mb_rows : sb_rows;
 
-    // Initialize cur_col to -1 for all rows.
-    memset(this_tile->row_mt_sync.cur_col, -1,
-           sizeof(*this_tile->row_mt_sync.cur_col) * jobs_per_tile_col);
+    vp9_row_mt_sync_reset(&this_tile->row_mt_sync, jobs_per_tile_col);
+    this_tile->row_mt_sync.sync_range =
+        cpi->oxcf.pass == 1 ? vp9_get_fp_sync_range(cm->width) : 1;
     vp9_zero(this_tile->fp_data);
     this_tile->fp_data.image_data_start_row = INVALID_ROW;
   }
@@ -201,29 +160,8 @@ void vp9_assign_tile_to_thread(MultiThreadHandle *multi_thread_ctxt,
 
 int vp9_get_job_queue_status(MultiThreadHandle *multi_thread_ctxt,
                              int cur_tile_id) {
-  RowMTInfo *row_mt_info;
-  JobQueueHandle *job_queue_hndl;
-#if CONFIG_MULTITHREAD
-  pthread_mutex_t *mutex;
-#endif
-  int num_jobs_remaining;
-
-  row_mt_info = &multi_thread_ctxt->row_mt_info[cur_tile_id];
-  job_queue_hndl = &row_mt_info->job_queue_hdl;
-#if CONFIG_MULTITHREAD
-  mutex = &row_mt_info->job_mutex;
-#endif
-
-#if CONFIG_MULTITHREAD
-  pthread_mutex_lock(mutex);
-#endif
-  num_jobs_remaining =
-      multi_thread_ctxt->jobs_per_tile_col - job_queue_hndl->num_jobs_acquired;
-#if CONFIG_MULTITHREAD
-  pthread_mutex_unlock(mutex);
-#endif
-
-  return (num_jobs_remaining);
+  return vpx_job_counter_remaining(
+      &multi_thread_ctxt->job_counter[cur_tile_id]);
 }
 
 void vp9_prepare_job_queue(VP9_COMP *cpi, JOB_TYPE job_type) {
@@ -231,7 +169,7 @@ void vp9_prepare_job_queue(VP9_COMP *cpi, JOB_TYPE job_type) {
   MultiThreadHandle *multi_thread_ctxt = &cpi->multi_thread_ctxt;
   JobQueue *job_queue = multi_thread_ctxt->job_queue;
   const int tile_cols = 1 << cm->log2_tile_cols;
-  int job_row_num, jobs_per_tile, jobs_per_tile_col = 0, total_jobs;
+  int job_row_num, jobs_per_tile, jobs_per_tile_col = 0;
   const int sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
   int tile_col, i;
 
@@ -241,35 +179,30 @@ void vp9_prepare_job_queue(VP9_COMP *cpi, JOB_TYPE job_type) {
     case ARNR_JOB:
       jobs_per_tile_col = ((cm->mi_rows + TF_ROUND) >> TF_SHIFT);
       break;
+    case TPL_JOB: {
+      const int mi_height = num_8x8_blocks_high_lookup[cpi->tpl_bsize];
+      jobs_per_tile_col = (cm->mi_rows + mi_height - 1) / mi_height;
+      break;
+    }
     default: assert(0);
   }
 
-  total_jobs = jobs_per_tile_col * tile_cols;
-
   multi_thread_ctxt->jobs_per_tile_col = jobs_per_tile_col;
-  // memset the entire job queue buffer to zero
-  memset(job_queue, 0, total_jobs * sizeof(JobQueue));
 
   // Job queue preparation
   for (tile_col = 0; tile_col < tile_cols; tile_col++) {
-    RowMTInfo *tile_ctxt = &multi_thread_ctxt->row_mt_info[tile_col];
-    JobQueue *job_queue_curr, *job_queue_temp;
     int tile_row = 0;
 
-    tile_ctxt->job_queue_hdl.next = (void *)job_queue;
-    tile_ctxt->job_queue_hdl.num_jobs_acquired = 0;
-
-    job_queue_curr = job_queue;
-    job_queue_temp = job_queue;
+    vpx_job_counter_reset(&multi_thread_ctxt->job_counter[tile_col],
+                          jobs_per_tile_col);
 
     // loop over all the vertical rows
     for (job_row_num = 0, jobs_per_tile = 0; job_row_num < jobs_per_tile_col;
          job_row_num++, jobs_per_tile++) {
-      job_queue_curr->job_info.vert_unit_row_num = job_row_num;
-      job_queue_curr->job_info.tile_col_id = tile_col;
-      job_queue_curr->job_info.tile_row_id = tile_row;
-      job_queue_curr->next = (void *)(job_queue_temp + 1);
-      job_queue_curr = ++job_queue_temp;
+      JobNode *const job_info = &job_queue[job_row_num].job_info;
+      job_info->vert_unit_row_num = job_row_num;
+      job_info->tile_col_id = tile_col;
+      job_info->tile_row_id = tile_row;
 
       if (ENCODE_JOB == job_type) {
         if (jobs_per_tile >=
@@ -280,10 +213,6 @@ void vp9_prepare_job_queue(VP9_COMP *cpi, JOB_TYPE job_type) {
       }
     }
 
-    // Set the last pointer to NULL
-    job_queue_curr += -1;
-    job_queue_curr->next = (void *)NULL;
-
     // Move to the next tile
     job_queue += jobs_per_tile_col;
   }
@@ -292,35 +221,14 @@ void vp9_prepare_job_queue(VP9_COMP *cpi, JOB_TYPE job_type) {
     EncWorkerData *thread_data;
     thread_data = &cpi->tile_thr_data[i];
     thread_data->thread_id = i;
-
-    for (tile_col = 0; tile_col < tile_cols; tile_col++)
-      thread_data->tile_completion_status[tile_col] = 0;
   }
 }
 
 int vp9_get_tiles_proc_status(MultiThreadHandle *multi_thread_ctxt,
-                              int *tile_completion_status, int *cur_tile_id,
-                              int tile_cols) {
-  int tile_col;
-  int tile_id = -1;  // Stores the tile ID with minimum proc done
-  int max_num_jobs_remaining = 0;
-  int num_jobs_remaining;
-
-  // Mark the completion to avoid check in the loop
-  tile_completion_status[*cur_tile_id] = 1;
-  // Check for the status of all the tiles
-  for (tile_col = 0; tile_col < tile_cols; tile_col++) {
-    if (tile_completion_status[tile_col] == 0) {
-      num_jobs_remaining =
-          vp9_get_job_queue_status(multi_thread_ctxt, tile_col);
-      // Mark the completion to avoid checks during future switches across tiles
-      if (num_jobs_remaining == 0) tile_completion_status[tile_col] = 1;
-      if (num_jobs_remaining > max_num_jobs_remaining) {
-        max_num_jobs_remaining = num_jobs_remaining;
-        tile_id = tile_col;
-      }
-    }
-  }
+                              int *cur_tile_id, int tile_cols) {
+  // The tile with the most jobs left, i.e. the least processed one.
+  const int tile_id = vpx_job_counter_most_remaining(
+      multi_thread_ctxt->job_counter, tile_cols);
 
   if (-1 == tile_id) {
     return 1;
@@ -34,8 +34,9 @@ void vp9_row_mt_alloc_rd_thresh(VP9_COMP *const cpi,
 
 void vp9_row_mt_mem_dealloc(VP9_COMP *cpi);
 
+// Moves a thread whose tile has no jobs left to another tile. Returns 1 when
+// all the tiles are done.
 int vp9_get_tiles_proc_status(MultiThreadHandle *multi_thread_ctxt,
-                              int *tile_completion_status, int *cur_tile_id,
-                              int tile_cols);
+                              int *cur_tile_id, int tile_cols);
 
 #endif  // VPX_VP9_ENCODER_VP9_MULTI_THREAD_H_
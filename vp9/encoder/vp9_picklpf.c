@@ -21,6 +21,7 @@
 #include "vp9/common/vp9_quant_common.h"
 
 #include "vp9/encoder/vp9_encoder.h"
+#include "vp9/encoder/vp9_ethread.h"
 #include "vp9/encoder/vp9_picklpf.h"
 #include "vp9/encoder/vp9_quantize.h"
 
@@ -75,6 +76,47 @@ static int64_t try_filter_frame(const YV12_BUFFER_CONFIG *sd,
   return filt_err;
 }
 
+int64_t vp9_try_filter_level_on_copy(const YV12_BUFFER_CONFIG *sd,
+                                     VP9_COMP *const cpi, int filt_level,
+                                     int partial_frame,
+                                     YV12_BUFFER_CONFIG *buf) {
+  VP9_COMMON *const cm = &cpi->common;
+
+  vpx_yv12_copy_y(&cpi->last_frame_uf, buf);
+  vp9_loop_filter_frame_y(buf, cm, cpi->td.mb.e_mbd.plane, filt_level,
+                          partial_frame);
+
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (cm->use_highbitdepth) return vpx_highbd_get_y_sse(sd, buf);
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  return vpx_get_y_sse(sd, buf);
+}
+
+// Adds 'filt_level' to the 'num_levels' levels to try, unless its error is
+// already known or it is there already. Returns the new number of levels.
+static int add_filter_level(int *levels, int num_levels, const int64_t *ss_err,
+                            int filt_level) {
+  int i;
+  if (ss_err[filt_level] >= 0) return num_levels;
+  for (i = 0; i < num_levels; ++i) {
+    if (levels[i] == filt_level) return num_levels;
+  }
+  levels[num_levels] = filt_level;
+  return num_levels + 1;
+}
+
+// Tries the levels at the same time on the encoder workers and stores their
+// errors in ss_err.
+static void try_filter_levels(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
+                              const int *levels, int num_levels,
+                              int64_t *ss_err, int partial_frame) {
+  int64_t errs[MAX_LOOP_FILTER + 1];
+  int i;
+  if (num_levels == 0) return;
+  vp9_try_filter_levels_mt(cpi, sd, levels, errs, num_levels, partial_frame);
+  for (i = 0; i < num_levels; ++i) ss_err[levels[i]] = errs[i];
+}
+
 static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
                                int partial_frame) {
   const VP9_COMMON *const cm = &cpi->common;
@@ -92,6 +134,13 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
   // Sum squared error at each filter level
   int64_t ss_err[MAX_LOOP_FILTER + 1];
   unsigned int section_intra_rating = get_section_intra_rating(cpi);
+  // With several workers, the levels a step needs are tried at the same time,
+  // along with the ones the next step may need while there are idle workers.
+  // The error of a level does not depend on when it is tried, so the search
+  // picks the same level either way.
+  const int try_mt = cpi->num_workers > 1;
+  int levels[MAX_LOOP_FILTER + 1];
+  int num_levels;
 
   // Set each entry to -1
   memset(ss_err, 0xFF, sizeof(ss_err));
@@ -99,7 +148,19 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
   //  Make a copy of the unfiltered / processed recon buffer
   vpx_yv12_copy_y(cm->frame_to_show, &cpi->last_frame_uf);
 
-  best_err = try_filter_frame(sd, cpi, filt_mid, partial_frame);
+  if (try_mt) {
+    num_levels = add_filter_level(levels, 0, ss_err, filt_mid);
+    num_levels =
+        add_filter_level(levels, num_levels, ss_err,
+                         VPXMAX(filt_mid - filter_step, min_filter_level));
+    num_levels =
+        add_filter_level(levels, num_levels, ss_err,
+                         VPXMIN(filt_mid + filter_step, max_filter_level));
+    try_filter_levels(sd, cpi, levels, num_levels, ss_err, partial_frame);
+    best_err = ss_err[filt_mid];
+  } else {
+    best_err = try_filter_frame(sd, cpi, filt_mid, partial_frame);
+  }
   filt_best = filt_mid;
   ss_err[filt_mid] = best_err;
 
@@ -116,6 +177,29 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
     // yx, bias less for large block size
     if (cm->tx_mode != ONLY_4X4) bias >>= 1;
 
+    if (try_mt) {
+      num_levels = 0;
+      if (filt_direction <= 0 && filt_low != filt_mid)
+        num_levels = add_filter_level(levels, num_levels, ss_err, filt_low);
+      if (filt_direction >= 0 && filt_high != filt_mid)
+        num_levels = add_filter_level(levels, num_levels, ss_err, filt_high);
+      if (num_levels > 0) {
+        // The next step tries the levels half a step away if neither level
+        // wins, or a step further on from the winning one.
+        int next_levels[4];
+        int i;
+        next_levels[0] = VPXMAX(filt_mid - filter_step / 2, min_filter_level);
+        next_levels[1] = VPXMIN(filt_mid + filter_step / 2, max_filter_level);
+        next_levels[2] = VPXMAX(filt_low - filter_step, min_filter_level);
+        next_levels[3] = VPXMIN(filt_high + filter_step, max_filter_level);
+        for (i = 0; i < 4 && num_levels < cpi->num_workers; ++i) {
+          num_levels =
+              add_filter_level(levels, num_levels, ss_err, next_levels[i]);
+        }
+        try_filter_levels(sd, cpi, levels, num_levels, ss_err, partial_frame);
+      }
+    }
+
     if (filt_direction <= 0 && filt_low != filt_mid) {
       // Get Low filter error score
       if (ss_err[filt_low] < 0) {
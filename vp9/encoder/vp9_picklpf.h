@@ -20,6 +20,14 @@ extern "C" {
 struct yv12_buffer_config;
 struct VP9_COMP;
 
+// Returns the luma sse against 'sd' of cpi->last_frame_uf filtered at
+// 'filt_level', filtering a copy of it in 'buf'. Several threads may call it at
+// once with different buffers.
+int64_t vp9_try_filter_level_on_copy(const struct yv12_buffer_config *sd,
+                                     struct VP9_COMP *const cpi,
+                                     int filt_level, int partial_frame,
+                                     struct yv12_buffer_config *buf);
+
 void vp9_pick_filter_level(const struct yv12_buffer_config *sd,
                            struct VP9_COMP *cpi, LPF_PICK_METHOD method);
 #ifdef __cplusplus
@@ -442,6 +442,8 @@ void vp9_rc_init(const VP9EncoderConfig *oxcf, int pass, RATE_CONTROL *rc) {
   rc->use_post_encode_drop = 0;
   rc->ext_use_post_encode_drop = 0;
   rc->disable_overshoot_maxq_cbr = 0;
+  rc->estimate_recode_size = 0;
+  rc->last_recode_size_estimate = -1;
   rc->arf_active_best_quality_adjustment_factor = 1.0;
   rc->arf_increase_active_best_quality = 0;
   rc->preserve_arf_as_gld = 0;
@@ -2614,6 +2616,7 @@ static void vbr_rate_correction(VP9_COMP *cpi, int *this_frame_target) {
   int64_t vbr_bits_off_target = rc->vbr_bits_off_target;
   int max_delta;
   int frame_window = VPXMIN(16, ((int)cpi->twopass.total_stats.count -
+                                 cpi->twopass.chunk_start_frame -
                                  cpi->common.current_video_frame));
 
   // Calcluate the adjustment to rate for this frame.
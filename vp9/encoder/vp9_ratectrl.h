@@ -197,6 +197,12 @@ typedef struct {
   int ext_use_post_encode_drop;
   // Flag to disable CBR feature to increase Q on overshoot detection.
   int disable_overshoot_maxq_cbr;
+  // Flag to predict the size of recoded frames instead of packing them. It
+  // is off and only set by the tests until it saves encode time.
+  int estimate_recode_size;
+  // Predicted size in bits of the final encode of the last frame, or -1 if
+  // its size was not predicted.
+  int last_recode_size_estimate;
   int damped_adjustment[RATE_FACTOR_LEVELS];
   double arf_active_best_quality_adjustment_factor;
   int arf_increase_active_best_quality;
@@ -20,7 +20,7 @@
 extern "C" {
 #endif
 
-#define EOSB_TOKEN 127  // Not signalled, encoder only
+#define EOSB_TOKEN 15  // Not signalled, encoder only
 
 #if CONFIG_VP9_HIGHBITDEPTH
 typedef int32_t EXTRABIT;
@@ -33,12 +33,24 @@ typedef struct {
   EXTRABIT extra;
 } TOKENVALUE;
 
+// The number of bits of the token in TOKENEXTRA::token_ctx.
+#define TOKEN_BITS 4
+
+// A token as stored between tokenization and packing. token_ctx has the token
+// in its low TOKEN_BITS bits, and above them the index of the coefficient
+// probabilities the token is coded with (see vp9_get_coef_probs_index()),
+// which keeps the struct at 4 bytes (8 bytes with CONFIG_VP9_HIGHBITDEPTH).
 typedef struct {
-  const vpx_prob *context_tree;
-  int16_t token;
+  uint16_t token_ctx;
   EXTRABIT extra;
 } TOKENEXTRA;
 
+static INLINE int vp9_get_coef_probs_index(TX_SIZE tx_size, PLANE_TYPE type,
+                                           int ref) {
+  return ((tx_size * PLANE_TYPES + type) * REF_TYPES + ref) * COEF_BANDS *
+         COEFF_CONTEXTS;
+}
+
 extern const vpx_tree_index vp9_coef_tree[];
 extern const vpx_tree_index vp9_coef_con_tree[];
 extern const struct vp9_token vp9_coef_encodings[];
@@ -0,0 +1,696 @@
+/*
+ *  Copyright (c) 2021 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <assert.h>
+#include <immintrin.h>
+
+#include "./vp9_rtcd.h"
+#include "./vpx_config.h"
+#include "vpx/vpx_integer.h"
+#include "vp9/encoder/vp9_encoder.h"
+#include "vp9/encoder/vp9_temporal_filter.h"
+#include "vp9/encoder/x86/temporal_filter_constants.h"
+
+static INLINE __m256i highbd_set_m128i(const __m128i lo, const __m128i hi) {
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+// Load the neighbor constants of 8 pixels, made of two sets of 4.
+static INLINE __m256i highbd_load_neighbors(const uint32_t *fst,
+                                            const uint32_t *snd) {
+  return highbd_set_m128i(_mm_load_si128((const __m128i *)fst),
+                          _mm_load_si128((const __m128i *)snd));
+}
+
+// Compute (a-b)**2 for 8 pixels with size 16-bit
+static INLINE void highbd_store_dist_8(const uint16_t *a, const uint16_t *b,
+                                       uint32_t *dst) {
+  const __m256i a_reg =
+      _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)a));
+  const __m256i b_reg =
+      _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)b));
+  __m256i dist;
+
+  dist = _mm256_sub_epi32(a_reg, b_reg);
+  dist = _mm256_mullo_epi32(dist, dist);
+
+  _mm256_storeu_si256((__m256i *)dst, dist);
+}
+
+// Sum up three neighboring distortions for the pixels
+static INLINE __m256i highbd_get_sum_8(const uint32_t *dist) {
+  const __m256i dist_reg = _mm256_loadu_si256((const __m256i *)dist);
+  const __m256i dist_left = _mm256_loadu_si256((const __m256i *)(dist - 1));
+  const __m256i dist_right = _mm256_loadu_si256((const __m256i *)(dist + 1));
+
+  return _mm256_add_epi32(_mm256_add_epi32(dist_reg, dist_left), dist_right);
+}
+
+// Average the value based on the number of values summed (9 for pixels away
+// from the border, 4 for pixels in corners, and 6 for other edge values, plus
+// however many values from y/uv plane are).
+//
+// Add in the rounding factor and shift, clamp to 16, invert and shift. Multiply
+// by weight.
+static INLINE __m256i highbd_average_8(const __m256i sum,
+                                       const __m256i mul_constants,
+                                       const int strength, const int rounding,
+                                       const __m256i weight) {
+  // _mm256_srl_epi32 uses the lower 64 bit value for the shift.
+  const __m128i strength_u128 = _mm_set_epi32(0, 0, 0, strength);
+  const __m256i rounding_u32 = _mm256_set1_epi32(rounding);
+  const __m256i sixteen = _mm256_set1_epi32(16);
+
+  // modifier * 3 / index;
+  // _mm256_mul_epu32 multiplies the even elements into 64 bits. The high 32
+  // bits of the even products are shifted down, and the odd products are
+  // computed in place and keep their high 32 bits in the odd elements.
+  const __m256i mul_even =
+      _mm256_srli_epi64(_mm256_mul_epu32(sum, mul_constants), 32);
+  const __m256i mul_odd =
+      _mm256_mul_epu32(_mm256_srli_epi64(sum, 32),
+                       _mm256_srli_epi64(mul_constants, 32));
+  __m256i output = _mm256_blend_epi32(mul_even, mul_odd, 0xaa);
+
+  // Round
+  output = _mm256_add_epi32(output, rounding_u32);
+  output = _mm256_srl_epi32(output, strength_u128);
+
+  // Multiply with the weight
+  output = _mm256_min_epu32(output, sixteen);
+  output = _mm256_sub_epi32(sixteen, output);
+  return _mm256_mullo_epi32(output, weight);
+}
+
+// Add 'sum_u32' to 'count'. Multiply by 'pred' and add to 'accumulator.'
+static INLINE void highbd_accumulate_and_store_8(const __m256i sum_u32,
+                                                 const uint16_t *pred,
+                                                 uint16_t *count,
+                                                 uint32_t *accumulator) {
+  // Cast down to 16-bit ints
+  const __m128i sum_u16 = _mm_packus_epi32(
+      _mm256_castsi256_si128(sum_u32), _mm256_extracti128_si256(sum_u32, 1));
+  const __m256i pred_u32 =
+      _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)pred));
+  __m128i count_u16 = _mm_loadu_si128((const __m128i *)count);
+  __m256i accum_u32 = _mm256_loadu_si256((const __m256i *)accumulator);
+
+  count_u16 = _mm_adds_epu16(count_u16, sum_u16);
+  _mm_storeu_si128((__m128i *)count, count_u16);
+
+  // The product does not fit in 16 bits for 12-bit input.
+  accum_u32 =
+      _mm256_add_epi32(_mm256_mullo_epi32(sum_u32, pred_u32), accum_u32);
+  _mm256_storeu_si256((__m256i *)accumulator, accum_u32);
+}
+
+// Read in a row of chroma values corresponds to a row of 8 luma values, and
+// return the sum of u and v.
+static INLINE __m256i highbd_read_chroma_dist_row_8(int ss_x,
+                                                    const uint32_t *u_dist,
+                                                    const uint32_t *v_dist) {
+  if (!ss_x) {
+    // If there is no chroma subsampling in the horizontal direction, then we
+    // need to load 8 entries from chroma.
+    return _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)u_dist),
+                            _mm256_loadu_si256((const __m256i *)v_dist));
+  } else {  // ss_x == 1
+    // Otherwise, we only need to load 4 entries, and use each of them twice.
+    const __m128i uv_reg =
+        _mm_add_epi32(_mm_loadu_si128((const __m128i *)u_dist),
+                      _mm_loadu_si128((const __m128i *)v_dist));
+    return _mm256_permutevar8x32_epi32(_mm256_castsi128_si256(uv_reg),
+                                       _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3,
+                                                         3));
+  }
+}
+
+// Return the luma distortion that corresponds to 8 chroma mods. If we are
+// subsampling in x direction, then we have 16 lumas, else we have 8.
+static INLINE __m256i highbd_get_luma_dist_for_8_chroma(const uint32_t *y_dist,
+                                                        int ss_x, int ss_y) {
+  __m256i y_reg;
+  if (!ss_x) {
+    y_reg = _mm256_loadu_si256((const __m256i *)y_dist);
+    if (ss_y == 1) {
+      y_reg = _mm256_add_epi32(
+          y_reg, _mm256_loadu_si256((const __m256i *)(y_dist + DIST_STRIDE)));
+    }
+  } else {
+    __m256i y_fst = _mm256_loadu_si256((const __m256i *)y_dist);
+    __m256i y_snd = _mm256_loadu_si256((const __m256i *)(y_dist + 8));
+    if (ss_y == 1) {
+      y_fst = _mm256_add_epi32(
+          y_fst, _mm256_loadu_si256((const __m256i *)(y_dist + DIST_STRIDE)));
+      y_snd = _mm256_add_epi32(
+          y_snd,
+          _mm256_loadu_si256((const __m256i *)(y_dist + 8 + DIST_STRIDE)));
+    }
+
+    // _mm256_hadd_epi32 works within the 128-bit lanes, so the pairs of
+    // y_fst and y_snd come out interleaved by 64 bits.
+    y_reg = _mm256_permute4x64_epi64(_mm256_hadd_epi32(y_fst, y_snd), 0xd8);
+  }
+
+  return y_reg;
+}
+
+static void vp9_highbd_apply_temporal_filter_luma_8(
+    const uint16_t *y_pre, int y_pre_stride, unsigned int block_width,
+    unsigned int block_height, int ss_x, int ss_y, int strength,
+    int use_whole_blk, uint32_t *y_accum, uint16_t *y_count,
+    const uint32_t *y_dist, const uint32_t *u_dist, const uint32_t *v_dist,
+    const uint32_t *const *neighbors_first,
+    const uint32_t *const *neighbors_second, int top_weight,
+    int bottom_weight) {
+  const int rounding = (1 << strength) >> 1;
+  __m256i weight = _mm256_set1_epi32(top_weight);
+
+  __m256i mul;
+
+  __m256i sum_row_1, sum_row_2, sum_row_3;
+
+  __m256i uv_sum;
+
+  __m256i sum_row;
+
+  // Loop variables
+  unsigned int h;
+
+  assert(strength >= 4 && strength <= 14 &&
+         "invalid adjusted temporal filter strength");
+  assert(block_width == 8);
+
+  (void)block_width;
+
+  // First row
+  mul = highbd_load_neighbors(neighbors_first[0], neighbors_second[0]);
+
+  // Add luma values
+  sum_row_2 = highbd_get_sum_8(y_dist);
+  sum_row_3 = highbd_get_sum_8(y_dist + DIST_STRIDE);
+
+  // We don't need to saturate here because the maximum value is UINT12_MAX ** 2
+  // * 9 ~= 2**24 * 9 < 2 ** 28 < INT32_MAX
+  sum_row = _mm256_add_epi32(sum_row_2, sum_row_3);
+
+  // Add chroma values
+  uv_sum = highbd_read_chroma_dist_row_8(ss_x, u_dist, v_dist);
+
+  // Max value here is 2 ** 24 * (9 + 2), so no saturation is needed
+  sum_row = _mm256_add_epi32(sum_row, uv_sum);
+
+  // Get modifier and store result
+  sum_row = highbd_average_8(sum_row, mul, strength, rounding, weight);
+  highbd_accumulate_and_store_8(sum_row, y_pre, y_count, y_accum);
+
+  y_pre += y_pre_stride;
+  y_count += y_pre_stride;
+  y_accum += y_pre_stride;
+  y_dist += DIST_STRIDE;
+
+  u_dist += DIST_STRIDE;
+  v_dist += DIST_STRIDE;
+
+  // Then all the rows except the last one
+  mul = highbd_load_neighbors(neighbors_first[1], neighbors_second[1]);
+
+  for (h = 1; h < block_height - 1; ++h) {
+    // Move the weight to bottom half
+    if (!use_whole_blk && h == block_height / 2) {
+      weight = _mm256_set1_epi32(bottom_weight);
+    }
+    // Shift the rows up
+    sum_row_1 = sum_row_2;
+    sum_row_2 = sum_row_3;
+
+    // Add luma values to the modifier
+    sum_row = _mm256_add_epi32(sum_row_1, sum_row_2);
+
+    sum_row_3 = highbd_get_sum_8(y_dist + DIST_STRIDE);
+
+    sum_row = _mm256_add_epi32(sum_row, sum_row_3);
+
+    // Add chroma values to the modifier
+    if (ss_y == 0 || h % 2 == 0) {
+      // Only calculate the new chroma distortion if we are at a pixel that
+      // corresponds to a new chroma row
+      uv_sum = highbd_read_chroma_dist_row_8(ss_x, u_dist, v_dist);
+
+      u_dist += DIST_STRIDE;
+      v_dist += DIST_STRIDE;
+    }
+
+    sum_row = _mm256_add_epi32(sum_row, uv_sum);
+
+    // Get modifier and store result
+    sum_row = highbd_average_8(sum_row, mul, strength, rounding, weight);
+    highbd_accumulate_and_store_8(sum_row, y_pre, y_count, y_accum);
+
+    y_pre += y_pre_stride;
+    y_count += y_pre_stride;
+    y_accum += y_pre_stride;
+    y_dist += DIST_STRIDE;
+  }
+
+  // The last row
+  mul = highbd_load_neighbors(neighbors_first[0], neighbors_second[0]);
+
+  // Shift the rows up
+  sum_row_1 = sum_row_2;
+  sum_row_2 = sum_row_3;
+
+  // Add luma values to the modifier
+  sum_row = _mm256_add_epi32(sum_row_1, sum_row_2);
+
+  // Add chroma values to the modifier
+  if (ss_y == 0) {
+    // Only calculate the new chroma distortion if we are at a pixel that
+    // corresponds to a new chroma row
+    uv_sum = highbd_read_chroma_dist_row_8(ss_x, u_dist, v_dist);
+  }
+
+  sum_row = _mm256_add_epi32(sum_row, uv_sum);
+
+  // Get modifier and store result
+  sum_row = highbd_average_8(sum_row, mul, strength, rounding, weight);
+  highbd_accumulate_and_store_8(sum_row, y_pre, y_count, y_accum);
+}
+
+// Perform temporal filter for the luma component.
+static void vp9_highbd_apply_temporal_filter_luma(
+    const uint16_t *y_pre, int y_pre_stride, unsigned int block_width,
+    unsigned int block_height, int ss_x, int ss_y, int strength,
+    const int *blk_fw, int use_whole_blk, uint32_t *y_accum,
+    uint16_t *y_count, const uint32_t *y_dist, const uint32_t *u_dist,
+    const uint32_t *v_dist) {
+  unsigned int blk_col = 0, uv_blk_col = 0;
+  const unsigned int blk_col_step = 8, uv_blk_col_step = 8 >> ss_x;
+  const unsigned int mid_width = block_width >> 1,
+                     last_width = block_width - blk_col_step;
+  int top_weight = blk_fw[0],
+      bottom_weight = use_whole_blk ? blk_fw[0] : blk_fw[2];
+  const uint32_t *const *neighbors_first;
+  const uint32_t *const *neighbors_second;
+
+  // Left
+  neighbors_first = HIGHBD_LUMA_LEFT_COLUMN_NEIGHBORS;
+  neighbors_second = HIGHBD_LUMA_MIDDLE_COLUMN_NEIGHBORS;
+  vp9_highbd_apply_temporal_filter_luma_8(
+      y_pre + blk_col, y_pre_stride, blk_col_step, block_height, ss_x, ss_y,
+      strength, use_whole_blk, y_accum + blk_col, y_count + blk_col,
+      y_dist + blk_col, u_dist + uv_blk_col, v_dist + uv_blk_col,
+      neighbors_first, neighbors_second, top_weight, bottom_weight);
+
+  blk_col += blk_col_step;
+  uv_blk_col += uv_blk_col_step;
+
+  // Middle First
+  neighbors_first = HIGHBD_LUMA_MIDDLE_COLUMN_NEIGHBORS;
+  for (; blk_col < mid_width;
+       blk_col += blk_col_step, uv_blk_col += uv_blk_col_step) {
+    vp9_highbd_apply_temporal_filter_luma_8(
+        y_pre + blk_col, y_pre_stride, blk_col_step, block_height, ss_x, ss_y,
+        strength, use_whole_blk, y_accum + blk_col, y_count + blk_col,
+        y_dist + blk_col, u_dist + uv_blk_col, v_dist + uv_blk_col,
+        neighbors_first, neighbors_second, top_weight, bottom_weight);
+  }
+
+  if (!use_whole_blk) {
+    top_weight = blk_fw[1];
+    bottom_weight = blk_fw[3];
+  }
+
+  // Middle Second
+  for (; blk_col < last_width;
+       blk_col += blk_col_step, uv_blk_col += uv_blk_col_step) {
+    vp9_highbd_apply_temporal_filter_luma_8(
+        y_pre + blk_col, y_pre_stride, blk_col_step, block_height, ss_x, ss_y,
+        strength, use_whole_blk, y_accum + blk_col, y_count + blk_col,
+        y_dist + blk_col, u_dist + uv_blk_col, v_dist + uv_blk_col,
+        neighbors_first, neighbors_second, top_weight, bottom_weight);
+  }
+
+  // Right
+  neighbors_second = HIGHBD_LUMA_RIGHT_COLUMN_NEIGHBORS;
+  vp9_highbd_apply_temporal_filter_luma_8(
+      y_pre + blk_col, y_pre_stride, blk_col_step, block_height, ss_x, ss_y,
+      strength, use_whole_blk, y_accum + blk_col, y_count + blk_col,
+      y_dist + blk_col, u_dist + uv_blk_col, v_dist + uv_blk_col,
+      neighbors_first, neighbors_second, top_weight, bottom_weight);
+}
+
+// Apply temporal filter to the chroma components. This performs temporal
+// filtering on a chroma block of 8 X uv_height. If blk_fw is not NULL, use
+// blk_fw as an array of size 4 for the weights for each of the 4 subblocks,
+// else use top_weight for top half, and bottom weight for bottom half.
+static void vp9_highbd_apply_temporal_filter_chroma_8(
+    const uint16_t *u_pre, const uint16_t *v_pre, int uv_pre_stride,
+    unsigned int uv_block_height, int ss_x, int ss_y, int strength,
+    uint32_t *u_accum, uint16_t *u_count, uint32_t *v_accum, uint16_t *v_count,
+    const uint32_t *y_dist, const uint32_t *u_dist, const uint32_t *v_dist,
+    const uint32_t *const *neighbors_fst, const uint32_t *const *neighbors_snd,
+    int top_weight, int bottom_weight, const int *blk_fw) {
+  const int rounding = (1 << strength) >> 1;
+
+  __m256i weight;
+
+  __m256i mul;
+
+  __m256i u_sum_row_1, u_sum_row_2, u_sum_row_3;
+  __m256i v_sum_row_1, v_sum_row_2, v_sum_row_3;
+
+  __m256i u_sum_row, v_sum_row, y_sum;
+
+  // Loop variable
+  unsigned int h;
+
+  // Initialize weight
+  if (blk_fw) {
+    weight = highbd_set_m128i(_mm_set1_epi32(blk_fw[0]),
+                              _mm_set1_epi32(blk_fw[1]));
+  } else {
+    weight = _mm256_set1_epi32(top_weight);
+  }
+
+  // First row
+  mul = highbd_load_neighbors(neighbors_fst[0], neighbors_snd[0]);
+
+  // Add chroma values
+  u_sum_row_2 = highbd_get_sum_8(u_dist);
+  u_sum_row_3 = highbd_get_sum_8(u_dist + DIST_STRIDE);
+
+  u_sum_row = _mm256_add_epi32(u_sum_row_2, u_sum_row_3);
+
+  v_sum_row_2 = highbd_get_sum_8(v_dist);
+  v_sum_row_3 = highbd_get_sum_8(v_dist + DIST_STRIDE);
+
+  v_sum_row = _mm256_add_epi32(v_sum_row_2, v_sum_row_3);
+
+  // Add luma values
+  y_sum = highbd_get_luma_dist_for_8_chroma(y_dist, ss_x, ss_y);
+  u_sum_row = _mm256_add_epi32(u_sum_row, y_sum);
+  v_sum_row = _mm256_add_epi32(v_sum_row, y_sum);
+
+  // Get modifier and store result
+  u_sum_row = highbd_average_8(u_sum_row, mul, strength, rounding, weight);
+  v_sum_row = highbd_average_8(v_sum_row, mul, strength, rounding, weight);
+
+  highbd_accumulate_and_store_8(u_sum_row, u_pre, u_count, u_accum);
+  highbd_accumulate_and_store_8(v_sum_row, v_pre, v_count, v_accum);
+
+  u_pre += uv_pre_stride;
+  u_dist += DIST_STRIDE;
+  v_pre += uv_pre_stride;
+  v_dist += DIST_STRIDE;
+  u_count += uv_pre_stride;
+  u_accum += uv_pre_stride;
+  v_count += uv_pre_stride;
+  v_accum += uv_pre_stride;
+
+  y_dist += DIST_STRIDE * (1 + ss_y);
+
+  // Then all the rows except the last one
+  mul = highbd_load_neighbors(neighbors_fst[1], neighbors_snd[1]);
+
+  for (h = 1; h < uv_block_height - 1; ++h) {
+    // Move the weight pointer to the bottom half of the blocks
+    if (h == uv_block_height / 2) {
+      if (blk_fw) {
+        weight = highbd_set_m128i(_mm_set1_epi32(blk_fw[2]),
+                                  _mm_set1_epi32(blk_fw[3]));
+      } else {
+        weight = _mm256_set1_epi32(bottom_weight);
+      }
+    }
+
+    // Shift the rows up
+    u_sum_row_1 = u_sum_row_2;
+    u_sum_row_2 = u_sum_row_3;
+
+    v_sum_row_1 = v_sum_row_2;
+    v_sum_row_2 = v_sum_row_3;
+
+    // Add chroma values
+    u_sum_row = _mm256_add_epi32(u_sum_row_1, u_sum_row_2);
+    u_sum_row_3 = highbd_get_sum_8(u_dist + DIST_STRIDE);
+    u_sum_row = _mm256_add_epi32(u_sum_row, u_sum_row_3);
+
+    v_sum_row = _mm256_add_epi32(v_sum_row_1, v_sum_row_2);
+    v_sum_row_3 = highbd_get_sum_8(v_dist + DIST_STRIDE);
+    v_sum_row = _mm256_add_epi32(v_sum_row, v_sum_row_3);
+
+    // Add luma values
+    y_sum = highbd_get_luma_dist_for_8_chroma(y_dist, ss_x, ss_y);
+    u_sum_row = _mm256_add_epi32(u_sum_row, y_sum);
+    v_sum_row = _mm256_add_epi32(v_sum_row, y_sum);
+
+    // Get modifier and store result
+    u_sum_row = highbd_average_8(u_sum_row, mul, strength, rounding, weight);
+    v_sum_row = highbd_average_8(v_sum_row, mul, strength, rounding, weight);
+
+    highbd_accumulate_and_store_8(u_sum_row, u_pre, u_count, u_accum);
+    highbd_accumulate_and_store_8(v_sum_row, v_pre, v_count, v_accum);
+
+    u_pre += uv_pre_stride;
+    u_dist += DIST_STRIDE;
+    v_pre += uv_pre_stride;
+    v_dist += DIST_STRIDE;
+    u_count += uv_pre_stride;
+    u_accum += uv_pre_stride;
+    v_count += uv_pre_stride;
+    v_accum += uv_pre_stride;
+
+    y_dist += DIST_STRIDE * (1 + ss_y);
+  }
+
+  // The last row
+  mul = highbd_load_neighbors(neighbors_fst[0], neighbors_snd[0]);
+
+  // Shift the rows up
+  u_sum_row_1 = u_sum_row_2;
+  u_sum_row_2 = u_sum_row_3;
+
+  v_sum_row_1 = v_sum_row_2;
+  v_sum_row_2 = v_sum_row_3;
+
+  // Add chroma values
+  u_sum_row = _mm256_add_epi32(u_sum_row_1, u_sum_row_2);
+  v_sum_row = _mm256_add_epi32(v_sum_row_1, v_sum_row_2);
+
+  // Add luma values
+  y_sum = highbd_get_luma_dist_for_8_chroma(y_dist, ss_x, ss_y);
+  u_sum_row = _mm256_add_epi32(u_sum_row, y_sum);
+  v_sum_row = _mm256_add_epi32(v_sum_row, y_sum);
+
+  // Get modifier and store result
+  u_sum_row = highbd_average_8(u_sum_row, mul, strength, rounding, weight);
+  v_sum_row = highbd_average_8(v_sum_row, mul, strength, rounding, weight);
+
+  highbd_accumulate_and_store_8(u_sum_row, u_pre, u_count, u_accum);
+  highbd_accumulate_and_store_8(v_sum_row, v_pre, v_count, v_accum);
+}
+
+// Perform temporal filter for the chroma components.
+static void vp9_highbd_apply_temporal_filter_chroma(
+    const uint16_t *u_pre, const uint16_t *v_pre, int uv_pre_stride,
+    unsigned int block_width, unsigned int block_height, int ss_x, int ss_y,
+    int strength, const int *blk_fw, int use_whole_blk, uint32_t *u_accum,
+    uint16_t *u_count, uint32_t *v_accum, uint16_t *v_count,
+    const uint32_t *y_dist, const uint32_t *u_dist, const uint32_t *v_dist) {
+  const unsigned int uv_width = block_width >> ss_x,
+                     uv_height = block_height >> ss_y;
+
+  unsigned int blk_col = 0, uv_blk_col = 0;
+  const unsigned int uv_blk_col_step = 8, blk_col_step = 8 << ss_x;
+  const unsigned int uv_mid_width = uv_width >> 1,
+                     uv_last_width = uv_width - uv_blk_col_step;
+  int top_weight = blk_fw[0],
+      bottom_weight = use_whole_blk ? blk_fw[0] : blk_fw[2];
+  const uint32_t *const *neighbors_fst;
+  const uint32_t *const *neighbors_snd;
+
+  if (uv_width == 8) {
+    // Special Case: We are subsampling in x direction on a 16x16 block. Since
+    // we are operating on a row of 8 chroma pixels, we can't use the usual
+    // left-middle-right pattern.
+    assert(ss_x);
+
+    if (ss_y) {
+      neighbors_fst = HIGHBD_CHROMA_DOUBLE_SS_LEFT_COLUMN_NEIGHBORS;
+      neighbors_snd = HIGHBD_CHROMA_DOUBLE_SS_RIGHT_COLUMN_NEIGHBORS;
+    } else {
+      neighbors_fst = HIGHBD_CHROMA_SINGLE_SS_LEFT_COLUMN_NEIGHBORS;
+      neighbors_snd = HIGHBD_CHROMA_SINGLE_SS_RIGHT_COLUMN_NEIGHBORS;
+    }
+
+    vp9_highbd_apply_temporal_filter_chroma_8(
+        u_pre, v_pre, uv_pre_stride, uv_height, ss_x, ss_y, strength, u_accum,
+        u_count, v_accum, v_count, y_dist, u_dist, v_dist, neighbors_fst,
+        neighbors_snd, top_weight, bottom_weight,
+        use_whole_blk ? NULL : blk_fw);
+    return;
+  }
+
+  // Left
+  if (ss_x && ss_y) {
+    neighbors_fst = HIGHBD_CHROMA_DOUBLE_SS_LEFT_COLUMN_NEIGHBORS;
+    neighbors_snd = HIGHBD_CHROMA_DOUBLE_SS_MIDDLE_COLUMN_NEIGHBORS;
+  } else if (ss_x || ss_y) {
+    neighbors_fst = HIGHBD_CHROMA_SINGLE_SS_LEFT_COLUMN_NEIGHBORS;
+    neighbors_snd = HIGHBD_CHROMA_SINGLE_SS_MIDDLE_COLUMN_NEIGHBORS;
+  } else {
+    neighbors_fst = HIGHBD_CHROMA_NO_SS_LEFT_COLUMN_NEIGHBORS;
+    neighbors_snd = HIGHBD_CHROMA_NO_SS_MIDDLE_COLUMN_NEIGHBORS;
+  }
+
+  vp9_highbd_apply_temporal_filter_chroma_8(
+      u_pre + uv_blk_col, v_pre + uv_blk_col, uv_pre_stride, uv_height, ss_x,
+      ss_y, strength, u_accum + uv_blk_col, u_count + uv_blk_col,
+      v_accum + uv_blk_col, v_count + uv_blk_col, y_dist + blk_col,
+      u_dist + uv_blk_col, v_dist + uv_blk_col, neighbors_fst, neighbors_snd,
+      top_weight, bottom_weight, NULL);
+
+  blk_col += blk_col_step;
+  uv_blk_col += uv_blk_col_step;
+
+  // Middle First
+  if (ss_x && ss_y) {
+    neighbors_fst = HIGHBD_CHROMA_DOUBLE_SS_MIDDLE_COLUMN_NEIGHBORS;
+  } else if (ss_x || ss_y) {
+    neighbors_fst = HIGHBD_CHROMA_SINGLE_SS_MIDDLE_COLUMN_NEIGHBORS;
+  } else {
+    neighbors_fst = HIGHBD_CHROMA_NO_SS_MIDDLE_COLUMN_NEIGHBORS;
+  }
+
+  for (; uv_blk_col < uv_mid_width;
+       blk_col += blk_col_step, uv_blk_col += uv_blk_col_step) {
+    vp9_highbd_apply_temporal_filter_chroma_8(
+        u_pre + uv_blk_col, v_pre + uv_blk_col, uv_pre_stride, uv_height, ss_x,
+        ss_y, strength, u_accum + uv_blk_col, u_count + uv_blk_col,
+        v_accum + uv_blk_col, v_count + uv_blk_col, y_dist + blk_col,
+        u_dist + uv_blk_col, v_dist + uv_blk_col, neighbors_fst, neighbors_snd,
+        top_weight, bottom_weight, NULL);
+  }
+
+  if (!use_whole_blk) {
+    top_weight = blk_fw[1];
+    bottom_weight = blk_fw[3];
+  }
+
+  // Middle Second
+  for (; uv_blk_col < uv_last_width;
+       blk_col += blk_col_step, uv_blk_col += uv_blk_col_step) {
+    vp9_highbd_apply_temporal_filter_chroma_8(
+        u_pre + uv_blk_col, v_pre + uv_blk_col, uv_pre_stride, uv_height, ss_x,
+        ss_y, strength, u_accum + uv_blk_col, u_count + uv_blk_col,
+        v_accum + uv_blk_col, v_count + uv_blk_col, y_dist + blk_col,
+        u_dist + uv_blk_col, v_dist + uv_blk_col, neighbors_fst, neighbors_snd,
+        top_weight, bottom_weight, NULL);
+  }
+
+  // Right
+  if (ss_x && ss_y) {
+    neighbors_snd = HIGHBD_CHROMA_DOUBLE_SS_RIGHT_COLUMN_NEIGHBORS;
+  } else if (ss_x || ss_y) {
+    neighbors_snd = HIGHBD_CHROMA_SINGLE_SS_RIGHT_COLUMN_NEIGHBORS;
+  } else {
+    neighbors_snd = HIGHBD_CHROMA_NO_SS_RIGHT_COLUMN_NEIGHBORS;
+  }
+
+  vp9_highbd_apply_temporal_filter_chroma_8(
+      u_pre + uv_blk_col, v_pre + uv_blk_col, uv_pre_stride, uv_height, ss_x,
+      ss_y, strength, u_accum + uv_blk_col, u_count + uv_blk_col,
+      v_accum + uv_blk_col, v_count + uv_blk_col, y_dist + blk_col,
+      u_dist + uv_blk_col, v_dist + uv_blk_col, neighbors_fst, neighbors_snd,
+      top_weight, bottom_weight, NULL);
+}
+
+void vp9_highbd_apply_temporal_filter_avx2(
+    const uint16_t *y_src, int y_src_stride, const uint16_t *y_pre,
+    int y_pre_stride, const uint16_t *u_src, const uint16_t *v_src,
+    int uv_src_stride, const uint16_t *u_pre, const uint16_t *v_pre,
+    int uv_pre_stride, unsigned int block_width, unsigned int block_height,
+    int ss_x, int ss_y, int strength, const int *const blk_fw,
+    int use_whole_blk, uint32_t *y_accum, uint16_t *y_count, uint32_t *u_accum,
+    uint16_t *u_count, uint32_t *v_accum, uint16_t *v_count) {
+  const unsigned int chroma_height = block_height >> ss_y,
+                     chroma_width = block_width >> ss_x;
+
+  DECLARE_ALIGNED(32, uint32_t, y_dist[BH * DIST_STRIDE]) = { 0 };
+  DECLARE_ALIGNED(32, uint32_t, u_dist[BH * DIST_STRIDE]) = { 0 };
+  DECLARE_ALIGNED(32, uint32_t, v_dist[BH * DIST_STRIDE]) = { 0 };
+
+  uint32_t *y_dist_ptr = y_dist + 1, *u_dist_ptr = u_dist + 1,
+           *v_dist_ptr = v_dist + 1;
+  const uint16_t *y_src_ptr = y_src, *u_src_ptr = u_src, *v_src_ptr = v_src;
+  const uint16_t *y_pre_ptr = y_pre, *u_pre_ptr = u_pre, *v_pre_ptr = v_pre;
+
+  // Loop variables
+  unsigned int row, blk_col;
+
+  assert(block_width <= BW && "block width too large");
+  assert(block_height <= BH && "block height too large");
+  assert(block_width % 16 == 0 && "block width must be multiple of 16");
+  assert(block_height % 2 == 0 && "block height must be even");
+  assert((ss_x == 0 || ss_x == 1) && (ss_y == 0 || ss_y == 1) &&
+         "invalid chroma subsampling");
+  assert(strength >= 4 && strength <= 14 &&
+         "invalid adjusted temporal filter strength");
+  assert(blk_fw[0] >= 0 && "filter weight must be positive");
+  assert(
+      (use_whole_blk || (blk_fw[1] >= 0 && blk_fw[2] >= 0 && blk_fw[3] >= 0)) &&
+      "subblock filter weight must be positive");
+  assert(blk_fw[0] <= 2 && "sublock filter weight must be less than 2");
+  assert(
+      (use_whole_blk || (blk_fw[1] <= 2 && blk_fw[2] <= 2 && blk_fw[3] <= 2)) &&
+      "subblock filter weight must be less than 2");
+
+  // Precompute the difference squared
+  for (row = 0; row < block_height; row++) {
+    for (blk_col = 0; blk_col < block_width; blk_col += 8) {
+      highbd_store_dist_8(y_src_ptr + blk_col, y_pre_ptr + blk_col,
+                          y_dist_ptr + blk_col);
+    }
+    y_src_ptr += y_src_stride;
+    y_pre_ptr += y_pre_stride;
+    y_dist_ptr += DIST_STRIDE;
+  }
+
+  for (row = 0; row < chroma_height; row++) {
+    for (blk_col = 0; blk_col < chroma_width; blk_col += 8) {
+      highbd_store_dist_8(u_src_ptr + blk_col, u_pre_ptr + blk_col,
+                          u_dist_ptr + blk_col);
+      highbd_store_dist_8(v_src_ptr + blk_col, v_pre_ptr + blk_col,
+                          v_dist_ptr + blk_col);
+    }
+
+    u_src_ptr += uv_src_stride;
+    u_pre_ptr += uv_pre_stride;
+    u_dist_ptr += DIST_STRIDE;
+    v_src_ptr += uv_src_stride;
+    v_pre_ptr += uv_pre_stride;
+    v_dist_ptr += DIST_STRIDE;
+  }
+
+  y_dist_ptr = y_dist + 1;
+  u_dist_ptr = u_dist + 1;
+  v_dist_ptr = v_dist + 1;
+
+  vp9_highbd_apply_temporal_filter_luma(
+      y_pre, y_pre_stride, block_width, block_height, ss_x, ss_y, strength,
+      blk_fw, use_whole_blk, y_accum, y_count, y_dist_ptr, u_dist_ptr,
+      v_dist_ptr);
+
+  vp9_highbd_apply_temporal_filter_chroma(
+      u_pre, v_pre, uv_pre_stride, block_width, block_height, ss_x, ss_y,
+      strength, blk_fw, use_whole_blk, u_accum, u_count, v_accum, v_count,
+      y_dist_ptr, u_dist_ptr, v_dist_ptr);
+}
@@ -0,0 +1,226 @@
+/*
+ *  Copyright (c) 2021 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./vpx_config.h"
+#include "./vp9_rtcd.h"
+
+#include "vpx/vpx_integer.h"
+#include "vp9/common/vp9_reconinter.h"
+#include "vp9/encoder/vp9_context_tree.h"
+#include "vp9/encoder/vp9_denoiser.h"
+#include "vpx_mem/vpx_mem.h"
+
+// The filter works on 32 pixels at a time: one row of a 32 or 64 wide block,
+// two rows of a 16 wide block or four rows of an 8 wide block. Each byte of
+// the accumulator takes up to 16 adjustments before it is added up. These
+// are at most 7, or 8 with increase_denoising, so a byte can reach 128 and
+// overflow int8. The adds saturate like the SSE2 version, which keeps 32 and
+// 64 wide blocks identical to it. A 16 wide block spreads each column over
+// two bytes here, so it can only differ from SSE2 where that saturates.
+#define ACC_VECTORS 16
+
+static INLINE __m256i load_32(const uint8_t *p, int stride, int width) {
+  if (width >= 32) return _mm256_loadu_si256((const __m256i *)p);
+  if (width == 16) {
+    return _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)p)),
+        _mm_loadu_si128((const __m128i *)(p + stride)), 1);
+  } else {
+    const __m128i r01 =
+        _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)p),
+                           _mm_loadl_epi64((const __m128i *)(p + stride)));
+    const __m128i r23 = _mm_unpacklo_epi64(
+        _mm_loadl_epi64((const __m128i *)(p + 2 * stride)),
+        _mm_loadl_epi64((const __m128i *)(p + 3 * stride)));
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(r01), r23, 1);
+  }
+}
+
+static INLINE void store_32(uint8_t *p, int stride, int width, __m256i v) {
+  const __m128i lo = _mm256_castsi256_si128(v);
+  const __m128i hi = _mm256_extracti128_si256(v, 1);
+  if (width >= 32) {
+    _mm256_storeu_si256((__m256i *)p, v);
+  } else if (width == 16) {
+    _mm_storeu_si128((__m128i *)p, lo);
+    _mm_storeu_si128((__m128i *)(p + stride), hi);
+  } else {
+    _mm_storel_epi64((__m128i *)p, lo);
+    _mm_storel_epi64((__m128i *)(p + stride), _mm_unpackhi_epi64(lo, lo));
+    _mm_storel_epi64((__m128i *)(p + 2 * stride), hi);
+    _mm_storel_epi64((__m128i *)(p + 3 * stride), _mm_unpackhi_epi64(hi, hi));
+  }
+}
+
+// Compute the sum of all pixel differences of this vector.
+static INLINE int sum_diff_32x1(__m256i acc_diff) {
+  const __m256i k_1 = _mm256_set1_epi16(1);
+  const __m256i acc_diff_lo =
+      _mm256_srai_epi16(_mm256_unpacklo_epi8(acc_diff, acc_diff), 8);
+  const __m256i acc_diff_hi =
+      _mm256_srai_epi16(_mm256_unpackhi_epi8(acc_diff, acc_diff), 8);
+  const __m256i sum_32 =
+      _mm256_madd_epi16(_mm256_add_epi16(acc_diff_lo, acc_diff_hi), k_1);
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(sum_32),
+                              _mm256_extracti128_si256(sum_32, 1));
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 8));
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 4));
+  return _mm_cvtsi128_si32(sum);
+}
+
+// Denoise 32 pixels with the strong filter.
+static INLINE __m256i denoiser_32x1_avx2(const __m256i v_sig,
+                                         const __m256i v_mc_running_avg_y,
+                                         __m256i *const v_running_avg_y,
+                                         const __m256i k_4, const __m256i l3,
+                                         const __m256i acc_diff) {
+  const __m256i k_0 = _mm256_setzero_si256();
+  const __m256i k_8 = _mm256_set1_epi8(8);
+  const __m256i k_16 = _mm256_set1_epi8(16);
+  // Difference between level 3 and level 2 is 2.
+  const __m256i l32 = _mm256_set1_epi8(2);
+  // Difference between level 2 and level 1 is 1.
+  const __m256i l21 = _mm256_set1_epi8(1);
+  const __m256i pdiff = _mm256_subs_epu8(v_mc_running_avg_y, v_sig);
+  const __m256i ndiff = _mm256_subs_epu8(v_sig, v_mc_running_avg_y);
+  // Obtain the sign. FF if diff is negative.
+  const __m256i diff_sign = _mm256_cmpeq_epi8(pdiff, k_0);
+  // Clamp absolute difference to 16 to be used to get mask. Doing this
+  // allows us to use _mm256_cmpgt_epi8, which operates on signed byte.
+  const __m256i clamped_absdiff =
+      _mm256_min_epu8(_mm256_or_si256(pdiff, ndiff), k_16);
+  // Get masks for l2 l1 and l0 adjustments.
+  const __m256i mask2 = _mm256_cmpgt_epi8(k_16, clamped_absdiff);
+  const __m256i mask1 = _mm256_cmpgt_epi8(k_8, clamped_absdiff);
+  const __m256i mask0 = _mm256_cmpgt_epi8(k_4, clamped_absdiff);
+  // Get adjustments for l2, l1, and l0.
+  const __m256i adj2 = _mm256_and_si256(mask2, l32);
+  const __m256i adj1 = _mm256_and_si256(mask1, l21);
+  const __m256i adj0 = _mm256_and_si256(mask0, clamped_absdiff);
+  __m256i adj, padj, nadj;
+
+  // Combine the adjustments and get absolute adjustments.
+  adj = _mm256_sub_epi8(l3, _mm256_add_epi8(adj2, adj1));
+  adj = _mm256_andnot_si256(mask0, adj);
+  adj = _mm256_or_si256(adj, adj0);
+
+  // Restore the sign and get positive and negative adjustments.
+  padj = _mm256_andnot_si256(diff_sign, adj);
+  nadj = _mm256_and_si256(diff_sign, adj);
+
+  // Calculate filtered value.
+  *v_running_avg_y =
+      _mm256_subs_epu8(_mm256_adds_epu8(v_sig, padj), nadj);
+
+  return _mm256_subs_epi8(_mm256_adds_epi8(acc_diff, padj), nadj);
+}
+
+// Denoise 32 pixels with a weaker filter.
+static INLINE __m256i denoiser_adj_32x1_avx2(const __m256i v_sig,
+                                             const __m256i v_mc_running_avg_y,
+                                             __m256i *const v_running_avg_y,
+                                             const __m256i k_delta,
+                                             const __m256i acc_diff) {
+  const __m256i pdiff = _mm256_subs_epu8(v_mc_running_avg_y, v_sig);
+  const __m256i ndiff = _mm256_subs_epu8(v_sig, v_mc_running_avg_y);
+  // Obtain the sign. FF if diff is negative.
+  const __m256i diff_sign = _mm256_cmpeq_epi8(pdiff, _mm256_setzero_si256());
+  // Clamp absolute difference to delta to get the adjustment.
+  const __m256i adj = _mm256_min_epu8(_mm256_or_si256(pdiff, ndiff), k_delta);
+  // Restore the sign and get positive and negative adjustments.
+  const __m256i padj = _mm256_andnot_si256(diff_sign, adj);
+  const __m256i nadj = _mm256_and_si256(diff_sign, adj);
+
+  // Calculate filtered value.
+  *v_running_avg_y =
+      _mm256_adds_epu8(_mm256_subs_epu8(*v_running_avg_y, padj), nadj);
+
+  return _mm256_adds_epi8(_mm256_subs_epi8(acc_diff, padj), nadj);
+}
+
+int vp9_denoiser_filter_avx2(const uint8_t *sig, int sig_stride,
+                             const uint8_t *mc_avg, int mc_avg_stride,
+                             uint8_t *avg, int avg_stride,
+                             int increase_denoising, BLOCK_SIZE bs,
+                             int motion_magnitude) {
+  const int shift_inc =
+      (increase_denoising && motion_magnitude <= MOTION_MAGNITUDE_THRESHOLD)
+          ? 1
+          : 0;
+  const __m256i k_4 = _mm256_set1_epi8(4 + shift_inc);
+  // Modify each level's adjustment according to motion_magnitude.
+  const __m256i l3 = _mm256_set1_epi8(
+      (motion_magnitude <= MOTION_MAGNITUDE_THRESHOLD) ? 7 + shift_inc : 6);
+  const int b_width = 4 << b_width_log2_lookup[bs];
+  const int b_height = 4 << b_height_log2_lookup[bs];
+  // Rows and columns covered by each 32 pixel vector.
+  const int rows = b_width >= 32 ? 1 : 32 / b_width;
+  const int cols = VPXMIN(b_width, 32);
+  __m256i acc_diff = _mm256_setzero_si256();
+  int sum_diff_thresh, sum_diff = 0, n = 0, r, c;
+
+  // Same block sizes as the SSE2 version, so both make the same decisions.
+  if (b_width < 8 || b_height < 8) return COPY_BLOCK;
+
+  for (r = 0; r < b_height; r += rows) {
+    for (c = 0; c < b_width; c += cols) {
+      __m256i v_running_avg_y;
+      acc_diff = denoiser_32x1_avx2(
+          load_32(sig + r * sig_stride + c, sig_stride, b_width),
+          load_32(mc_avg + r * mc_avg_stride + c, mc_avg_stride, b_width),
+          &v_running_avg_y, k_4, l3, acc_diff);
+      store_32(avg + r * avg_stride + c, avg_stride, b_width, v_running_avg_y);
+      if (++n == ACC_VECTORS) {
+        sum_diff += sum_diff_32x1(acc_diff);
+        acc_diff = _mm256_setzero_si256();
+        n = 0;
+      }
+    }
+  }
+  sum_diff += sum_diff_32x1(acc_diff);
+
+  sum_diff_thresh = total_adj_strong_thresh(bs, increase_denoising);
+  if (abs(sum_diff) > sum_diff_thresh) {
+    // Before returning to copy the block (i.e., apply no denoising), check
+    // if we can still apply some (weaker) temporal filtering to this block,
+    // by moving running_avg_y closer to sig by at most delta.
+    const int delta =
+        ((abs(sum_diff) - sum_diff_thresh) >> num_pels_log2_lookup[bs]) + 1;
+    __m256i k_delta;
+
+    // Only apply the adjustment for max delta up to 3.
+    if (delta >= 4) return COPY_BLOCK;
+
+    k_delta = _mm256_set1_epi8(delta);
+    acc_diff = _mm256_setzero_si256();
+    n = 0;
+    for (r = 0; r < b_height; r += rows) {
+      for (c = 0; c < b_width; c += cols) {
+        uint8_t *const avg_ptr = avg + r * avg_stride + c;
+        __m256i v_running_avg_y = load_32(avg_ptr, avg_stride, b_width);
+        acc_diff = denoiser_adj_32x1_avx2(
+            load_32(sig + r * sig_stride + c, sig_stride, b_width),
+            load_32(mc_avg + r * mc_avg_stride + c, mc_avg_stride, b_width),
+            &v_running_avg_y, k_delta, acc_diff);
+        store_32(avg_ptr, avg_stride, b_width, v_running_avg_y);
+        if (++n == ACC_VECTORS) {
+          sum_diff += sum_diff_32x1(acc_diff);
+          acc_diff = _mm256_setzero_si256();
+          n = 0;
+        }
+      }
+    }
+    sum_diff += sum_diff_32x1(acc_diff);
+    if (abs(sum_diff) > sum_diff_thresh) return COPY_BLOCK;
+  }
+  return FILTER_BLOCK;
+}
@@ -0,0 +1,397 @@
+/*
+ *  Copyright (c) 2021 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <assert.h>
+#include <immintrin.h>  // AVX2
+#include <stdlib.h>
+
+#include "./vp9_rtcd.h"
+#include "./vpx_dsp_rtcd.h"
+#include "./vpx_scale_rtcd.h"
+#include "vp9/common/vp9_blockd.h"
+#include "vpx_dsp/vpx_dsp_common.h"
+#include "vpx_dsp/vpx_filter.h"
+#include "vpx_ports/mem.h"
+#include "vpx_scale/yv12config.h"
+
+// Fills in the source pixel and the filter phase of each output pixel of a
+// plane, the same way the 16x16 block walk of vp9_scale_and_extend_frame_c()
+// does. The arrays need room for (dst_len + 15) / 16 * 16 / factor entries.
+static void get_scale_positions(int dst_len, int src_len, int factor,
+                                int phase_scaler, int *pos, int *phase) {
+  const int bs = 16 / factor;
+  const int step = 16 * src_len / dst_len;
+  int i, j;
+
+  for (i = 0; i < dst_len; i += 16) {
+    const int q4 = i * bs * src_len / dst_len + phase_scaler;
+    const int base = (i / factor) * src_len / dst_len;
+    for (j = 0; j < bs; ++j) {
+      const int p = (q4 & SUBPEL_MASK) + j * step;
+      *pos++ = base + (p >> SUBPEL_BITS);
+      *phase++ = p & SUBPEL_MASK;
+    }
+  }
+}
+
+static INLINE __m256i load_kernel_pair(const InterpKernel *const kernel,
+                                       const int phase0, const int phase1) {
+  const __m128i k0 = _mm_load_si128((const __m128i *)kernel[phase0]);
+  const __m128i k1 = _mm_load_si128((const __m128i *)kernel[phase1]);
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(k0), k1, 1);
+}
+
+static INLINE __m256i round_shift(const __m256i sum) {
+  const __m256i rounding = _mm256_set1_epi32(1 << (FILTER_BITS - 1));
+  return _mm256_srai_epi32(_mm256_add_epi32(sum, rounding), FILTER_BITS);
+}
+
+static INLINE __m128i round_shift_sse(const __m128i sum) {
+  const __m128i rounding = _mm_set1_epi32(1 << (FILTER_BITS - 1));
+  return _mm_srai_epi32(_mm_add_epi32(sum, rounding), FILTER_BITS);
+}
+
+// Adds up the 8 tap products of the outputs {0, 4}, {1, 5}, {2, 6} and
+// {3, 7}, given as madd pairs in the lanes of sum[0..3], into outputs 0..3 in
+// the low lane and 4..7 in the high lane.
+static INLINE __m256i add_taps(const __m256i *const sum) {
+  const __m256i s01 = _mm256_hadd_epi32(sum[0], sum[1]);
+  const __m256i s23 = _mm256_hadd_epi32(sum[2], sum[3]);
+  return round_shift(_mm256_hadd_epi32(s01, s23));
+}
+
+static INLINE void get_tap_pairs(const int16_t *const filter,
+                                 __m256i *const f) {
+  const __m256i f8 =
+      _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)filter));
+  f[0] = _mm256_shuffle_epi32(f8, 0x00);
+  f[1] = _mm256_shuffle_epi32(f8, 0x55);
+  f[2] = _mm256_shuffle_epi32(f8, 0xaa);
+  f[3] = _mm256_shuffle_epi32(f8, 0xff);
+}
+
+// Sums 8 rows of 16-bit pixels, interleaved in pairs, against the tap pairs.
+static INLINE __m256i filter_rows(const __m256i *const r,
+                                  const __m256i *const f) {
+  const __m256i s0 = _mm256_madd_epi16(r[0], f[0]);
+  const __m256i s1 = _mm256_madd_epi16(r[1], f[1]);
+  const __m256i s2 = _mm256_madd_epi16(r[2], f[2]);
+  const __m256i s3 = _mm256_madd_epi16(r[3], f[3]);
+  return round_shift(
+      _mm256_add_epi32(_mm256_add_epi32(s0, s1), _mm256_add_epi32(s2, s3)));
+}
+
+static INLINE __m128i filter_rows_sse(const __m128i *const r,
+                                      const __m256i *const f) {
+  const __m128i s0 = _mm_madd_epi16(r[0], _mm256_castsi256_si128(f[0]));
+  const __m128i s1 = _mm_madd_epi16(r[1], _mm256_castsi256_si128(f[1]));
+  const __m128i s2 = _mm_madd_epi16(r[2], _mm256_castsi256_si128(f[2]));
+  const __m128i s3 = _mm_madd_epi16(r[3], _mm256_castsi256_si128(f[3]));
+  return round_shift_sse(
+      _mm_add_epi32(_mm_add_epi32(s0, s1), _mm_add_epi32(s2, s3)));
+}
+
+// Filters 16 columns of 8 rows held as 16-bit pixels in r[]. Returns the
+// outputs as 16-bit values.
+static INLINE __m256i filter_vert_16(const __m256i *const r,
+                                     const __m256i *const f) {
+  __m256i lo[4], hi[4];
+  int k;
+
+  for (k = 0; k < 4; ++k) {
+    lo[k] = _mm256_unpacklo_epi16(r[2 * k], r[2 * k + 1]);
+    hi[k] = _mm256_unpackhi_epi16(r[2 * k], r[2 * k + 1]);
+  }
+  return _mm256_packs_epi32(filter_rows(lo, f), filter_rows(hi, f));
+}
+
+static INLINE __m128i filter_vert_8(const __m128i *const r,
+                                    const __m256i *const f) {
+  __m128i lo[4], hi[4];
+  int k;
+
+  for (k = 0; k < 4; ++k) {
+    lo[k] = _mm_unpacklo_epi16(r[2 * k], r[2 * k + 1]);
+    hi[k] = _mm_unpackhi_epi16(r[2 * k], r[2 * k + 1]);
+  }
+  return _mm_packs_epi32(filter_rows_sse(lo, f), filter_rows_sse(hi, f));
+}
+
+static void filter_horiz(const uint8_t *src, uint8_t *dst, const int w,
+                         const int *const x_pos, const int *const x_phase,
+                         const InterpKernel *const kernel) {
+  int x, j;
+
+  src -= SUBPEL_TAPS / 2 - 1;
+  for (x = 0; x < w; x += 8) {
+    __m256i sum[4], t;
+    for (j = 0; j < 4; ++j) {
+      const __m128i s0 = _mm_cvtepu8_epi16(
+          _mm_loadl_epi64((const __m128i *)(src + x_pos[x + j])));
+      const __m128i s1 = _mm_cvtepu8_epi16(
+          _mm_loadl_epi64((const __m128i *)(src + x_pos[x + j + 4])));
+      const __m256i s =
+          _mm256_inserti128_si256(_mm256_castsi128_si256(s0), s1, 1);
+      sum[j] = _mm256_madd_epi16(
+          s, load_kernel_pair(kernel, x_phase[x + j], x_phase[x + j + 4]));
+    }
+    t = _mm256_packs_epi32(add_taps(sum), add_taps(sum));
+    t = _mm256_packus_epi16(t, t);
+    _mm_storel_epi64((__m128i *)(dst + x),
+                     _mm_unpacklo_epi32(_mm256_castsi256_si128(t),
+                                        _mm256_extracti128_si256(t, 1)));
+  }
+}
+
+static void filter_vert(const uint8_t *src, const int src_stride,
+                        uint8_t *dst, const int w,
+                        const int16_t *const filter) {
+  __m256i f[4];
+  int x = 0, k;
+
+  get_tap_pairs(filter, f);
+  for (; x + 16 <= w; x += 16) {
+    __m256i r[8], t;
+    for (k = 0; k < 8; ++k) {
+      r[k] = _mm256_cvtepu8_epi16(
+          _mm_loadu_si128((const __m128i *)(src + k * src_stride + x)));
+    }
+    t = filter_vert_16(r, f);
+    t = _mm256_permute4x64_epi64(_mm256_packus_epi16(t, t), 0x08);
+    _mm_storeu_si128((__m128i *)(dst + x), _mm256_castsi256_si128(t));
+  }
+  if (x < w) {
+    __m128i r[8], t;
+    for (k = 0; k < 8; ++k) {
+      r[k] = _mm_cvtepu8_epi16(
+          _mm_loadl_epi64((const __m128i *)(src + k * src_stride + x)));
+    }
+    t = filter_vert_8(r, f);
+    _mm_storel_epi64((__m128i *)(dst + x), _mm_packus_epi16(t, t));
+  }
+}
+
+// Scales a plane with a separable polyphase filter. Every source row in
+// [top, bottom] is filtered horizontally once into temp, which holds w
+// pixels per row, and the output rows are filtered vertically from temp.
+static void scale_plane(const uint8_t *src, const int src_stride,
+                        uint8_t *dst, const int dst_stride, const int w,
+                        const int h, const int *const x_pos,
+                        const int *const x_phase, const int *const y_pos,
+                        const int *const y_phase, const int top,
+                        const int bottom, const InterpKernel *const kernel,
+                        uint8_t *const temp) {
+  int y;
+
+  for (y = top; y <= bottom; ++y) {
+    filter_horiz(src + y * src_stride, temp + (y - top) * w, w, x_pos, x_phase,
+                 kernel);
+  }
+  for (y = 0; y < h; ++y) {
+    const int row = y_pos[y] - (SUBPEL_TAPS / 2 - 1) - top;
+    filter_vert(temp + row * w, w, dst + y * dst_stride, w, kernel[y_phase[y]]);
+  }
+}
+
+#if CONFIG_VP9_HIGHBITDEPTH
+static void highbd_filter_horiz(const uint16_t *src, uint16_t *dst,
+                                const int w, const int *const x_pos,
+                                const int *const x_phase,
+                                const InterpKernel *const kernel,
+                                const int bd) {
+  const __m256i max = _mm256_set1_epi16((1 << bd) - 1);
+  int x, j;
+
+  src -= SUBPEL_TAPS / 2 - 1;
+  for (x = 0; x < w; x += 8) {
+    __m256i sum[4], t;
+    for (j = 0; j < 4; ++j) {
+      const __m128i s0 = _mm_loadu_si128((const __m128i *)(src + x_pos[x + j]));
+      const __m128i s1 =
+          _mm_loadu_si128((const __m128i *)(src + x_pos[x + j + 4]));
+      const __m256i s =
+          _mm256_inserti128_si256(_mm256_castsi128_si256(s0), s1, 1);
+      sum[j] = _mm256_madd_epi16(
+          s, load_kernel_pair(kernel, x_phase[x + j], x_phase[x + j + 4]));
+    }
+    t = _mm256_packs_epi32(add_taps(sum), add_taps(sum));
+    t = _mm256_min_epi16(_mm256_max_epi16(t, _mm256_setzero_si256()), max);
+    t = _mm256_permute4x64_epi64(t, 0x08);
+    _mm_storeu_si128((__m128i *)(dst + x), _mm256_castsi256_si128(t));
+  }
+}
+
+static void highbd_filter_vert(const uint16_t *src, const int src_stride,
+                               uint16_t *dst, const int w,
+                               const int16_t *const filter, const int bd) {
+  const __m256i max = _mm256_set1_epi16((1 << bd) - 1);
+  __m256i f[4];
+  int x = 0, k;
+
+  get_tap_pairs(filter, f);
+  for (; x + 16 <= w; x += 16) {
+    __m256i r[8], t;
+    for (k = 0; k < 8; ++k) {
+      r[k] = _mm256_loadu_si256((const __m256i *)(src + k * src_stride + x));
+    }
+    t = filter_vert_16(r, f);
+    t = _mm256_min_epi16(_mm256_max_epi16(t, _mm256_setzero_si256()), max);
+    _mm256_storeu_si256((__m256i *)(dst + x), t);
+  }
+  if (x < w) {
+    __m128i r[8], t;
+    for (k = 0; k < 8; ++k) {
+      r[k] = _mm_loadu_si128((const __m128i *)(src + k * src_stride + x));
+    }
+    t = filter_vert_8(r, f);
+    t = _mm_min_epi16(_mm_max_epi16(t, _mm_setzero_si128()),
+                      _mm256_castsi256_si128(max));
+    _mm_storeu_si128((__m128i *)(dst + x), t);
+  }
+}
+
+static void highbd_scale_plane(const uint16_t *src, const int src_stride,
+                               uint16_t *dst, const int dst_stride,
+                               const int w, const int h,
+                               const int *const x_pos,
+                               const int *const x_phase,
+                               const int *const y_pos,
+                               const int *const y_phase, const int top,
+                               const int bottom,
+                               const InterpKernel *const kernel,
+                               uint16_t *const temp, const int bd) {
+  int y;
+
+  for (y = top; y <= bottom; ++y) {
+    highbd_filter_horiz(src + y * src_stride, temp + (y - top) * w, w, x_pos,
+                        x_phase, kernel, bd);
+  }
+  for (y = 0; y < h; ++y) {
+    const int row = y_pos[y] - (SUBPEL_TAPS / 2 - 1) - top;
+    highbd_filter_vert(temp + row * w, w, dst + y * dst_stride, w,
+                       kernel[y_phase[y]], bd);
+  }
+}
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
+// Scales any ratio the way the general path of vp9_scale_and_extend_frame_c()
+// does, but filters the frame a plane at a time instead of a block at a time.
+// Only the visible part of each plane, rounded up to 8 pixels, is written;
+// the borders are extended afterwards. Returns 0 if out of memory.
+static int scale_frame(const YV12_BUFFER_CONFIG *src, YV12_BUFFER_CONFIG *dst,
+                       INTERP_FILTER filter_type, int phase_scaler,
+                       int use_highbitdepth, int bd) {
+  const int src_w = src->y_crop_width;
+  const int src_h = src->y_crop_height;
+  const int dst_w = dst->y_crop_width;
+  const int dst_h = dst->y_crop_height;
+  const uint8_t *const srcs[3] = { src->y_buffer, src->u_buffer,
+                                   src->v_buffer };
+  const int src_strides[3] = { src->y_stride, src->uv_stride, src->uv_stride };
+  uint8_t *const dsts[3] = { dst->y_buffer, dst->u_buffer, dst->v_buffer };
+  const int dst_strides[3] = { dst->y_stride, dst->uv_stride, dst->uv_stride };
+  const int dst_ws[3] = { dst_w, dst->uv_crop_width, dst->uv_crop_width };
+  const int dst_hs[3] = { dst_h, dst->uv_crop_height, dst->uv_crop_height };
+  const InterpKernel *const kernel = vp9_filter_kernels[filter_type];
+  const int x_len = (dst_w + 15) & ~15;
+  const int y_len = (dst_h + 15) & ~15;
+  int *const x_pos = (int *)malloc(2 * (x_len + y_len) * sizeof(*x_pos));
+  int *const x_phase = x_pos + x_len;
+  int *const y_pos = x_phase + x_len;
+  int *const y_phase = y_pos + y_len;
+  int i, y;
+
+  assert(phase_scaler >= 0 && phase_scaler < 16);
+  if (!x_pos) return 0;
+
+  for (i = 0; i < MAX_MB_PLANE; ++i) {
+    const int factor = (i == 0 ? 1 : 2);
+    const int w = (dst_ws[i] + 7) & ~7;
+    const int h = (dst_hs[i] + 7) & ~7;
+    int top, bottom;
+    void *temp;
+
+    get_scale_positions(dst_w, src_w, factor, phase_scaler, x_pos, x_phase);
+    get_scale_positions(dst_h, src_h, factor, phase_scaler, y_pos, y_phase);
+    top = bottom = y_pos[0];
+    for (y = 1; y < h; ++y) {
+      top = VPXMIN(top, y_pos[y]);
+      bottom = VPXMAX(bottom, y_pos[y]);
+    }
+    top -= SUBPEL_TAPS / 2 - 1;
+    bottom += SUBPEL_TAPS / 2;
+
+    temp = malloc((bottom - top + 1) * w * (use_highbitdepth ? 2 : 1));
+    if (!temp) {
+      free(x_pos);
+      return 0;
+    }
+#if CONFIG_VP9_HIGHBITDEPTH
+    if (use_highbitdepth) {
+      highbd_scale_plane(CONVERT_TO_SHORTPTR(srcs[i]), src_strides[i],
+                         CONVERT_TO_SHORTPTR(dsts[i]), dst_strides[i], w, h,
+                         x_pos, x_phase, y_pos, y_phase, top, bottom, kernel,
+                         (uint16_t *)temp, bd);
+    } else {
+      scale_plane(srcs[i], src_strides[i], dsts[i], dst_strides[i], w, h,
+                  x_pos, x_phase, y_pos, y_phase, top, bottom, kernel,
+                  (uint8_t *)temp);
+    }
+#else
+    (void)bd;
+    (void)use_highbitdepth;
+    scale_plane(srcs[i], src_strides[i], dsts[i], dst_strides[i], w, h, x_pos,
+                x_phase, y_pos, y_phase, top, bottom, kernel, (uint8_t *)temp);
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+    free(temp);
+  }
+
+  free(x_pos);
+  vpx_extend_frame_borders(dst);
+  return 1;
+}
+
+void vp9_scale_and_extend_frame_avx2(const YV12_BUFFER_CONFIG *src,
+                                     YV12_BUFFER_CONFIG *dst,
+                                     INTERP_FILTER filter_type,
+                                     int phase_scaler) {
+  const int src_w = src->y_crop_width;
+  const int src_h = src->y_crop_height;
+  const int dst_w = dst->y_crop_width;
+  const int dst_h = dst->y_crop_height;
+
+#if HAVE_SSSE3
+  // The ssse3 version has dedicated kernels for 2:1, 4:1, 4:3 and 1:2.
+  if ((dst_w * 2 == src_w && dst_h * 2 == src_h) ||
+      (4 * dst_w == src_w && 4 * dst_h == src_h) ||
+      (4 * dst_w == 3 * src_w && 4 * dst_h == 3 * src_h) ||
+      (dst_w == src_w * 2 && dst_h == src_h * 2 && phase_scaler == 0)) {
+    vp9_scale_and_extend_frame_ssse3(src, dst, filter_type, phase_scaler);
+    return;
+  }
+#endif  // HAVE_SSSE3
+
+  if (!scale_frame(src, dst, filter_type, phase_scaler, 0, 8)) {
+    vp9_scale_and_extend_frame_c(src, dst, filter_type, phase_scaler);
+  }
+}
+
+#if CONFIG_VP9_HIGHBITDEPTH
+void vp9_highbd_scale_and_extend_frame_avx2(const YV12_BUFFER_CONFIG *src,
+                                            YV12_BUFFER_CONFIG *dst, int bd,
+                                            INTERP_FILTER filter_type,
+                                            int phase_scaler) {
+  if (!scale_frame(src, dst, filter_type, phase_scaler,
+                   (src->flags & YV12_FLAG_HIGHBITDEPTH) != 0, bd)) {
+    vp9_highbd_scale_and_extend_frame_c(src, dst, bd, filter_type,
+                                        phase_scaler);
+  }
+}
+#endif  // CONFIG_VP9_HIGHBITDEPTH
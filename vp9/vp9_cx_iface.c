@@ -63,6 +63,7 @@ typedef struct vp9_extracfg {
   unsigned int row_mt;
   unsigned int motion_vector_unit_test;
   int delta_q_uv;
+  unsigned int fp_lookahead;
 } vp9_extracfg;
 
 static struct vp9_extracfg default_extra_cfg = {
@@ -98,6 +99,7 @@ static struct vp9_extracfg default_extra_cfg = {
   0,                     // row_mt
   0,                     // motion_vector_unit_test
   0,                     // delta_q_uv
+  0,                     // fp_lookahead
 };
 
 struct vpx_codec_alg_priv {
@@ -194,8 +196,16 @@ static vpx_codec_err_t validate_config(vpx_codec_alg_priv_t *ctx,
   RANGE_CHECK_HI(cfg, rc_resize_down_thresh, 100);
 #if CONFIG_REALTIME_ONLY
   RANGE_CHECK(cfg, g_pass, VPX_RC_ONE_PASS, VPX_RC_ONE_PASS);
+  RANGE_CHECK_HI(extra_cfg, fp_lookahead, 0);
 #else
   RANGE_CHECK(cfg, g_pass, VPX_RC_ONE_PASS, VPX_RC_LAST_PASS);
+  RANGE_CHECK_HI(extra_cfg, fp_lookahead, MAX_FP_LOOKAHEAD);
+  if (extra_cfg->fp_lookahead > 0) {
+    if (cfg->g_pass != VPX_RC_ONE_PASS)
+      ERROR("fp_lookahead requires g_pass == VPX_RC_ONE_PASS");
+    if (cfg->ss_number_layers > 1 || cfg->ts_number_layers > 1)
+      ERROR("fp_lookahead not supported with spatial or temporal layers");
+  }
 #endif
   RANGE_CHECK(extra_cfg, min_gf_interval, 0, (MAX_LAG_BUFFERS - 1));
   RANGE_CHECK(extra_cfg, max_gf_interval, 0, (MAX_LAG_BUFFERS - 1));
@@ -324,7 +334,9 @@ static vpx_codec_err_t validate_config(vpx_codec_alg_priv_t *ctx,
       stats =
           (const FIRSTPASS_STATS *)cfg->rc_twopass_stats_in.buf + n_packets - 1;
 
-      if ((int)(stats->count + 0.5) != n_packets - 1)
+      // The total stats may count more frames than the buffer holds, when
+      // the buffer is a window of the first pass stats.
+      if ((int)(stats->count + 0.5) < n_packets - 1)
         ERROR("rc_twopass_stats_in missing EOS stats packet");
     }
   }
@@ -511,13 +523,15 @@ static vpx_codec_err_t set_encoder_config(
   oxcf->mode = GOOD;
 
   switch (cfg->g_pass) {
-    case VPX_RC_ONE_PASS: oxcf->pass = 0; break;
+    // The first pass lookahead runs both passes in one.
+    case VPX_RC_ONE_PASS: oxcf->pass = extra_cfg->fp_lookahead ? 2 : 0; break;
     case VPX_RC_FIRST_PASS: oxcf->pass = 1; break;
     case VPX_RC_LAST_PASS: oxcf->pass = 2; break;
   }
 
   oxcf->lag_in_frames =
       cfg->g_pass == VPX_RC_FIRST_PASS ? 0 : cfg->g_lag_in_frames;
+  oxcf->fp_lookahead = extra_cfg->fp_lookahead;
   oxcf->rc_mode = cfg->rc_end_usage;
 
   raw_target_rate =
@@ -1030,6 +1044,15 @@ static vpx_codec_err_t ctrl_set_row_mt(vpx_codec_alg_priv_t *ctx,
   return update_extra_cfg(ctx, &extra_cfg);
 }
 
+static vpx_codec_err_t ctrl_set_first_pass_lookahead(vpx_codec_alg_priv_t *ctx,
+                                                    va_list args) {
+  struct vp9_extracfg extra_cfg = ctx->extra_cfg;
+  // The size of the lookahead is set when the first frame comes in.
+  if (ctx->cpi->lookahead != NULL) return VPX_CODEC_ERROR;
+  extra_cfg.fp_lookahead = CAST(VP9E_SET_FIRST_PASS_LOOKAHEAD, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
 static vpx_codec_err_t ctrl_enable_motion_vector_unit_test(
     vpx_codec_alg_priv_t *ctx, va_list args) {
   struct vp9_extracfg extra_cfg = ctx->extra_cfg;
@@ -1045,6 +1068,75 @@ static vpx_codec_err_t ctrl_get_level(vpx_codec_alg_priv_t *ctx, va_list args) {
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_get_frame_stats(vpx_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  vpx_frame_stats_t *const arg = va_arg(args, vpx_frame_stats_t *);
+  if (arg == NULL) return VPX_CODEC_INVALID_PARAM;
+  vp9_get_stage_times(ctx->cpi, arg);
+  ctx->cpi->time_block_stages = 1;
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_get_key_frame_map(vpx_codec_alg_priv_t *ctx,
+                                              va_list args) {
+#if !CONFIG_REALTIME_ONLY
+  VP9_COMP *const cpi = ctx->cpi;
+  int *const arg = va_arg(args, int *);
+  if (arg == NULL) return VPX_CODEC_INVALID_PARAM;
+  if (cpi->oxcf.pass != 2 || cpi->oxcf.fp_lookahead > 0 || cpi->use_svc ||
+      cpi->common.current_video_frame > 0)
+    return VPX_CODEC_ERROR;
+  vp9_get_key_frame_map(&cpi->oxcf, &cpi->twopass, arg);
+  return VPX_CODEC_OK;
+#else
+  (void)ctx;
+  (void)args;
+  return VPX_CODEC_INCAPABLE;
+#endif  // !CONFIG_REALTIME_ONLY
+}
+
+static vpx_codec_err_t ctrl_get_key_frame_map_size(vpx_codec_alg_priv_t *ctx,
+                                                   va_list args) {
+#if !CONFIG_REALTIME_ONLY
+  VP9_COMP *const cpi = ctx->cpi;
+  unsigned int *const arg = va_arg(args, unsigned int *);
+  if (arg == NULL) return VPX_CODEC_INVALID_PARAM;
+  if (cpi->oxcf.pass != 2 || cpi->oxcf.fp_lookahead > 0 || cpi->use_svc)
+    return VPX_CODEC_ERROR;
+  *arg = (unsigned int)cpi->twopass.first_pass_info.num_frames;
+  return VPX_CODEC_OK;
+#else
+  (void)ctx;
+  (void)args;
+  return VPX_CODEC_INCAPABLE;
+#endif  // !CONFIG_REALTIME_ONLY
+}
+
+static vpx_codec_err_t ctrl_set_chunk_start_frame(vpx_codec_alg_priv_t *ctx,
+                                                  va_list args) {
+#if !CONFIG_REALTIME_ONLY
+  VP9_COMP *const cpi = ctx->cpi;
+  const TWO_PASS *const twopass = &cpi->twopass;
+  const unsigned int start_frame = CAST(VP9E_SET_CHUNK_START_FRAME, args);
+  int num_frames;
+  if (cpi->oxcf.pass != 2 || cpi->oxcf.fp_lookahead > 0 || cpi->use_svc ||
+      cpi->common.current_video_frame > 0 || twopass->chunk_start_frame > 0 ||
+      twopass->stats_in_end == NULL)
+    return VPX_CODEC_ERROR;
+  // The stats must cover the whole clip, not a window of it.
+  num_frames = (int)(twopass->stats_in_end - twopass->stats_in_start);
+  if ((int)(twopass->stats_in_end->count + 0.5) != num_frames)
+    return VPX_CODEC_ERROR;
+  if (start_frame >= (unsigned int)num_frames) return VPX_CODEC_INVALID_PARAM;
+  if (start_frame > 0) vp9_twopass_set_chunk_start_frame(cpi, start_frame);
+  return VPX_CODEC_OK;
+#else
+  (void)ctx;
+  (void)args;
+  return VPX_CODEC_INCAPABLE;
+#endif  // !CONFIG_REALTIME_ONLY
+}
+
 static vpx_codec_err_t encoder_init(vpx_codec_ctx_t *ctx,
                                     vpx_codec_priv_enc_mr_cfg_t *data) {
   vpx_codec_err_t res = VPX_CODEC_OK;
@@ -1110,7 +1202,10 @@ static void pick_quickcompress_mode(vpx_codec_alg_priv_t *ctx,
 #else
   switch (ctx->cfg.g_pass) {
     case VPX_RC_ONE_PASS:
-      if (deadline > 0) {
+      if (ctx->extra_cfg.fp_lookahead > 0) {
+        // Coded as the last pass of a two-pass encode.
+        new_mode = deadline > 0 ? GOOD : BEST;
+      } else if (deadline > 0) {
         // Convert duration parameter from stream timebase to microseconds.
         uint64_t duration_us;
 
@@ -1285,6 +1380,7 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
 
   pick_quickcompress_mode(ctx, duration, deadline);
   vpx_codec_pkt_list_init(&ctx->pkt_list);
+  vp9_reset_stage_times(cpi);
 
   // Handle Flags
   if (((flags & VP8_EFLAG_NO_UPD_GF) && (flags & VP8_EFLAG_FORCE_GF)) ||
@@ -1879,6 +1975,17 @@ static vpx_codec_err_t ctrl_set_disable_loopfilter(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_set_thread_pool(vpx_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  VP9_COMP *const cpi = ctx->cpi;
+  vpx_codec_thread_pool_t *const pool =
+      va_arg(args, vpx_codec_thread_pool_t *);
+  // The workers pick up the pool when they are created.
+  if (cpi->num_workers > 0) return VPX_CODEC_ERROR;
+  cpi->thread_pool = pool;
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t ctrl_set_external_rate_control(vpx_codec_alg_priv_t *ctx,
                                                       va_list args) {
   vpx_rc_funcs_t funcs = *CAST(VP9E_SET_EXTERNAL_RATE_CONTROL, args);
@@ -1962,6 +2069,9 @@ static vpx_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { VP9E_SET_DELTA_Q_UV, ctrl_set_delta_q_uv },
   { VP9E_SET_DISABLE_LOOPFILTER, ctrl_set_disable_loopfilter },
   { VP9E_SET_EXTERNAL_RATE_CONTROL, ctrl_set_external_rate_control },
+  { VP9E_SET_THREAD_POOL, ctrl_set_thread_pool },
+  { VP9E_SET_FIRST_PASS_LOOKAHEAD, ctrl_set_first_pass_lookahead },
+  { VP9E_SET_CHUNK_START_FRAME, ctrl_set_chunk_start_frame },
 
   // Getters
   { VP8E_GET_LAST_QUANTIZER, ctrl_get_quantizer },
@@ -1971,6 +2081,9 @@ static vpx_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { VP9E_GET_ACTIVEMAP, ctrl_get_active_map },
   { VP9E_GET_LEVEL, ctrl_get_level },
   { VP9E_GET_SVC_REF_FRAME_CONFIG, ctrl_get_svc_ref_frame_config },
+  { VP9E_GET_KEY_FRAME_MAP, ctrl_get_key_frame_map },
+  { VP9E_GET_FRAME_STATS, ctrl_get_frame_stats },
+  { VP9E_GET_KEY_FRAME_MAP_SIZE, ctrl_get_key_frame_map_size },
 
   { -1, NULL },
 };
@@ -2074,7 +2187,8 @@ CODEC_INTERFACE(vpx_codec_vp9_cx) = {
       NULL,  // vpx_codec_get_si_fn_t
       NULL,  // vpx_codec_decode_fn_t
       NULL,  // vpx_codec_frame_get_fn_t
-      NULL   // vpx_codec_set_fb_fn_t
+      NULL,  // vpx_codec_set_fb_fn_t
+      NULL   // vpx_codec_set_fb_layout_fn_t
   },
   {
       // NOLINT
@@ -2310,3 +2424,7 @@ void vp9_set_first_pass_stats(VP9EncoderConfig *oxcf,
                               const vpx_fixed_buf_t *stats) {
   oxcf->two_pass_stats_in = *stats;
 }
+
+VP9_COMP *vp9_get_encoder(vpx_codec_ctx_t *ctx) {
+  return ((vpx_codec_alg_priv_t *)ctx->priv)->cpi;
+}
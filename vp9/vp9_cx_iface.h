@@ -41,6 +41,10 @@ ticks_to_timebase_units(const vpx_rational64_t *timestamp_ratio, int64_t n) {
 void vp9_set_first_pass_stats(VP9EncoderConfig *oxcf,
                               const vpx_fixed_buf_t *stats);
 
+// Returns the encoder of the VP9 encoder context 'ctx'. Only meant for the
+// tests of encoder features that have no codec control.
+VP9_COMP *vp9_get_encoder(vpx_codec_ctx_t *ctx);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
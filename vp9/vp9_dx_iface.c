@@ -25,12 +25,17 @@
 #include "vp9/common/vp9_frame_buffers.h"
 
 #include "vp9/decoder/vp9_decodeframe.h"
+#include "vp9/decoder/vp9_dthread.h"
 
 #include "vp9/vp9_dx_iface.h"
 #include "vp9/vp9_iface_common.h"
 
 #define VP9_CAP_POSTPROC (CONFIG_VP9_POSTPROC ? VPX_CODEC_CAP_POSTPROC : 0)
 
+// Each frame worker needs a new frame buffer and holds one for output, so the
+// number of frames decoded in parallel is bounded by the frame buffer pool.
+#define MAX_FRAME_WORKERS 4
+
 static vpx_codec_err_t decoder_init(vpx_codec_ctx_t *ctx,
                                     vpx_codec_priv_enc_mr_cfg_t *data) {
   // This function only allocates space for the vpx_codec_alg_priv_t
@@ -57,13 +62,33 @@ static vpx_codec_err_t decoder_init(vpx_codec_ctx_t *ctx,
 }
 
 static vpx_codec_err_t decoder_destroy(vpx_codec_alg_priv_t *ctx) {
-  if (ctx->pbi != NULL) {
+  if (ctx->frame_workers != NULL) {
+    int i;
+    for (i = 0; i < ctx->num_frame_workers; ++i) {
+      VPxWorker *const worker = &ctx->frame_workers[i];
+      FrameWorkerData *const frame_worker_data =
+          (FrameWorkerData *)worker->data1;
+      vpx_get_worker_interface()->end(worker);
+      if (frame_worker_data == NULL) continue;
+      vp9_decoder_remove(frame_worker_data->pbi);
+      vpx_free(frame_worker_data->scratch_buffer);
+#if CONFIG_MULTITHREAD
+      pthread_mutex_destroy(&frame_worker_data->stats_mutex);
+      pthread_cond_destroy(&frame_worker_data->stats_cond);
+#endif
+      vpx_free(frame_worker_data);
+    }
+    vpx_free(ctx->frame_workers);
+  } else if (ctx->pbi != NULL) {
     vp9_decoder_remove(ctx->pbi);
   }
 
   if (ctx->buffer_pool) {
     vp9_free_ref_frame_buffers(ctx->buffer_pool);
     vp9_free_internal_frame_buffers(&ctx->buffer_pool->int_frame_buffers);
+#if CONFIG_MULTITHREAD
+    pthread_mutex_destroy(&ctx->buffer_pool->pool_mutex);
+#endif
   }
 
   vpx_free(ctx->buffer_pool);
@@ -204,12 +229,23 @@ static vpx_codec_err_t update_error_state(
 static void init_buffer_callbacks(vpx_codec_alg_priv_t *ctx) {
   VP9_COMMON *const cm = &ctx->pbi->common;
   BufferPool *const pool = cm->buffer_pool;
+  int i;
+
+  for (i = 0; i < ctx->num_frame_workers; ++i) {
+    VP9_COMMON *const worker_cm =
+        ctx->frame_workers != NULL
+            ? &((FrameWorkerData *)ctx->frame_workers[i].data1)->pbi->common
+            : cm;
+    worker_cm->new_fb_idx = INVALID_IDX;
+    worker_cm->byte_alignment = ctx->byte_alignment;
+    worker_cm->skip_loop_filter = ctx->skip_loop_filter;
+  }
 
-  cm->new_fb_idx = INVALID_IDX;
-  cm->byte_alignment = ctx->byte_alignment;
-  cm->skip_loop_filter = ctx->skip_loop_filter;
-
-  if (ctx->get_ext_fb_cb != NULL && ctx->release_ext_fb_cb != NULL) {
+  if (ctx->get_ext_fb_layout_cb != NULL && ctx->release_ext_fb_cb != NULL) {
+    pool->get_fb_layout_cb = ctx->get_ext_fb_layout_cb;
+    pool->release_fb_cb = ctx->release_ext_fb_cb;
+    pool->cb_priv = ctx->ext_priv;
+  } else if (ctx->get_ext_fb_cb != NULL && ctx->release_ext_fb_cb != NULL) {
     pool->get_fb_cb = ctx->get_ext_fb_cb;
     pool->release_fb_cb = ctx->release_ext_fb_cb;
     pool->cb_priv = ctx->ext_priv;
@@ -251,27 +287,155 @@ static void set_ppflags(const vpx_codec_alg_priv_t *ctx, vp9_ppflags_t *flags) {
       ERROR(#memb " out of range [" #lo ".." #hi "]");                   \
   } while (0)
 
+static int frame_worker_hook(void *arg1, void *arg2) {
+  FrameWorkerData *const frame_worker_data = (FrameWorkerData *)arg1;
+  VP9Decoder *const pbi = frame_worker_data->pbi;
+  const uint8_t *data = frame_worker_data->data;
+  (void)arg2;
+
+  frame_worker_data->result =
+      vp9_receive_compressed_data(pbi, frame_worker_data->data_size, &data);
+  frame_worker_data->data_end = data;
+
+  if (frame_worker_data->result != 0) {
+    // Release the workers waiting on the context of this frame. The next
+    // worker inherits need_resync and skips frames until a key frame.
+    vp9_frameworker_lock_stats(pbi->frame_worker_owner);
+    pbi->cur_buf->buf.corrupted = 1;
+    pbi->need_resync = 1;
+    frame_worker_data->frame_context_ready = 1;
+    frame_worker_data->frame_decoded = 1;
+    vp9_frameworker_signal_stats(pbi->frame_worker_owner);
+    vp9_frameworker_unlock_stats(pbi->frame_worker_owner);
+  }
+  return !frame_worker_data->result;
+}
+
+static vpx_codec_err_t init_frame_workers(vpx_codec_alg_priv_t *ctx) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  // With row-mt, two frames are pipelined and the threads are split between
+  // them: the next frame is parsed while the current one is still being
+  // reconstructed and loop filtered. Each frame needs at least two threads to
+  // be decoded row-wise, otherwise the frames are only decoded in parallel.
+  const int row_mt = ctx->row_mt && ctx->cfg.threads >= 4;
+  int i;
+
+  ctx->num_frame_workers =
+      row_mt ? 2 : VPXMIN(VPXMAX((int)ctx->cfg.threads, 1), MAX_FRAME_WORKERS);
+  ctx->available_threads = ctx->num_frame_workers;
+  ctx->next_submit_worker_id = 0;
+  ctx->last_submit_worker_id = -1;
+  ctx->next_output_worker_id = 0;
+  ctx->frame_cache_read = 0;
+  ctx->frame_cache_write = 0;
+  ctx->num_cache_frames = 0;
+
+  ctx->frame_workers = (VPxWorker *)vpx_calloc(ctx->num_frame_workers,
+                                               sizeof(*ctx->frame_workers));
+  if (ctx->frame_workers == NULL) {
+    set_error_detail(ctx, "Failed to allocate frame_workers");
+    return VPX_CODEC_MEM_ERROR;
+  }
+
+  for (i = 0; i < ctx->num_frame_workers; ++i) {
+    VPxWorker *const worker = &ctx->frame_workers[i];
+    FrameWorkerData *frame_worker_data = NULL;
+    winterface->init(worker);
+    worker->pool = ctx->thread_pool;
+    worker->data1 = vpx_calloc(1, sizeof(FrameWorkerData));
+    if (worker->data1 == NULL) {
+      set_error_detail(ctx, "Failed to allocate frame_worker_data");
+      return VPX_CODEC_MEM_ERROR;
+    }
+    frame_worker_data = (FrameWorkerData *)worker->data1;
+    frame_worker_data->pbi = vp9_decoder_create(ctx->buffer_pool);
+    if (frame_worker_data->pbi == NULL) {
+      set_error_detail(ctx, "Failed to allocate frame_worker_data");
+      return VPX_CODEC_MEM_ERROR;
+    }
+    frame_worker_data->pbi->frame_worker_owner = worker;
+    frame_worker_data->worker_id = i;
+    frame_worker_data->scratch_buffer = NULL;
+    frame_worker_data->scratch_buffer_size = 0;
+    frame_worker_data->frame_context_ready = 0;
+    frame_worker_data->received_frame = 0;
+#if CONFIG_MULTITHREAD
+    if (pthread_mutex_init(&frame_worker_data->stats_mutex, NULL)) {
+      set_error_detail(ctx, "Failed to allocate frame_worker_data mutex");
+      return VPX_CODEC_MEM_ERROR;
+    }
+
+    if (pthread_cond_init(&frame_worker_data->stats_cond, NULL)) {
+      set_error_detail(ctx, "Failed to allocate frame_worker_data cond");
+      return VPX_CODEC_MEM_ERROR;
+    }
+#endif
+    // Without row-mt each frame is decoded by a single thread; the
+    // parallelism comes from decoding several frames at once. With row-mt the
+    // two workers together use no more than cfg.threads threads.
+    frame_worker_data->pbi->max_threads =
+        row_mt ? ((int)ctx->cfg.threads + i) / 2 : 1;
+    frame_worker_data->pbi->inv_tile_order = ctx->invert_tile_order;
+    frame_worker_data->pbi->frame_parallel_decode = 1;
+    frame_worker_data->pbi->row_mt = row_mt;
+    frame_worker_data->pbi->lpf_mt_opt = 0;
+    frame_worker_data->pbi->thread_pool = ctx->thread_pool;
+
+    worker->hook = frame_worker_hook;
+    if (!winterface->reset(worker)) {
+      set_error_detail(ctx, "Frame Worker thread creation failed");
+      return VPX_CODEC_MEM_ERROR;
+    }
+  }
+
+  ctx->pbi = ((FrameWorkerData *)ctx->frame_workers[0].data1)->pbi;
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
   ctx->last_show_frame = -1;
   ctx->need_resync = 1;
   ctx->flushed = 0;
+  ctx->num_frame_workers = 1;
 
   ctx->buffer_pool = (BufferPool *)vpx_calloc(1, sizeof(BufferPool));
   if (ctx->buffer_pool == NULL) return VPX_CODEC_MEM_ERROR;
 
-  ctx->pbi = vp9_decoder_create(ctx->buffer_pool);
-  if (ctx->pbi == NULL) {
-    set_error_detail(ctx, "Failed to allocate decoder");
+#if CONFIG_MULTITHREAD
+  if (pthread_mutex_init(&ctx->buffer_pool->pool_mutex, NULL)) {
+    vpx_free(ctx->buffer_pool);
+    ctx->buffer_pool = NULL;
+    set_error_detail(ctx, "Failed to allocate buffer pool mutex");
     return VPX_CODEC_MEM_ERROR;
   }
-  ctx->pbi->max_threads = ctx->cfg.threads;
-  ctx->pbi->inv_tile_order = ctx->invert_tile_order;
+#endif
 
   RANGE_CHECK(ctx, row_mt, 0, 1);
-  ctx->pbi->row_mt = ctx->row_mt;
-
   RANGE_CHECK(ctx, lpf_opt, 0, 1);
-  ctx->pbi->lpf_mt_opt = ctx->lpf_opt;
+
+  if (ctx->frame_parallel_decode &&
+      (ctx->base.init_flags & VPX_CODEC_USE_POSTPROC)) {
+    set_error_detail(ctx, "Not supported in frame parallel decode");
+    return VPX_CODEC_INCAPABLE;
+  }
+
+  if (ctx->frame_parallel_decode) {
+    const vpx_codec_err_t res = init_frame_workers(ctx);
+    if (res != VPX_CODEC_OK) return res;
+  } else {
+    ctx->pbi = vp9_decoder_create(ctx->buffer_pool);
+    if (ctx->pbi == NULL) {
+      set_error_detail(ctx, "Failed to allocate decoder");
+      return VPX_CODEC_MEM_ERROR;
+    }
+    ctx->pbi->max_threads = ctx->cfg.threads;
+    ctx->pbi->inv_tile_order = ctx->invert_tile_order;
+    ctx->pbi->row_mt = ctx->row_mt;
+    // The tile workers of the loop filter optimization wait on rows decoded
+    // by the other workers, which may still be queued on a shared pool.
+    ctx->pbi->lpf_mt_opt = ctx->lpf_opt && ctx->thread_pool == NULL;
+    ctx->pbi->thread_pool = ctx->thread_pool;
+  }
 
   // If postprocessing was enabled by the application and a
   // configuration has not been provided, default it.
@@ -309,22 +473,146 @@ static vpx_codec_err_t decode_one(vpx_codec_alg_priv_t *ctx,
     if (!ctx->si.is_kf && !is_intra_only) return VPX_CODEC_ERROR;
   }
 
-  ctx->user_priv = user_priv;
+  if (!ctx->frame_parallel_decode) {
+    ctx->user_priv = user_priv;
+
+    // Set these even if already initialized.  The caller may have changed the
+    // decrypt config between frames.
+    ctx->pbi->decrypt_cb = ctx->decrypt_cb;
+    ctx->pbi->decrypt_state = ctx->decrypt_state;
+
+    if (vp9_receive_compressed_data(ctx->pbi, data_sz, data)) {
+      ctx->pbi->cur_buf->buf.corrupted = 1;
+      ctx->pbi->need_resync = 1;
+      ctx->need_resync = 1;
+      return update_error_state(ctx, &ctx->pbi->common.error);
+    }
 
-  // Set these even if already initialized.  The caller may have changed the
-  // decrypt config between frames.
-  ctx->pbi->decrypt_cb = ctx->decrypt_cb;
-  ctx->pbi->decrypt_state = ctx->decrypt_state;
+    check_resync(ctx, ctx->pbi);
+  } else {
+    // Decode in frame parallel mode. The compressed data is copied so the
+    // caller may reuse its buffer while the frame is being decoded.
+    const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+    VPxWorker *const worker = &ctx->frame_workers[ctx->next_submit_worker_id];
+    FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+    VP9Decoder *const pbi = frame_worker_data->pbi;
+
+    // Copy context from last worker thread to next worker thread.
+    if (ctx->last_submit_worker_id >= 0 &&
+        ctx->next_submit_worker_id != ctx->last_submit_worker_id &&
+        vp9_frameworker_copy_context(
+            worker, &ctx->frame_workers[ctx->last_submit_worker_id])) {
+      set_error_detail(ctx, "Failed to allocate context buffers");
+      return VPX_CODEC_MEM_ERROR;
+    }
 
-  if (vp9_receive_compressed_data(ctx->pbi, data_sz, data)) {
-    ctx->pbi->cur_buf->buf.corrupted = 1;
-    ctx->pbi->need_resync = 1;
-    ctx->need_resync = 1;
-    return update_error_state(ctx, &ctx->pbi->common.error);
+    // Copy the compressed data into worker's internal buffer.
+    if (frame_worker_data->scratch_buffer_size < data_sz) {
+      vpx_free(frame_worker_data->scratch_buffer);
+      frame_worker_data->scratch_buffer_size = 0;
+      frame_worker_data->scratch_buffer = (uint8_t *)vpx_malloc(data_sz);
+      if (frame_worker_data->scratch_buffer == NULL) {
+        set_error_detail(ctx, "Failed to reallocate scratch buffer");
+        return VPX_CODEC_MEM_ERROR;
+      }
+      frame_worker_data->scratch_buffer_size = data_sz;
+    }
+    frame_worker_data->data_size = data_sz;
+    memcpy(frame_worker_data->scratch_buffer, *data, data_sz);
+
+    pbi->decrypt_cb = ctx->decrypt_cb;
+    pbi->decrypt_state = ctx->decrypt_state;
+    pbi->ready_for_new_data = 0;
+    vp9_zero(pbi->stats);
+    frame_worker_data->frame_decoded = 0;
+    frame_worker_data->frame_context_ready = 0;
+    frame_worker_data->received_frame = 1;
+    frame_worker_data->data = frame_worker_data->scratch_buffer;
+    frame_worker_data->user_priv = user_priv;
+
+    ctx->last_submit_worker_id = ctx->next_submit_worker_id;
+    ctx->next_submit_worker_id =
+        (ctx->next_submit_worker_id + 1) % ctx->num_frame_workers;
+    --ctx->available_threads;
+    worker->had_error = 0;
+    winterface->launch(worker);
+
+    // A worker must consume the whole buffer, frames packed together without
+    // a superframe index can not be split up front.
+    *data += data_sz;
   }
 
-  check_resync(ctx, ctx->pbi);
+  return VPX_CODEC_OK;
+}
 
+static void release_last_output_frame(vpx_codec_alg_priv_t *ctx) {
+  RefCntBuffer *const frame_bufs = ctx->buffer_pool->frame_bufs;
+  // Decrease reference count of the last output frame in frame parallel mode.
+  if (ctx->frame_parallel_decode && ctx->last_show_frame >= 0) {
+    BufferPool *const pool = ctx->buffer_pool;
+    lock_buffer_pool(pool);
+    decrease_ref_count(ctx->last_show_frame, frame_bufs, pool);
+    unlock_buffer_pool(pool);
+    ctx->last_show_frame = -1;
+  }
+}
+
+// Wait for the oldest frame worker and return its pbi if it decoded a frame to
+// show, NULL otherwise. The worker becomes available for the next frame.
+static VP9Decoder *sync_output_worker(vpx_codec_alg_priv_t *ctx,
+                                      YV12_BUFFER_CONFIG *sd,
+                                      void **user_priv) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  VPxWorker *const worker = &ctx->frame_workers[ctx->next_output_worker_id];
+  FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+  VP9Decoder *const pbi = frame_worker_data->pbi;
+  vp9_ppflags_t flags = { 0, 0, 0 };
+
+  ctx->next_output_worker_id =
+      (ctx->next_output_worker_id + 1) % ctx->num_frame_workers;
+  if (!winterface->sync(worker)) ctx->need_resync = 1;
+  frame_worker_data->received_frame = 0;
+  ++ctx->available_threads;
+  check_resync(ctx, pbi);
+
+  *user_priv = frame_worker_data->user_priv;
+  if (vp9_get_raw_frame(pbi, sd, &flags) != 0) return NULL;
+  ctx->pbi = pbi;
+  if (ctx->need_resync) {
+    // The frame is dropped; release the reference held for output.
+    BufferPool *const pool = ctx->buffer_pool;
+    lock_buffer_pool(pool);
+    decrease_ref_count(pbi->common.new_fb_idx, pool->frame_bufs, pool);
+    unlock_buffer_pool(pool);
+    return NULL;
+  }
+  return pbi;
+}
+
+// Wait for the oldest frame worker to finish decoding and cache its frame, so
+// a new frame can be submitted while the application holds on to its output.
+static vpx_codec_err_t wait_worker_and_cache_frame(vpx_codec_alg_priv_t *ctx) {
+  YV12_BUFFER_CONFIG sd;
+  void *user_priv;
+  VP9Decoder *pbi;
+
+  if (ctx->num_cache_frames >= FRAME_CACHE_SIZE) {
+    set_error_detail(ctx, "Frame output cache is full.");
+    return VPX_CODEC_ERROR;
+  }
+
+  pbi = sync_output_worker(ctx, &sd, &user_priv);
+  if (pbi != NULL) {
+    VP9_COMMON *const cm = &pbi->common;
+    RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
+    cache_frame *const frame = &ctx->frame_cache[ctx->frame_cache_write];
+    frame->fb_idx = cm->new_fb_idx;
+    yuvconfig2image(&frame->img, &sd, user_priv);
+    frame->img.fb_priv = frame_bufs[cm->new_fb_idx].raw_frame_buffer.priv;
+    frame->stats = pbi->stats;
+    ctx->frame_cache_write = (ctx->frame_cache_write + 1) % FRAME_CACHE_SIZE;
+    ++ctx->num_cache_frames;
+  }
   return VPX_CODEC_OK;
 }
 
@@ -355,6 +643,8 @@ static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
                                    ctx->decrypt_cb, ctx->decrypt_state);
   if (res != VPX_CODEC_OK) return res;
 
+  if (!ctx->frame_parallel_decode) vp9_zero(ctx->pbi->stats);
+
   if (ctx->svc_decoding && ctx->svc_spatial_layer < frame_count - 1)
     frame_count = ctx->svc_spatial_layer + 1;
 
@@ -371,6 +661,13 @@ static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
         return VPX_CODEC_CORRUPT_FRAME;
       }
 
+      if (ctx->frame_parallel_decode && ctx->available_threads == 0) {
+        // No more threads for decoding. Wait until the next output worker
+        // finishes decoding, then copy the decoded frame into the cache.
+        res = wait_worker_and_cache_frame(ctx);
+        if (res != VPX_CODEC_OK) return res;
+      }
+
       res = decode_one(ctx, &data_start_copy, frame_size, user_priv, deadline);
       if (res != VPX_CODEC_OK) return res;
 
@@ -379,8 +676,12 @@ static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
   } else {
     while (data_start < data_end) {
       const uint32_t frame_size = (uint32_t)(data_end - data_start);
-      const vpx_codec_err_t res =
-          decode_one(ctx, &data_start, frame_size, user_priv, deadline);
+      if (ctx->frame_parallel_decode && ctx->available_threads == 0) {
+        res = wait_worker_and_cache_frame(ctx);
+        if (res != VPX_CODEC_OK) return res;
+      }
+
+      res = decode_one(ctx, &data_start, frame_size, user_priv, deadline);
       if (res != VPX_CODEC_OK) return res;
 
       // Account for suboptimal termination by the encoder.
@@ -404,6 +705,41 @@ static vpx_image_t *decoder_get_frame(vpx_codec_alg_priv_t *ctx,
   // always return only 1 frame per decode call.
   (void)iter;
 
+  if (ctx->frame_parallel_decode) {
+    // Output the frames in the cache first.
+    if (ctx->num_cache_frames > 0) {
+      release_last_output_frame(ctx);
+      ctx->last_show_frame = ctx->frame_cache[ctx->frame_cache_read].fb_idx;
+      ctx->output_stats = ctx->frame_cache[ctx->frame_cache_read].stats;
+      img = &ctx->frame_cache[ctx->frame_cache_read].img;
+      ctx->frame_cache_read = (ctx->frame_cache_read + 1) % FRAME_CACHE_SIZE;
+      --ctx->num_cache_frames;
+      return img;
+    }
+
+    // Only wait for a frame when all the workers are busy or the application
+    // has flushed the decoder, so the workers keep decoding ahead.
+    while (ctx->frame_workers != NULL &&
+           ctx->available_threads < ctx->num_frame_workers &&
+           (ctx->flushed || ctx->available_threads == 0)) {
+      YV12_BUFFER_CONFIG sd;
+      void *user_priv;
+      VP9Decoder *const pbi = sync_output_worker(ctx, &sd, &user_priv);
+      if (pbi != NULL) {
+        RefCntBuffer *const frame_bufs = pbi->common.buffer_pool->frame_bufs;
+        release_last_output_frame(ctx);
+        ctx->last_show_frame = pbi->common.new_fb_idx;
+        yuvconfig2image(&ctx->img, &sd, user_priv);
+        ctx->img.fb_priv =
+            frame_bufs[pbi->common.new_fb_idx].raw_frame_buffer.priv;
+        ctx->output_stats = pbi->stats;
+        img = &ctx->img;
+        return img;
+      }
+    }
+    return NULL;
+  }
+
   if (ctx->pbi != NULL) {
     YV12_BUFFER_CONFIG sd;
     vp9_ppflags_t flags = { 0, 0, 0 };
@@ -431,6 +767,25 @@ static vpx_codec_err_t decoder_set_fb_fn(
     // If the decoder has already been initialized, do not accept changes to
     // the frame buffer functions.
     ctx->get_ext_fb_cb = cb_get;
+    ctx->get_ext_fb_layout_cb = NULL;
+    ctx->release_ext_fb_cb = cb_release;
+    ctx->ext_priv = cb_priv;
+    return VPX_CODEC_OK;
+  }
+
+  return VPX_CODEC_ERROR;
+}
+
+static vpx_codec_err_t decoder_set_fb_layout_fn(
+    vpx_codec_alg_priv_t *ctx, vpx_get_frame_buffer_layout_cb_fn_t cb_get,
+    vpx_release_frame_buffer_cb_fn_t cb_release, void *cb_priv) {
+  if (cb_get == NULL || cb_release == NULL) {
+    return VPX_CODEC_INVALID_PARAM;
+  } else if (ctx->pbi == NULL) {
+    // If the decoder has already been initialized, do not accept changes to
+    // the frame buffer functions.
+    ctx->get_ext_fb_cb = NULL;
+    ctx->get_ext_fb_layout_cb = cb_get;
     ctx->release_ext_fb_cb = cb_release;
     ctx->ext_priv = cb_priv;
     return VPX_CODEC_OK;
@@ -443,6 +798,12 @@ static vpx_codec_err_t ctrl_set_reference(vpx_codec_alg_priv_t *ctx,
                                           va_list args) {
   vpx_ref_frame_t *const data = va_arg(args, vpx_ref_frame_t *);
 
+  // The reference frames change while the frame workers are decoding.
+  if (ctx->frame_parallel_decode) {
+    set_error_detail(ctx, "Not supported in frame parallel decode");
+    return VPX_CODEC_INCAPABLE;
+  }
+
   if (data) {
     vpx_ref_frame_t *const frame = (vpx_ref_frame_t *)data;
     YV12_BUFFER_CONFIG sd;
@@ -458,6 +819,11 @@ static vpx_codec_err_t ctrl_copy_reference(vpx_codec_alg_priv_t *ctx,
                                            va_list args) {
   vpx_ref_frame_t *data = va_arg(args, vpx_ref_frame_t *);
 
+  if (ctx->frame_parallel_decode) {
+    set_error_detail(ctx, "Not supported in frame parallel decode");
+    return VPX_CODEC_INCAPABLE;
+  }
+
   if (data) {
     vpx_ref_frame_t *frame = (vpx_ref_frame_t *)data;
     YV12_BUFFER_CONFIG sd;
@@ -473,6 +839,11 @@ static vpx_codec_err_t ctrl_get_reference(vpx_codec_alg_priv_t *ctx,
                                           va_list args) {
   vp9_ref_frame_t *data = va_arg(args, vp9_ref_frame_t *);
 
+  if (ctx->frame_parallel_decode) {
+    set_error_detail(ctx, "Not supported in frame parallel decode");
+    return VPX_CODEC_INCAPABLE;
+  }
+
   if (data) {
     if (ctx->pbi) {
       const int fb_idx = ctx->pbi->common.cur_show_frame_fb_idx;
@@ -519,6 +890,11 @@ static vpx_codec_err_t ctrl_get_last_ref_updates(vpx_codec_alg_priv_t *ctx,
                                                  va_list args) {
   int *const update_info = va_arg(args, int *);
 
+  if (ctx->frame_parallel_decode) {
+    set_error_detail(ctx, "Not supported in frame parallel decode");
+    return VPX_CODEC_INCAPABLE;
+  }
+
   if (update_info) {
     if (ctx->pbi != NULL) {
       *update_info = ctx->pbi->refresh_frame_flags;
@@ -538,6 +914,13 @@ static vpx_codec_err_t ctrl_get_frame_corrupted(vpx_codec_alg_priv_t *ctx,
   if (corrupted) {
     if (ctx->pbi != NULL) {
       RefCntBuffer *const frame_bufs = ctx->pbi->common.buffer_pool->frame_bufs;
+      // In frame parallel decode the output may lag behind the decoding.
+      if (ctx->frame_parallel_decode) {
+        *corrupted = ctx->last_show_frame >= 0
+                         ? frame_bufs[ctx->last_show_frame].buf.corrupted
+                         : 0;
+        return VPX_CODEC_OK;
+      }
       if (ctx->pbi->common.frame_to_show == NULL) return VPX_CODEC_ERROR;
       if (ctx->last_show_frame >= 0)
         *corrupted = frame_bufs[ctx->last_show_frame].buf.corrupted;
@@ -603,6 +986,25 @@ static vpx_codec_err_t ctrl_get_bit_depth(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_INVALID_PARAM;
 }
 
+static vpx_codec_err_t ctrl_get_decode_stats(vpx_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  vpx_decode_stats_t *const stats = va_arg(args, vpx_decode_stats_t *);
+
+  if (stats) {
+    if (ctx->frame_parallel_decode) {
+      *stats = ctx->output_stats;
+      return VPX_CODEC_OK;
+    } else if (ctx->pbi != NULL) {
+      *stats = ctx->pbi->stats;
+      return VPX_CODEC_OK;
+    } else {
+      return VPX_CODEC_ERROR;
+    }
+  }
+
+  return VPX_CODEC_INVALID_PARAM;
+}
+
 static vpx_codec_err_t ctrl_set_invert_tile_order(vpx_codec_alg_priv_t *ctx,
                                                   va_list args) {
   ctx->invert_tile_order = va_arg(args, int);
@@ -631,7 +1033,14 @@ static vpx_codec_err_t ctrl_set_byte_alignment(vpx_codec_alg_priv_t *ctx,
     return VPX_CODEC_INVALID_PARAM;
 
   ctx->byte_alignment = byte_alignment;
-  if (ctx->pbi != NULL) {
+  if (ctx->frame_workers != NULL) {
+    int i;
+    for (i = 0; i < ctx->num_frame_workers; ++i) {
+      FrameWorkerData *const frame_worker_data =
+          (FrameWorkerData *)ctx->frame_workers[i].data1;
+      frame_worker_data->pbi->common.byte_alignment = byte_alignment;
+    }
+  } else if (ctx->pbi != NULL) {
     ctx->pbi->common.byte_alignment = byte_alignment;
   }
   return VPX_CODEC_OK;
@@ -641,7 +1050,14 @@ static vpx_codec_err_t ctrl_set_skip_loop_filter(vpx_codec_alg_priv_t *ctx,
                                                  va_list args) {
   ctx->skip_loop_filter = va_arg(args, int);
 
-  if (ctx->pbi != NULL) {
+  if (ctx->frame_workers != NULL) {
+    int i;
+    for (i = 0; i < ctx->num_frame_workers; ++i) {
+      FrameWorkerData *const frame_worker_data =
+          (FrameWorkerData *)ctx->frame_workers[i].data1;
+      frame_worker_data->pbi->common.skip_loop_filter = ctx->skip_loop_filter;
+    }
+  } else if (ctx->pbi != NULL) {
     ctx->pbi->common.skip_loop_filter = ctx->skip_loop_filter;
   }
 
@@ -672,6 +1088,37 @@ static vpx_codec_err_t ctrl_enable_lpf_opt(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_set_frame_parallel(vpx_codec_alg_priv_t *ctx,
+                                               va_list args) {
+  const int frame_parallel_decode = va_arg(args, int);
+
+  // The decoding mode can not change once the decoder has been initialized.
+  if (ctx->pbi != NULL) {
+    if (!frame_parallel_decode == !ctx->frame_parallel_decode)
+      return VPX_CODEC_OK;
+    set_error_detail(ctx, "Frame parallel mode must be set before decoding");
+    return VPX_CODEC_ERROR;
+  }
+  ctx->frame_parallel_decode = frame_parallel_decode != 0;
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_thread_pool(vpx_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  vpx_codec_thread_pool_t *const pool =
+      va_arg(args, vpx_codec_thread_pool_t *);
+
+  // The workers pick up the pool when the decoder is initialized.
+  if (ctx->pbi != NULL) {
+    set_error_detail(ctx, "Thread pool must be set before decoding");
+    return VPX_CODEC_ERROR;
+  }
+  ctx->thread_pool = pool;
+
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { VP8_COPY_REFERENCE, ctrl_copy_reference },
 
@@ -685,6 +1132,8 @@ static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { VP9_DECODE_SVC_SPATIAL_LAYER, ctrl_set_spatial_layer_svc },
   { VP9D_SET_ROW_MT, ctrl_set_row_mt },
   { VP9D_SET_LOOP_FILTER_OPT, ctrl_enable_lpf_opt },
+  { VP9D_SET_FRAME_PARALLEL, ctrl_set_frame_parallel },
+  { VPXD_SET_THREAD_POOL, ctrl_set_thread_pool },
 
   // Getters
   { VPXD_GET_LAST_QUANTIZER, ctrl_get_quantizer },
@@ -694,6 +1143,7 @@ static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { VP9D_GET_DISPLAY_SIZE, ctrl_get_render_size },
   { VP9D_GET_BIT_DEPTH, ctrl_get_bit_depth },
   { VP9D_GET_FRAME_SIZE, ctrl_get_frame_size },
+  { VP9D_GET_DECODE_STATS, ctrl_get_decode_stats },
 
   { -1, NULL },
 };
@@ -708,17 +1158,19 @@ CODEC_INTERFACE(vpx_codec_vp9_dx) = {
   VPX_CODEC_CAP_HIGHBITDEPTH |
 #endif
       VPX_CODEC_CAP_DECODER | VP9_CAP_POSTPROC |
-      VPX_CODEC_CAP_EXTERNAL_FRAME_BUFFER,  // vpx_codec_caps_t
-  decoder_init,                             // vpx_codec_init_fn_t
-  decoder_destroy,                          // vpx_codec_destroy_fn_t
-  decoder_ctrl_maps,                        // vpx_codec_ctrl_fn_map_t
+      VPX_CODEC_CAP_EXTERNAL_FRAME_BUFFER |
+      VPX_CODEC_CAP_EXTERNAL_FRAME_BUFFER_LAYOUT,  // vpx_codec_caps_t
+  decoder_init,                                    // vpx_codec_init_fn_t
+  decoder_destroy,                                 // vpx_codec_destroy_fn_t
+  decoder_ctrl_maps,                               // vpx_codec_ctrl_fn_map_t
   {
       // NOLINT
-      decoder_peek_si,    // vpx_codec_peek_si_fn_t
-      decoder_get_si,     // vpx_codec_get_si_fn_t
-      decoder_decode,     // vpx_codec_decode_fn_t
-      decoder_get_frame,  // vpx_codec_frame_get_fn_t
-      decoder_set_fb_fn,  // vpx_codec_set_fb_fn_t
+      decoder_peek_si,           // vpx_codec_peek_si_fn_t
+      decoder_get_si,            // vpx_codec_get_si_fn_t
+      decoder_decode,            // vpx_codec_decode_fn_t
+      decoder_get_frame,         // vpx_codec_frame_get_fn_t
+      decoder_set_fb_fn,         // vpx_codec_set_fb_fn_t
+      decoder_set_fb_layout_fn,  // vpx_codec_set_fb_layout_fn_t
   },
   {
       // NOLINT
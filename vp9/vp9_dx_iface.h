@@ -15,6 +15,16 @@
 
 typedef vpx_codec_stream_info_t vp9_stream_info_t;
 
+// Frames decoded in frame parallel mode that were not yet output. This limit
+// is due to framebuffer numbers.
+#define FRAME_CACHE_SIZE 4  // Cache maximum 4 decoded frames.
+
+typedef struct cache_frame {
+  int fb_idx;
+  vpx_image_t img;
+  vpx_decode_stats_t stats;
+} cache_frame;
+
 struct vpx_codec_alg_priv {
   vpx_codec_priv_t base;
   vpx_codec_dec_cfg_t cfg;
@@ -33,6 +43,20 @@ struct vpx_codec_alg_priv {
   int byte_alignment;
   int skip_loop_filter;
 
+  // Frame parallel related.
+  int frame_parallel_decode;  // frame-based threading.
+  VPxWorker *frame_workers;
+  int num_frame_workers;
+  int next_submit_worker_id;
+  int last_submit_worker_id;
+  int next_output_worker_id;
+  int available_threads;
+  cache_frame frame_cache[FRAME_CACHE_SIZE];
+  int frame_cache_write;
+  int frame_cache_read;
+  int num_cache_frames;
+  vpx_decode_stats_t output_stats;  // Decode times of the last output frame.
+
   int need_resync;  // wait for key/intra-only frame
   // BufferPool that holds all reference frames.
   BufferPool *buffer_pool;
@@ -41,12 +65,14 @@ struct vpx_codec_alg_priv {
   void *ext_priv;  // Private data associated with the external frame buffers.
   vpx_get_frame_buffer_cb_fn_t get_ext_fb_cb;
   vpx_release_frame_buffer_cb_fn_t release_ext_fb_cb;
+  vpx_get_frame_buffer_layout_cb_fn_t get_ext_fb_layout_cb;
 
   // Allow for decoding up to a given spatial layer for SVC stream.
   int svc_decoding;
   int svc_spatial_layer;
   int row_mt;
   int lpf_opt;
+  VPxThreadPool *thread_pool;
 };
 
 #endif  // VPX_VP9_VP9_DX_IFACE_H_
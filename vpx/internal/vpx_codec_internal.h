@@ -60,7 +60,7 @@ extern "C" {
  * types, removing or reassigning enums, adding/removing/rearranging
  * fields to structures
  */
-#define VPX_CODEC_INTERNAL_ABI_VERSION (5) /**<\hideinitializer*/
+#define VPX_CODEC_INTERNAL_ABI_VERSION (6) /**<\hideinitializer*/
 
 typedef struct vpx_codec_alg_priv vpx_codec_alg_priv_t;
 typedef struct vpx_codec_priv_enc_mr_cfg vpx_codec_priv_enc_mr_cfg_t;
@@ -248,6 +248,20 @@ typedef vpx_codec_err_t (*vpx_codec_set_fb_fn_t)(
     vpx_codec_alg_priv_t *ctx, vpx_get_frame_buffer_cb_fn_t cb_get,
     vpx_release_frame_buffer_cb_fn_t cb_release, void *cb_priv);
 
+/*!\brief Pass in external frame buffers with a caller defined layout.
+ *
+ * Same as #vpx_codec_set_fb_fn_t, but the get callback also decides the plane
+ * layout of the frame buffers.
+ *
+ * \param[in] ctx          Pointer to this instance's context
+ * \param[in] cb_get       Pointer to the get callback function
+ * \param[in] cb_release   Pointer to the release callback function
+ * \param[in] cb_priv      Callback's private data
+ */
+typedef vpx_codec_err_t (*vpx_codec_set_fb_layout_fn_t)(
+    vpx_codec_alg_priv_t *ctx, vpx_get_frame_buffer_layout_cb_fn_t cb_get,
+    vpx_release_frame_buffer_cb_fn_t cb_release, void *cb_priv);
+
 typedef vpx_codec_err_t (*vpx_codec_encode_fn_t)(vpx_codec_alg_priv_t *ctx,
                                                  const vpx_image_t *img,
                                                  vpx_codec_pts_t pts,
@@ -301,6 +315,8 @@ struct vpx_codec_iface {
     vpx_codec_get_frame_fn_t
         get_frame;                   /**< \copydoc ::vpx_codec_get_frame_fn_t */
     vpx_codec_set_fb_fn_t set_fb_fn; /**< \copydoc ::vpx_codec_set_fb_fn_t */
+    vpx_codec_set_fb_layout_fn_t
+        set_fb_layout_fn; /**< \copydoc ::vpx_codec_set_fb_layout_fn_t */
   } dec;
   struct vpx_codec_enc_iface {
     int cfg_map_count;
@@ -0,0 +1,21 @@
+/*
+ *  Copyright (c) 2021 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "vpx/vpx_thread_pool.h"
+#include "vpx_util/vpx_thread.h"
+
+vpx_codec_thread_pool_t *vpx_codec_thread_pool_create(int num_threads) {
+  if (num_threads < 1 || num_threads > VPX_THREAD_POOL_MAX_THREADS) return NULL;
+  return vpx_thread_pool_create(num_threads);
+}
+
+void vpx_codec_thread_pool_destroy(vpx_codec_thread_pool_t *pool) {
+  vpx_thread_pool_destroy(pool);
+}
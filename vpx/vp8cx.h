@@ -18,6 +18,7 @@
 #include "./vp8.h"
 #include "./vpx_encoder.h"
 #include "./vpx_ext_ratectrl.h"
+#include "./vpx_thread_pool.h"
 
 /*!\file
  * \brief Provides definitions for using VP8 or VP9 encoder algorithm within the
@@ -712,6 +713,87 @@ enum vp8e_enc_control_id {
    * Supported in codecs: VP9
    */
   VP9E_SET_EXTERNAL_RATE_CONTROL,
+
+  /*!\brief Codec control function to run the encoder threads on a thread
+   * pool shared with other codec instances, see vpx_thread_pool.h.
+   *
+   * The pool must outlive the encoder. Must be set before the first frame is
+   * encoded.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_THREAD_POOL,
+
+  /*!\brief Codec control function to run the first pass of a two-pass encode
+   * alongside the second pass, in a single pass over the input.
+   *
+   * The first pass stats are computed on a background thread as frames are
+   * received, and the second pass codes each frame once the stats of the
+   * given number of frames beyond the lag are known. This delays the output
+   * by lag + frames frames instead of the length of the clip. Rate control
+   * decisions extending past the known stats are extrapolated from them.
+   *
+   * 0: off (default), 1..256: number of frames of first pass lookahead.
+   * Only valid with g_pass set to VPX_RC_ONE_PASS and a non realtime deadline.
+   * Must be set before the first frame is encoded.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_FIRST_PASS_LOOKAHEAD,
+
+  /*!\brief Codec control function to get where the second pass starts key
+   * frame groups, as decided from the first pass stats alone.
+   *
+   * The argument points to an int array with one entry per frame of
+   * rc_twopass_stats_in, excluding the total stats packet. Each entry is set
+   * to 1 if a key frame group starts on that frame and 0 otherwise. The
+   * number of entries is given by VP9E_GET_KEY_FRAME_MAP_SIZE. Only valid
+   * with g_pass set to VPX_RC_LAST_PASS, before the first frame is encoded.
+   * Key frames forced by the application are not accounted for.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_GET_KEY_FRAME_MAP,
+
+  /*!\brief Codec control function to encode a chunk of a longer clip.
+   *
+   * The argument is the frame of rc_twopass_stats_in the input starts on,
+   * which should start a key frame group (see VP9E_GET_KEY_FRAME_MAP). The
+   * encoder then codes the input as that part of the clip: the bits of the
+   * frames before it are left out of the budget, so chunks of one clip
+   * encoded separately add up to about the target bitrate, and can be
+   * concatenated into one stream. Only valid with g_pass set to
+   * VPX_RC_LAST_PASS and the stats of the whole clip, before the first frame
+   * is encoded.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_CHUNK_START_FRAME,
+
+  /*!\brief Codec control function to get the time spent in each stage of
+   * the last encode.
+   *
+   * The argument points to a vpx_frame_stats_t, which is filled with the
+   * times of all the frames coded by the last call to vpx_codec_encode(),
+   * so the spatial layers of a superframe are added up.
+   *
+   * The mode search, transform and tokenization times come from per block
+   * timers, which the first call of this control turns on. Until then they
+   * read 0, and pack_us only covers the bitstream packing.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_GET_FRAME_STATS,
+
+  /*!\brief Codec control function to get the number of entries of the array
+   * that VP9E_GET_KEY_FRAME_MAP fills, which is the number of frames of
+   * rc_twopass_stats_in, excluding the total stats packet.
+   *
+   * Only valid with g_pass set to VPX_RC_LAST_PASS.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_GET_KEY_FRAME_MAP_SIZE,
 };
 
 /*!\brief vpx 1-D scaling mode
@@ -903,6 +985,22 @@ typedef struct vpx_svc_spatial_layer_sync {
   int base_layer_intra_only; /**< Flag for setting Intra-only frame on base */
 } vpx_svc_spatial_layer_sync_t;
 
+/*!\brief vp9 per-stage encode times.
+ *
+ * Wall clock time in microseconds spent in each stage of the encode, as
+ * returned by VP9E_GET_FRAME_STATS. The block level stages are added up over
+ * the encoder threads, so with multiple threads they may sum to more than the
+ * time of the whole encode.
+ */
+typedef struct vpx_frame_stats {
+  int64_t scale_us;     /**< Scaling of the source and reference frames */
+  int64_t pick_mode_us; /**< Partition and mode search of the blocks */
+  int64_t transform_us; /**< Prediction, transform and quantization */
+  int64_t pack_us;      /**< Tokenization and bitstream packing */
+  int64_t lf_search_us; /**< Loop filter level search */
+  int64_t lf_us;        /**< Loop filter and border extension */
+} vpx_frame_stats_t;
+
 /*!\cond */
 /*!\brief VP8 encoder control function parameter type
  *
@@ -1071,6 +1169,24 @@ VPX_CTRL_USE_TYPE(VP9E_SET_DISABLE_LOOPFILTER, int)
 VPX_CTRL_USE_TYPE(VP9E_SET_EXTERNAL_RATE_CONTROL, vpx_rc_funcs_t *)
 #define VPX_CTRL_VP9E_SET_EXTERNAL_RATE_CONTROL
 
+VPX_CTRL_USE_TYPE(VP9E_SET_THREAD_POOL, vpx_codec_thread_pool_t *)
+#define VPX_CTRL_VP9E_SET_THREAD_POOL
+
+VPX_CTRL_USE_TYPE(VP9E_SET_FIRST_PASS_LOOKAHEAD, unsigned int)
+#define VPX_CTRL_VP9E_SET_FIRST_PASS_LOOKAHEAD
+
+VPX_CTRL_USE_TYPE(VP9E_GET_KEY_FRAME_MAP, int *)
+#define VPX_CTRL_VP9E_GET_KEY_FRAME_MAP
+
+VPX_CTRL_USE_TYPE(VP9E_SET_CHUNK_START_FRAME, unsigned int)
+#define VPX_CTRL_VP9E_SET_CHUNK_START_FRAME
+
+VPX_CTRL_USE_TYPE(VP9E_GET_FRAME_STATS, vpx_frame_stats_t *)
+#define VPX_CTRL_VP9E_GET_FRAME_STATS
+
+VPX_CTRL_USE_TYPE(VP9E_GET_KEY_FRAME_MAP_SIZE, unsigned int *)
+#define VPX_CTRL_VP9E_GET_KEY_FRAME_MAP_SIZE
+
 /*!\endcond */
 /*! @} - end defgroup vp8_encoder */
 #ifdef __cplusplus
@@ -26,6 +26,7 @@ extern "C" {
 
 /* Include controls common to both the encoder and decoder */
 #include "./vp8.h"
+#include "./vpx_thread_pool.h"
 
 /*!\name Algorithm interface for VP8
  *
@@ -142,6 +143,50 @@ enum vp8_dec_control_id {
    */
   VP9D_SET_LOOP_FILTER_OPT,
 
+  /*!\brief Codec control function to enable frame parallel decoding.
+   *
+   * Up to 4 frames are decoded at the same time, each by its own thread
+   * (vpx_codec_dec_cfg_t.threads limits the number of threads). Decoded
+   * frames are returned with a delay of up to one frame per thread; call
+   * vpx_codec_decode() with NULL data to flush them at the end of the stream.
+   * Each frame passed to the decoder must either be a single frame or a
+   * superframe with a superframe index. Must be set before the first frame
+   * is decoded, and can not be combined with postprocessing.
+   *
+   * Combined with VP9D_SET_ROW_MT and at least 4 threads, two frames are
+   * pipelined instead, each decoded row-wise with half of the threads: the
+   * next frame is parsed while the current one is reconstructed and loop
+   * filtered. Decoded frames are then returned with a delay of one frame.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_FRAME_PARALLEL,
+
+  /*!\brief Codec control function to run the decoder threads on a thread
+   * pool shared with other codec instances, see vpx_thread_pool.h.
+   *
+   * The pool must outlive the decoder. Must be set before the first frame is
+   * decoded. VP9D_SET_LOOP_FILTER_OPT has no effect on a decoder using a
+   * thread pool, its workers depend on each other in ways a shared pool can
+   * not schedule safely.
+   *
+   * Supported in codecs: VP8, VP9
+   */
+  VPXD_SET_THREAD_POOL,
+
+  /*!\brief Codec control function to get the time spent in each stage of
+   * decoding and how busy the decoder threads were.
+   *
+   * The argument points to a vpx_decode_stats_t, which is filled with the
+   * times of all the frames decoded by the last call to vpx_codec_decode(),
+   * including the postprocessing of the frame returned by
+   * vpx_codec_get_frame(). With VP9D_SET_FRAME_PARALLEL the times are those
+   * of the last frame returned by vpx_codec_get_frame().
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_GET_DECODE_STATS,
+
   VP8_DECODER_CTRL_ID_MAX
 };
 
@@ -163,6 +208,45 @@ typedef struct vpx_decrypt_init {
   void *decrypt_state;
 } vpx_decrypt_init;
 
+/*!\brief Maximum number of decoder threads reported in vpx_decode_stats_t. */
+#define VPX_DECODE_STATS_MAX_WORKERS 64
+
+/*!\brief Time spent in a decoder stage, in microseconds.
+ *
+ * The CPU time is 0 on systems without a per thread CPU clock.
+ */
+typedef struct vpx_stage_time {
+  int64_t wall_us; /**< Wall clock time */
+  int64_t cpu_us;  /**< CPU time of the threads running the stage */
+} vpx_stage_time_t;
+
+/*!\brief vp9 decode statistics.
+ *
+ * Returned by VP9D_GET_DECODE_STATS. The stages run by more than one thread
+ * are added up over the threads, so with multiple threads they may sum to
+ * more than the time of the whole decode. Parsing and reconstruction are only
+ * told apart by the row based multi-threaded decoder (VP9D_SET_ROW_MT), the
+ * other decoders do both for each block in turn and report the time as
+ * parsing.
+ *
+ * The worker times describe the tile and row decoding threads of a
+ * multi-threaded decode, the calling thread being the last of them. Time a
+ * worker spent waiting for the rows it depends on is counted as busy.
+ */
+typedef struct vpx_decode_stats {
+  vpx_stage_time_t header;   /**< Uncompressed and compressed headers */
+  vpx_stage_time_t parse;    /**< Tile parsing */
+  vpx_stage_time_t recon;    /**< Reconstruction */
+  vpx_stage_time_t lf;       /**< Loop filter */
+  vpx_stage_time_t postproc; /**< Postprocessing */
+  /*! Number of worker threads, 0 for a single-threaded tile decode. */
+  int num_workers;
+  /*! Wall clock time each worker spent decoding. */
+  int64_t worker_busy_us[VPX_DECODE_STATS_MAX_WORKERS];
+  /*! Wall clock time each worker spent waiting for work. */
+  int64_t worker_idle_us[VPX_DECODE_STATS_MAX_WORKERS];
+} vpx_decode_stats_t;
+
 /*!\cond */
 /*!\brief VP8 decoder control function parameter type
  *
@@ -199,6 +283,12 @@ VPX_CTRL_USE_TYPE(VP9_SET_SKIP_LOOP_FILTER, int)
 VPX_CTRL_USE_TYPE(VP9D_SET_ROW_MT, int)
 #define VPX_CTRL_VP9_SET_LOOP_FILTER_OPT
 VPX_CTRL_USE_TYPE(VP9D_SET_LOOP_FILTER_OPT, int)
+#define VPX_CTRL_VP9D_SET_FRAME_PARALLEL
+VPX_CTRL_USE_TYPE(VP9D_SET_FRAME_PARALLEL, int)
+#define VPX_CTRL_VPXD_SET_THREAD_POOL
+VPX_CTRL_USE_TYPE(VPXD_SET_THREAD_POOL, vpx_codec_thread_pool_t *)
+#define VPX_CTRL_VP9D_GET_DECODE_STATS
+VPX_CTRL_USE_TYPE(VP9D_GET_DECODE_STATS, vpx_decode_stats_t *)
 
 /*!\endcond */
 /*! @} - end defgroup vp8_decoder */
@@ -62,6 +62,8 @@ extern "C" {
 #define VPX_CODEC_CAP_FRAME_THREADING 0x200000
 /*!brief Can support external frame buffers */
 #define VPX_CODEC_CAP_EXTERNAL_FRAME_BUFFER 0x400000
+/*!brief Can support external frame buffers with a caller defined layout */
+#define VPX_CODEC_CAP_EXTERNAL_FRAME_BUFFER_LAYOUT 0x800000
 
 /*! \brief Initialization-time Feature Enabling
  *
@@ -315,9 +317,10 @@ vpx_codec_err_t vpx_codec_register_put_slice_cb(vpx_codec_ctx_t *ctx,
 
 /*!\defgroup cap_external_frame_buffer External Frame Buffer Functions
  *
- * The following function is required to be implemented for all decoders
- * that advertise the VPX_CODEC_CAP_EXTERNAL_FRAME_BUFFER capability.
- * Calling this function for codecs that don't advertise this capability
+ * The following functions are required to be implemented for all decoders
+ * that advertise the VPX_CODEC_CAP_EXTERNAL_FRAME_BUFFER and
+ * VPX_CODEC_CAP_EXTERNAL_FRAME_BUFFER_LAYOUT capabilities, respectively.
+ * Calling these functions for codecs that don't advertise the capability
  * will result in an error code being returned, usually VPX_CODEC_INCAPABLE.
  *
  * \note
@@ -356,6 +359,40 @@ vpx_codec_err_t vpx_codec_set_frame_buffer_functions(
     vpx_codec_ctx_t *ctx, vpx_get_frame_buffer_cb_fn_t cb_get,
     vpx_release_frame_buffer_cb_fn_t cb_release, void *cb_priv);
 
+/*!\brief Pass in external frame buffers with a caller defined layout.
+ *
+ * Same as vpx_codec_set_frame_buffer_functions(), but the get callback also
+ * chooses the stride, the offset and the border of each plane of the frame
+ * buffer. The decoded frames returned by vpx_codec_get_frame() point to the
+ * planes in place, which lets the application decode straight into the
+ * buffers it will use next, e.g. the input of an encoder, without a copy.
+ * Frames that are post-processed are still returned in an internal buffer,
+ * and VP9_SET_BYTE_ALIGNMENT has no effect.
+ * This set function must be called before the first call to decode. It
+ * replaces any functions set with vpx_codec_set_frame_buffer_functions().
+ *
+ * \param[in] ctx          Pointer to this instance's context
+ * \param[in] cb_get       Pointer to the get callback function
+ * \param[in] cb_release   Pointer to the release callback function
+ * \param[in] cb_priv      Callback's private data
+ *
+ * \retval #VPX_CODEC_OK
+ *     External frame buffers will be used by libvpx.
+ * \retval #VPX_CODEC_INVALID_PARAM
+ *     One or more of the callbacks were NULL.
+ * \retval #VPX_CODEC_ERROR
+ *     Decoder context not initialized.
+ * \retval #VPX_CODEC_INCAPABLE
+ *     Algorithm not capable of using external frame buffer layouts.
+ *
+ * \note
+ * The same number of frame buffers as for
+ * vpx_codec_set_frame_buffer_functions() may be required.
+ */
+vpx_codec_err_t vpx_codec_set_frame_buffer_layout_functions(
+    vpx_codec_ctx_t *ctx, vpx_get_frame_buffer_layout_cb_fn_t cb_get,
+    vpx_release_frame_buffer_cb_fn_t cb_release, void *cb_priv);
+
 /*!@} - end defgroup cap_external_frame_buffer */
 
 /*!@} - end defgroup decoder*/
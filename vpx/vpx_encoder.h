@@ -444,7 +444,9 @@ typedef struct vpx_codec_enc_cfg {
   /*!\brief Two-pass stats buffer.
    *
    * A buffer containing all of the stats packets produced in the first
-   * pass, concatenated.
+   * pass, concatenated. It may instead hold the stats packets of a run of
+   * consecutive frames, followed by the last packet of the first pass, to
+   * code those frames only.
    */
   vpx_fixed_buf_t rc_twopass_stats_in;
 
@@ -76,6 +76,60 @@ typedef int (*vpx_get_frame_buffer_cb_fn_t)(void *priv, size_t min_size,
 typedef int (*vpx_release_frame_buffer_cb_fn_t)(void *priv,
                                                 vpx_codec_frame_buffer_t *fb);
 
+/*!\brief External frame buffer layout
+ *
+ * Describes where the decoder writes the planes of a frame in an external
+ * frame buffer. The first group of fields is set by the decoder, the second
+ * one by the get frame buffer layout callback. All sizes are in pixels unless
+ * noted otherwise; the chroma planes are the luma sizes shifted right by the
+ * subsampling.
+ */
+typedef struct vpx_codec_frame_buffer_layout {
+  int width;            /**< Width of the luma plane, a multiple of 8 */
+  int height;           /**< Height of the luma plane, a multiple of 8 */
+  int subsampling_x;    /**< Horizontal chroma subsampling, 0 or 1 */
+  int subsampling_y;    /**< Vertical chroma subsampling, 0 or 1 */
+  int bytes_per_sample; /**< 2 for high bitdepth frames, 1 otherwise */
+
+  /*!\brief Border around the luma plane
+   *
+   * Set by the decoder to the smallest border it can work with. The callback
+   * may make it larger. The decoder reads and writes up to this many pixels
+   * past the right and bottom edges of each plane.
+   */
+  int border;
+  /*!\brief Bytes between the rows of the Y, U and V planes
+   *
+   * Must be multiples of 16. The U and V planes must have the same stride.
+   */
+  int stride[3];
+  /*!\brief Offsets in bytes of the Y, U and V planes from fb->data
+   *
+   * The offset of the top left pixel of each plane. fb->data plus the offset
+   * must be 16 byte aligned.
+   */
+  size_t offset[3];
+} vpx_codec_frame_buffer_layout_t;
+
+/*!\brief get frame buffer layout callback prototype
+ *
+ * Like vpx_get_frame_buffer_cb_fn_t, but the application also decides how
+ * the planes are laid out in the buffer, so the decoder can write the frame
+ * directly where the application needs it. The callback must set fb->data,
+ * fb->size and optionally fb->priv, and fill in the border, stride and offset
+ * fields of |layout|. The planes, including their borders, must fit in
+ * fb->size bytes and must not overlap. |layout| and |fb| are guaranteed to
+ * not be NULL. On success the callback must return 0. Any failure the
+ * callback must return a value less than 0.
+ *
+ * \param[in] priv         Callback's private data
+ * \param[in,out] layout   Pointer to vpx_codec_frame_buffer_layout_t
+ * \param[in,out] fb       Pointer to vpx_codec_frame_buffer_t
+ */
+typedef int (*vpx_get_frame_buffer_layout_cb_fn_t)(
+    void *priv, vpx_codec_frame_buffer_layout_t *layout,
+    vpx_codec_frame_buffer_t *fb);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
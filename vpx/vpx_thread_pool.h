@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2021 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPX_VPX_VPX_THREAD_POOL_H_
+#define VPX_VPX_VPX_THREAD_POOL_H_
+
+/*!\file
+ * \brief Describes the thread pool that codec instances can share.
+ *
+ * By default every codec instance starts its own threads. A thread pool
+ * created by the application can instead be attached to any number of VP8
+ * decoder, VP9 decoder and VP9 encoder instances with the VPXD_SET_THREAD_POOL
+ * and VP9E_SET_THREAD_POOL controls. The instances then run their worker
+ * jobs on the threads of the pool, so the threads are only started once and
+ * the number of threads running codec work is bounded by the size of the
+ * pool, plus the application threads calling into the codecs.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!\brief The maximum number of threads of a thread pool. */
+#define VPX_THREAD_POOL_MAX_THREADS 256
+
+/*!\brief Thread pool
+ *
+ * Opaque handle of a thread pool, shared by the codec instances it is
+ * attached to.
+ */
+typedef struct vpx_codec_thread_pool vpx_codec_thread_pool_t;
+
+/*!\brief Create a thread pool
+ *
+ * Starts num_threads threads, which wait for work from the codec instances
+ * the pool is attached to. The pool can be used from any thread.
+ *
+ * \param[in] num_threads  Number of threads, in the range
+ *                         [1, VPX_THREAD_POOL_MAX_THREADS].
+ *
+ * \return The thread pool, or NULL if num_threads is out of range or the
+ *         threads could not be started.
+ */
+vpx_codec_thread_pool_t *vpx_codec_thread_pool_create(int num_threads);
+
+/*!\brief Destroy a thread pool
+ *
+ * Stops the threads of the pool. All the codec instances the pool was attached
+ * to must have been destroyed first.
+ *
+ * \param[in] pool  Thread pool to destroy. May be NULL.
+ */
+void vpx_codec_thread_pool_destroy(vpx_codec_thread_pool_t *pool);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // VPX_VPX_VPX_THREAD_POOL_H_
@@ -33,6 +33,17 @@ void vpx_stop_encode(vpx_writer *br) {
 #endif
   for (i = 0; i < 32; i++) vpx_write_bit(br, 0);
 
+  // Write out the remaining whole bytes.
+  while (br->count >= 0) {
+    const int shift = br->count + 24;
+
+    if ((br->lowvalue >> shift) & 0x100) vpx_writer_carry(br);
+
+    br->buffer[br->pos++] = (uint8_t)(br->lowvalue >> shift);
+    br->lowvalue &= ((uint64_t)1 << shift) - 1;
+    br->count -= 8;
+  }
+
   // Ensure there's no ambigous collision with any index marker bytes
   if ((br->buffer[br->pos - 1] & 0xe0) == 0xc0) br->buffer[br->pos++] = 0;
 
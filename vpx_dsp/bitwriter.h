@@ -24,8 +24,12 @@
 extern "C" {
 #endif
 
+// lowvalue holds the bits of the low end of the range that have not been
+// written out yet: count + 24 bits above the 8 bits of the range. Once count
+// reaches 24 the top 4 bytes are flushed to the buffer at once, and a carry out
+// of them is added to the bytes written before.
 typedef struct vpx_writer {
-  unsigned int lowvalue;
+  uint64_t lowvalue;
   unsigned int range;
   int count;
   unsigned int pos;
@@ -35,11 +39,39 @@ typedef struct vpx_writer {
 void vpx_start_encode(vpx_writer *br, uint8_t *source);
 void vpx_stop_encode(vpx_writer *br);
 
+// Adds a carry to the bytes already written to the buffer.
+static INLINE void vpx_writer_carry(vpx_writer *br) {
+  int x = br->pos - 1;
+
+  while (x >= 0 && br->buffer[x] == 0xff) {
+    br->buffer[x] = 0;
+    x--;
+  }
+
+  br->buffer[x] += 1;
+}
+
+// Writes out the 4 bytes above the 24 bits kept for the range, with the carry
+// out of them.
+static INLINE void vpx_writer_flush(vpx_writer *br) {
+  const int count = br->count;
+  const uint64_t bytes = br->lowvalue >> count;
+  uint8_t *const buffer = br->buffer + br->pos;
+
+  if (bytes >> 32) vpx_writer_carry(br);
+
+  buffer[0] = (uint8_t)(bytes >> 24);
+  buffer[1] = (uint8_t)(bytes >> 16);
+  buffer[2] = (uint8_t)(bytes >> 8);
+  buffer[3] = (uint8_t)bytes;
+  br->pos += 4;
+  br->lowvalue &= ((uint64_t)1 << count) - 1;
+  br->count = count - 32;
+}
+
 static INLINE void vpx_write(vpx_writer *br, int bit, int probability) {
   unsigned int split;
-  int count = br->count;
   unsigned int range = br->range;
-  unsigned int lowvalue = br->lowvalue;
   int shift;
 
 #if CONFIG_BITSTREAM_DEBUG
@@ -59,43 +91,20 @@ static INLINE void vpx_write(vpx_writer *br, int bit, int probability) {
 
   split = 1 + (((range - 1) * probability) >> 8);
 
-  range = split;
-
   if (bit) {
-    lowvalue += split;
-    range = br->range - split;
+    br->lowvalue += split;
+    range -= split;
+  } else {
+    range = split;
   }
 
   shift = vpx_norm[range];
 
-  range <<= shift;
-  count += shift;
-
-  if (count >= 0) {
-    int offset = shift - count;
-
-    if ((lowvalue << (offset - 1)) & 0x80000000) {
-      int x = br->pos - 1;
-
-      while (x >= 0 && br->buffer[x] == 0xff) {
-        br->buffer[x] = 0;
-        x--;
-      }
-
-      br->buffer[x] += 1;
-    }
-
-    br->buffer[br->pos++] = (lowvalue >> (24 - offset)) & 0xff;
-    lowvalue <<= offset;
-    shift = count;
-    lowvalue &= 0xffffff;
-    count -= 8;
-  }
+  br->range = range << shift;
+  br->lowvalue <<= shift;
+  br->count += shift;
 
-  lowvalue <<= shift;
-  br->count = count;
-  br->lowvalue = lowvalue;
-  br->range = range;
+  if (br->count >= 24) vpx_writer_flush(br);
 }
 
 static INLINE void vpx_write_bit(vpx_writer *w, int bit) {
@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2021 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include <immintrin.h>
+#include "./vpx_dsp_rtcd.h"
+#include "vpx_dsp/vpx_dsp_common.h"
+#include "vpx_ports/mem.h"
+
+// The absolute differences of up to 16 rows of 16 pixels are accumulated in
+// 16 bits before being widened: 16 * 4095 still fits in an unsigned short.
+#define HIGHBD_SAD_VECTORS 16
+
+static INLINE __m256i highbd_sad_widen_avx2(const __m256i sad16) {
+  const __m256i zero = _mm256_setzero_si256();
+  return _mm256_add_epi32(_mm256_unpacklo_epi16(sad16, zero),
+                          _mm256_unpackhi_epi16(sad16, zero));
+}
+
+static INLINE unsigned int highbd_sad_final_avx2(const __m256i sum) {
+  const __m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum),
+                                       _mm256_extracti128_si256(sum, 1));
+  const __m128i sum64 = _mm_add_epi32(sum128, _mm_srli_si128(sum128, 8));
+  const __m128i sum32 = _mm_add_epi32(sum64, _mm_srli_si128(sum64, 4));
+  return (unsigned int)_mm_cvtsi128_si32(sum32);
+}
+
+static INLINE unsigned int highbd_sad_avx2(const uint16_t *src,
+                                           int src_stride,
+                                           const uint16_t *ref,
+                                           int ref_stride, int w, int h) {
+  const int rows = VPXMIN(HIGHBD_SAD_VECTORS * 16 / w, h);
+  __m256i sum = _mm256_setzero_si256();
+  int i, r, j;
+
+  for (i = 0; i < h; i += rows) {
+    __m256i sad16 = _mm256_setzero_si256();
+    for (r = 0; r < rows; ++r) {
+      for (j = 0; j < w; j += 16) {
+        const __m256i s = _mm256_loadu_si256((const __m256i *)(src + j));
+        const __m256i p = _mm256_loadu_si256((const __m256i *)(ref + j));
+        sad16 = _mm256_add_epi16(sad16,
+                                 _mm256_abs_epi16(_mm256_sub_epi16(s, p)));
+      }
+      src += src_stride;
+      ref += ref_stride;
+    }
+    sum = _mm256_add_epi32(sum, highbd_sad_widen_avx2(sad16));
+  }
+  return highbd_sad_final_avx2(sum);
+}
+
+static INLINE unsigned int highbd_sad_avg_avx2(
+    const uint16_t *src, int src_stride, const uint16_t *ref, int ref_stride,
+    const uint16_t *second_pred, int w, int h) {
+  const int rows = VPXMIN(HIGHBD_SAD_VECTORS * 16 / w, h);
+  __m256i sum = _mm256_setzero_si256();
+  int i, r, j;
+
+  for (i = 0; i < h; i += rows) {
+    __m256i sad16 = _mm256_setzero_si256();
+    for (r = 0; r < rows; ++r) {
+      for (j = 0; j < w; j += 16) {
+        const __m256i s = _mm256_loadu_si256((const __m256i *)(src + j));
+        const __m256i p = _mm256_avg_epu16(
+            _mm256_loadu_si256((const __m256i *)(ref + j)),
+            _mm256_loadu_si256((const __m256i *)(second_pred + j)));
+        sad16 = _mm256_add_epi16(sad16,
+                                 _mm256_abs_epi16(_mm256_sub_epi16(s, p)));
+      }
+      src += src_stride;
+      ref += ref_stride;
+      second_pred += w;
+    }
+    sum = _mm256_add_epi32(sum, highbd_sad_widen_avx2(sad16));
+  }
+  return highbd_sad_final_avx2(sum);
+}
+
+#define HIGHBD_SADMXN(m, n)                                                  \
+  unsigned int vpx_highbd_sad##m##x##n##_avx2(                               \
+      const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr,        \
+      int ref_stride) {                                                      \
+    return highbd_sad_avx2(CONVERT_TO_SHORTPTR(src_ptr), src_stride,         \
+                           CONVERT_TO_SHORTPTR(ref_ptr), ref_stride, m, n);  \
+  }                                                                          \
+                                                                             \
+  unsigned int vpx_highbd_sad##m##x##n##_avg_avx2(                           \
+      const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr,        \
+      int ref_stride, const uint8_t *second_pred) {                          \
+    return highbd_sad_avg_avx2(CONVERT_TO_SHORTPTR(src_ptr), src_stride,     \
+                               CONVERT_TO_SHORTPTR(ref_ptr), ref_stride,     \
+                               CONVERT_TO_SHORTPTR(second_pred), m, n);      \
+  }
+
+HIGHBD_SADMXN(64, 64)
+HIGHBD_SADMXN(64, 32)
+HIGHBD_SADMXN(32, 64)
+HIGHBD_SADMXN(32, 32)
+HIGHBD_SADMXN(32, 16)
+HIGHBD_SADMXN(16, 32)
+HIGHBD_SADMXN(16, 16)
+HIGHBD_SADMXN(16, 8)
+
+#undef HIGHBD_SADMXN
+
+static INLINE void highbd_sad_x4d_avx2(const uint16_t *src, int src_stride,
+                                       const uint8_t *const ref_array[],
+                                       int ref_stride, uint32_t *sad_array,
+                                       int w, int h) {
+  const int rows = VPXMIN(HIGHBD_SAD_VECTORS * 16 / w, h);
+  const uint16_t *ref[4];
+  __m256i sum[4];
+  int i, r, j, k;
+
+  for (k = 0; k < 4; ++k) {
+    ref[k] = CONVERT_TO_SHORTPTR(ref_array[k]);
+    sum[k] = _mm256_setzero_si256();
+  }
+
+  for (i = 0; i < h; i += rows) {
+    __m256i sad16[4];
+    for (k = 0; k < 4; ++k) sad16[k] = _mm256_setzero_si256();
+    for (r = 0; r < rows; ++r) {
+      for (j = 0; j < w; j += 16) {
+        const __m256i s = _mm256_loadu_si256((const __m256i *)(src + j));
+        for (k = 0; k < 4; ++k) {
+          const __m256i p = _mm256_loadu_si256((const __m256i *)(ref[k] + j));
+          sad16[k] = _mm256_add_epi16(
+              sad16[k], _mm256_abs_epi16(_mm256_sub_epi16(s, p)));
+        }
+      }
+      src += src_stride;
+      for (k = 0; k < 4; ++k) ref[k] += ref_stride;
+    }
+    for (k = 0; k < 4; ++k) {
+      sum[k] = _mm256_add_epi32(sum[k], highbd_sad_widen_avx2(sad16[k]));
+    }
+  }
+
+  {
+    // Reduce the four accumulators together: after the two hadd steps each
+    // 128-bit lane holds the partial sums of all four references in order.
+    const __m256i sum01 = _mm256_hadd_epi32(sum[0], sum[1]);
+    const __m256i sum23 = _mm256_hadd_epi32(sum[2], sum[3]);
+    const __m256i sum0123 = _mm256_hadd_epi32(sum01, sum23);
+    const __m128i res = _mm_add_epi32(_mm256_castsi256_si128(sum0123),
+                                      _mm256_extracti128_si256(sum0123, 1));
+    _mm_storeu_si128((__m128i *)sad_array, res);
+  }
+}
+
+#define HIGHBD_SADMXNX4D(m, n)                                               \
+  void vpx_highbd_sad##m##x##n##x4d_avx2(                                    \
+      const uint8_t *src_ptr, int src_stride,                                \
+      const uint8_t *const ref_array[], int ref_stride,                      \
+      uint32_t *sad_array) {                                                 \
+    highbd_sad_x4d_avx2(CONVERT_TO_SHORTPTR(src_ptr), src_stride, ref_array, \
+                        ref_stride, sad_array, m, n);                        \
+  }
+
+HIGHBD_SADMXNX4D(64, 64)
+HIGHBD_SADMXNX4D(64, 32)
+HIGHBD_SADMXNX4D(32, 64)
+HIGHBD_SADMXNX4D(32, 32)
+HIGHBD_SADMXNX4D(32, 16)
+HIGHBD_SADMXNX4D(16, 32)
+HIGHBD_SADMXNX4D(16, 16)
+HIGHBD_SADMXNX4D(16, 8)
+
+#undef HIGHBD_SADMXNX4D
@@ -0,0 +1,251 @@
+/*
+ *  Copyright (c) 2021 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./vpx_config.h"
+#include "./vpx_dsp_rtcd.h"
+#include "vpx_ports/mem.h"
+
+// Accumulates the sum and the sum of squares of the differences of 16 pixels.
+// The squares of up to 64 vectors of 12-bit differences fit in 32 bits, so
+// the callers widen the sse once per column of 16 pixels.
+static INLINE void highbd_variance_kernel_avx2(const __m256i src,
+                                               const __m256i ref,
+                                               __m256i *const sse,
+                                               __m256i *const sum) {
+  const __m256i one = _mm256_set1_epi16(1);
+  const __m256i diff = _mm256_sub_epi16(src, ref);
+  *sum = _mm256_add_epi32(*sum, _mm256_madd_epi16(diff, one));
+  *sse = _mm256_add_epi32(*sse, _mm256_madd_epi16(diff, diff));
+}
+
+static INLINE __m256i highbd_sse_to_64bit_avx2(const __m256i sse) {
+  const __m256i zero = _mm256_setzero_si256();
+  return _mm256_add_epi64(_mm256_unpacklo_epi32(sse, zero),
+                          _mm256_unpackhi_epi32(sse, zero));
+}
+
+static INLINE void highbd_variance_final_avx2(const __m256i vsse,
+                                              const __m256i vsum,
+                                              uint64_t *const sse,
+                                              int64_t *const sum) {
+  const __m128i sse128 = _mm_add_epi64(_mm256_castsi256_si128(vsse),
+                                       _mm256_extracti128_si256(vsse, 1));
+  const __m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(vsum),
+                                       _mm256_extracti128_si256(vsum, 1));
+  const __m128i sse64 = _mm_add_epi64(sse128, _mm_srli_si128(sse128, 8));
+  const __m128i sum64 = _mm_add_epi32(sum128, _mm_srli_si128(sum128, 8));
+  const __m128i sum32 = _mm_add_epi32(sum64, _mm_srli_si128(sum64, 4));
+  _mm_storel_epi64((__m128i *)sse, sse64);
+  *sum = _mm_cvtsi128_si32(sum32);
+}
+
+static INLINE void highbd_variance_avx2(const uint16_t *src, int src_stride,
+                                        const uint16_t *ref, int ref_stride,
+                                        int w, int h, uint64_t *sse,
+                                        int64_t *sum) {
+  __m256i vsse64 = _mm256_setzero_si256();
+  __m256i vsum = _mm256_setzero_si256();
+  int i, j;
+
+  if (w == 8) {
+    __m256i vsse = _mm256_setzero_si256();
+    for (i = 0; i < h; i += 2) {
+      const __m128i s0 = _mm_loadu_si128((const __m128i *)src);
+      const __m128i s1 = _mm_loadu_si128((const __m128i *)(src + src_stride));
+      const __m128i r0 = _mm_loadu_si128((const __m128i *)ref);
+      const __m128i r1 = _mm_loadu_si128((const __m128i *)(ref + ref_stride));
+      highbd_variance_kernel_avx2(
+          _mm256_inserti128_si256(_mm256_castsi128_si256(s0), s1, 1),
+          _mm256_inserti128_si256(_mm256_castsi128_si256(r0), r1, 1), &vsse,
+          &vsum);
+      src += 2 * src_stride;
+      ref += 2 * ref_stride;
+    }
+    vsse64 = highbd_sse_to_64bit_avx2(vsse);
+  } else {
+    for (j = 0; j < w; j += 16) {
+      __m256i vsse = _mm256_setzero_si256();
+      for (i = 0; i < h; ++i) {
+        highbd_variance_kernel_avx2(
+            _mm256_loadu_si256((const __m256i *)(src + i * src_stride + j)),
+            _mm256_loadu_si256((const __m256i *)(ref + i * ref_stride + j)),
+            &vsse, &vsum);
+      }
+      vsse64 = _mm256_add_epi64(vsse64, highbd_sse_to_64bit_avx2(vsse));
+    }
+  }
+  highbd_variance_final_avx2(vsse64, vsum, sse, sum);
+}
+
+// The bilinear taps are multiples of 16, so (a * f0 + b * f1 + 64) >> 7 with
+// f1 = 16 * offset is computed exactly in 16 bits as below, even for 12-bit
+// input.
+static INLINE __m256i highbd_bilinear_avx2(const __m256i a, const __m256i b,
+                                           const __m256i f0,
+                                           const __m256i f1) {
+  const __m256i round = _mm256_set1_epi16(4);
+  const __m256i sum =
+      _mm256_add_epi16(_mm256_mullo_epi16(a, f0), _mm256_mullo_epi16(b, f1));
+  return _mm256_srli_epi16(_mm256_add_epi16(sum, round), 3);
+}
+
+static INLINE __m256i highbd_filter_x_avx2(const uint16_t *src, int x_offset,
+                                           const __m256i f0,
+                                           const __m256i f1) {
+  const __m256i a = _mm256_loadu_si256((const __m256i *)src);
+  if (!x_offset) return a;
+  return highbd_bilinear_avx2(
+      a, _mm256_loadu_si256((const __m256i *)(src + 1)), f0, f1);
+}
+
+// Filters each column of 16 pixels horizontally and then vertically, keeping
+// the previous row in a register, and accumulates the variance against ref.
+// When second_pred is not NULL the filtered block is first averaged with it.
+static INLINE void highbd_subpel_variance_avx2(
+    const uint16_t *src, int src_stride, int x_offset, int y_offset,
+    const uint16_t *ref, int ref_stride, const uint16_t *second_pred, int w,
+    int h, uint64_t *sse, int64_t *sum) {
+  const __m256i fx0 = _mm256_set1_epi16(8 - x_offset);
+  const __m256i fx1 = _mm256_set1_epi16(x_offset);
+  const __m256i fy0 = _mm256_set1_epi16(8 - y_offset);
+  const __m256i fy1 = _mm256_set1_epi16(y_offset);
+  __m256i vsse64 = _mm256_setzero_si256();
+  __m256i vsum = _mm256_setzero_si256();
+  int i, j;
+
+  for (j = 0; j < w; j += 16) {
+    const uint16_t *s = src + j;
+    __m256i vsse = _mm256_setzero_si256();
+    __m256i prev = highbd_filter_x_avx2(s, x_offset, fx0, fx1);
+
+    for (i = 0; i < h; ++i) {
+      __m256i pred;
+      if (y_offset) {
+        const __m256i next =
+            highbd_filter_x_avx2(s + src_stride, x_offset, fx0, fx1);
+        pred = highbd_bilinear_avx2(prev, next, fy0, fy1);
+        prev = next;
+      } else {
+        pred = prev;
+        if (i + 1 < h) {
+          prev = highbd_filter_x_avx2(s + src_stride, x_offset, fx0, fx1);
+        }
+      }
+      if (second_pred != NULL) {
+        pred = _mm256_avg_epu16(
+            pred, _mm256_loadu_si256((const __m256i *)(second_pred + i * w)));
+      }
+      highbd_variance_kernel_avx2(
+          pred, _mm256_loadu_si256((const __m256i *)(ref + i * ref_stride)),
+          &vsse, &vsum);
+      s += src_stride;
+    }
+    vsse64 = _mm256_add_epi64(vsse64, highbd_sse_to_64bit_avx2(vsse));
+    ref += 16;
+    if (second_pred != NULL) second_pred += 16;
+  }
+  highbd_variance_final_avx2(vsse64, vsum, sse, sum);
+}
+
+static INLINE uint32_t highbd_8_variance_avx2(uint64_t sse_long,
+                                              int64_t sum_long, int shift,
+                                              uint32_t *sse) {
+  const int sum = (int)sum_long;
+  *sse = (uint32_t)sse_long;
+  return *sse - (uint32_t)(((int64_t)sum * sum) >> shift);
+}
+
+static INLINE uint32_t highbd_10_variance_avx2(uint64_t sse_long,
+                                               int64_t sum_long, int shift,
+                                               uint32_t *sse) {
+  const int sum = (int)ROUND_POWER_OF_TWO(sum_long, 2);
+  int64_t var;
+  *sse = (uint32_t)ROUND_POWER_OF_TWO(sse_long, 4);
+  var = (int64_t)(*sse) - (((int64_t)sum * sum) >> shift);
+  return (var >= 0) ? (uint32_t)var : 0;
+}
+
+static INLINE uint32_t highbd_12_variance_avx2(uint64_t sse_long,
+                                               int64_t sum_long, int shift,
+                                               uint32_t *sse) {
+  const int sum = (int)ROUND_POWER_OF_TWO(sum_long, 4);
+  int64_t var;
+  *sse = (uint32_t)ROUND_POWER_OF_TWO(sse_long, 8);
+  var = (int64_t)(*sse) - (((int64_t)sum * sum) >> shift);
+  return (var >= 0) ? (uint32_t)var : 0;
+}
+
+#define VAR_FN(bd, w, h, shift)                                             \
+  uint32_t vpx_highbd_##bd##_variance##w##x##h##_avx2(                      \
+      const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr,       \
+      int ref_stride, uint32_t *sse) {                                      \
+    uint64_t sse_long;                                                      \
+    int64_t sum_long;                                                       \
+    highbd_variance_avx2(CONVERT_TO_SHORTPTR(src_ptr), src_stride,          \
+                         CONVERT_TO_SHORTPTR(ref_ptr), ref_stride, w, h,    \
+                         &sse_long, &sum_long);                             \
+    return highbd_##bd##_variance_avx2(sse_long, sum_long, shift, sse);     \
+  }
+
+#define SUBPIX_VAR_FN(bd, w, h, shift)                                      \
+  uint32_t vpx_highbd_##bd##_sub_pixel_variance##w##x##h##_avx2(            \
+      const uint8_t *src_ptr, int src_stride, int x_offset, int y_offset,   \
+      const uint8_t *ref_ptr, int ref_stride, uint32_t *sse) {              \
+    uint64_t sse_long;                                                      \
+    int64_t sum_long;                                                       \
+    highbd_subpel_variance_avx2(CONVERT_TO_SHORTPTR(src_ptr), src_stride,   \
+                                x_offset, y_offset,                         \
+                                CONVERT_TO_SHORTPTR(ref_ptr), ref_stride,   \
+                                NULL, w, h, &sse_long, &sum_long);          \
+    return highbd_##bd##_variance_avx2(sse_long, sum_long, shift, sse);     \
+  }                                                                         \
+                                                                            \
+  uint32_t vpx_highbd_##bd##_sub_pixel_avg_variance##w##x##h##_avx2(        \
+      const uint8_t *src_ptr, int src_stride, int x_offset, int y_offset,   \
+      const uint8_t *ref_ptr, int ref_stride, uint32_t *sse,                \
+      const uint8_t *second_pred) {                                         \
+    uint64_t sse_long;                                                      \
+    int64_t sum_long;                                                       \
+    highbd_subpel_variance_avx2(                                            \
+        CONVERT_TO_SHORTPTR(src_ptr), src_stride, x_offset, y_offset,       \
+        CONVERT_TO_SHORTPTR(ref_ptr), ref_stride,                           \
+        CONVERT_TO_SHORTPTR(second_pred), w, h, &sse_long, &sum_long);      \
+    return highbd_##bd##_variance_avx2(sse_long, sum_long, shift, sse);     \
+  }
+
+#define VAR_FNS(bd)              \
+  VAR_FN(bd, 64, 64, 12)         \
+  VAR_FN(bd, 64, 32, 11)         \
+  VAR_FN(bd, 32, 64, 11)         \
+  VAR_FN(bd, 32, 32, 10)         \
+  VAR_FN(bd, 32, 16, 9)          \
+  VAR_FN(bd, 16, 32, 9)          \
+  VAR_FN(bd, 16, 16, 8)          \
+  VAR_FN(bd, 16, 8, 7)           \
+  VAR_FN(bd, 8, 16, 7)           \
+  VAR_FN(bd, 8, 8, 6)            \
+  SUBPIX_VAR_FN(bd, 64, 64, 12)  \
+  SUBPIX_VAR_FN(bd, 64, 32, 11)  \
+  SUBPIX_VAR_FN(bd, 32, 64, 11)  \
+  SUBPIX_VAR_FN(bd, 32, 32, 10)  \
+  SUBPIX_VAR_FN(bd, 32, 16, 9)   \
+  SUBPIX_VAR_FN(bd, 16, 32, 9)   \
+  SUBPIX_VAR_FN(bd, 16, 16, 8)   \
+  SUBPIX_VAR_FN(bd, 16, 8, 7)
+
+VAR_FNS(8)
+VAR_FNS(10)
+VAR_FNS(12)
+
+#undef VAR_FNS
+#undef SUBPIX_VAR_FN
+#undef VAR_FN
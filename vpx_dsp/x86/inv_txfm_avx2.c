@@ -0,0 +1,1178 @@
+/*
+ *  Copyright (c) 2021 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./vpx_dsp_rtcd.h"
+#include "vpx_dsp/x86/inv_txfm_avx2.h"
+
+void vpx_idct16x16_256_add_avx2(const tran_low_t *input, uint8_t *dest,
+                                int stride) {
+  __m256i io[16];
+  int i;
+
+  load_transpose_16bit_16x16_avx2(input, 16, io);
+  idct16_16col_avx2(io, io);
+  transpose_16bit_16x16_avx2(io, io);
+  idct16_16col_avx2(io, io);
+
+  for (i = 0; i < 16; ++i) {
+    write_buffer_16x1_avx2(dest + i * stride, io[i]);
+  }
+}
+
+// Only the first 8 inputs of each 16 point idct are non-zero.
+static INLINE void idct16x16_38_16col_avx2(const __m256i *const in /*in[16]*/,
+                                           __m256i *const out /*out[16]*/) {
+  __m256i step1[16], step2[16];
+
+  // stage 2
+  partial_butterfly_avx2(in[1], cospi_30_64, cospi_2_64, &step2[8],
+                         &step2[15]);
+  partial_butterfly_avx2(in[7], -cospi_18_64, cospi_14_64, &step2[9],
+                         &step2[14]);
+  partial_butterfly_avx2(in[5], cospi_22_64, cospi_10_64, &step2[10],
+                         &step2[13]);
+  partial_butterfly_avx2(in[3], -cospi_26_64, cospi_6_64, &step2[11],
+                         &step2[12]);
+
+  // stage 3
+  partial_butterfly_avx2(in[2], cospi_28_64, cospi_4_64, &step1[4], &step1[7]);
+  partial_butterfly_avx2(in[6], -cospi_20_64, cospi_12_64, &step1[5],
+                         &step1[6]);
+  step1[8] = _mm256_add_epi16(step2[8], step2[9]);
+  step1[9] = _mm256_sub_epi16(step2[8], step2[9]);
+  step1[10] = _mm256_sub_epi16(step2[11], step2[10]);
+  step1[11] = _mm256_add_epi16(step2[10], step2[11]);
+  step1[12] = _mm256_add_epi16(step2[12], step2[13]);
+  step1[13] = _mm256_sub_epi16(step2[12], step2[13]);
+  step1[14] = _mm256_sub_epi16(step2[15], step2[14]);
+  step1[15] = _mm256_add_epi16(step2[14], step2[15]);
+
+  // stage 4
+  step2[0] = partial_butterfly_cospi16_avx2(in[0]);
+  step2[1] = step2[0];
+  partial_butterfly_avx2(in[4], cospi_24_64, cospi_8_64, &step2[2], &step2[3]);
+  idct16_16col_stage_4_to_7_avx2(step1, step2, out);
+}
+
+void vpx_idct16x16_38_add_avx2(const tran_low_t *input, uint8_t *dest,
+                               int stride) {
+  __m256i io[16];
+  int i;
+
+  // Only the top left 8x8 block has non-zero coefficients.
+  for (i = 0; i < 8; ++i) io[i] = load_input_data16_avx2(input + i * 16);
+  transpose_16bit_2x8x8_avx2(io, io);
+  idct16x16_38_16col_avx2(io, io);
+  transpose_16bit_16x8_avx2(io, io);
+  idct16x16_38_16col_avx2(io, io);
+
+  for (i = 0; i < 16; ++i) {
+    write_buffer_16x1_avx2(dest + i * stride, io[i]);
+  }
+}
+
+// Only the first 4 inputs of each 16 point idct are non-zero.
+static INLINE void idct16x16_10_16col_avx2(const __m256i *const in /*in[16]*/,
+                                           __m256i *const out /*out[16]*/) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i step1[16], step2[16];
+
+  // stage 2
+  partial_butterfly_avx2(in[1], cospi_30_64, cospi_2_64, &step2[8],
+                         &step2[15]);
+  partial_butterfly_avx2(in[3], -cospi_26_64, cospi_6_64, &step2[11],
+                         &step2[12]);
+
+  // stage 3
+  partial_butterfly_avx2(in[2], cospi_28_64, cospi_4_64, &step1[4], &step1[7]);
+  step1[5] = zero;
+  step1[6] = zero;
+  step1[8] = step2[8];
+  step1[9] = step2[8];
+  step1[10] = step2[11];
+  step1[11] = step2[11];
+  step1[12] = step2[12];
+  step1[13] = step2[12];
+  step1[14] = step2[15];
+  step1[15] = step2[15];
+
+  // stage 4
+  step2[0] = partial_butterfly_cospi16_avx2(in[0]);
+  step2[1] = step2[0];
+  step2[2] = zero;
+  step2[3] = zero;
+  idct16_16col_stage_4_to_7_avx2(step1, step2, out);
+}
+
+void vpx_idct16x16_10_add_avx2(const tran_low_t *input, uint8_t *dest,
+                               int stride) {
+  __m256i io[16];
+  int i;
+
+  // Only the top left 4x4 block has non-zero coefficients.
+  for (i = 0; i < 4; ++i) io[i] = load_input_data16_avx2(input + i * 16);
+  for (i = 4; i < 8; ++i) io[i] = _mm256_setzero_si256();
+  transpose_16bit_2x8x8_avx2(io, io);
+  idct16x16_10_16col_avx2(io, io);
+  transpose_16bit_16x8_avx2(io, io);
+  idct16x16_10_16col_avx2(io, io);
+
+  for (i = 0; i < 16; ++i) {
+    write_buffer_16x1_avx2(dest + i * stride, io[i]);
+  }
+}
+
+// Add dc_value to two rows of 16 pixels.
+static INLINE void recon_and_store_16x2_avx2(uint8_t *const dest,
+                                             const int stride,
+                                             const __m256i dc_value) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m128i d0 = _mm_loadu_si128((const __m128i *)dest);
+  const __m128i d1 = _mm_loadu_si128((const __m128i *)(dest + stride));
+  __m256i d, lo, hi;
+
+  d = _mm256_inserti128_si256(_mm256_castsi128_si256(d0), d1, 1);
+  lo = _mm256_add_epi16(_mm256_unpacklo_epi8(d, zero), dc_value);
+  hi = _mm256_add_epi16(_mm256_unpackhi_epi8(d, zero), dc_value);
+  d = _mm256_packus_epi16(lo, hi);
+  _mm_storeu_si128((__m128i *)dest, _mm256_castsi256_si128(d));
+  _mm_storeu_si128((__m128i *)(dest + stride), _mm256_extracti128_si256(d, 1));
+}
+
+// Add dc_value to one row of 32 pixels.
+static INLINE void recon_and_store_32_avx2(uint8_t *const dest,
+                                           const __m256i dc_value) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i d, lo, hi;
+
+  d = _mm256_loadu_si256((const __m256i *)dest);
+  lo = _mm256_add_epi16(_mm256_unpacklo_epi8(d, zero), dc_value);
+  hi = _mm256_add_epi16(_mm256_unpackhi_epi8(d, zero), dc_value);
+  _mm256_storeu_si256((__m256i *)dest, _mm256_packus_epi16(lo, hi));
+}
+
+void vpx_idct16x16_1_add_avx2(const tran_low_t *input, uint8_t *dest,
+                              int stride) {
+  __m256i dc_value;
+  int i;
+  tran_high_t a1;
+  tran_low_t out =
+      WRAPLOW(dct_const_round_shift((int16_t)input[0] * cospi_16_64));
+
+  out = WRAPLOW(dct_const_round_shift(out * cospi_16_64));
+  a1 = ROUND_POWER_OF_TWO(out, 6);
+  dc_value = _mm256_set1_epi16((int16_t)a1);
+
+  for (i = 0; i < 16; i += 2) {
+    recon_and_store_16x2_avx2(dest, stride, dc_value);
+    dest += 2 * stride;
+  }
+}
+
+void vpx_iadst16_16col_avx2(__m256i *const in) {
+  // perform 16x16 1-D ADST for 16 columns
+  __m256i s[16], x[16], u[32], v[32];
+  const __m256i k__cospi_p01_p31 = pair_set_epi16_avx2(cospi_1_64, cospi_31_64);
+  const __m256i k__cospi_p31_m01 =
+      pair_set_epi16_avx2(cospi_31_64, -cospi_1_64);
+  const __m256i k__cospi_p05_p27 = pair_set_epi16_avx2(cospi_5_64, cospi_27_64);
+  const __m256i k__cospi_p27_m05 =
+      pair_set_epi16_avx2(cospi_27_64, -cospi_5_64);
+  const __m256i k__cospi_p09_p23 = pair_set_epi16_avx2(cospi_9_64, cospi_23_64);
+  const __m256i k__cospi_p23_m09 =
+      pair_set_epi16_avx2(cospi_23_64, -cospi_9_64);
+  const __m256i k__cospi_p13_p19 =
+      pair_set_epi16_avx2(cospi_13_64, cospi_19_64);
+  const __m256i k__cospi_p19_m13 =
+      pair_set_epi16_avx2(cospi_19_64, -cospi_13_64);
+  const __m256i k__cospi_p17_p15 =
+      pair_set_epi16_avx2(cospi_17_64, cospi_15_64);
+  const __m256i k__cospi_p15_m17 =
+      pair_set_epi16_avx2(cospi_15_64, -cospi_17_64);
+  const __m256i k__cospi_p21_p11 =
+      pair_set_epi16_avx2(cospi_21_64, cospi_11_64);
+  const __m256i k__cospi_p11_m21 =
+      pair_set_epi16_avx2(cospi_11_64, -cospi_21_64);
+  const __m256i k__cospi_p25_p07 = pair_set_epi16_avx2(cospi_25_64, cospi_7_64);
+  const __m256i k__cospi_p07_m25 =
+      pair_set_epi16_avx2(cospi_7_64, -cospi_25_64);
+  const __m256i k__cospi_p29_p03 = pair_set_epi16_avx2(cospi_29_64, cospi_3_64);
+  const __m256i k__cospi_p03_m29 =
+      pair_set_epi16_avx2(cospi_3_64, -cospi_29_64);
+  const __m256i k__cospi_p04_p28 = pair_set_epi16_avx2(cospi_4_64, cospi_28_64);
+  const __m256i k__cospi_p28_m04 =
+      pair_set_epi16_avx2(cospi_28_64, -cospi_4_64);
+  const __m256i k__cospi_p20_p12 =
+      pair_set_epi16_avx2(cospi_20_64, cospi_12_64);
+  const __m256i k__cospi_p12_m20 =
+      pair_set_epi16_avx2(cospi_12_64, -cospi_20_64);
+  const __m256i k__cospi_m28_p04 =
+      pair_set_epi16_avx2(-cospi_28_64, cospi_4_64);
+  const __m256i k__cospi_m12_p20 =
+      pair_set_epi16_avx2(-cospi_12_64, cospi_20_64);
+  const __m256i k__cospi_p08_p24 = pair_set_epi16_avx2(cospi_8_64, cospi_24_64);
+  const __m256i k__cospi_p24_m08 =
+      pair_set_epi16_avx2(cospi_24_64, -cospi_8_64);
+  const __m256i k__cospi_m24_p08 =
+      pair_set_epi16_avx2(-cospi_24_64, cospi_8_64);
+  const __m256i k__cospi_m16_m16 = _mm256_set1_epi16(-cospi_16_64);
+  const __m256i k__cospi_p16_p16 = _mm256_set1_epi16(cospi_16_64);
+  const __m256i k__cospi_p16_m16 =
+      pair_set_epi16_avx2(cospi_16_64, -cospi_16_64);
+  const __m256i k__cospi_m16_p16 =
+      pair_set_epi16_avx2(-cospi_16_64, cospi_16_64);
+  const __m256i kZero = _mm256_set1_epi16(0);
+
+  u[0] = _mm256_unpacklo_epi16(in[15], in[0]);
+  u[1] = _mm256_unpackhi_epi16(in[15], in[0]);
+  u[2] = _mm256_unpacklo_epi16(in[13], in[2]);
+  u[3] = _mm256_unpackhi_epi16(in[13], in[2]);
+  u[4] = _mm256_unpacklo_epi16(in[11], in[4]);
+  u[5] = _mm256_unpackhi_epi16(in[11], in[4]);
+  u[6] = _mm256_unpacklo_epi16(in[9], in[6]);
+  u[7] = _mm256_unpackhi_epi16(in[9], in[6]);
+  u[8] = _mm256_unpacklo_epi16(in[7], in[8]);
+  u[9] = _mm256_unpackhi_epi16(in[7], in[8]);
+  u[10] = _mm256_unpacklo_epi16(in[5], in[10]);
+  u[11] = _mm256_unpackhi_epi16(in[5], in[10]);
+  u[12] = _mm256_unpacklo_epi16(in[3], in[12]);
+  u[13] = _mm256_unpackhi_epi16(in[3], in[12]);
+  u[14] = _mm256_unpacklo_epi16(in[1], in[14]);
+  u[15] = _mm256_unpackhi_epi16(in[1], in[14]);
+
+  v[0] = _mm256_madd_epi16(u[0], k__cospi_p01_p31);
+  v[1] = _mm256_madd_epi16(u[1], k__cospi_p01_p31);
+  v[2] = _mm256_madd_epi16(u[0], k__cospi_p31_m01);
+  v[3] = _mm256_madd_epi16(u[1], k__cospi_p31_m01);
+  v[4] = _mm256_madd_epi16(u[2], k__cospi_p05_p27);
+  v[5] = _mm256_madd_epi16(u[3], k__cospi_p05_p27);
+  v[6] = _mm256_madd_epi16(u[2], k__cospi_p27_m05);
+  v[7] = _mm256_madd_epi16(u[3], k__cospi_p27_m05);
+  v[8] = _mm256_madd_epi16(u[4], k__cospi_p09_p23);
+  v[9] = _mm256_madd_epi16(u[5], k__cospi_p09_p23);
+  v[10] = _mm256_madd_epi16(u[4], k__cospi_p23_m09);
+  v[11] = _mm256_madd_epi16(u[5], k__cospi_p23_m09);
+  v[12] = _mm256_madd_epi16(u[6], k__cospi_p13_p19);
+  v[13] = _mm256_madd_epi16(u[7], k__cospi_p13_p19);
+  v[14] = _mm256_madd_epi16(u[6], k__cospi_p19_m13);
+  v[15] = _mm256_madd_epi16(u[7], k__cospi_p19_m13);
+  v[16] = _mm256_madd_epi16(u[8], k__cospi_p17_p15);
+  v[17] = _mm256_madd_epi16(u[9], k__cospi_p17_p15);
+  v[18] = _mm256_madd_epi16(u[8], k__cospi_p15_m17);
+  v[19] = _mm256_madd_epi16(u[9], k__cospi_p15_m17);
+  v[20] = _mm256_madd_epi16(u[10], k__cospi_p21_p11);
+  v[21] = _mm256_madd_epi16(u[11], k__cospi_p21_p11);
+  v[22] = _mm256_madd_epi16(u[10], k__cospi_p11_m21);
+  v[23] = _mm256_madd_epi16(u[11], k__cospi_p11_m21);
+  v[24] = _mm256_madd_epi16(u[12], k__cospi_p25_p07);
+  v[25] = _mm256_madd_epi16(u[13], k__cospi_p25_p07);
+  v[26] = _mm256_madd_epi16(u[12], k__cospi_p07_m25);
+  v[27] = _mm256_madd_epi16(u[13], k__cospi_p07_m25);
+  v[28] = _mm256_madd_epi16(u[14], k__cospi_p29_p03);
+  v[29] = _mm256_madd_epi16(u[15], k__cospi_p29_p03);
+  v[30] = _mm256_madd_epi16(u[14], k__cospi_p03_m29);
+  v[31] = _mm256_madd_epi16(u[15], k__cospi_p03_m29);
+
+  u[0] = _mm256_add_epi32(v[0], v[16]);
+  u[1] = _mm256_add_epi32(v[1], v[17]);
+  u[2] = _mm256_add_epi32(v[2], v[18]);
+  u[3] = _mm256_add_epi32(v[3], v[19]);
+  u[4] = _mm256_add_epi32(v[4], v[20]);
+  u[5] = _mm256_add_epi32(v[5], v[21]);
+  u[6] = _mm256_add_epi32(v[6], v[22]);
+  u[7] = _mm256_add_epi32(v[7], v[23]);
+  u[8] = _mm256_add_epi32(v[8], v[24]);
+  u[9] = _mm256_add_epi32(v[9], v[25]);
+  u[10] = _mm256_add_epi32(v[10], v[26]);
+  u[11] = _mm256_add_epi32(v[11], v[27]);
+  u[12] = _mm256_add_epi32(v[12], v[28]);
+  u[13] = _mm256_add_epi32(v[13], v[29]);
+  u[14] = _mm256_add_epi32(v[14], v[30]);
+  u[15] = _mm256_add_epi32(v[15], v[31]);
+  u[16] = _mm256_sub_epi32(v[0], v[16]);
+  u[17] = _mm256_sub_epi32(v[1], v[17]);
+  u[18] = _mm256_sub_epi32(v[2], v[18]);
+  u[19] = _mm256_sub_epi32(v[3], v[19]);
+  u[20] = _mm256_sub_epi32(v[4], v[20]);
+  u[21] = _mm256_sub_epi32(v[5], v[21]);
+  u[22] = _mm256_sub_epi32(v[6], v[22]);
+  u[23] = _mm256_sub_epi32(v[7], v[23]);
+  u[24] = _mm256_sub_epi32(v[8], v[24]);
+  u[25] = _mm256_sub_epi32(v[9], v[25]);
+  u[26] = _mm256_sub_epi32(v[10], v[26]);
+  u[27] = _mm256_sub_epi32(v[11], v[27]);
+  u[28] = _mm256_sub_epi32(v[12], v[28]);
+  u[29] = _mm256_sub_epi32(v[13], v[29]);
+  u[30] = _mm256_sub_epi32(v[14], v[30]);
+  u[31] = _mm256_sub_epi32(v[15], v[31]);
+
+  u[0] = dct_const_round_shift_avx2(u[0]);
+  u[1] = dct_const_round_shift_avx2(u[1]);
+  u[2] = dct_const_round_shift_avx2(u[2]);
+  u[3] = dct_const_round_shift_avx2(u[3]);
+  u[4] = dct_const_round_shift_avx2(u[4]);
+  u[5] = dct_const_round_shift_avx2(u[5]);
+  u[6] = dct_const_round_shift_avx2(u[6]);
+  u[7] = dct_const_round_shift_avx2(u[7]);
+  u[8] = dct_const_round_shift_avx2(u[8]);
+  u[9] = dct_const_round_shift_avx2(u[9]);
+  u[10] = dct_const_round_shift_avx2(u[10]);
+  u[11] = dct_const_round_shift_avx2(u[11]);
+  u[12] = dct_const_round_shift_avx2(u[12]);
+  u[13] = dct_const_round_shift_avx2(u[13]);
+  u[14] = dct_const_round_shift_avx2(u[14]);
+  u[15] = dct_const_round_shift_avx2(u[15]);
+  u[16] = dct_const_round_shift_avx2(u[16]);
+  u[17] = dct_const_round_shift_avx2(u[17]);
+  u[18] = dct_const_round_shift_avx2(u[18]);
+  u[19] = dct_const_round_shift_avx2(u[19]);
+  u[20] = dct_const_round_shift_avx2(u[20]);
+  u[21] = dct_const_round_shift_avx2(u[21]);
+  u[22] = dct_const_round_shift_avx2(u[22]);
+  u[23] = dct_const_round_shift_avx2(u[23]);
+  u[24] = dct_const_round_shift_avx2(u[24]);
+  u[25] = dct_const_round_shift_avx2(u[25]);
+  u[26] = dct_const_round_shift_avx2(u[26]);
+  u[27] = dct_const_round_shift_avx2(u[27]);
+  u[28] = dct_const_round_shift_avx2(u[28]);
+  u[29] = dct_const_round_shift_avx2(u[29]);
+  u[30] = dct_const_round_shift_avx2(u[30]);
+  u[31] = dct_const_round_shift_avx2(u[31]);
+
+  s[0] = _mm256_packs_epi32(u[0], u[1]);
+  s[1] = _mm256_packs_epi32(u[2], u[3]);
+  s[2] = _mm256_packs_epi32(u[4], u[5]);
+  s[3] = _mm256_packs_epi32(u[6], u[7]);
+  s[4] = _mm256_packs_epi32(u[8], u[9]);
+  s[5] = _mm256_packs_epi32(u[10], u[11]);
+  s[6] = _mm256_packs_epi32(u[12], u[13]);
+  s[7] = _mm256_packs_epi32(u[14], u[15]);
+  s[8] = _mm256_packs_epi32(u[16], u[17]);
+  s[9] = _mm256_packs_epi32(u[18], u[19]);
+  s[10] = _mm256_packs_epi32(u[20], u[21]);
+  s[11] = _mm256_packs_epi32(u[22], u[23]);
+  s[12] = _mm256_packs_epi32(u[24], u[25]);
+  s[13] = _mm256_packs_epi32(u[26], u[27]);
+  s[14] = _mm256_packs_epi32(u[28], u[29]);
+  s[15] = _mm256_packs_epi32(u[30], u[31]);
+
+  // stage 2
+  u[0] = _mm256_unpacklo_epi16(s[8], s[9]);
+  u[1] = _mm256_unpackhi_epi16(s[8], s[9]);
+  u[2] = _mm256_unpacklo_epi16(s[10], s[11]);
+  u[3] = _mm256_unpackhi_epi16(s[10], s[11]);
+  u[4] = _mm256_unpacklo_epi16(s[12], s[13]);
+  u[5] = _mm256_unpackhi_epi16(s[12], s[13]);
+  u[6] = _mm256_unpacklo_epi16(s[14], s[15]);
+  u[7] = _mm256_unpackhi_epi16(s[14], s[15]);
+
+  v[0] = _mm256_madd_epi16(u[0], k__cospi_p04_p28);
+  v[1] = _mm256_madd_epi16(u[1], k__cospi_p04_p28);
+  v[2] = _mm256_madd_epi16(u[0], k__cospi_p28_m04);
+  v[3] = _mm256_madd_epi16(u[1], k__cospi_p28_m04);
+  v[4] = _mm256_madd_epi16(u[2], k__cospi_p20_p12);
+  v[5] = _mm256_madd_epi16(u[3], k__cospi_p20_p12);
+  v[6] = _mm256_madd_epi16(u[2], k__cospi_p12_m20);
+  v[7] = _mm256_madd_epi16(u[3], k__cospi_p12_m20);
+  v[8] = _mm256_madd_epi16(u[4], k__cospi_m28_p04);
+  v[9] = _mm256_madd_epi16(u[5], k__cospi_m28_p04);
+  v[10] = _mm256_madd_epi16(u[4], k__cospi_p04_p28);
+  v[11] = _mm256_madd_epi16(u[5], k__cospi_p04_p28);
+  v[12] = _mm256_madd_epi16(u[6], k__cospi_m12_p20);
+  v[13] = _mm256_madd_epi16(u[7], k__cospi_m12_p20);
+  v[14] = _mm256_madd_epi16(u[6], k__cospi_p20_p12);
+  v[15] = _mm256_madd_epi16(u[7], k__cospi_p20_p12);
+
+  u[0] = _mm256_add_epi32(v[0], v[8]);
+  u[1] = _mm256_add_epi32(v[1], v[9]);
+  u[2] = _mm256_add_epi32(v[2], v[10]);
+  u[3] = _mm256_add_epi32(v[3], v[11]);
+  u[4] = _mm256_add_epi32(v[4], v[12]);
+  u[5] = _mm256_add_epi32(v[5], v[13]);
+  u[6] = _mm256_add_epi32(v[6], v[14]);
+  u[7] = _mm256_add_epi32(v[7], v[15]);
+  u[8] = _mm256_sub_epi32(v[0], v[8]);
+  u[9] = _mm256_sub_epi32(v[1], v[9]);
+  u[10] = _mm256_sub_epi32(v[2], v[10]);
+  u[11] = _mm256_sub_epi32(v[3], v[11]);
+  u[12] = _mm256_sub_epi32(v[4], v[12]);
+  u[13] = _mm256_sub_epi32(v[5], v[13]);
+  u[14] = _mm256_sub_epi32(v[6], v[14]);
+  u[15] = _mm256_sub_epi32(v[7], v[15]);
+
+  u[0] = dct_const_round_shift_avx2(u[0]);
+  u[1] = dct_const_round_shift_avx2(u[1]);
+  u[2] = dct_const_round_shift_avx2(u[2]);
+  u[3] = dct_const_round_shift_avx2(u[3]);
+  u[4] = dct_const_round_shift_avx2(u[4]);
+  u[5] = dct_const_round_shift_avx2(u[5]);
+  u[6] = dct_const_round_shift_avx2(u[6]);
+  u[7] = dct_const_round_shift_avx2(u[7]);
+  u[8] = dct_const_round_shift_avx2(u[8]);
+  u[9] = dct_const_round_shift_avx2(u[9]);
+  u[10] = dct_const_round_shift_avx2(u[10]);
+  u[11] = dct_const_round_shift_avx2(u[11]);
+  u[12] = dct_const_round_shift_avx2(u[12]);
+  u[13] = dct_const_round_shift_avx2(u[13]);
+  u[14] = dct_const_round_shift_avx2(u[14]);
+  u[15] = dct_const_round_shift_avx2(u[15]);
+
+  x[0] = _mm256_add_epi16(s[0], s[4]);
+  x[1] = _mm256_add_epi16(s[1], s[5]);
+  x[2] = _mm256_add_epi16(s[2], s[6]);
+  x[3] = _mm256_add_epi16(s[3], s[7]);
+  x[4] = _mm256_sub_epi16(s[0], s[4]);
+  x[5] = _mm256_sub_epi16(s[1], s[5]);
+  x[6] = _mm256_sub_epi16(s[2], s[6]);
+  x[7] = _mm256_sub_epi16(s[3], s[7]);
+  x[8] = _mm256_packs_epi32(u[0], u[1]);
+  x[9] = _mm256_packs_epi32(u[2], u[3]);
+  x[10] = _mm256_packs_epi32(u[4], u[5]);
+  x[11] = _mm256_packs_epi32(u[6], u[7]);
+  x[12] = _mm256_packs_epi32(u[8], u[9]);
+  x[13] = _mm256_packs_epi32(u[10], u[11]);
+  x[14] = _mm256_packs_epi32(u[12], u[13]);
+  x[15] = _mm256_packs_epi32(u[14], u[15]);
+
+  // stage 3
+  u[0] = _mm256_unpacklo_epi16(x[4], x[5]);
+  u[1] = _mm256_unpackhi_epi16(x[4], x[5]);
+  u[2] = _mm256_unpacklo_epi16(x[6], x[7]);
+  u[3] = _mm256_unpackhi_epi16(x[6], x[7]);
+  u[4] = _mm256_unpacklo_epi16(x[12], x[13]);
+  u[5] = _mm256_unpackhi_epi16(x[12], x[13]);
+  u[6] = _mm256_unpacklo_epi16(x[14], x[15]);
+  u[7] = _mm256_unpackhi_epi16(x[14], x[15]);
+
+  v[0] = _mm256_madd_epi16(u[0], k__cospi_p08_p24);
+  v[1] = _mm256_madd_epi16(u[1], k__cospi_p08_p24);
+  v[2] = _mm256_madd_epi16(u[0], k__cospi_p24_m08);
+  v[3] = _mm256_madd_epi16(u[1], k__cospi_p24_m08);
+  v[4] = _mm256_madd_epi16(u[2], k__cospi_m24_p08);
+  v[5] = _mm256_madd_epi16(u[3], k__cospi_m24_p08);
+  v[6] = _mm256_madd_epi16(u[2], k__cospi_p08_p24);
+  v[7] = _mm256_madd_epi16(u[3], k__cospi_p08_p24);
+  v[8] = _mm256_madd_epi16(u[4], k__cospi_p08_p24);
+  v[9] = _mm256_madd_epi16(u[5], k__cospi_p08_p24);
+  v[10] = _mm256_madd_epi16(u[4], k__cospi_p24_m08);
+  v[11] = _mm256_madd_epi16(u[5], k__cospi_p24_m08);
+  v[12] = _mm256_madd_epi16(u[6], k__cospi_m24_p08);
+  v[13] = _mm256_madd_epi16(u[7], k__cospi_m24_p08);
+  v[14] = _mm256_madd_epi16(u[6], k__cospi_p08_p24);
+  v[15] = _mm256_madd_epi16(u[7], k__cospi_p08_p24);
+
+  u[0] = _mm256_add_epi32(v[0], v[4]);
+  u[1] = _mm256_add_epi32(v[1], v[5]);
+  u[2] = _mm256_add_epi32(v[2], v[6]);
+  u[3] = _mm256_add_epi32(v[3], v[7]);
+  u[4] = _mm256_sub_epi32(v[0], v[4]);
+  u[5] = _mm256_sub_epi32(v[1], v[5]);
+  u[6] = _mm256_sub_epi32(v[2], v[6]);
+  u[7] = _mm256_sub_epi32(v[3], v[7]);
+  u[8] = _mm256_add_epi32(v[8], v[12]);
+  u[9] = _mm256_add_epi32(v[9], v[13]);
+  u[10] = _mm256_add_epi32(v[10], v[14]);
+  u[11] = _mm256_add_epi32(v[11], v[15]);
+  u[12] = _mm256_sub_epi32(v[8], v[12]);
+  u[13] = _mm256_sub_epi32(v[9], v[13]);
+  u[14] = _mm256_sub_epi32(v[10], v[14]);
+  u[15] = _mm256_sub_epi32(v[11], v[15]);
+
+  v[0] = dct_const_round_shift_avx2(u[0]);
+  v[1] = dct_const_round_shift_avx2(u[1]);
+  v[2] = dct_const_round_shift_avx2(u[2]);
+  v[3] = dct_const_round_shift_avx2(u[3]);
+  v[4] = dct_const_round_shift_avx2(u[4]);
+  v[5] = dct_const_round_shift_avx2(u[5]);
+  v[6] = dct_const_round_shift_avx2(u[6]);
+  v[7] = dct_const_round_shift_avx2(u[7]);
+  v[8] = dct_const_round_shift_avx2(u[8]);
+  v[9] = dct_const_round_shift_avx2(u[9]);
+  v[10] = dct_const_round_shift_avx2(u[10]);
+  v[11] = dct_const_round_shift_avx2(u[11]);
+  v[12] = dct_const_round_shift_avx2(u[12]);
+  v[13] = dct_const_round_shift_avx2(u[13]);
+  v[14] = dct_const_round_shift_avx2(u[14]);
+  v[15] = dct_const_round_shift_avx2(u[15]);
+
+  s[0] = _mm256_add_epi16(x[0], x[2]);
+  s[1] = _mm256_add_epi16(x[1], x[3]);
+  s[2] = _mm256_sub_epi16(x[0], x[2]);
+  s[3] = _mm256_sub_epi16(x[1], x[3]);
+  s[4] = _mm256_packs_epi32(v[0], v[1]);
+  s[5] = _mm256_packs_epi32(v[2], v[3]);
+  s[6] = _mm256_packs_epi32(v[4], v[5]);
+  s[7] = _mm256_packs_epi32(v[6], v[7]);
+  s[8] = _mm256_add_epi16(x[8], x[10]);
+  s[9] = _mm256_add_epi16(x[9], x[11]);
+  s[10] = _mm256_sub_epi16(x[8], x[10]);
+  s[11] = _mm256_sub_epi16(x[9], x[11]);
+  s[12] = _mm256_packs_epi32(v[8], v[9]);
+  s[13] = _mm256_packs_epi32(v[10], v[11]);
+  s[14] = _mm256_packs_epi32(v[12], v[13]);
+  s[15] = _mm256_packs_epi32(v[14], v[15]);
+
+  // stage 4
+  u[0] = _mm256_unpacklo_epi16(s[2], s[3]);
+  u[1] = _mm256_unpackhi_epi16(s[2], s[3]);
+  u[2] = _mm256_unpacklo_epi16(s[6], s[7]);
+  u[3] = _mm256_unpackhi_epi16(s[6], s[7]);
+  u[4] = _mm256_unpacklo_epi16(s[10], s[11]);
+  u[5] = _mm256_unpackhi_epi16(s[10], s[11]);
+  u[6] = _mm256_unpacklo_epi16(s[14], s[15]);
+  u[7] = _mm256_unpackhi_epi16(s[14], s[15]);
+
+  in[7] = idct_calc_wraplow_avx2(u[0], u[1], k__cospi_m16_m16);
+  in[8] = idct_calc_wraplow_avx2(u[0], u[1], k__cospi_p16_m16);
+  in[4] = idct_calc_wraplow_avx2(u[2], u[3], k__cospi_p16_p16);
+  in[11] = idct_calc_wraplow_avx2(u[2], u[3], k__cospi_m16_p16);
+  in[6] = idct_calc_wraplow_avx2(u[4], u[5], k__cospi_p16_p16);
+  in[9] = idct_calc_wraplow_avx2(u[4], u[5], k__cospi_m16_p16);
+  in[5] = idct_calc_wraplow_avx2(u[6], u[7], k__cospi_m16_m16);
+  in[10] = idct_calc_wraplow_avx2(u[6], u[7], k__cospi_p16_m16);
+
+  in[0] = s[0];
+  in[1] = _mm256_sub_epi16(kZero, s[8]);
+  in[2] = s[12];
+  in[3] = _mm256_sub_epi16(kZero, s[4]);
+  in[12] = s[5];
+  in[13] = _mm256_sub_epi16(kZero, s[13]);
+  in[14] = s[9];
+  in[15] = _mm256_sub_epi16(kZero, s[1]);
+}
+
+// Group the coefficient calculation into smaller functions to prevent stack
+// spillover in 32x32 idct optimizations:
+// quarter_1: 0-7
+// quarter_2: 8-15
+// quarter_3_4: 16-23, 24-31
+
+static INLINE void idct32_16x32_quarter_2_stage_4_to_6(
+    __m256i *const step1 /*step1[16]*/, __m256i *const out /*out[16]*/) {
+  __m256i step2[32];
+
+  // stage 4
+  step2[8] = step1[8];
+  step2[15] = step1[15];
+  butterfly_avx2(step1[14], step1[9], cospi_24_64, cospi_8_64, &step2[9],
+                 &step2[14]);
+  butterfly_avx2(step1[13], step1[10], -cospi_8_64, cospi_24_64, &step2[10],
+                 &step2[13]);
+  step2[11] = step1[11];
+  step2[12] = step1[12];
+
+  // stage 5
+  step1[8] = _mm256_add_epi16(step2[8], step2[11]);
+  step1[9] = _mm256_add_epi16(step2[9], step2[10]);
+  step1[10] = _mm256_sub_epi16(step2[9], step2[10]);
+  step1[11] = _mm256_sub_epi16(step2[8], step2[11]);
+  step1[12] = _mm256_sub_epi16(step2[15], step2[12]);
+  step1[13] = _mm256_sub_epi16(step2[14], step2[13]);
+  step1[14] = _mm256_add_epi16(step2[14], step2[13]);
+  step1[15] = _mm256_add_epi16(step2[15], step2[12]);
+
+  // stage 6
+  out[8] = step1[8];
+  out[9] = step1[9];
+  butterfly_avx2(step1[13], step1[10], cospi_16_64, cospi_16_64, &out[10],
+                 &out[13]);
+  butterfly_avx2(step1[12], step1[11], cospi_16_64, cospi_16_64, &out[11],
+                 &out[12]);
+  out[14] = step1[14];
+  out[15] = step1[15];
+}
+
+static INLINE void idct32_16x32_quarter_3_4_stage_4_to_7(
+    __m256i *const step1 /*step1[32]*/, __m256i *const out /*out[32]*/) {
+  __m256i step2[32];
+
+  // stage 4
+  step2[16] = _mm256_add_epi16(step1[16], step1[19]);
+  step2[17] = _mm256_add_epi16(step1[17], step1[18]);
+  step2[18] = _mm256_sub_epi16(step1[17], step1[18]);
+  step2[19] = _mm256_sub_epi16(step1[16], step1[19]);
+  step2[20] = _mm256_sub_epi16(step1[23], step1[20]);
+  step2[21] = _mm256_sub_epi16(step1[22], step1[21]);
+  step2[22] = _mm256_add_epi16(step1[22], step1[21]);
+  step2[23] = _mm256_add_epi16(step1[23], step1[20]);
+
+  step2[24] = _mm256_add_epi16(step1[24], step1[27]);
+  step2[25] = _mm256_add_epi16(step1[25], step1[26]);
+  step2[26] = _mm256_sub_epi16(step1[25], step1[26]);
+  step2[27] = _mm256_sub_epi16(step1[24], step1[27]);
+  step2[28] = _mm256_sub_epi16(step1[31], step1[28]);
+  step2[29] = _mm256_sub_epi16(step1[30], step1[29]);
+  step2[30] = _mm256_add_epi16(step1[29], step1[30]);
+  step2[31] = _mm256_add_epi16(step1[28], step1[31]);
+
+  // stage 5
+  step1[16] = step2[16];
+  step1[17] = step2[17];
+  butterfly_avx2(step2[29], step2[18], cospi_24_64, cospi_8_64, &step1[18],
+                 &step1[29]);
+  butterfly_avx2(step2[28], step2[19], cospi_24_64, cospi_8_64, &step1[19],
+                 &step1[28]);
+  butterfly_avx2(step2[27], step2[20], -cospi_8_64, cospi_24_64, &step1[20],
+                 &step1[27]);
+  butterfly_avx2(step2[26], step2[21], -cospi_8_64, cospi_24_64, &step1[21],
+                 &step1[26]);
+  step1[22] = step2[22];
+  step1[23] = step2[23];
+  step1[24] = step2[24];
+  step1[25] = step2[25];
+  step1[30] = step2[30];
+  step1[31] = step2[31];
+
+  // stage 6
+  out[16] = _mm256_add_epi16(step1[16], step1[23]);
+  out[17] = _mm256_add_epi16(step1[17], step1[22]);
+  out[18] = _mm256_add_epi16(step1[18], step1[21]);
+  out[19] = _mm256_add_epi16(step1[19], step1[20]);
+  step2[20] = _mm256_sub_epi16(step1[19], step1[20]);
+  step2[21] = _mm256_sub_epi16(step1[18], step1[21]);
+  step2[22] = _mm256_sub_epi16(step1[17], step1[22]);
+  step2[23] = _mm256_sub_epi16(step1[16], step1[23]);
+
+  step2[24] = _mm256_sub_epi16(step1[31], step1[24]);
+  step2[25] = _mm256_sub_epi16(step1[30], step1[25]);
+  step2[26] = _mm256_sub_epi16(step1[29], step1[26]);
+  step2[27] = _mm256_sub_epi16(step1[28], step1[27]);
+  out[28] = _mm256_add_epi16(step1[27], step1[28]);
+  out[29] = _mm256_add_epi16(step1[26], step1[29]);
+  out[30] = _mm256_add_epi16(step1[25], step1[30]);
+  out[31] = _mm256_add_epi16(step1[24], step1[31]);
+
+  // stage 7
+  butterfly_avx2(step2[27], step2[20], cospi_16_64, cospi_16_64, &out[20],
+                 &out[27]);
+  butterfly_avx2(step2[26], step2[21], cospi_16_64, cospi_16_64, &out[21],
+                 &out[26]);
+  butterfly_avx2(step2[25], step2[22], cospi_16_64, cospi_16_64, &out[22],
+                 &out[25]);
+  butterfly_avx2(step2[24], step2[23], cospi_16_64, cospi_16_64, &out[23],
+                 &out[24]);
+}
+
+// For each 16x32 block __m256i in[32],
+// Input with index, 0, 4
+// output pixels: 0-7 in __m256i out[32]
+static INLINE void idct32_34_16x32_quarter_1(
+    const __m256i *const in /*in[32]*/, __m256i *const out /*out[8]*/) {
+  __m256i step1[8], step2[8];
+
+  // stage 3
+  partial_butterfly_avx2(in[4], cospi_28_64, cospi_4_64, &step1[4], &step1[7]);
+
+  // stage 4
+  step2[0] = partial_butterfly_cospi16_avx2(in[0]);
+  step2[4] = step1[4];
+  step2[5] = step1[4];
+  step2[6] = step1[7];
+  step2[7] = step1[7];
+
+  // stage 5
+  step1[0] = step2[0];
+  step1[1] = step2[0];
+  step1[2] = step2[0];
+  step1[3] = step2[0];
+  step1[4] = step2[4];
+  butterfly_avx2(step2[6], step2[5], cospi_16_64, cospi_16_64, &step1[5],
+                 &step1[6]);
+  step1[7] = step2[7];
+
+  // stage 6
+  out[0] = _mm256_add_epi16(step1[0], step1[7]);
+  out[1] = _mm256_add_epi16(step1[1], step1[6]);
+  out[2] = _mm256_add_epi16(step1[2], step1[5]);
+  out[3] = _mm256_add_epi16(step1[3], step1[4]);
+  out[4] = _mm256_sub_epi16(step1[3], step1[4]);
+  out[5] = _mm256_sub_epi16(step1[2], step1[5]);
+  out[6] = _mm256_sub_epi16(step1[1], step1[6]);
+  out[7] = _mm256_sub_epi16(step1[0], step1[7]);
+}
+
+// For each 16x32 block __m256i in[32],
+// Input with index, 2, 6
+// output pixels: 8-15 in __m256i out[32]
+static INLINE void idct32_34_16x32_quarter_2(
+    const __m256i *const in /*in[32]*/, __m256i *const out /*out[16]*/) {
+  __m256i step1[16], step2[16];
+
+  // stage 2
+  partial_butterfly_avx2(in[2], cospi_30_64, cospi_2_64, &step2[8], &step2[15]);
+  partial_butterfly_avx2(in[6], -cospi_26_64, cospi_6_64, &step2[11],
+                         &step2[12]);
+
+  // stage 3
+  step1[8] = step2[8];
+  step1[9] = step2[8];
+  step1[14] = step2[15];
+  step1[15] = step2[15];
+  step1[10] = step2[11];
+  step1[11] = step2[11];
+  step1[12] = step2[12];
+  step1[13] = step2[12];
+
+  idct32_16x32_quarter_2_stage_4_to_6(step1, out);
+}
+
+static INLINE void idct32_34_16x32_quarter_1_2(
+    const __m256i *const in /*in[32]*/, __m256i *const out /*out[32]*/) {
+  __m256i temp[16];
+  idct32_34_16x32_quarter_1(in, temp);
+  idct32_34_16x32_quarter_2(in, temp);
+  // stage 7
+  add_sub_butterfly_avx2(temp, out, 16);
+}
+
+// For each 16x32 block __m256i in[32],
+// Input with odd index, 1, 3, 5, 7
+// output pixels: 16-23, 24-31 in __m256i out[32]
+static INLINE void idct32_34_16x32_quarter_3_4(
+    const __m256i *const in /*in[32]*/, __m256i *const out /*out[32]*/) {
+  __m256i step1[32];
+
+  // stage 1
+  partial_butterfly_avx2(in[1], cospi_31_64, cospi_1_64, &step1[16],
+                         &step1[31]);
+  partial_butterfly_avx2(in[7], -cospi_25_64, cospi_7_64, &step1[19],
+                         &step1[28]);
+  partial_butterfly_avx2(in[5], cospi_27_64, cospi_5_64, &step1[20],
+                         &step1[27]);
+  partial_butterfly_avx2(in[3], -cospi_29_64, cospi_3_64, &step1[23],
+                         &step1[24]);
+
+  // stage 3
+  butterfly_avx2(step1[31], step1[16], cospi_28_64, cospi_4_64, &step1[17],
+                 &step1[30]);
+  butterfly_avx2(step1[28], step1[19], -cospi_4_64, cospi_28_64, &step1[18],
+                 &step1[29]);
+  butterfly_avx2(step1[27], step1[20], cospi_12_64, cospi_20_64, &step1[21],
+                 &step1[26]);
+  butterfly_avx2(step1[24], step1[23], -cospi_20_64, cospi_12_64, &step1[22],
+                 &step1[25]);
+
+  idct32_16x32_quarter_3_4_stage_4_to_7(step1, out);
+}
+
+static INLINE void idct32_34_16x32_avx2(
+    const __m256i *const in /*in[32]*/, __m256i *const out /*out[32]*/) {
+  __m256i temp[32];
+
+  idct32_34_16x32_quarter_1_2(in, temp);
+  idct32_34_16x32_quarter_3_4(in, temp);
+  // final stage
+  add_sub_butterfly_avx2(temp, out, 32);
+}
+
+// For each 16x32 block __m256i in[32],
+// Input with index, 0, 4, 8, 12
+// output pixels: 0-7 in __m256i out[32]
+static INLINE void idct32_135_16x32_quarter_1(
+    const __m256i *const in /*in[32]*/, __m256i *const out /*out[8]*/) {
+  __m256i step1[8], step2[8];
+
+  // stage 3
+  partial_butterfly_avx2(in[4], cospi_28_64, cospi_4_64, &step1[4], &step1[7]);
+  partial_butterfly_avx2(in[12], -cospi_20_64, cospi_12_64, &step1[5],
+                         &step1[6]);
+
+  // stage 4
+  step2[0] = partial_butterfly_cospi16_avx2(in[0]);
+  partial_butterfly_avx2(in[8], cospi_24_64, cospi_8_64, &step2[2], &step2[3]);
+  step2[4] = _mm256_add_epi16(step1[4], step1[5]);
+  step2[5] = _mm256_sub_epi16(step1[4], step1[5]);
+  step2[6] = _mm256_sub_epi16(step1[7], step1[6]);
+  step2[7] = _mm256_add_epi16(step1[7], step1[6]);
+
+  // stage 5
+  step1[0] = _mm256_add_epi16(step2[0], step2[3]);
+  step1[1] = _mm256_add_epi16(step2[0], step2[2]);
+  step1[2] = _mm256_sub_epi16(step2[0], step2[2]);
+  step1[3] = _mm256_sub_epi16(step2[0], step2[3]);
+  step1[4] = step2[4];
+  butterfly_avx2(step2[6], step2[5], cospi_16_64, cospi_16_64, &step1[5],
+                 &step1[6]);
+  step1[7] = step2[7];
+
+  // stage 6
+  out[0] = _mm256_add_epi16(step1[0], step1[7]);
+  out[1] = _mm256_add_epi16(step1[1], step1[6]);
+  out[2] = _mm256_add_epi16(step1[2], step1[5]);
+  out[3] = _mm256_add_epi16(step1[3], step1[4]);
+  out[4] = _mm256_sub_epi16(step1[3], step1[4]);
+  out[5] = _mm256_sub_epi16(step1[2], step1[5]);
+  out[6] = _mm256_sub_epi16(step1[1], step1[6]);
+  out[7] = _mm256_sub_epi16(step1[0], step1[7]);
+}
+
+// For each 16x32 block __m256i in[32],
+// Input with index, 2, 6, 10, 14
+// output pixels: 8-15 in __m256i out[32]
+static INLINE void idct32_135_16x32_quarter_2(
+    const __m256i *const in /*in[32]*/, __m256i *const out /*out[16]*/) {
+  __m256i step1[16], step2[16];
+
+  // stage 2
+  partial_butterfly_avx2(in[2], cospi_30_64, cospi_2_64, &step2[8], &step2[15]);
+  partial_butterfly_avx2(in[14], -cospi_18_64, cospi_14_64, &step2[9],
+                         &step2[14]);
+  partial_butterfly_avx2(in[10], cospi_22_64, cospi_10_64, &step2[10],
+                         &step2[13]);
+  partial_butterfly_avx2(in[6], -cospi_26_64, cospi_6_64, &step2[11],
+                         &step2[12]);
+
+  // stage 3
+  step1[8] = _mm256_add_epi16(step2[8], step2[9]);
+  step1[9] = _mm256_sub_epi16(step2[8], step2[9]);
+  step1[10] = _mm256_sub_epi16(step2[11], step2[10]);
+  step1[11] = _mm256_add_epi16(step2[11], step2[10]);
+  step1[12] = _mm256_add_epi16(step2[12], step2[13]);
+  step1[13] = _mm256_sub_epi16(step2[12], step2[13]);
+  step1[14] = _mm256_sub_epi16(step2[15], step2[14]);
+  step1[15] = _mm256_add_epi16(step2[15], step2[14]);
+
+  idct32_16x32_quarter_2_stage_4_to_6(step1, out);
+}
+
+static INLINE void idct32_135_16x32_quarter_1_2(
+    const __m256i *const in /*in[32]*/, __m256i *const out /*out[32]*/) {
+  __m256i temp[16];
+  idct32_135_16x32_quarter_1(in, temp);
+  idct32_135_16x32_quarter_2(in, temp);
+  // stage 7
+  add_sub_butterfly_avx2(temp, out, 16);
+}
+
+// For each 16x32 block __m256i in[32],
+// Input with odd index,
+// 1, 3, 5, 7, 9, 11, 13, 15
+// output pixels: 16-23, 24-31 in __m256i out[32]
+static INLINE void idct32_135_16x32_quarter_3_4(
+    const __m256i *const in /*in[32]*/, __m256i *const out /*out[32]*/) {
+  __m256i step1[32], step2[32];
+
+  // stage 1
+  partial_butterfly_avx2(in[1], cospi_31_64, cospi_1_64, &step1[16],
+                         &step1[31]);
+  partial_butterfly_avx2(in[15], -cospi_17_64, cospi_15_64, &step1[17],
+                         &step1[30]);
+  partial_butterfly_avx2(in[9], cospi_23_64, cospi_9_64, &step1[18],
+                         &step1[29]);
+  partial_butterfly_avx2(in[7], -cospi_25_64, cospi_7_64, &step1[19],
+                         &step1[28]);
+
+  partial_butterfly_avx2(in[5], cospi_27_64, cospi_5_64, &step1[20],
+                         &step1[27]);
+  partial_butterfly_avx2(in[11], -cospi_21_64, cospi_11_64, &step1[21],
+                         &step1[26]);
+
+  partial_butterfly_avx2(in[13], cospi_19_64, cospi_13_64, &step1[22],
+                         &step1[25]);
+  partial_butterfly_avx2(in[3], -cospi_29_64, cospi_3_64, &step1[23],
+                         &step1[24]);
+
+  // stage 2
+  step2[16] = _mm256_add_epi16(step1[16], step1[17]);
+  step2[17] = _mm256_sub_epi16(step1[16], step1[17]);
+  step2[18] = _mm256_sub_epi16(step1[19], step1[18]);
+  step2[19] = _mm256_add_epi16(step1[19], step1[18]);
+  step2[20] = _mm256_add_epi16(step1[20], step1[21]);
+  step2[21] = _mm256_sub_epi16(step1[20], step1[21]);
+  step2[22] = _mm256_sub_epi16(step1[23], step1[22]);
+  step2[23] = _mm256_add_epi16(step1[23], step1[22]);
+
+  step2[24] = _mm256_add_epi16(step1[24], step1[25]);
+  step2[25] = _mm256_sub_epi16(step1[24], step1[25]);
+  step2[26] = _mm256_sub_epi16(step1[27], step1[26]);
+  step2[27] = _mm256_add_epi16(step1[27], step1[26]);
+  step2[28] = _mm256_add_epi16(step1[28], step1[29]);
+  step2[29] = _mm256_sub_epi16(step1[28], step1[29]);
+  step2[30] = _mm256_sub_epi16(step1[31], step1[30]);
+  step2[31] = _mm256_add_epi16(step1[31], step1[30]);
+
+  // stage 3
+  step1[16] = step2[16];
+  step1[31] = step2[31];
+  butterfly_avx2(step2[30], step2[17], cospi_28_64, cospi_4_64, &step1[17],
+                 &step1[30]);
+  butterfly_avx2(step2[29], step2[18], -cospi_4_64, cospi_28_64, &step1[18],
+                 &step1[29]);
+  step1[19] = step2[19];
+  step1[20] = step2[20];
+  butterfly_avx2(step2[26], step2[21], cospi_12_64, cospi_20_64, &step1[21],
+                 &step1[26]);
+  butterfly_avx2(step2[25], step2[22], -cospi_20_64, cospi_12_64, &step1[22],
+                 &step1[25]);
+  step1[23] = step2[23];
+  step1[24] = step2[24];
+  step1[27] = step2[27];
+  step1[28] = step2[28];
+
+  idct32_16x32_quarter_3_4_stage_4_to_7(step1, out);
+}
+
+static INLINE void idct32_135_16x32_avx2(
+    const __m256i *const in /*in[32]*/, __m256i *const out /*out[32]*/) {
+  __m256i temp[32];
+  idct32_135_16x32_quarter_1_2(in, temp);
+  idct32_135_16x32_quarter_3_4(in, temp);
+  // final stage
+  add_sub_butterfly_avx2(temp, out, 32);
+}
+
+
+// For each 16x32 block __m256i in[32],
+// Input with index, 0, 4, 8, 12, 16, 20, 24, 28
+// output pixels: 0-7 in __m256i out[32]
+static INLINE void idct32_1024_16x32_quarter_1(
+    const __m256i *const in /*in[32]*/, __m256i *const out /*out[8]*/) {
+  __m256i step1[8], step2[8];
+
+  // stage 3
+  butterfly_avx2(in[4], in[28], cospi_28_64, cospi_4_64, &step1[4], &step1[7]);
+  butterfly_avx2(in[20], in[12], cospi_12_64, cospi_20_64, &step1[5],
+                 &step1[6]);
+
+  // stage 4
+  butterfly_avx2(in[0], in[16], cospi_16_64, cospi_16_64, &step2[1], &step2[0]);
+  butterfly_avx2(in[8], in[24], cospi_24_64, cospi_8_64, &step2[2], &step2[3]);
+  step2[4] = _mm256_add_epi16(step1[4], step1[5]);
+  step2[5] = _mm256_sub_epi16(step1[4], step1[5]);
+  step2[6] = _mm256_sub_epi16(step1[7], step1[6]);
+  step2[7] = _mm256_add_epi16(step1[7], step1[6]);
+
+  // stage 5
+  step1[0] = _mm256_add_epi16(step2[0], step2[3]);
+  step1[1] = _mm256_add_epi16(step2[1], step2[2]);
+  step1[2] = _mm256_sub_epi16(step2[1], step2[2]);
+  step1[3] = _mm256_sub_epi16(step2[0], step2[3]);
+  step1[4] = step2[4];
+  butterfly_avx2(step2[6], step2[5], cospi_16_64, cospi_16_64, &step1[5],
+                 &step1[6]);
+  step1[7] = step2[7];
+
+  // stage 6
+  out[0] = _mm256_add_epi16(step1[0], step1[7]);
+  out[1] = _mm256_add_epi16(step1[1], step1[6]);
+  out[2] = _mm256_add_epi16(step1[2], step1[5]);
+  out[3] = _mm256_add_epi16(step1[3], step1[4]);
+  out[4] = _mm256_sub_epi16(step1[3], step1[4]);
+  out[5] = _mm256_sub_epi16(step1[2], step1[5]);
+  out[6] = _mm256_sub_epi16(step1[1], step1[6]);
+  out[7] = _mm256_sub_epi16(step1[0], step1[7]);
+}
+
+// For each 16x32 block __m256i in[32],
+// Input with index, 2, 6, 10, 14, 18, 22, 26, 30
+// output pixels: 8-15 in __m256i out[32]
+static INLINE void idct32_1024_16x32_quarter_2(
+    const __m256i *const in /*in[32]*/, __m256i *const out /*out[16]*/) {
+  __m256i step1[16], step2[16];
+
+  // stage 2
+  butterfly_avx2(in[2], in[30], cospi_30_64, cospi_2_64, &step2[8], &step2[15]);
+  butterfly_avx2(in[18], in[14], cospi_14_64, cospi_18_64, &step2[9],
+                 &step2[14]);
+  butterfly_avx2(in[10], in[22], cospi_22_64, cospi_10_64, &step2[10],
+                 &step2[13]);
+  butterfly_avx2(in[26], in[6], cospi_6_64, cospi_26_64, &step2[11],
+                 &step2[12]);
+
+  // stage 3
+  step1[8] = _mm256_add_epi16(step2[8], step2[9]);
+  step1[9] = _mm256_sub_epi16(step2[8], step2[9]);
+  step1[10] = _mm256_sub_epi16(step2[11], step2[10]);
+  step1[11] = _mm256_add_epi16(step2[11], step2[10]);
+  step1[12] = _mm256_add_epi16(step2[12], step2[13]);
+  step1[13] = _mm256_sub_epi16(step2[12], step2[13]);
+  step1[14] = _mm256_sub_epi16(step2[15], step2[14]);
+  step1[15] = _mm256_add_epi16(step2[15], step2[14]);
+
+  idct32_16x32_quarter_2_stage_4_to_6(step1, out);
+}
+
+static INLINE void idct32_1024_16x32_quarter_1_2(
+    const __m256i *const in /*in[32]*/, __m256i *const out /*out[32]*/) {
+  __m256i temp[16];
+  idct32_1024_16x32_quarter_1(in, temp);
+  idct32_1024_16x32_quarter_2(in, temp);
+  // stage 7
+  add_sub_butterfly_avx2(temp, out, 16);
+}
+
+// For each 16x32 block __m256i in[32],
+// Input with odd index,
+// 1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31
+// output pixels: 16-23, 24-31 in __m256i out[32]
+static INLINE void idct32_1024_16x32_quarter_3_4(
+    const __m256i *const in /*in[32]*/, __m256i *const out /*out[32]*/) {
+  __m256i step1[32], step2[32];
+
+  // stage 1
+  butterfly_avx2(in[1], in[31], cospi_31_64, cospi_1_64, &step1[16],
+                 &step1[31]);
+  butterfly_avx2(in[17], in[15], cospi_15_64, cospi_17_64, &step1[17],
+                 &step1[30]);
+  butterfly_avx2(in[9], in[23], cospi_23_64, cospi_9_64, &step1[18],
+                 &step1[29]);
+  butterfly_avx2(in[25], in[7], cospi_7_64, cospi_25_64, &step1[19],
+                 &step1[28]);
+
+  butterfly_avx2(in[5], in[27], cospi_27_64, cospi_5_64, &step1[20],
+                 &step1[27]);
+  butterfly_avx2(in[21], in[11], cospi_11_64, cospi_21_64, &step1[21],
+                 &step1[26]);
+
+  butterfly_avx2(in[13], in[19], cospi_19_64, cospi_13_64, &step1[22],
+                 &step1[25]);
+  butterfly_avx2(in[29], in[3], cospi_3_64, cospi_29_64, &step1[23],
+                 &step1[24]);
+
+  // stage 2
+  step2[16] = _mm256_add_epi16(step1[16], step1[17]);
+  step2[17] = _mm256_sub_epi16(step1[16], step1[17]);
+  step2[18] = _mm256_sub_epi16(step1[19], step1[18]);
+  step2[19] = _mm256_add_epi16(step1[19], step1[18]);
+  step2[20] = _mm256_add_epi16(step1[20], step1[21]);
+  step2[21] = _mm256_sub_epi16(step1[20], step1[21]);
+  step2[22] = _mm256_sub_epi16(step1[23], step1[22]);
+  step2[23] = _mm256_add_epi16(step1[23], step1[22]);
+
+  step2[24] = _mm256_add_epi16(step1[24], step1[25]);
+  step2[25] = _mm256_sub_epi16(step1[24], step1[25]);
+  step2[26] = _mm256_sub_epi16(step1[27], step1[26]);
+  step2[27] = _mm256_add_epi16(step1[27], step1[26]);
+  step2[28] = _mm256_add_epi16(step1[28], step1[29]);
+  step2[29] = _mm256_sub_epi16(step1[28], step1[29]);
+  step2[30] = _mm256_sub_epi16(step1[31], step1[30]);
+  step2[31] = _mm256_add_epi16(step1[31], step1[30]);
+
+  // stage 3
+  step1[16] = step2[16];
+  step1[31] = step2[31];
+  butterfly_avx2(step2[30], step2[17], cospi_28_64, cospi_4_64, &step1[17],
+                 &step1[30]);
+  butterfly_avx2(step2[29], step2[18], -cospi_4_64, cospi_28_64, &step1[18],
+                 &step1[29]);
+  step1[19] = step2[19];
+  step1[20] = step2[20];
+  butterfly_avx2(step2[26], step2[21], cospi_12_64, cospi_20_64, &step1[21],
+                 &step1[26]);
+  butterfly_avx2(step2[25], step2[22], -cospi_20_64, cospi_12_64, &step1[22],
+                 &step1[25]);
+  step1[23] = step2[23];
+  step1[24] = step2[24];
+  step1[27] = step2[27];
+  step1[28] = step2[28];
+
+  idct32_16x32_quarter_3_4_stage_4_to_7(step1, out);
+}
+
+static INLINE void idct32_1024_16x32_avx2(
+    const __m256i *const in /*in[32]*/, __m256i *const out /*out[32]*/) {
+  __m256i temp[32];
+
+  idct32_1024_16x32_quarter_1_2(in, temp);
+  idct32_1024_16x32_quarter_3_4(in, temp);
+  // final stage
+  add_sub_butterfly_avx2(temp, out, 32);
+}
+
+static INLINE void store_buffer_16x32_avx2(const __m256i *const in,
+                                           uint8_t *dest, const int stride) {
+  int j;
+  for (j = 0; j < 32; ++j) {
+    write_buffer_16x1_avx2(dest + j * stride, in[j]);
+  }
+}
+
+void vpx_idct32x32_1024_add_avx2(const tran_low_t *input, uint8_t *dest,
+                                 int stride) {
+  __m256i col[2][32], io[32];
+  int i;
+
+  // rows
+  for (i = 0; i < 2; i++) {
+    load_transpose_16bit_16x16_avx2(&input[0], 32, &io[0]);
+    load_transpose_16bit_16x16_avx2(&input[16], 32, &io[16]);
+    idct32_1024_16x32_avx2(io, col[i]);
+    input += 32 << 4;
+  }
+
+  // columns
+  for (i = 0; i < 32; i += 16) {
+    // Transpose 32x16 block to 16x32 block
+    transpose_16bit_16x16_avx2(col[0] + i, io);
+    transpose_16bit_16x16_avx2(col[1] + i, io + 16);
+
+    idct32_1024_16x32_avx2(io, io);
+    store_buffer_16x32_avx2(io, dest, stride);
+    dest += 16;
+  }
+}
+
+// Only upper-left 16x16 has non-zero coeff
+void vpx_idct32x32_135_add_avx2(const tran_low_t *input, uint8_t *dest,
+                                int stride) {
+  __m256i col[32], io[32];
+  int i;
+
+  // rows
+  load_transpose_16bit_16x16_avx2(input, 32, io);
+  idct32_135_16x32_avx2(io, col);
+
+  // columns
+  for (i = 0; i < 32; i += 16) {
+    transpose_16bit_16x16_avx2(col + i, io);
+    idct32_135_16x32_avx2(io, io);
+    store_buffer_16x32_avx2(io, dest, stride);
+    dest += 16;
+  }
+}
+
+// Only upper-left 8x8 has non-zero coeff
+void vpx_idct32x32_34_add_avx2(const tran_low_t *input, uint8_t *dest,
+                               int stride) {
+  __m256i col[32], io[32];
+  int i;
+
+  // rows. Only need to load the top left 8x8 block.
+  for (i = 0; i < 8; ++i) io[i] = load_input_data16_avx2(input + i * 32);
+  transpose_16bit_2x8x8_avx2(io, io);
+  idct32_34_16x32_avx2(io, col);
+
+  // columns
+  for (i = 0; i < 32; i += 16) {
+    transpose_16bit_16x8_avx2(col + i, io);
+    idct32_34_16x32_avx2(io, io);
+    store_buffer_16x32_avx2(io, dest, stride);
+    dest += 16;
+  }
+}
+
+void vpx_idct32x32_1_add_avx2(const tran_low_t *input, uint8_t *dest,
+                              int stride) {
+  __m256i dc_value;
+  int j;
+  tran_high_t a1;
+  tran_low_t out =
+      WRAPLOW(dct_const_round_shift((int16_t)input[0] * cospi_16_64));
+
+  out = WRAPLOW(dct_const_round_shift(out * cospi_16_64));
+  a1 = ROUND_POWER_OF_TWO(out, 6);
+  dc_value = _mm256_set1_epi16((int16_t)a1);
+
+  for (j = 0; j < 32; ++j) {
+    recon_and_store_32_avx2(dest + j * stride, dc_value);
+  }
+}
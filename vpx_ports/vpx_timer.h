@@ -32,6 +32,7 @@
  * POSIX specific includes
  */
 #include <sys/time.h>
+#include <time.h>
 
 /* timersub is not provided by msys at this time. */
 #ifndef timersub
@@ -87,6 +88,31 @@ static INLINE int64_t vpx_usec_timer_elapsed(struct vpx_usec_timer *t) {
 #endif
 }
 
+/* CPU time used by the calling thread in microseconds, or 0 where there is no
+ * per thread clock. Much slower than the wall clock timer on some systems, so
+ * only use it around large pieces of work.
+ */
+static INLINE int64_t vpx_usec_thread_cpu_time(void) {
+#if defined(_WIN32)
+  FILETIME creation, exit_time, kernel, user;
+  if (!GetThreadTimes(GetCurrentThread(), &creation, &exit_time, &kernel,
+                      &user))
+    return 0;
+  /* FILETIME is in units of 100 nanoseconds. */
+  return (int64_t)((((uint64_t)kernel.dwHighDateTime << 32) |
+                    kernel.dwLowDateTime) +
+                   (((uint64_t)user.dwHighDateTime << 32) |
+                    user.dwLowDateTime)) /
+         10;
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts)) return 0;
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#else
+  return 0;
+#endif
+}
+
 #else /* CONFIG_OS_SUPPORT = 0*/
 
 /* Empty timer functions if CONFIG_OS_SUPPORT = 0 */
@@ -104,6 +130,8 @@ static INLINE void vpx_usec_timer_mark(struct vpx_usec_timer *t) {}
 
 static INLINE int vpx_usec_timer_elapsed(struct vpx_usec_timer *t) { return 0; }
 
+static INLINE int64_t vpx_usec_thread_cpu_time(void) { return 0; }
+
 #endif /* CONFIG_OS_SUPPORT */
 
 #endif  // VPX_VPX_PORTS_VPX_TIMER_H_
@@ -285,6 +285,116 @@ int vpx_realloc_frame_buffer(YV12_BUFFER_CONFIG *ybf, int width, int height,
   return -2;
 }
 
+// Returns 1 if a plane of width x height pixels plus its border, starting at
+// |offset| bytes into |fb| with |stride|, fits in the frame buffer and is
+// 16 byte aligned.
+static int plane_fits(const vpx_codec_frame_buffer_t *fb, size_t offset,
+                      int stride, int width, int height, int border_w,
+                      int border_h, int bytes_per_sample) {
+  const uint64_t row_bytes =
+      (uint64_t)(width + 2 * border_w) * bytes_per_sample;
+  const uint64_t start =
+      (uint64_t)border_h * stride + (uint64_t)border_w * bytes_per_sample;
+  if (stride <= 0 || (stride & 15) || (uint64_t)stride < row_bytes) return 0;
+  if (((size_t)fb->data + offset) & 15) return 0;
+  if (offset < start) return 0;
+  return offset - start + (uint64_t)(height + 2 * border_h - 1) * stride +
+             row_bytes <=
+         fb->size;
+}
+
+int vpx_realloc_frame_buffer_layout(YV12_BUFFER_CONFIG *ybf, int width,
+                                    int height, int ss_x, int ss_y,
+#if CONFIG_VP9_HIGHBITDEPTH
+                                    int use_highbitdepth,
+#endif
+                                    int border, vpx_codec_frame_buffer_t *fb,
+                                    vpx_get_frame_buffer_layout_cb_fn_t cb,
+                                    void *cb_priv) {
+#if CONFIG_SIZE_LIMIT
+  if (width > DECODE_WIDTH_LIMIT || height > DECODE_HEIGHT_LIMIT) return -1;
+#endif
+
+  if (ybf) {
+    const int aligned_width = (width + 7) & ~7;
+    const int aligned_height = (height + 7) & ~7;
+    const int uv_width = aligned_width >> ss_x;
+    const int uv_height = aligned_height >> ss_y;
+#if CONFIG_VP9_HIGHBITDEPTH
+    const int bytes_per_sample = 1 + use_highbitdepth;
+#else
+    const int bytes_per_sample = 1;
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+    vpx_codec_frame_buffer_layout_t layout;
+    int plane;
+
+    if (border < 0) return -1;
+
+    assert(fb != NULL && cb != NULL);
+
+    memset(&layout, 0, sizeof(layout));
+    layout.width = aligned_width;
+    layout.height = aligned_height;
+    layout.subsampling_x = ss_x;
+    layout.subsampling_y = ss_y;
+    layout.bytes_per_sample = bytes_per_sample;
+    layout.border = border;
+
+    if (cb(cb_priv, &layout, fb) < 0) return -1;
+    if (fb->data == NULL || layout.border < border) return -1;
+    if (layout.stride[1] != layout.stride[2]) return -1;
+
+    for (plane = 0; plane < 3; ++plane) {
+      const int plane_ss_x = plane ? ss_x : 0;
+      const int plane_ss_y = plane ? ss_y : 0;
+      if (!plane_fits(fb, layout.offset[plane], layout.stride[plane],
+                      aligned_width >> plane_ss_x, aligned_height >> plane_ss_y,
+                      layout.border >> plane_ss_x, layout.border >> plane_ss_y,
+                      bytes_per_sample)) {
+        return -1;
+      }
+    }
+
+    ybf->buffer_alloc = fb->data;
+
+    ybf->y_crop_width = width;
+    ybf->y_crop_height = height;
+    ybf->y_width = aligned_width;
+    ybf->y_height = aligned_height;
+    ybf->y_stride = layout.stride[0] / bytes_per_sample;
+
+    ybf->uv_crop_width = (width + ss_x) >> ss_x;
+    ybf->uv_crop_height = (height + ss_y) >> ss_y;
+    ybf->uv_width = uv_width;
+    ybf->uv_height = uv_height;
+    ybf->uv_stride = layout.stride[1] / bytes_per_sample;
+
+    ybf->border = layout.border;
+    ybf->frame_size = fb->size;
+    ybf->subsampling_x = ss_x;
+    ybf->subsampling_y = ss_y;
+
+    ybf->y_buffer = fb->data + layout.offset[0];
+    ybf->u_buffer = fb->data + layout.offset[1];
+    ybf->v_buffer = fb->data + layout.offset[2];
+#if CONFIG_VP9_HIGHBITDEPTH
+    if (use_highbitdepth) {
+      // Store uint16 addresses when using 16bit framebuffers
+      ybf->y_buffer = CONVERT_TO_BYTEPTR(ybf->y_buffer);
+      ybf->u_buffer = CONVERT_TO_BYTEPTR(ybf->u_buffer);
+      ybf->v_buffer = CONVERT_TO_BYTEPTR(ybf->v_buffer);
+      ybf->flags = YV12_FLAG_HIGHBITDEPTH;
+    } else {
+      ybf->flags = 0;
+    }
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
+    ybf->corrupted = 0; /* assume not corrupted by errors */
+    return 0;
+  }
+  return -2;
+}
+
 int vpx_alloc_frame_buffer(YV12_BUFFER_CONFIG *ybf, int width, int height,
                            int ss_x, int ss_y,
 #if CONFIG_VP9_HIGHBITDEPTH
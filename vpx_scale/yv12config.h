@@ -94,6 +94,19 @@ int vpx_realloc_frame_buffer(YV12_BUFFER_CONFIG *ybf, int width, int height,
                              int border, int byte_alignment,
                              vpx_codec_frame_buffer_t *fb,
                              vpx_get_frame_buffer_cb_fn_t cb, void *cb_priv);
+
+// Updates the yv12 buffer config with the frame buffer and the plane layout
+// returned by cb. |border| is the smallest border the caller can work with.
+// Returns 0 on success. Returns < 0 on failure, including when the layout
+// does not fit in the frame buffer.
+int vpx_realloc_frame_buffer_layout(YV12_BUFFER_CONFIG *ybf, int width,
+                                    int height, int ss_x, int ss_y,
+#if CONFIG_VP9_HIGHBITDEPTH
+                                    int use_highbitdepth,
+#endif
+                                    int border, vpx_codec_frame_buffer_t *fb,
+                                    vpx_get_frame_buffer_layout_cb_fn_t cb,
+                                    void *cb_priv);
 int vpx_free_frame_buffer(YV12_BUFFER_CONFIG *ybf);
 
 #ifdef __cplusplus
@@ -13,6 +13,11 @@
 
 #include "./vpx_config.h"
 
+#if CONFIG_OS_SUPPORT && CONFIG_MULTITHREAD && defined(_MSC_VER) && \
+    !defined(__clang__)
+#include <windows.h>  // NOLINT, for MemoryBarrier().
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
@@ -50,14 +55,21 @@ extern "C" {
 #define vpx_atomic_memory_barrier() \
   do {                              \
   } while (0)
+// A store followed by a load of another location may still be reordered by the
+// CPU, which needs a full barrier.
+#define vpx_atomic_full_memory_barrier() MemoryBarrier()
 #else
 #if VPX_ARCH_X86 || VPX_ARCH_X86_64
 // Use a compiler barrier on x86, no runtime penalty.
 #define vpx_atomic_memory_barrier() __asm__ __volatile__("" ::: "memory")
+#define vpx_atomic_full_memory_barrier() \
+  __asm__ __volatile__("mfence" ::: "memory")
 #elif VPX_ARCH_ARM
 #define vpx_atomic_memory_barrier() __asm__ __volatile__("dmb ish" ::: "memory")
+#define vpx_atomic_full_memory_barrier() vpx_atomic_memory_barrier()
 #elif VPX_ARCH_MIPS
 #define vpx_atomic_memory_barrier() __asm__ __volatile__("sync" ::: "memory")
+#define vpx_atomic_full_memory_barrier() vpx_atomic_memory_barrier()
 #else
 #error Unsupported architecture!
 #endif  // VPX_ARCH_X86 || VPX_ARCH_X86_64
@@ -99,8 +111,44 @@ static INLINE int vpx_atomic_load_acquire(const vpx_atomic_int *atomic) {
 #endif  // defined(VPX_USE_ATOMIC_BUILTINS)
 }
 
+// Sequentially consistent store and load. Unlike the release/acquire pair, a
+// store followed by a load of another atomic is not reordered, which is what
+// is needed to safely decide whether a sleeping thread must be woken.
+static INLINE void vpx_atomic_store_seq_cst(vpx_atomic_int *atomic, int value) {
+#if defined(VPX_USE_ATOMIC_BUILTINS)
+  __atomic_store_n(&atomic->value, value, __ATOMIC_SEQ_CST);
+#else
+  vpx_atomic_memory_barrier();
+  atomic->value = value;
+  vpx_atomic_full_memory_barrier();
+#endif  // defined(VPX_USE_ATOMIC_BUILTINS)
+}
+
+static INLINE int vpx_atomic_load_seq_cst(const vpx_atomic_int *atomic) {
+#if defined(VPX_USE_ATOMIC_BUILTINS)
+  return __atomic_load_n(&atomic->value, __ATOMIC_SEQ_CST);
+#else
+  int v = atomic->value;
+  vpx_atomic_memory_barrier();
+  return v;
+#endif  // defined(VPX_USE_ATOMIC_BUILTINS)
+}
+
+// Atomically adds value and returns the previous value. This is a full
+// barrier.
+static INLINE int vpx_atomic_fetch_add(vpx_atomic_int *atomic, int value) {
+#if defined(VPX_USE_ATOMIC_BUILTINS)
+  return __atomic_fetch_add(&atomic->value, value, __ATOMIC_SEQ_CST);
+#elif defined(_MSC_VER)
+  return (int)InterlockedExchangeAdd((volatile LONG *)&atomic->value, value);
+#else
+  return __sync_fetch_and_add(&atomic->value, value);
+#endif  // defined(VPX_USE_ATOMIC_BUILTINS)
+}
+
 #undef VPX_USE_ATOMIC_BUILTINS
 #undef vpx_atomic_memory_barrier
+#undef vpx_atomic_full_memory_barrier
 
 #endif /* CONFIG_OS_SUPPORT && CONFIG_MULTITHREAD */
 
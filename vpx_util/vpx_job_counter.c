@@ -0,0 +1,62 @@
+/*
+ *  Copyright (c) 2021 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "vpx_util/vpx_job_counter.h"
+
+static INLINE int load_next_job(const VPxJobCounter *counter) {
+#if CONFIG_OS_SUPPORT && CONFIG_MULTITHREAD
+  return vpx_atomic_load_acquire(&counter->next_job);
+#else
+  return counter->next_job;
+#endif
+}
+
+void vpx_job_counter_reset(VPxJobCounter *counter, int num_jobs) {
+#if CONFIG_OS_SUPPORT && CONFIG_MULTITHREAD
+  vpx_atomic_init(&counter->next_job, 0);
+#else
+  counter->next_job = 0;
+#endif
+  counter->num_jobs = num_jobs;
+}
+
+int vpx_job_counter_next(VPxJobCounter *counter) {
+  int job;
+  // Skip the increment once all the jobs are taken, so that next_job stays
+  // bounded however often idle workers poll it.
+  if (load_next_job(counter) >= counter->num_jobs) return -1;
+#if CONFIG_OS_SUPPORT && CONFIG_MULTITHREAD
+  job = vpx_atomic_fetch_add(&counter->next_job, 1);
+#else
+  job = counter->next_job++;
+#endif
+  return job < counter->num_jobs ? job : -1;
+}
+
+int vpx_job_counter_remaining(const VPxJobCounter *counter) {
+  const int remaining = counter->num_jobs - load_next_job(counter);
+  return remaining > 0 ? remaining : 0;
+}
+
+int vpx_job_counter_most_remaining(const VPxJobCounter *counters,
+                                   int num_counters) {
+  int index = -1;
+  int max_remaining = 0;
+  int i;
+
+  for (i = 0; i < num_counters; ++i) {
+    const int remaining = vpx_job_counter_remaining(&counters[i]);
+    if (remaining > max_remaining) {
+      max_remaining = remaining;
+      index = i;
+    }
+  }
+  return index;
+}
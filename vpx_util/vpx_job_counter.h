@@ -0,0 +1,55 @@
+/*
+ *  Copyright (c) 2021 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPX_VPX_UTIL_VPX_JOB_COUNTER_H_
+#define VPX_VPX_UTIL_VPX_JOB_COUNTER_H_
+
+#include "./vpx_config.h"
+#include "vpx_util/vpx_atomics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Lock-free hand out of row jobs.
+//
+// A counter hands out the jobs 0 to num_jobs - 1 in order with an atomic
+// increment, so taking a job never locks a mutex. The jobs are not stored,
+// the index is enough to find them, e.g. the superblock row of a tile column.
+typedef struct VPxJobCounter {
+#if CONFIG_OS_SUPPORT && CONFIG_MULTITHREAD
+  vpx_atomic_int next_job;
+#else
+  int next_job;
+#endif
+  int num_jobs;
+} VPxJobCounter;
+
+// Sets up the counter to hand out the jobs 0 to num_jobs - 1. Not thread
+// safe.
+void vpx_job_counter_reset(VPxJobCounter *counter, int num_jobs);
+
+// Takes the next job of the counter. Returns its index, or -1 if all the jobs
+// have been taken.
+int vpx_job_counter_next(VPxJobCounter *counter);
+
+// Returns the number of jobs of the counter that have not been taken yet.
+int vpx_job_counter_remaining(const VPxJobCounter *counter);
+
+// Returns the index of the counter with the most jobs left, or -1 if all the
+// jobs of all the counters have been taken.
+int vpx_job_counter_most_remaining(const VPxJobCounter *counters,
+                                   int num_counters);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // VPX_VPX_UTIL_VPX_JOB_COUNTER_H_
@@ -23,12 +23,97 @@ struct VPxWorkerImpl {
   pthread_mutex_t mutex_;
   pthread_cond_t condition_;
   pthread_t thread_;
+  // Links in the queue of the thread pool while the job waits for a thread.
+  VPxWorker *prev_;
+  VPxWorker *next_;
+  int queued_;
+};
+
+struct vpx_codec_thread_pool {
+  pthread_mutex_t mutex_;
+  pthread_cond_t condition_;
+  pthread_t *threads_;
+  int num_threads_;
+  // Launched workers waiting for a thread, oldest first.
+  VPxWorker *head_;
+  VPxWorker *tail_;
+  int done_;
 };
 
 //------------------------------------------------------------------------------
 
 static void execute(VPxWorker *const worker);  // Forward declaration.
 
+// The pool mutex must be held.
+static void pool_push(VPxThreadPool *const pool, VPxWorker *const worker) {
+  worker->impl_->prev_ = pool->tail_;
+  worker->impl_->next_ = NULL;
+  worker->impl_->queued_ = 1;
+  if (pool->tail_ != NULL) {
+    pool->tail_->impl_->next_ = worker;
+  } else {
+    pool->head_ = worker;
+  }
+  pool->tail_ = worker;
+}
+
+// The pool mutex must be held.
+static void pool_remove(VPxThreadPool *const pool, VPxWorker *const worker) {
+  VPxWorkerImpl *const impl = worker->impl_;
+  if (impl->prev_ != NULL) {
+    impl->prev_->impl_->next_ = impl->next_;
+  } else {
+    pool->head_ = impl->next_;
+  }
+  if (impl->next_ != NULL) {
+    impl->next_->impl_->prev_ = impl->prev_;
+  } else {
+    pool->tail_ = impl->prev_;
+  }
+  impl->prev_ = impl->next_ = NULL;
+  impl->queued_ = 0;
+}
+
+// Runs the job of a worker taken off the pool queue and signals its end.
+static void pool_execute(VPxWorker *const worker) {
+  execute(worker);
+  pthread_mutex_lock(&worker->impl_->mutex_);
+  worker->status_ = OK;
+  pthread_cond_signal(&worker->impl_->condition_);
+  pthread_mutex_unlock(&worker->impl_->mutex_);
+}
+
+static THREADFN pool_thread_loop(void *ptr) {
+  VPxThreadPool *const pool = (VPxThreadPool *)ptr;
+  pthread_mutex_lock(&pool->mutex_);
+  while (1) {
+    VPxWorker *worker;
+    while (pool->head_ == NULL && !pool->done_) {
+      pthread_cond_wait(&pool->condition_, &pool->mutex_);
+    }
+    if (pool->head_ == NULL) break;
+    worker = pool->head_;
+    pool_remove(pool, worker);
+    pthread_mutex_unlock(&pool->mutex_);
+    pool_execute(worker);
+    pthread_mutex_lock(&pool->mutex_);
+  }
+  pthread_mutex_unlock(&pool->mutex_);
+  return THREAD_RETURN(NULL);
+}
+
+// Runs the job of the worker in the calling thread if no pool thread has
+// picked it up yet.
+static void pool_steal(VPxWorker *const worker) {
+  VPxThreadPool *const pool = worker->pool;
+  int stolen;
+  pthread_mutex_lock(&pool->mutex_);
+  stolen = worker->impl_->queued_;
+  if (stolen) pool_remove(pool, worker);
+  pthread_mutex_unlock(&pool->mutex_);
+  if (stolen) pool_execute(worker);
+}
+
 static THREADFN thread_loop(void *ptr) {
   VPxWorker *const worker = (VPxWorker *)ptr;
   int done = 0;
@@ -57,6 +142,8 @@ static void change_state(VPxWorker *const worker, VPxWorkerStatus new_status) {
   // race.
   if (worker->impl_ == NULL) return;
 
+  if (worker->pool != NULL) pool_steal(worker);
+
   pthread_mutex_lock(&worker->impl_->mutex_);
   if (worker->status_ >= OK) {
     // wait for the worker to finish
@@ -106,7 +193,10 @@ static int reset(VPxWorker *const worker) {
       goto Error;
     }
     pthread_mutex_lock(&worker->impl_->mutex_);
-    ok = !pthread_create(&worker->impl_->thread_, NULL, thread_loop, worker);
+    // Pooled workers have no thread of their own.
+    if (worker->pool == NULL) {
+      ok = !pthread_create(&worker->impl_->thread_, NULL, thread_loop, worker);
+    }
     if (ok) worker->status_ = OK;
     pthread_mutex_unlock(&worker->impl_->mutex_);
     if (!ok) {
@@ -136,6 +226,13 @@ static void execute(VPxWorker *const worker) {
 static void launch(VPxWorker *const worker) {
 #if CONFIG_MULTITHREAD
   change_state(worker, WORK);
+  if (worker->pool != NULL && worker->impl_ != NULL) {
+    VPxThreadPool *const pool = worker->pool;
+    pthread_mutex_lock(&pool->mutex_);
+    pool_push(pool, worker);
+    pthread_cond_signal(&pool->condition_);
+    pthread_mutex_unlock(&pool->mutex_);
+  }
 #else
   execute(worker);
 #endif
@@ -145,7 +242,7 @@ static void end(VPxWorker *const worker) {
 #if CONFIG_MULTITHREAD
   if (worker->impl_ != NULL) {
     change_state(worker, NOT_OK);
-    pthread_join(worker->impl_->thread_, NULL);
+    if (worker->pool == NULL) pthread_join(worker->impl_->thread_, NULL);
     pthread_mutex_destroy(&worker->impl_->mutex_);
     pthread_cond_destroy(&worker->impl_->condition_);
     vpx_free(worker->impl_);
@@ -179,3 +276,64 @@ const VPxWorkerInterface *vpx_get_worker_interface(void) {
 }
 
 //------------------------------------------------------------------------------
+
+#if CONFIG_MULTITHREAD
+VPxThreadPool *vpx_thread_pool_create(int num_threads) {
+  VPxThreadPool *const pool = (VPxThreadPool *)vpx_calloc(1, sizeof(*pool));
+  if (pool == NULL) return NULL;
+  pool->threads_ =
+      (pthread_t *)vpx_calloc(num_threads, sizeof(*pool->threads_));
+  if (pool->threads_ == NULL) goto Error;
+  if (pthread_mutex_init(&pool->mutex_, NULL)) goto Error;
+  if (pthread_cond_init(&pool->condition_, NULL)) {
+    pthread_mutex_destroy(&pool->mutex_);
+    goto Error;
+  }
+  for (; pool->num_threads_ < num_threads; ++pool->num_threads_) {
+    if (pthread_create(&pool->threads_[pool->num_threads_], NULL,
+                       pool_thread_loop, pool)) {
+      vpx_thread_pool_destroy(pool);
+      return NULL;
+    }
+  }
+  return pool;
+
+Error:
+  vpx_free(pool->threads_);
+  vpx_free(pool);
+  return NULL;
+}
+
+void vpx_thread_pool_destroy(VPxThreadPool *pool) {
+  int i;
+  if (pool == NULL) return;
+  pthread_mutex_lock(&pool->mutex_);
+  assert(pool->head_ == NULL);
+  pool->done_ = 1;
+  pthread_cond_broadcast(&pool->condition_);
+  pthread_mutex_unlock(&pool->mutex_);
+  for (i = 0; i < pool->num_threads_; ++i) {
+    pthread_join(pool->threads_[i], NULL);
+  }
+  pthread_mutex_destroy(&pool->mutex_);
+  pthread_cond_destroy(&pool->condition_);
+  vpx_free(pool->threads_);
+  vpx_free(pool);
+}
+#else
+// Without threads the workers run their jobs when they are launched, the pool
+// only needs to exist.
+struct vpx_codec_thread_pool {
+  int num_threads_;
+};
+
+VPxThreadPool *vpx_thread_pool_create(int num_threads) {
+  VPxThreadPool *const pool = (VPxThreadPool *)vpx_calloc(1, sizeof(*pool));
+  if (pool != NULL) pool->num_threads_ = num_threads;
+  return pool;
+}
+
+void vpx_thread_pool_destroy(VPxThreadPool *pool) { vpx_free(pool); }
+#endif  // CONFIG_MULTITHREAD
+
+//------------------------------------------------------------------------------
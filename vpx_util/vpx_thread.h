@@ -16,6 +16,7 @@
 #define VPX_VPX_UTIL_VPX_THREAD_H_
 
 #include "./vpx_config.h"
+#include "vpx/vpx_thread_pool.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -384,6 +385,10 @@ typedef int (*VPxWorkerHook)(void *, void *);
 // Platform-dependent implementation details for the worker.
 typedef struct VPxWorkerImpl VPxWorkerImpl;
 
+// Threads shared by the workers of any number of codec instances. This is the
+// object behind the public vpx_codec_thread_pool_t.
+typedef struct vpx_codec_thread_pool VPxThreadPool;
+
 // Synchronization object used to launch job in the worker thread
 typedef struct {
   VPxWorkerImpl *impl_;
@@ -392,6 +397,9 @@ typedef struct {
   void *data1;         // first argument passed to 'hook'
   void *data2;         // second argument passed to 'hook'
   int had_error;       // return value of the last call to 'hook'
+  // When set, between init() and reset(), the worker runs its jobs on the
+  // threads of the pool instead of starting its own thread.
+  VPxThreadPool *pool;
 } VPxWorker;
 
 // The interface for all thread-worker related functions. All these functions
@@ -429,6 +437,18 @@ int vpx_set_worker_interface(const VPxWorkerInterface *const winterface);
 // Retrieve the currently set thread worker interface.
 const VPxWorkerInterface *vpx_get_worker_interface(void);
 
+// Starts a pool of num_threads threads. Returns NULL in case of error.
+//
+// Launched workers are run by the pool threads in launch order. When sync()
+// is called on a worker that no pool thread has picked up yet, the calling
+// thread runs the job itself, so a job waiting for its own workers never
+// blocks on the pool being busy.
+VPxThreadPool *vpx_thread_pool_create(int num_threads);
+
+// Stops the threads of the pool. The workers using the pool must have been
+// ended first.
+void vpx_thread_pool_destroy(VPxThreadPool *pool);
+
 //------------------------------------------------------------------------------
 
 #ifdef __cplusplus
@@ -16,5 +16,7 @@ UTIL_SRCS-yes += endian_inl.h
 UTIL_SRCS-yes += vpx_write_yuv_frame.h
 UTIL_SRCS-yes += vpx_write_yuv_frame.c
 UTIL_SRCS-yes += vpx_timestamp.h
+UTIL_SRCS-yes += vpx_job_counter.c
+UTIL_SRCS-yes += vpx_job_counter.h
 UTIL_SRCS-$(or $(CONFIG_BITSTREAM_DEBUG),$(CONFIG_MISMATCH_DEBUG)) += vpx_debug_util.h
 UTIL_SRCS-$(or $(CONFIG_BITSTREAM_DEBUG),$(CONFIG_MISMATCH_DEBUG)) += vpx_debug_util.c
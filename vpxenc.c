@@ -42,6 +42,7 @@
 #include "vpx/vpx_integer.h"
 #include "vpx_ports/mem_ops.h"
 #include "vpx_ports/vpx_timer.h"
+#include "vpx_util/vpx_thread.h"
 #include "./rate_hist.h"
 #include "./vpxstats.h"
 #include "./warnings.h"
@@ -114,6 +115,18 @@ static const arg_def_t pass_arg =
     ARG_DEF(NULL, "pass", 1, "Pass to execute (1/2)");
 static const arg_def_t fpf_name =
     ARG_DEF(NULL, "fpf", 1, "First pass statistics file name");
+static const arg_def_t fpf_indexed =
+    ARG_DEF(NULL, "fpf-indexed", 0,
+            "Write the first pass statistics file with a key frame group "
+            "index");
+static const arg_def_t kf_groups =
+    ARG_DEF(NULL, "kf-groups", 1,
+            "Second pass: only code key frame groups first[:count] of an "
+            "indexed statistics file");
+static const arg_def_t chunks_arg =
+    ARG_DEF(NULL, "chunks", 1,
+            "Second pass: split the clip at key frames into n chunks "
+            "encoded in parallel");
 #if CONFIG_FP_MB_STATS
 static const arg_def_t fpmbf_name =
     ARG_DEF(NULL, "fpmbf", 1, "First pass block statistics file name");
@@ -176,6 +189,9 @@ static const arg_def_t *main_args[] = { &help,
                                         &passes,
                                         &pass_arg,
                                         &fpf_name,
+                                        &fpf_indexed,
+                                        &kf_groups,
+                                        &chunks_arg,
                                         &limit,
                                         &skip,
                                         &deadline,
@@ -524,6 +540,12 @@ static const arg_def_t row_mt =
     ARG_DEF(NULL, "row-mt", 1,
             "Enable row based non-deterministic multi-threading in VP9");
 
+static const arg_def_t fp_lookahead =
+    ARG_DEF(NULL, "fp-lookahead", 1,
+            "Run the first pass this many frames ahead of the lag in a "
+            "single pass two-pass encode (0: off (default), use with "
+            "--passes=1)");
+
 static const arg_def_t disable_loopfilter =
     ARG_DEF(NULL, "disable-loopfilter", 1,
             "Control Loopfilter in VP9\n"
@@ -561,6 +583,7 @@ static const arg_def_t *vp9_args[] = { &cpu_used_vp9,
                                        &target_level,
                                        &row_mt,
                                        &disable_loopfilter,
+                                       &fp_lookahead,
 // NOTE: The entries above have a corresponding entry in vp9_arg_ctrl_map. The
 // entries below do not have a corresponding entry in vp9_arg_ctrl_map. They
 // must be listed at the end of vp9_args.
@@ -597,6 +620,7 @@ static const int vp9_arg_ctrl_map[] = { VP8E_SET_CPUUSED,
                                         VP9E_SET_TARGET_LEVEL,
                                         VP9E_SET_ROW_MT,
                                         VP9E_SET_DISABLE_LOOPFILTER,
+                                        VP9E_SET_FIRST_PASS_LOOKAHEAD,
                                         0 };
 #endif
 
@@ -669,11 +693,30 @@ struct WebmOutputContext {
 };
 #endif
 
+/* Compressed frames of a chunk, held until the chunks before it are written */
+struct chunk_frame {
+  vpx_codec_cx_pkt_t pkt;
+  size_t offset;
+};
+
+struct chunk_output {
+  struct chunk_frame *frames;
+  int num_frames;
+  int frames_alloc;
+  uint8_t *data;
+  size_t data_sz;
+  size_t data_alloc;
+};
+
 /* Per-stream configuration */
 struct stream_config {
   struct vpx_codec_enc_cfg cfg;
   const char *out_fn;
   const char *stats_fn;
+  int stats_indexed;
+  int use_kf_groups;
+  unsigned int kf_group_first;
+  unsigned int kf_group_count;
 #if CONFIG_FP_MB_STATS
   const char *fpmb_stats_fn;
 #endif
@@ -710,6 +753,7 @@ struct stream_state {
   struct vpx_image *img;
   vpx_codec_ctx_t decoder;
   int mismatch_seen;
+  struct chunk_output *chunk_out;
 };
 
 static void validate_positive_rational(const char *msg,
@@ -789,6 +833,8 @@ static void parse_global_config(struct VpxEncoderConfig *global, char **argv) {
       global->limit = arg_parse_uint(&arg);
     else if (arg_match(&arg, &skip, argi))
       global->skip_frames = arg_parse_uint(&arg);
+    else if (arg_match(&arg, &chunks_arg, argi))
+      global->chunks = arg_parse_uint(&arg);
     else if (arg_match(&arg, &psnrarg, argi))
       global->show_psnr = 1;
     else if (arg_match(&arg, &recontest, argi))
@@ -943,6 +989,17 @@ static int parse_stream_params(struct VpxEncoderConfig *global,
       config->out_fn = arg.val;
     } else if (arg_match(&arg, &fpf_name, argi)) {
       config->stats_fn = arg.val;
+    } else if (arg_match(&arg, &fpf_indexed, argi)) {
+      config->stats_indexed = 1;
+    } else if (arg_match(&arg, &kf_groups, argi)) {
+      char *endptr;
+      config->use_kf_groups = 1;
+      config->kf_group_first = (unsigned int)strtoul(arg.val, &endptr, 10);
+      config->kf_group_count = 0;
+      if (*endptr == ':')
+        config->kf_group_count = (unsigned int)strtoul(endptr + 1, &endptr, 10);
+      if (endptr == arg.val || *endptr != '\0')
+        die("Error: Invalid --kf-groups, expected first[:count]\n");
 #if CONFIG_FP_MB_STATS
     } else if (arg_match(&arg, &fpmbf_name, argi)) {
       config->fpmb_stats_fn = arg.val;
@@ -1331,8 +1388,29 @@ static void close_output_file(struct stream_state *stream,
 static void setup_pass(struct stream_state *stream,
                        struct VpxEncoderConfig *global, int pass) {
   if (stream->config.stats_fn) {
-    if (!stats_open_file(&stream->stats, stream->config.stats_fn, pass))
+    if (pass == 0 && stream->config.stats_indexed) {
+      if (!stats_open_indexed_file(&stream->stats, stream->config.stats_fn))
+        fatal("Failed to open statistics store");
+    } else if (!stats_open_file(&stream->stats, stream->config.stats_fn,
+                                pass)) {
       fatal("Failed to open statistics store");
+    }
+
+    if (pass && stream->config.use_kf_groups) {
+      unsigned int first_frame, num_frames;
+      if (!stats_select_kf_groups(&stream->stats, stream->config.kf_group_first,
+                                  stream->config.kf_group_count, &first_frame,
+                                  &num_frames))
+        fatal("Stream %d: Key frame groups not found in %s", stream->index,
+              stream->config.stats_fn);
+      if (stream->index > 0 &&
+          (global->skip_frames != (int)first_frame ||
+           global->limit != (int)(first_frame + num_frames)))
+        fatal("Stream %d: Key frame groups differ from stream 0",
+              stream->index);
+      global->skip_frames = (int)first_frame;
+      global->limit = (int)(first_frame + num_frames);
+    }
   } else {
     if (!stats_open_mem(&stream->stats, pass))
       fatal("Failed to open statistics store");
@@ -1365,6 +1443,45 @@ static void setup_pass(struct stream_state *stream,
   stream->frames_out = 0;
 }
 
+// Adds the index of the key frame groups the second pass will code to the
+// stats file written in the first pass.
+static void index_stats_file(struct stream_state *stream,
+                             struct VpxEncoderConfig *global) {
+  struct vpx_codec_enc_cfg cfg = stream->config.cfg;
+  vpx_codec_ctx_t encoder;
+  stats_io_t stats;
+  int *key_frame_map;
+  unsigned int *group_starts;
+  unsigned int num_frames, num_groups = 0, i;
+
+  if (!stats_open_file(&stats, stream->config.stats_fn, 1) || !stats.indexed ||
+      stats.num_packets < 2)
+    fatal("Stream %d: Failed to read statistics store", stream->index);
+  num_frames = stats.num_packets - 1;
+
+  cfg.g_pass = VPX_RC_LAST_PASS;
+  cfg.rc_twopass_stats_in = stats_get(&stats);
+  vpx_codec_enc_init(&encoder, global->codec->codec_interface(), &cfg, 0);
+  ctx_exit_on_error(&encoder, "Failed to initialize encoder");
+
+  key_frame_map = malloc(num_frames * sizeof(*key_frame_map));
+  group_starts = malloc(num_frames * sizeof(*group_starts));
+  if (!key_frame_map || !group_starts)
+    fatal("Failed to allocate key frame group index");
+  vpx_codec_control(&encoder, VP9E_GET_KEY_FRAME_MAP, key_frame_map);
+  ctx_exit_on_error(&encoder, "Failed to get key frame groups");
+  for (i = 0; i < num_frames; ++i) {
+    if (key_frame_map[i]) group_starts[num_groups++] = i;
+  }
+  vpx_codec_destroy(&encoder);
+  stats_close(&stats, 1);
+
+  if (!stats_write_index(stream->config.stats_fn, group_starts, num_groups))
+    fatal("Stream %d: Failed to write key frame group index", stream->index);
+  free(key_frame_map);
+  free(group_starts);
+}
+
 static void initialize_encoder(struct stream_state *stream,
                                struct VpxEncoderConfig *global) {
   int i;
@@ -1501,52 +1618,92 @@ static void update_quantizer_histogram(struct stream_state *stream) {
   }
 }
 
+// Appends a compressed frame to the output of a chunk.
+static void buffer_chunk_frame(struct chunk_output *out,
+                               const vpx_codec_cx_pkt_t *pkt) {
+  struct chunk_frame *frame;
+
+  if (out->num_frames == out->frames_alloc) {
+    const int new_alloc = out->frames_alloc ? 2 * out->frames_alloc : 64;
+    struct chunk_frame *const new_frames =
+        realloc(out->frames, new_alloc * sizeof(*new_frames));
+    if (!new_frames) fatal("Failed to allocate chunk output");
+    out->frames = new_frames;
+    out->frames_alloc = new_alloc;
+  }
+  if (out->data_sz + pkt->data.frame.sz > out->data_alloc) {
+    size_t new_alloc = out->data_alloc ? 2 * out->data_alloc : 1 << 20;
+    uint8_t *new_data;
+    while (new_alloc < out->data_sz + pkt->data.frame.sz) new_alloc *= 2;
+    new_data = realloc(out->data, new_alloc);
+    if (!new_data) fatal("Failed to allocate chunk output");
+    out->data = new_data;
+    out->data_alloc = new_alloc;
+  }
+
+  frame = &out->frames[out->num_frames++];
+  frame->pkt = *pkt;
+  frame->offset = out->data_sz;
+  memcpy(out->data + out->data_sz, pkt->data.frame.buf, pkt->data.frame.sz);
+  out->data_sz += pkt->data.frame.sz;
+}
+
+static void write_cx_frame(struct stream_state *stream,
+                           const vpx_codec_cx_pkt_t *pkt) {
+  static size_t fsize = 0;
+  static FileOffset ivf_header_pos = 0;
+  const struct vpx_codec_enc_cfg *cfg = &stream->config.cfg;
+
+  if (!(pkt->data.frame.flags & VPX_FRAME_IS_FRAGMENT)) {
+    stream->frames_out++;
+  }
+  stream->nbytes += pkt->data.raw.sz;
+
+  if (stream->chunk_out) {
+    buffer_chunk_frame(stream->chunk_out, pkt);
+    return;
+  }
+
+  update_rate_histogram(stream->rate_hist, cfg, pkt);
+#if CONFIG_WEBM_IO
+  if (stream->config.write_webm) {
+    write_webm_block(&stream->webm_ctx, cfg, pkt);
+  }
+#endif
+  if (!stream->config.write_webm) {
+    if (pkt->data.frame.partition_id <= 0) {
+      ivf_header_pos = ftello(stream->file);
+      fsize = pkt->data.frame.sz;
+
+      ivf_write_frame_header(stream->file, pkt->data.frame.pts, fsize);
+    } else {
+      fsize += pkt->data.frame.sz;
+
+      if (!(pkt->data.frame.flags & VPX_FRAME_IS_FRAGMENT)) {
+        const FileOffset currpos = ftello(stream->file);
+        fseeko(stream->file, ivf_header_pos, SEEK_SET);
+        ivf_write_frame_size(stream->file, fsize);
+        fseeko(stream->file, currpos, SEEK_SET);
+      }
+    }
+
+    (void)fwrite(pkt->data.frame.buf, 1, pkt->data.frame.sz, stream->file);
+  }
+}
+
 static void get_cx_data(struct stream_state *stream,
                         struct VpxEncoderConfig *global, int *got_data) {
   const vpx_codec_cx_pkt_t *pkt;
-  const struct vpx_codec_enc_cfg *cfg = &stream->config.cfg;
   vpx_codec_iter_t iter = NULL;
 
   *got_data = 0;
   while ((pkt = vpx_codec_get_cx_data(&stream->encoder, &iter))) {
-    static size_t fsize = 0;
-    static FileOffset ivf_header_pos = 0;
-
     switch (pkt->kind) {
       case VPX_CODEC_CX_FRAME_PKT:
-        if (!(pkt->data.frame.flags & VPX_FRAME_IS_FRAGMENT)) {
-          stream->frames_out++;
-        }
         if (!global->quiet)
           fprintf(stderr, " %6luF", (unsigned long)pkt->data.frame.sz);
 
-        update_rate_histogram(stream->rate_hist, cfg, pkt);
-#if CONFIG_WEBM_IO
-        if (stream->config.write_webm) {
-          write_webm_block(&stream->webm_ctx, cfg, pkt);
-        }
-#endif
-        if (!stream->config.write_webm) {
-          if (pkt->data.frame.partition_id <= 0) {
-            ivf_header_pos = ftello(stream->file);
-            fsize = pkt->data.frame.sz;
-
-            ivf_write_frame_header(stream->file, pkt->data.frame.pts, fsize);
-          } else {
-            fsize += pkt->data.frame.sz;
-
-            if (!(pkt->data.frame.flags & VPX_FRAME_IS_FRAGMENT)) {
-              const FileOffset currpos = ftello(stream->file);
-              fseeko(stream->file, ivf_header_pos, SEEK_SET);
-              ivf_write_frame_size(stream->file, fsize);
-              fseeko(stream->file, currpos, SEEK_SET);
-            }
-          }
-
-          (void)fwrite(pkt->data.frame.buf, 1, pkt->data.frame.sz,
-                       stream->file);
-        }
-        stream->nbytes += pkt->data.raw.sz;
+        write_cx_frame(stream, pkt);
 
         *got_data = 1;
 #if CONFIG_DECODERS
@@ -1695,6 +1852,209 @@ static void test_decode(struct stream_state *stream,
   vpx_img_free(&dec_img);
 }
 
+struct chunk {
+  struct stream_state stream;
+  struct VpxEncoderConfig global;
+  struct VpxInputContext input;
+  struct chunk_output out;
+  int start_frame;  // First frame of the chunk in the stats.
+  int num_frames;   // 0 to code up to the end of the input.
+  int input_shift;
+  int use_16bit_internal;
+  int frames_coded;
+};
+
+// Returns the size of a frame of raw input read into img by read_frame().
+static int64_t raw_frame_size(const vpx_image_t *img) {
+  const int bytespp = (img->fmt & VPX_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+  int64_t size = 0;
+  int plane;
+  for (plane = 0; plane < 3; ++plane) {
+    int w = vpx_img_plane_width(img, plane);
+    // NV12 stores both chroma planes in one.
+    if (img->fmt == VPX_IMG_FMT_NV12 && plane > 1) break;
+    if (img->fmt == VPX_IMG_FMT_NV12 && plane == 1) w = (w + 1) & ~1;
+    size += (int64_t)w * vpx_img_plane_height(img, plane) * bytespp;
+  }
+  return size;
+}
+
+// Encodes one chunk of the clip on its own encoder, reading the input from a
+// file of its own.
+static THREADFN encode_chunk(void *arg) {
+  struct chunk *const chunk = (struct chunk *)arg;
+  struct stream_state *const stream = &chunk->stream;
+  struct VpxEncoderConfig *const global = &chunk->global;
+  struct VpxInputContext *const input = &chunk->input;
+  const int first = global->skip_frames + chunk->start_frame;
+  int end = chunk->num_frames ? first + chunk->num_frames : INT_MAX;
+  vpx_image_t raw;
+#if CONFIG_VP9_HIGHBITDEPTH
+  vpx_image_t raw_shift;
+  int allocated_raw_shift = 0;
+#endif
+  int frames_in = 0, frame_avail = 1, got_data = 0;
+
+  if (global->limit && global->limit < end) end = global->limit;
+
+  memset(&raw, 0, sizeof(raw));
+  open_input_file(input);
+  // The Y4M reader does its own allocation.
+  if (input->file_type != FILE_TYPE_Y4M) {
+    vpx_img_alloc(&raw, input->fmt, input->width, input->height, 32);
+  }
+
+  // Raw frames all have the same size, so the input can be positioned on the
+  // first frame of the chunk. Y4M frames are read to get past them.
+  if (input->file_type == FILE_TYPE_RAW && first > 0 &&
+      !fseeko(input->file, (FileOffset)(raw_frame_size(&raw) * first),
+              SEEK_SET)) {
+    // The bytes read to detect the file type belong to the first frame.
+    input->detect.position = input->detect.buf_read;
+    frames_in = first;
+  }
+
+  initialize_encoder(stream, global);
+  vpx_codec_control(&stream->encoder, VP9E_SET_CHUNK_START_FRAME,
+                    (unsigned int)chunk->start_frame);
+  ctx_exit_on_error(&stream->encoder, "Failed to set chunk start frame");
+
+  while (frame_avail || got_data) {
+    vpx_image_t *frame_to_encode = &raw;
+
+    frame_avail = frames_in < end && read_frame(input, &raw);
+    if (frame_avail) frames_in++;
+    // The frames before the chunk are only read to get past them.
+    if (frames_in <= first) continue;
+
+#if CONFIG_VP9_HIGHBITDEPTH
+    if (chunk->input_shift ||
+        (chunk->use_16bit_internal && input->bit_depth == 8)) {
+      if (!allocated_raw_shift) {
+        vpx_img_alloc(&raw_shift, raw.fmt | VPX_IMG_FMT_HIGHBITDEPTH,
+                      input->width, input->height, 32);
+        allocated_raw_shift = 1;
+      }
+      vpx_img_upshift(&raw_shift, &raw, chunk->input_shift);
+      frame_to_encode = &raw_shift;
+    }
+#endif
+    encode_frame(stream, global, frame_avail ? frame_to_encode : NULL,
+                 frames_in);
+    update_quantizer_histogram(stream);
+
+    got_data = 0;
+    get_cx_data(stream, global, &got_data);
+    if (got_data && global->test_decode != TEST_DECODE_OFF)
+      test_decode(stream, global->test_decode, global->codec);
+  }
+  chunk->frames_coded = frames_in > first ? frames_in - first : 0;
+
+  vpx_codec_destroy(&stream->encoder);
+  if (global->test_decode != TEST_DECODE_OFF)
+    vpx_codec_destroy(&stream->decoder);
+  close_input_file(input);
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (allocated_raw_shift) vpx_img_free(&raw_shift);
+#endif
+  vpx_img_free(&raw);
+  vpx_img_free(stream->img);
+  return THREAD_RETURN(NULL);
+}
+
+// Splits the second pass of the stream at key frame groups into chunks that
+// are encoded in parallel, then writes them out in order. Returns the number
+// of frames coded.
+static int encode_chunks(struct stream_state *stream,
+                         struct VpxEncoderConfig *global,
+                         const struct VpxInputContext *input, int input_shift,
+                         int use_16bit_internal) {
+  struct chunk *chunks;
+  int *key_frame_map;
+  unsigned int map_size;
+  int num_frames, num_chunks = 1, frames_coded = 0, i, j;
+#if CONFIG_MULTITHREAD
+  pthread_t *threads;
+#endif
+
+  vpx_codec_control(&stream->encoder, VP9E_GET_KEY_FRAME_MAP_SIZE, &map_size);
+  ctx_exit_on_error(&stream->encoder, "Failed to get key frame groups");
+  num_frames = (int)map_size;
+  key_frame_map = malloc(map_size * sizeof(*key_frame_map));
+  chunks = calloc(global->chunks, sizeof(*chunks));
+  if (!key_frame_map || !chunks) fatal("Failed to allocate chunks");
+
+  vpx_codec_control(&stream->encoder, VP9E_GET_KEY_FRAME_MAP, key_frame_map);
+  ctx_exit_on_error(&stream->encoder, "Failed to get key frame groups");
+
+  // Start each chunk on the first key frame group at or past its even share
+  // of the frames.
+  for (i = 1; i < num_frames && num_chunks < global->chunks; ++i) {
+    if (key_frame_map[i] &&
+        (int64_t)i * global->chunks >= (int64_t)num_frames * num_chunks) {
+      struct chunk *const prev = &chunks[num_chunks - 1];
+      prev->num_frames = i - prev->start_frame;
+      chunks[num_chunks++].start_frame = i;
+    }
+  }
+  free(key_frame_map);
+
+  for (i = 0; i < num_chunks; ++i) {
+    struct chunk *const chunk = &chunks[i];
+    struct stream_state *const chunk_stream = &chunk->stream;
+
+    chunk->global = *global;
+    chunk->global.quiet = 1;
+    chunk->input = *input;
+    chunk->input.file = NULL;
+    chunk->input_shift = input_shift;
+    chunk->use_16bit_internal = use_16bit_internal;
+
+    chunk_stream->index = stream->index;
+    chunk_stream->config = stream->config;
+    chunk_stream->chunk_out = &chunk->out;
+  }
+
+#if CONFIG_MULTITHREAD
+  threads = malloc(num_chunks * sizeof(*threads));
+  if (!threads) fatal("Failed to allocate chunks");
+  for (i = 0; i < num_chunks; ++i) {
+    if (pthread_create(&threads[i], NULL, encode_chunk, &chunks[i]))
+      fatal("Failed to start chunk %d", i);
+  }
+  for (i = 0; i < num_chunks; ++i) pthread_join(threads[i], NULL);
+  free(threads);
+#else
+  for (i = 0; i < num_chunks; ++i) encode_chunk(&chunks[i]);
+#endif
+
+  for (i = 0; i < num_chunks; ++i) {
+    struct chunk *const chunk = &chunks[i];
+    const struct stream_state *const chunk_stream = &chunk->stream;
+
+    for (j = 0; j < chunk->out.num_frames; ++j) {
+      vpx_codec_cx_pkt_t *const pkt = &chunk->out.frames[j].pkt;
+      pkt->data.frame.buf = chunk->out.data + chunk->out.frames[j].offset;
+      write_cx_frame(stream, pkt);
+    }
+    frames_coded += chunk->frames_coded;
+
+    stream->psnr_sse_total += chunk_stream->psnr_sse_total;
+    stream->psnr_samples_total += chunk_stream->psnr_samples_total;
+    for (j = 0; j < 4; ++j)
+      stream->psnr_totals[j] += chunk_stream->psnr_totals[j];
+    stream->psnr_count += chunk_stream->psnr_count;
+    for (j = 0; j < 64; ++j) stream->counts[j] += chunk_stream->counts[j];
+    if (chunk_stream->mismatch_seen && !stream->mismatch_seen)
+      stream->mismatch_seen = chunk->start_frame + chunk_stream->mismatch_seen;
+
+    free(chunk->out.frames);
+    free(chunk->out.data);
+  }
+  free(chunks);
+  return frames_coded;
+}
+
 static void print_time(const char *label, int64_t etl) {
   int64_t hours;
   int64_t mins;
@@ -1794,6 +2154,14 @@ int main(int argc, const char **argv_) {
   /* Decide if other chroma subsamplings than 4:2:0 are supported */
   if (global.codec->fourcc == VP9_FOURCC) input.only_i420 = 0;
 
+  if (global.chunks > 1) {
+    if (global.passes != 2 || global.codec->fourcc != VP9_FOURCC ||
+        stream_cnt > 1 || streams->config.use_kf_groups)
+      die("Error: --chunks requires a single two-pass VP9 stream\n");
+    if (!strcmp(input.filename, "-"))
+      die("Error: --chunks can not read the input from stdin\n");
+  }
+
   for (pass = global.pass ? global.pass - 1 : 0; pass < global.passes; pass++) {
     int frames_in = 0, seen_frames = 0;
     int64_t estimated_time_left = -1;
@@ -1915,6 +2283,21 @@ int main(int argc, const char **argv_) {
     frame_avail = 1;
     got_data = 0;
 
+    if (global.chunks > 1 && pass == 1) {
+      struct vpx_usec_timer timer;
+      vpx_usec_timer_start(&timer);
+#if CONFIG_VP9_HIGHBITDEPTH
+      seen_frames = encode_chunks(streams, &global, &input, input_shift,
+                                  use_16bit_internal);
+#else
+      seen_frames = encode_chunks(streams, &global, &input, 0, 0);
+#endif
+      vpx_usec_timer_mark(&timer);
+      cx_time = streams->cx_time = vpx_usec_timer_elapsed(&timer);
+      frames_in = global.skip_frames + seen_frames;
+      frame_avail = 0;
+    }
+
     while (frame_avail || got_data) {
       struct vpx_usec_timer timer;
 
@@ -2068,6 +2451,11 @@ int main(int argc, const char **argv_) {
     FOREACH_STREAM(close_output_file(stream, global.codec->fourcc));
 
     FOREACH_STREAM(stats_close(&stream->stats, global.passes - 1));
+    if (pass == 0 && global.passes == 2) {
+      FOREACH_STREAM({
+        if (stream->config.stats_indexed) index_stats_file(stream, &global);
+      });
+    }
 
 #if CONFIG_FP_MB_STATS
     FOREACH_STREAM(stats_close(&stream->fpmb_stats, global.passes - 1));
@@ -45,6 +45,7 @@ struct VpxEncoderConfig {
   int verbose;
   int limit;
   int skip_frames;
+  int chunks;
   int show_psnr;
   enum TestDecodeFatality test_decode;
   int have_framerate;
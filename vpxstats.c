@@ -15,10 +15,74 @@
 #include <string.h>
 
 #include "./tools_common.h"
+#include "vpx_ports/mem_ops.h"
+
+#if !defined(_WIN32) && HAVE_UNISTD_H
+#define USE_POSIX_MMAP 1
+#include <sys/mman.h>
+#endif
+
+static const char kStatsFileMagic[4] = { 'V', 'P', 'F', 'S' };
+
+static void init_stats_file(stats_io_t *stats) {
+  stats->indexed = 0;
+  stats->packet_sz = 0;
+  stats->num_packets = 0;
+  stats->num_groups = 0;
+  stats->index = NULL;
+  stats->map = NULL;
+  stats->map_sz = 0;
+  stats->window = NULL;
+}
+
+static int write_header(FILE *file, unsigned int packet_sz,
+                        unsigned int num_packets, unsigned int num_groups) {
+  unsigned char header[STATS_FILE_HEADER_SZ] = { 0 };
+
+  memcpy(header, kStatsFileMagic, sizeof(kStatsFileMagic));
+  mem_put_le32(header + 4, STATS_FILE_VERSION);
+  mem_put_le32(header + 8, STATS_FILE_HEADER_SZ);
+  mem_put_le32(header + 12, packet_sz);
+  mem_put_le32(header + 16, num_packets);
+  mem_put_le32(header + 20, num_groups);
+
+  return !fseek(file, 0, SEEK_SET) &&
+         fwrite(header, 1, sizeof(header), file) == sizeof(header);
+}
+
+// Points the stats at the packets of an indexed file, if data is one.
+static void read_header(stats_io_t *stats, unsigned char *data, size_t sz) {
+  unsigned int header_sz;
+  uint64_t packets_sz;
+
+  if (sz < STATS_FILE_HEADER_SZ ||
+      memcmp(data, kStatsFileMagic, sizeof(kStatsFileMagic)))
+    return;
+
+  if (mem_get_le32(data + 4) != STATS_FILE_VERSION)
+    fatal("Unsupported first-pass stats file version %u",
+          (unsigned int)mem_get_le32(data + 4));
+
+  header_sz = (unsigned int)mem_get_le32(data + 8);
+  stats->packet_sz = (unsigned int)mem_get_le32(data + 12);
+  stats->num_packets = (unsigned int)mem_get_le32(data + 16);
+  stats->num_groups = (unsigned int)mem_get_le32(data + 20);
+  packets_sz = (uint64_t)stats->num_packets * stats->packet_sz;
+
+  if (header_sz < STATS_FILE_HEADER_SZ || stats->packet_sz == 0 ||
+      header_sz + packets_sz + 4 * (uint64_t)stats->num_groups > sz)
+    fatal("Truncated first-pass stats file");
+
+  stats->indexed = 1;
+  stats->buf.buf = data + header_sz;
+  stats->buf.sz = (size_t)packets_sz;
+  stats->index = data + header_sz + packets_sz;
+}
 
 int stats_open_file(stats_io_t *stats, const char *fpf, int pass) {
   int res;
   stats->pass = pass;
+  init_stats_file(stats);
 
   if (pass == 0) {
     stats->file = fopen(fpf, "wb");
@@ -38,22 +102,53 @@ int stats_open_file(stats_io_t *stats, const char *fpf, int pass) {
     stats->buf.sz = stats->buf_alloc_sz = ftell(stats->file);
     rewind(stats->file);
 
-    stats->buf.buf = malloc(stats->buf_alloc_sz);
+#if USE_POSIX_MMAP
+    // Map the file rather than read it, so the second pass only reads the
+    // stats it looks at.
+    if (stats->buf.sz > 0) {
+      void *map = mmap(NULL, stats->buf.sz, PROT_READ, MAP_PRIVATE,
+                       fileno(stats->file), 0);
+      if (map != MAP_FAILED) {
+        stats->map = map;
+        stats->map_sz = stats->buf.sz;
+      }
+    }
+#endif
+
+    if (stats->map) {
+      stats->buf.buf = stats->map;
+      res = 1;
+    } else {
+      stats->buf.buf = malloc(stats->buf_alloc_sz);
 
-    if (!stats->buf.buf)
-      fatal("Failed to allocate first-pass stats buffer (%lu bytes)",
-            (unsigned int)stats->buf_alloc_sz);
+      if (!stats->buf.buf)
+        fatal("Failed to allocate first-pass stats buffer (%lu bytes)",
+              (unsigned int)stats->buf_alloc_sz);
+
+      nbytes = fread(stats->buf.buf, 1, stats->buf.sz, stats->file);
+      res = (nbytes == stats->buf.sz);
+      stats->map = stats->buf.buf;
+      stats->map_sz = 0;
+    }
 
-    nbytes = fread(stats->buf.buf, 1, stats->buf.sz, stats->file);
-    res = (nbytes == stats->buf.sz);
+    if (res) read_header(stats, stats->map, stats->buf_alloc_sz);
   }
 
   return res;
 }
 
+int stats_open_indexed_file(stats_io_t *stats, const char *fpf) {
+  if (!stats_open_file(stats, fpf, 0)) return 0;
+
+  // Leave room for the header, written once the number of packets is known.
+  stats->indexed = 1;
+  return write_header(stats->file, 0, 0, 0);
+}
+
 int stats_open_mem(stats_io_t *stats, int pass) {
   int res;
   stats->pass = pass;
+  init_stats_file(stats);
 
   if (!pass) {
     stats->buf.sz = 0;
@@ -68,8 +163,19 @@ int stats_open_mem(stats_io_t *stats, int pass) {
 
 void stats_close(stats_io_t *stats, int last_pass) {
   if (stats->file) {
+    if (stats->pass == 0 && stats->indexed) {
+      if (!write_header(stats->file, stats->packet_sz, stats->num_packets, 0))
+        fatal("Failed to write first-pass stats file header");
+    }
+
     if (stats->pass == last_pass) {
-      free(stats->buf.buf);
+#if USE_POSIX_MMAP
+      if (stats->map_sz > 0)
+        munmap(stats->map, stats->map_sz);
+      else
+#endif
+        free(stats->map);
+      free(stats->window);
     }
 
     fclose(stats->file);
@@ -81,6 +187,12 @@ void stats_close(stats_io_t *stats, int last_pass) {
 
 void stats_write(stats_io_t *stats, const void *pkt, size_t len) {
   if (stats->file) {
+    if (stats->indexed) {
+      if (stats->num_packets > 0 && len != stats->packet_sz)
+        fatal("First-pass stats packets must all be the same size.");
+      stats->packet_sz = (unsigned int)len;
+      ++stats->num_packets;
+    }
     (void)fwrite(pkt, 1, len, stats->file);
   } else {
     if (stats->buf.sz + len > stats->buf_alloc_sz) {
@@ -103,3 +215,70 @@ void stats_write(stats_io_t *stats, const void *pkt, size_t len) {
 }
 
 vpx_fixed_buf_t stats_get(stats_io_t *stats) { return stats->buf; }
+
+int stats_write_index(const char *fpf, const unsigned int *group_starts,
+                      unsigned int num_groups) {
+  unsigned char header[STATS_FILE_HEADER_SZ];
+  unsigned int packet_sz = 0, num_packets = 0, i;
+  FILE *file = fopen(fpf, "r+b");
+  int res;
+
+  if (file == NULL) return 0;
+
+  res = fread(header, 1, sizeof(header), file) == sizeof(header) &&
+        !memcmp(header, kStatsFileMagic, sizeof(kStatsFileMagic)) &&
+        mem_get_le32(header + 4) == STATS_FILE_VERSION;
+  if (res) {
+    packet_sz = (unsigned int)mem_get_le32(header + 12);
+    num_packets = (unsigned int)mem_get_le32(header + 16);
+    res = !fseek(file,
+                 (long)(STATS_FILE_HEADER_SZ +
+                        (uint64_t)num_packets * packet_sz),
+                 SEEK_SET);
+  }
+  for (i = 0; res && i < num_groups; ++i) {
+    unsigned char entry[4];
+    mem_put_le32(entry, group_starts[i]);
+    res = fwrite(entry, 1, sizeof(entry), file) == sizeof(entry);
+  }
+  if (res) res = write_header(file, packet_sz, num_packets, num_groups);
+
+  fclose(file);
+  return res;
+}
+
+int stats_select_kf_groups(stats_io_t *stats, unsigned int first,
+                           unsigned int count, unsigned int *first_frame,
+                           unsigned int *num_frames) {
+  const unsigned int num_frames_in_file = stats->num_packets - 1;
+  const char *const packets = (const char *)stats->buf.buf;
+  unsigned int start, end;
+  char *window;
+
+  if (!stats->indexed || stats->num_packets == 0 || first >= stats->num_groups)
+    return 0;
+  if (count == 0 || count > stats->num_groups - first)
+    count = stats->num_groups - first;
+
+  start = (unsigned int)mem_get_le32(stats->index + 4 * first);
+  end = first + count < stats->num_groups
+            ? (unsigned int)mem_get_le32(stats->index + 4 * (first + count))
+            : num_frames_in_file;
+  if (start >= end || end > num_frames_in_file) return 0;
+
+  window = malloc((size_t)(end - start + 1) * stats->packet_sz);
+  if (!window) return 0;
+  memcpy(window, packets + (size_t)start * stats->packet_sz,
+         (size_t)(end - start) * stats->packet_sz);
+  memcpy(window + (size_t)(end - start) * stats->packet_sz,
+         packets + (size_t)num_frames_in_file * stats->packet_sz,
+         stats->packet_sz);
+
+  free(stats->window);
+  stats->window = window;
+  stats->buf.buf = window;
+  stats->buf.sz = (size_t)(end - start + 1) * stats->packet_sz;
+  *first_frame = start;
+  *num_frames = end - start;
+  return 1;
+}
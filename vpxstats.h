@@ -19,6 +19,22 @@
 extern "C" {
 #endif
 
+/* Indexed first pass stats file layout, version 1:
+ *
+ *   header    STATS_FILE_HEADER_SZ bytes, little endian:
+ *               "VPFS" magic, version, header size, packet size,
+ *               number of packets, number of key frame groups, 8 reserved
+ *               bytes
+ *   packets   the stats packets of the first pass as output by the encoder,
+ *             the last one holding the totals of the whole pass
+ *   index     the first frame of each key frame group, 32-bit little endian
+ *
+ * The packets are opaque and keep the byte order of the encoder that wrote
+ * them, as in the plain stats file, which is the packets alone.
+ */
+#define STATS_FILE_VERSION 1
+#define STATS_FILE_HEADER_SZ 32
+
 /* This structure is used to abstract the different ways of handling
  * first pass statistics
  */
@@ -28,14 +44,44 @@ typedef struct {
   FILE *file;
   char *buf_ptr;
   size_t buf_alloc_sz;
+  /* Indexed stats file. */
+  int indexed;
+  unsigned int packet_sz;
+  unsigned int num_packets;
+  unsigned int num_groups;
+  const unsigned char *index;
+  /* Mapping of a stats file read in the last pass, or NULL if it was read
+   * into buf.
+   */
+  void *map;
+  size_t map_sz;
+  /* Copy of the packets of the key frame groups selected from the file. */
+  void *window;
 } stats_io_t;
 
 int stats_open_file(stats_io_t *stats, const char *fpf, int pass);
+/* Opens fpf to write first pass stats in the indexed format. The index is
+ * added by stats_write_index() once the file is closed.
+ */
+int stats_open_indexed_file(stats_io_t *stats, const char *fpf);
 int stats_open_mem(stats_io_t *stats, int pass);
 void stats_close(stats_io_t *stats, int last_pass);
 void stats_write(stats_io_t *stats, const void *pkt, size_t len);
 vpx_fixed_buf_t stats_get(stats_io_t *stats);
 
+/* Appends the key frame group index to a closed indexed stats file. */
+int stats_write_index(const char *fpf, const unsigned int *group_starts,
+                      unsigned int num_groups);
+
+/* Narrows the stats read from an indexed file to count key frame groups
+ * starting at group first, followed by the totals packet of the file. Only
+ * the packets of these groups are read. Returns the range of frames they
+ * cover in *first_frame and *num_frames.
+ */
+int stats_select_kf_groups(stats_io_t *stats, unsigned int first,
+                           unsigned int count, unsigned int *first_frame,
+                           unsigned int *num_frames);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif